@@ -31,6 +31,7 @@ set(DOCUMENT_FILES
 )
 
 set(EXPORTERS_FILES
+    ${LOMSE_SRC_DIR}/exporters/lomse_export_sink.cpp
     ${LOMSE_SRC_DIR}/exporters/lomse_ldp_exporter.cpp
     ${LOMSE_SRC_DIR}/exporters/lomse_lmd_exporter.cpp
     ${LOMSE_SRC_DIR}/exporters/lomse_mnx_exporter.cpp
@@ -53,6 +54,7 @@ set(GRAPHIC_MODEL_FILES
     ${LOMSE_SRC_DIR}/graphic_model/lomse_fragment_mark.cpp
     ${LOMSE_SRC_DIR}/graphic_model/lomse_glyphs.cpp
     ${LOMSE_SRC_DIR}/graphic_model/lomse_gm_basic.cpp
+    ${LOMSE_SRC_DIR}/graphic_model/lomse_gm_shapes_index.cpp
     ${LOMSE_SRC_DIR}/graphic_model/lomse_graphical_model.cpp
     ${LOMSE_SRC_DIR}/graphic_model/lomse_handler.cpp
     ${LOMSE_SRC_DIR}/graphic_model/lomse_gm_measures_table.cpp
@@ -140,6 +142,7 @@ set(INTERNAL_MODEL_FILES
     ${LOMSE_SRC_DIR}/internal_model/lomse_im_figured_bass.cpp
     ${LOMSE_SRC_DIR}/internal_model/lomse_im_measures_table.cpp
     ${LOMSE_SRC_DIR}/internal_model/lomse_im_note.cpp
+    ${LOMSE_SRC_DIR}/internal_model/lomse_im_snapshot.cpp
     ${LOMSE_SRC_DIR}/internal_model/lomse_internal_model.cpp
     ${LOMSE_SRC_DIR}/internal_model/lomse_model_builder.cpp
     ${LOMSE_SRC_DIR}/internal_model/lomse_score_algorithms.cpp
@@ -201,6 +204,7 @@ set(RENDER_FILES
     ${LOMSE_SRC_DIR}/render/lomse_font_storage.cpp
     ${LOMSE_SRC_DIR}/render/lomse_renderer.cpp
     ${LOMSE_SRC_DIR}/render/lomse_screen_drawer.cpp
+    ${LOMSE_SRC_DIR}/render/lomse_tile_cache.cpp
 )
 
 set(SCORE_FILES
@@ -55,6 +55,10 @@ a) Events always sent to the global handler:
 	- EventEndOfPlayback (type <tt>k_end_of_playback_event</tt>) - End of playback.
 	- EventScoreHighlight (type <tt>k_highlight_event</tt>) - Event containing mainly a list of notes/rests to highlight or unhighlight
 
+- Events created in the Lomse layout thread, when progressive layout is enabled:
+
+	- EventLayout (type <tt>k_layout_completed_event</tt>) - All pages laid out. Ask user app to invoke Interactor::on_layout_completed().
+
 - Mouse clicks on links (ImoLink objects):
 
 	- EventMouse (type <tt>k_on_link_clicked_event</tt>) - left click on link (ImoLink object).
@@ -189,5 +189,24 @@ void DocumentWindow::print_page(PrinterDC* pDC, int page, int paperWidthPixels,
 }
 @endcode
 
+
+@section print-batch Rendering many pages concurrently
+
+When many pages have to be rendered (e.g. for exporting a document as images), your application can use Interactor::print_pages() instead of invoking Interactor::print_page() in a loop. It takes a list of pages and a rendering buffer for each page, and renders the pages concurrently in a pool of worker threads. Each worker uses its own drawer, renderer and fonts, and the result is identical to rendering the pages one by one with Interactor::print_page(). Printer resolution is taken from Interactor::set_print_ppi(), and the print buffer set by Interactor::set_print_buffer() is not used.
+
+@code
+    int numPages = spInteractor->get_num_pages();
+    vector<int> pages;
+    vector<RenderingBuffer*> buffers;
+    for (int i=0; i < numPages; ++i)
+    {
+        pages.push_back(i);
+        buffers.push_back( create_page_buffer(paperWidthPixels, paperHeightPixels) );
+    }
+
+    spInteractor->set_print_ppi(300.0);
+    spInteractor->print_pages(pages, buffers);     //use all available cores
+@endcode
+
 */
 
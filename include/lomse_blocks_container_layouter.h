@@ -62,6 +62,8 @@ class ContentLayouter : public Layouter
 {
 protected:
     ImoContent* m_pContent;
+    int m_iFirstItem;
+    Layouter* m_pFirstItemLayouter;
 
 public:
     ContentLayouter(ImoContentObj* pItem, Layouter* pParent,
@@ -73,6 +75,14 @@ public:
     void layout_in_box() override;
     void create_main_box(GmoBox* pParentBox, UPoint pos, LUnits width, LUnits height) override;
 
+    //for incremental layout: previous items are already laid out. When a layouter
+    //is provided, the layout of the first item was interrupted and continues from
+    //the state saved in its layouter
+    inline void set_first_item(int iItem, Layouter* pLayouter=nullptr) {
+        m_iFirstItem = iItem;
+        m_pFirstItemLayouter = pLayouter;
+    }
+
 };
 
 //----------------------------------------------------------------------------------
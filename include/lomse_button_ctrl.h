@@ -81,7 +81,7 @@ protected:
     LUnits  m_yLabel;
 
     ImoStyle* create_default_style();
-    void center_text();
+    void center_text(Drawer* pDrawer);
 
 };
 
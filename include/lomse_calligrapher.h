@@ -43,6 +43,8 @@
 #include "lomse_injectors.h"
 #include "lomse_basic.h"
 
+#include <vector>
+
 
 namespace lomse
 {
@@ -50,10 +52,17 @@ namespace lomse
 //forward declarations
 class Renderer;
 class FontStorage;
+struct glyph_cache;
 
 
 // Calligrapher: A speciallized drawer that knows how to create bitmaps and
 //               paths to render fonts
+//
+// Glyphs can be rendered immediately (draw_text(), draw_glyph()) or queued in a
+// batch (add_text_to_batch(), add_glyph_to_batch()) and rendered later, in the
+// same order in which they were queued, by invoking render_batch(). The coverage
+// data of each queued glyph is copied into the batch, so the batch remains valid
+// even if the font is changed or the glyph is evicted from the font cache.
 //---------------------------------------------------------------------------------------
 class Calligrapher
 {
@@ -61,6 +70,17 @@ protected:
     FontStorage* m_pFonts;
     Renderer* m_pRenderer;
 
+    struct BatchedGlyph
+    {
+        double x;
+        double y;
+        size_t offset;      //position of glyph data in m_batchData
+        unsigned size;      //size of glyph data
+        Color color;
+    };
+    std::vector<BatchedGlyph> m_batch;
+    std::vector<unsigned char> m_batchData;
+
 public:
     Calligrapher(FontStorage* fonts, Renderer* renderer);
     ~Calligrapher();
@@ -71,9 +91,23 @@ public:
                   double scale=1.0);
     void draw_glyph(double x, double y, unsigned int ch, Color color, double scale);
 
+    //batched rendering
+    int add_text_to_batch(double x, double y, const std::string& str, Color color,
+                          double scale=1.0);
+    int add_text_to_batch(double x, double y, const wstring& str, Color color,
+                          double scale=1.0);
+    void add_glyph_to_batch(double x, double y, unsigned int ch, Color color,
+                            double scale);
+    void render_batch();
+    void clear_batch();
+    inline bool is_batch_empty() { return m_batch.empty(); }
+    inline size_t get_batch_size() { return m_batch.size(); }
+
 protected:
     void draw_glyph(double x, double y, unsigned int ch, Color color);
     void set_scale(double scale);
+    bool add_glyph_to_batch(const lomse::glyph_cache* glyph, double x, double y,
+                            Color color);
 
 };
 
@@ -89,6 +123,7 @@ protected:
 
 public:
     TextMeter(LibraryScope& libraryScope);
+    TextMeter(LibraryScope& libraryScope, FontStorage* pFonts);
     ~TextMeter();
 
     LUnits measure_width(const std::string& str);
@@ -92,8 +92,7 @@ public:
     void rewind(int UNUSED(pathId) = 0) override { m_nCurVertex = 0; }
 
 protected:
-    void select_font();
-    URect determine_text_position_and_size();
+    URect determine_text_position_and_size(Drawer* pDrawer);
     ImoStyle* create_default_style();
 
 };
@@ -48,6 +48,7 @@ namespace lomse
 
 //forward declarations
 class Document;
+class ImSnapshot;
 class SelectionSet;
 class DocCommandExecuter;
 class OverlappedNoteRest;
@@ -82,7 +83,10 @@ class DocCommand
 {
 protected:
     string m_name;          //displayable name for undo/redo actions display
-    string m_checkpoint;    //checkpoint data
+    string m_checkpoint;    //checkpoint data, or source code for m_pSnapshot
+    string m_packed;        //checkpoint data, when compressed. See DocCommandExecuter
+    DocCommand* m_pDeltaBase;   //command with the base text for m_packed, or nullptr
+    ImSnapshot* m_pSnapshot;    //checkpoint snapshot
     ImoId m_idChk;          //id for target object in case of partial checkpoint
     ImoId m_idRefresh;      //id for cursor object, for k_refresh policy
     string m_error;
@@ -97,6 +101,8 @@ protected:
 
     DocCommand(const string& name)
         : m_name(name)
+        , m_pDeltaBase(nullptr)
+        , m_pSnapshot(nullptr)
         , m_idChk(k_no_imoid)
         , m_idRefresh(k_no_imoid)
         , m_flags(0)
@@ -105,7 +111,7 @@ protected:
 
 public:
     /// Destructor.
-    virtual ~DocCommand() {}
+    virtual ~DocCommand();
 
     /** This enum describes the policies for updating the cursor after executing a
 		command.    */
@@ -198,10 +204,19 @@ public:
     virtual int set_target(Document* pDoc, DocCursor* pCursor, SelectionSet* pSelection)=0;
     virtual int perform_action(Document* pDoc, DocCursor* pCursor)=0;
     virtual void undo_action(Document* pDoc, DocCursor* pCursor);
+
+    //checkpoint compression, for the undo history
+    void pack_checkpoint(Document* pDoc, DocCommand* pBase);
+    void unpack_checkpoint();
+    inline bool is_checkpoint_packed() { return !m_packed.empty(); }
+    inline bool is_checkpoint_delta() { return m_pDeltaBase != nullptr; }
+    size_t get_checkpoint_memory();
 ///@endcond
 
 protected:
     void create_checkpoint(Document* pDoc);
+    string get_checkpoint_source();
+    void save_snapshot_source(Document* pDoc);
     void log_forensic_data(Document* pDoc, DocCursor* pCursor);
     void set_command_name(const string& name, ImoObj* pImo);
     int validate_source(const string& source);
@@ -316,6 +331,8 @@ private:
     Document*   m_pDoc;
     UndoStack   m_stack;
     string      m_error;
+    list<ImoId> m_dirtyIds;
+    size_t      m_budget;       //max memory for the undo history, in bytes. 0: no limit
 
 public:
     /// Constructor
@@ -346,10 +363,38 @@ public:
     /// Returns the number of undo/redo elements in the undo/redo stack.
     virtual size_t undo_stack_size() { return m_stack.size(); }
 
+    //undo history memory
+    /** Sets the maximum memory, in bytes, to be used by the undo/redo history. When
+        exceeded, the checkpoints of all commands but the last one are compressed and,
+        if still exceeded, the oldest undo elements are removed. The most recent undo
+        element is never removed. Value 0 (the default) means no limit: checkpoints
+        are neither compressed nor removed.    */
+    void set_undo_memory_budget(size_t bytes);
+    /// Returns the maximum memory, in bytes, for the undo/redo history. 0 means no limit.
+    inline size_t get_undo_memory_budget() { return m_budget; }
+    /** Returns the memory, in bytes, currently used by the checkpoints saved in the
+        undo/redo history. Checkpoints are saved as snapshots when snapshots are enabled
+        (see LibraryScope::set_undo_snapshots()). Once the memory budget has been
+        exceeded, all checkpoints but the last one are kept as compressed source
+        code.    */
+    size_t get_undo_memory_size();
+
+    //modified objects
+    /** Returns the ids of the objects modified by the commands executed, undone or
+        redone since last invocation of clear_dirty_ids(). If the list contains
+        value @c k_no_imoid the modified objects are not known and the whole
+        document must be considered modified.    */
+    inline const list<ImoId>& get_dirty_ids() { return m_dirtyIds; }
+    /// Empties the list of modified objects.
+    inline void clear_dirty_ids() { m_dirtyIds.clear(); }
+
 protected:
     friend class DocCmdComposite;
     void update_cursor(DocCursor* pCursor, DocCommand* pCmd);
     void update_selection(SelectionSet* pSelection, DocCommand* pCmd);
+    void save_dirty_ids(bool fKnown=true);
+    void pack_checkpoints();
+    void enforce_memory_budget();
 
 };
 
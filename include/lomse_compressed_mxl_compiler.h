@@ -59,7 +59,7 @@ public:
 
 protected:
     std::string get_rootfile_path(ZipInputStream&);
-    std::string read_rootfile(ZipInputStream&);
+    ImoDocument* compile_rootfile(ZipInputStream&);
 };
 
 
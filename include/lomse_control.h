@@ -36,6 +36,7 @@
 #include "lomse_events.h"               // EventHandler
 #include "lomse_gm_basic.h"
 #include "lomse_calligrapher.h"         //TextMeter
+#include "lomse_drawer.h"
 
 namespace lomse
 {
@@ -43,7 +44,6 @@ namespace lomse
 //forward declarations
 class ImoContent;
 class GmoBox;
-class Drawer;
 struct RenderOptions;
 
 
@@ -181,6 +181,18 @@ protected:
                           m_style->is_italic() );
     }
 
+    void select_font(Drawer* pDrawer)
+    {
+        //AWARE: when drawing, the font must be selected in the drawer, as it could be
+        //using its own font storage
+        pDrawer->select_font(m_language,
+                             m_style->font_file(),
+                             m_style->font_name(),
+                             m_style->font_size(),
+                             m_style->is_bold(),
+                             m_style->is_italic() );
+    }
+
 };
 
 
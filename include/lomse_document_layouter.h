@@ -35,6 +35,8 @@
 #include "lomse_layouter.h"
 
 #include <sstream>
+#include <atomic>
+#include <list>
 using namespace std;
 
 namespace lomse
@@ -58,6 +60,11 @@ protected:
     ImoDocument* m_pDoc;
     LUnits m_viewWidth;
 
+    //for interrupting the layout (progressive layout)
+    int m_maxPages;
+    std::atomic<bool>* m_pCancel;
+    int m_numPrevPages;         //pages in previous graphic model, when layout resumed
+
     //for unit tests: need to access ScoreLayouter.
     Layouter* m_pScoreLayouter;
 
@@ -68,12 +75,21 @@ public:
 
     void layout_document();
     void layout_empty_document();
+    bool layout_document_reusing(GraphicModel* pOldModel, int iDirtyBlock);
+    int relayout_score(GraphicModel* pModel, int iBlock, const std::list<ImoId>& dirtyIds);
+    bool resume_layout();
+
+    //progressive layout
+    inline void set_page_limit(int maxPages) { m_maxPages = maxPages; }
+    inline void set_cancel_flag(std::atomic<bool>* pCancel) { m_pCancel = pCancel; }
+    inline bool is_layout_interrupted() { return m_result == k_layout_interrupted; }
 
     //implementation of virtual methods in Layouter base class
     void layout_in_box() override {}
     void create_main_box(GmoBox* UNUSED(pParentBox), UPoint UNUSED(pos),
                          LUnits UNUSED(width), LUnits UNUSED(height)) override {}
     GmoBox* start_new_page() override;
+    bool must_interrupt_layout() override;
 
     //only for unit tests
     ScoreLayouter* get_score_layouter();
@@ -81,6 +97,10 @@ public:
 
 protected:
     int layout_content();
+    int layout_content_from(int iFirstBlock, Layouter* pFirstLayouter=nullptr);
+    int find_interrupted_block();
+    int find_page_for_resuming_layout(GraphicModel* pOldModel, int iDirtyBlock,
+                                      int* pFirstBlock);
     void fix_document_size();
     void delete_last_trial();
 
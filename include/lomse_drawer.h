@@ -260,8 +260,12 @@ protected:
 
 public:
     Drawer(LibraryScope& libraryScope);
+    Drawer(LibraryScope& libraryScope, FontStorage* pFonts);
     virtual ~Drawer() {}
 
+    //font storage used by this drawer. It could be a private one, not shared
+    inline FontStorage* get_font_storage() { return m_pFonts; }
+
     // SVG path commands
     // http://www.w3.org/TR/SVG/paths.html#PathData
     virtual void begin_path() = 0;                                  //SVG: <path>
@@ -116,6 +116,9 @@ enum EEventType
         //EventEndOfPlayback
         k_end_of_playback_event,        ///< Playback ended.
 
+    //EventLayout
+        k_layout_completed_event,       ///< Background layout finished: all pages ready.
+
 
 };
 
@@ -161,6 +164,7 @@ public:
     inline bool is_tracking_event() { return m_type == k_tracking_event; }
     inline bool is_update_viewport_event() { return m_type == k_update_viewport_event; }
     inline bool is_end_of_playback_event() { return m_type == k_end_of_playback_event; }
+    inline bool is_layout_completed_event() { return m_type == k_layout_completed_event; }
     //@}
 
 protected:
@@ -1014,6 +1018,66 @@ typedef std::shared_ptr<EventEndOfPlayback>  SpEventEndOfPlayback;
 
 
 
+//---------------------------------------------------------------------------------------
+/** An event generated by the Interactor when the progressive layout mode is enabled
+    (see Interactor::set_progressive_layout()) and the layout of the whole document,
+    done in a background thread, has finished. The only type for this event is
+    <b>k_layout_completed_event</b>.
+
+	@warning This event is sent to your application from the Lomse layout thread.
+			 For processing it, do not retain control: generate an application
+			 event, place it on the application events loop, and return control to Lomse.
+
+    The event is always sent to the global handler. When processing the application
+    event, your application must request the Interactor to add the remaining pages
+    to the graphic model. Preferably, this should be done in the main thread:
+
+	@code
+	void DocumentWindow::on_layout_completed(MyLayoutCompletedEvent& event)
+	{
+		SpEventLayout pEv = event.get_lomse_event();
+		WpInteractor wpInteractor = pEv->get_interactor();
+		if (SpInteractor spInteractor = wpInteractor.lock())
+		    spInteractor->on_layout_completed();
+	}
+	@endcode
+
+    Interactor::on_layout_completed() can also be invoked directly from the global
+    handler. See its documentation.
+*/
+class EventLayout : public EventInfo
+{
+protected:
+    WpInteractor m_wpInteractor;
+    int m_numPages;
+
+public:
+    /// Constructor
+    EventLayout(EEventType type, WpInteractor wpInteractor, int numPages)
+        : EventInfo(type)
+        , m_wpInteractor(wpInteractor)
+        , m_numPages(numPages)
+    {
+    }
+    /// Destructor
+    virtual ~EventLayout() {}
+
+    /** Returns a weak pointer to the Interactor object managing the
+        View for which the layout has been done. */
+    inline WpInteractor get_interactor() { return m_wpInteractor; }
+
+    /** Returns the number of pages in the complete graphic model. */
+    inline int get_num_pages() { return m_numPages; }
+};
+
+/** A shared pointer for an EventLayout.
+    @ingroup typedefs
+    @#include <lomse_events.h>
+*/
+typedef std::shared_ptr<EventLayout>  SpEventLayout;
+
+
+
 //---------------------------------------------------------------------------------------
 // EventVisualTracking
 /**
@@ -36,7 +36,9 @@
 
 #include <thread>
 #include <mutex>
-#include <queue>
+#include <condition_variable>
+#include <chrono>
+#include <deque>
 using namespace std;
 
 namespace lomse
@@ -49,6 +51,7 @@ namespace lomse
 typedef std::thread EventsThread;
 typedef std::mutex QueueMutex;
 typedef std::unique_lock<std::mutex> QueueLock;
+typedef std::chrono::steady_clock::time_point EventTimestamp;
 
 
 
@@ -56,16 +59,43 @@ typedef std::unique_lock<std::mutex> QueueLock;
 // EventsDispatcher
 //  Class to manage the event-dispatch loop.
 //  This class is a singleton maintained in Lomse LibraryScope object
+//
+//  By default (fDirectInvocation == true) events are not enqueued: the observer
+//  is notified directly, in the thread that posts the event, without any locking
+//  or statistics. The queued mode is selected by LibraryScope::set_queued_events().
+//  When events are enqueued, the dispatch thread sleeps until an event is posted and
+//  then dispatches all pending events in a batch. Events that supersede a previous
+//  event still pending for the same observer are coalesced with it:
+//    - k_update_viewport_event: the new event replaces the pending one.
+//    - k_tracking_event: the sub-events are appended to the pending event.
+//
 class EventsDispatcher
 {
 protected:
+    struct QueuedEvent
+    {
+        SpEventInfo pEvent;
+        Observer* pObserver;
+        EventTimestamp timestamp;       //when the event was posted
+    };
+
+    bool m_fDirectInvocation;       //do not use events thread
     EventsThread* m_pThread;        //execution thread
-    QueueMutex m_mutex;             //to control queue access
+    QueueMutex m_mutex;             //to control queue and statistics access
+    std::condition_variable m_wakeUp;
     bool m_fStopLoop;
-    queue< pair<SpEventInfo, Observer*> > m_events;
+    std::deque<QueuedEvent> m_events;
+
+    //statistics
+    size_t m_maxQueueDepth;
+    long m_numPosted;
+    long m_numDispatched;
+    long m_numCoalesced;
+    double m_totalLatency;          //milliseconds
+    double m_maxLatency;            //milliseconds
 
 public:
-    EventsDispatcher();
+    EventsDispatcher(bool fDirectInvocation=true);
     ~EventsDispatcher();
 
     void start_events_loop();
@@ -73,12 +103,25 @@ public:
 
     void post_event(Observer* pObserver, SpEventInfo pEvent);
 
+    //statistics. Only collected when events are enqueued
+    size_t get_queue_depth();
+    size_t get_max_queue_depth();
+    long get_num_posted_events();
+    long get_num_dispatched_events();
+    long get_num_coalesced_events();
+    /** Mean and max. time (milliseconds) between posting an event and delivering it
+        to its observer.    */
+    double get_mean_dispatch_latency();
+    double get_max_dispatch_latency();
+    void reset_statistics();
+
 protected:
     inline bool stop_event_received() { return m_fStopLoop; }
     void run_events_loop();
     void thread_main();
-    inline bool pending_events() { return !m_events.empty(); }
-    void dispatch_next_event();
+    void dispatch_events(std::deque<QueuedEvent>& batch);
+    bool coalesce_with_pending_event(Observer* pObserver, SpEventInfo pEvent);
+    void update_statistics(const EventTimestamp& posted);
 
 };
 
@@ -0,0 +1,80 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2020. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+//---------------------------------------------------------------------------------------
+
+#ifndef __LOMSE_EXPORT_SINK_H__
+#define __LOMSE_EXPORT_SINK_H__
+
+#include <streambuf>
+#include <ostream>
+#include <string>
+
+namespace lomse
+{
+
+//---------------------------------------------------------------------------------------
+/** %ExportSink is the output for exporters (LdpExporter, LmdExporter and MnxExporter).
+    All generators write the source code into the same sink, through an std::ostream
+    built over it, and the sink appends it either to a string or to the stream buffer
+    of a user stream (e.g. a file).
+
+    The sink also supports <i>pending text</i>: text that must be written before the
+    next output but that must be discarded if nothing else is written (e.g. the
+    separator before an element that could generate no source code).
+*/
+class ExportSink : public std::streambuf
+{
+protected:
+    std::string* m_pBuffer;         //output string, or nullptr
+    std::streambuf* m_pTarget;      //output stream buffer when no output string
+    std::string m_pending;          //text to write before next output
+    size_t m_numWritten;            //number of chars written
+
+public:
+    ExportSink(std::string& buffer);
+    ExportSink(std::ostream& out);
+
+    /// Number of characters written into this sink
+    inline size_t get_num_written() { return m_numWritten; }
+
+    //pending text
+    inline void add_pending(const std::string& text) { m_pending.append(text); }
+    inline size_t get_pending_size() { return m_pending.size(); }
+    inline void remove_pending(size_t size) { m_pending.resize(size); }
+
+protected:
+    int_type overflow(int_type c) override;
+    std::streamsize xsputn(const char* s, std::streamsize n) override;
+    void write(const char* s, size_t n);
+
+};
+
+
+}   //namespace lomse
+
+#endif      //__LOMSE_EXPORT_SINK_H__
@@ -49,6 +49,7 @@
 //std
 #include <string>
 #include <map>
+#include <mutex>
 using namespace std;
 
 using namespace agg;
@@ -85,6 +86,7 @@ protected:
     bool    m_fFlip_y;
     EFontCacheType      m_fontCacheType;
     string m_fontFullName;
+    agg::trans_affine   m_transform;    //current transform in font engine
 
 public:
     FontStorage(LibraryScope* pLibScope);
@@ -132,7 +134,13 @@ public:
         return m_fontCacheManager.gray8_scanline();
     }
     inline void set_transform(agg::trans_affine& mtx) {
-        m_fontEngine.transform(mtx);
+        //changing the transform forces the font engine to recompute the font
+        //signature. Avoid it when the transform doesn't change
+        if (!m_transform.is_equal(mtx))
+        {
+            m_transform = mtx;
+            m_fontEngine.transform(mtx);
+        }
     }
 
 protected:
@@ -149,6 +157,7 @@ class FontSelector
 protected:
     LibraryScope* m_pLibScope;
     std::map<string, string> m_cache;
+    std::mutex m_mutex;     //find_font() can be invoked from several threads
 
 public:
     FontSelector(LibraryScope* pLibScope) : m_pLibScope(pLibScope) {}
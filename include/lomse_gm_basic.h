@@ -33,6 +33,7 @@
 #include "lomse_basic.h"
 #include "lomse_observable.h"
 #include "lomse_events.h"
+#include "lomse_gm_shapes_index.h"
 
 #include <vector>
 #include <list>
@@ -85,13 +86,50 @@ protected:
     vector<GmoBoxScorePage*> m_pages;
     GmMeasuresTable* m_measures;
 
+    //timeline index, for locating the page and the system for a timepos. It contains
+    //the pages having systems and their systems, in order, with their time span and the
+    //maximum end time up to each one (in the page, for systems). As max. end times
+    //never decrease, the first page or system ending at or after a timepos is found
+    //by binary search.
+    struct TimelineSpan
+    {
+        GmoBox*     pBox;           //page or system
+        TimeUnits   startTime;
+        TimeUnits   endTime;
+        TimeUnits   maxEndTime;
+        int         iFirstSystem;   //for pages: index to first system in m_systemSpans
+    };
+    vector<TimelineSpan> m_pageSpans;
+    vector<TimelineSpan> m_systemSpans;
+    bool m_fTimelineValid;
+
 public:
     ScoreStub(ImoScore* pScore);
     ~ScoreStub();
 
-    inline void add_page(GmoBoxScorePage* pPage) { m_pages.push_back(pPage); }
+    inline void add_page(GmoBoxScorePage* pPage) {
+        m_pages.push_back(pPage);
+        m_fTimelineValid = false;
+    }
     inline vector<GmoBoxScorePage*>& get_pages() { return m_pages; }
 
+    /** Replaces the table of measures by a copy of the table in @c pStub. It is used
+        when the layout of the score continues in other graphic model, for not losing
+        the measures already engraved.
+    */
+    void copy_measures_from(ScoreStub* pStub);
+
+    /** Appends the pages in @c pStub, the stub for the continuation of this score in
+        other graphic model. Its table of measures contains the measures in both stubs
+        and replaces the table in this stub.
+    */
+    void append_pages_from(ScoreStub* pStub);
+
+    /** Removes the pages placed in document page @c iDocPage (0..n-1) or in the
+        following ones. Returns @false if no page remains in this stub.
+    */
+    bool remove_pages_from(int iDocPage);
+
     /** Returns the GmoBoxScorePage containing timepos @c time. If @c time is not in
         the score, returns @nullptr. This method gives preference to find pages for
         events instead of non-timed staff objects. For example, the last
@@ -102,9 +140,28 @@ public:
     */
     GmoBoxScorePage* get_page_for(TimeUnits time);
 
+    /** Returns the GmoBoxSystem containing timepos @c time. If @c time is not in
+        the score, returns @nullptr. As in get_page_for(), when two systems contain
+        @c time (i.e. the last barline in one system and the first event in next
+        system) this method will return the second system.
+        @param time The time position (absolute time units) for the requested system.
+    */
+    GmoBoxSystem* get_system_for(TimeUnits time);
+
+    /** Creates the timeline index used by get_page_for() and get_system_for(). It is
+        invoked when the score layout is finished. Otherwise, the index is created when
+        first needed.
+    */
+    void build_timeline();
+
     /** Returns the table of measures for this score */
     inline GmMeasuresTable* get_measures_table() { return m_measures; }
 
+protected:
+    int find_page_span(TimeUnits time);
+    static int find_span(vector<TimelineSpan>& spans, int iStart, int iEnd,
+                         TimeUnits time);
+
 };
 
 
@@ -131,6 +188,7 @@ public:
         k_children_dirty    = 0x0004,   //this is not dirty but some children are dirty
         k_hover             = 0x0008,   //mouse over
         k_has_edit_focus    = 0x0010,   //this box has the focus for edition
+        k_in_shapes_index   = 0x0020,   //shape included in the spatial index of its page
 
         //structural flags
         k_in_link           = 0x0100,   //is part of a link
@@ -161,6 +219,13 @@ public:
         value ? m_flags |= k_add_to_vprofile : m_flags &= ~k_add_to_vprofile;
     }
 
+    //included in page spatial index. When position or size of an indexed shape
+    //changes the spatial index of its page is invalidated
+    inline bool is_in_shapes_index() { return (m_flags & k_in_shapes_index) != 0; }
+    void set_in_shapes_index(bool value) {
+        value ? m_flags |= k_in_shapes_index : m_flags &= ~k_in_shapes_index;
+    }
+
 
     //clasification
     enum { k_box = 0,
@@ -272,8 +337,14 @@ public:
     //size
     inline LUnits get_width() { return m_size.width; }
     inline LUnits get_height() { return m_size.height; }
-    inline void set_width(LUnits width) { m_size.width = width; }
-    inline void set_height(LUnits height) { m_size.height = height; }
+    inline void set_width(LUnits width) {
+        m_size.width = width;
+        on_geometry_changed();
+    }
+    inline void set_height(LUnits height) {
+        m_size.height = height;
+        on_geometry_changed();
+    }
 
     //position
     inline LUnits get_left() { return m_origin.x; }
@@ -318,6 +389,11 @@ public:
 protected:
     GmoObj(int objtype, ImoObj* pCreatorImo);
     void propagate_dirty();
+    inline void on_geometry_changed() {
+        if (m_flags & k_in_shapes_index)
+            invalidate_page_shapes_index();
+    }
+    void invalidate_page_shapes_index();
 
 };
 
@@ -509,6 +585,8 @@ public:
     //doc pages
     GmoBoxDocPage* add_new_page();
     GmoBoxDocPage* get_page(int i);     //i = 0..n-1
+    void take_pages_from(GmoBoxDocument* pSource, int numPages);
+    void delete_pages_from(int iPage);
     inline int get_num_pages() { return get_num_boxes(); }
     inline GmoBoxDocPage* get_last_page() { return m_pLastPage; }
     int get_page_number(GmoBoxDocPage* pBoxPage);
@@ -524,6 +602,7 @@ class GmoBoxDocPage : public GmoBox
 protected:
     int m_numPage;      //1..n
     std::list<GmoShape*> m_allShapes;		//contained shapes, ordered by layer and creation order
+    GmShapesIndex m_shapesIndex;            //spatial index for m_allShapes
 
 public:
     GmoBoxDocPage(ImoObj* pCreatorImo);
@@ -541,6 +620,14 @@ public:
     GmoShape* get_first_shape_for_layer(int order);
     GmoShape* find_shape_for_object(ImoStaffObj* pSO);
     void store_in_map_imo_shape(GmoShape* pShape);
+    void store_all_shapes_in_map_imo_shape();
+    void remove_all_shapes_from_map_imo_shape();
+
+    //spatial index. It is built when the page is finalized and, in any case, it is
+    //rebuilt when needed after adding shapes. It is invalidated when an indexed
+    //shape is moved or resized.
+    void build_shapes_index();
+    inline void invalidate_shapes_index() { m_shapesIndex.invalidate(); }
 
     //hit testing
     GmoObj* hit_test(LUnits x, LUnits y);
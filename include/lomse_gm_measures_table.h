@@ -56,6 +56,7 @@ protected:
 
 public:
     GmMeasuresTable(ImoScore* pScore);
+    GmMeasuresTable(const GmMeasuresTable& table);
     ///Destructor
     ~GmMeasuresTable();
 
@@ -63,6 +64,13 @@ public:
     //invoked when a non-middle barline is found
     void finish_measure(int iInstr, GmoShapeBarline* pBarlineShape);
 
+    /** Support for incremental relayout. Keeps the barlines for the first
+        @c numMeasures[i] measures of each instrument i, and adjusts the table to the
+        current number of measures in the score, so that next measures can be
+        added again by finish_measure().
+    */
+    void truncate(ImoScore* pScore, const vector<int>& numMeasures);
+
     //info
     int get_num_measures(int iInstr);
     inline int get_num_instruments() { return int(m_instrument.size()); }
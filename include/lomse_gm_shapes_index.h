@@ -0,0 +1,121 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2020. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+//---------------------------------------------------------------------------------------
+
+#ifndef __LOMSE_GM_SHAPES_INDEX_H__
+#define __LOMSE_GM_SHAPES_INDEX_H__
+
+#include "lomse_basic.h"
+
+#include <vector>
+#include <list>
+#include <map>
+
+namespace lomse
+{
+
+//forward declarations
+class GmoShape;
+class ImoObj;
+
+//---------------------------------------------------------------------------------------
+/** %GmShapesIndex is a spatial index (a static, bulk loaded R-tree) over the bounds
+    of the shapes contained in a GmoBoxDocPage. It is used for hit testing and for
+    rectangle selection, so that these operations do not require to traverse all
+    page shapes.
+
+    The index keeps, for each shape, its position in the page list of shapes
+    (ordered by layer and creation order). This order is used to preserve the
+    z-order semantics: when several shapes are found, the one with highest order
+    is the top one.
+
+    The index is a snapshot: if shapes are added or moved, the index must be
+    rebuilt. For this, indexed shapes are flagged (see GmoObj::is_in_shapes_index())
+    and they invalidate the index of their page when moved or resized.
+*/
+class GmShapesIndex
+{
+protected:
+    struct Entry
+    {
+        LUnits left, top, right, bottom;
+        int order;
+        GmoShape* pShape;
+    };
+
+    struct Node
+    {
+        LUnits left, top, right, bottom;
+        int first;          //index of first child: to m_entries (leaf) or to m_nodes
+        int count;          //number of children
+        bool fLeaf;
+    };
+
+    std::vector<Entry> m_entries;
+    std::vector<Node> m_nodes;
+    std::map<ImoObj*, GmoShape*> m_imoToShape;  //first shape created by each ImoObj
+    bool m_fValid;
+
+public:
+    GmShapesIndex();
+    ~GmShapesIndex() {}
+
+    //creation
+    void build(std::list<GmoShape*>& shapes);
+    void clear();
+    inline void invalidate() { m_fValid = false; }
+    inline bool is_valid() { return m_fValid; }
+
+    //queries
+    /** Returns the top shape (highest layer and, in it, the last added) containing
+        point (x, y), or @nullptr if no shape contains the point.   */
+    GmoShape* find_shape_at(LUnits x, LUnits y);
+
+    /** Returns, in param @c found, all shapes fully contained in rectangle
+        @c rect, ordered from top to bottom shape.  */
+    void find_shapes_in_rectangle(const URect& rect, std::vector<GmoShape*>& found);
+
+    /** Returns the first shape (lowest layer and, in it, the first added) created
+        by ImoObj @c pImo, or @nullptr if none.  */
+    GmoShape* find_shape_for_object(ImoObj* pImo);
+
+    //info
+    inline int get_num_entries() { return int(m_entries.size()); }
+
+protected:
+    void build_leaves(std::vector<Node>& leaves);
+    void build_upper_levels(std::vector<Node>& level);
+
+    static const int k_max_children = 16;
+
+};
+
+
+}   //namespace lomse
+
+#endif      //__LOMSE_GM_SHAPES_INDEX_H__
@@ -58,6 +58,7 @@ class Document;
 class ImoStaffObj;
 class Caret;
 class DocCursor;
+class TileCache;
 class OverlaysGenerator;
 class VisualEffect;
 class DraggedImage;
@@ -197,6 +198,10 @@ protected:
     //options
     Color       m_backgroundColor;
 
+    //cache of rendered tiles, when enabled
+    TileCache*  m_pTileCache;
+    size_t      m_tileCacheBudget;
+
 public:
 ///@cond INTERNALS
 //excluded from public API because the View methods are managed from Interactor
@@ -212,6 +217,7 @@ public:
     void set_viewport_at_page_center(Pixels screenWidth);
     virtual void set_viewport_for_page_fit_full(Pixels screenWidth) = 0;
     LUnits get_viewport_width();
+    LUnits get_viewport_height();
     void use_cursor(DocCursor* pCursor);
     void use_selection_set(SelectionSet* pSelectionSet);
     void add_visual_effect(VisualEffect* pEffect);
@@ -234,6 +240,21 @@ public:
     void draw_handler(Handler* pHandler);
     void set_background(Color color) { m_backgroundColor = color; }
 
+    /** Enables or disables the cache of rendered tiles. When enabled, the graphic
+        model is rendered in square tiles that are kept in memory, so that when the
+        viewport is scrolled only the newly exposed tiles are rendered. By default
+        the tile cache is disabled.   */
+    void enable_tile_cache(bool fValue);
+    inline bool is_tile_cache_enabled() { return m_pTileCache != nullptr; }
+    inline TileCache* get_tile_cache() { return m_pTileCache; }
+
+    /** Sets the maximum memory, in bytes, to be used by the tile cache. */
+    void set_tile_cache_budget(size_t bytes);
+
+    /** Discards all cached tiles. It is not necessary to invoke it when the graphic
+        model is modified or replaced.  */
+    void invalidate_tiles();
+
     ///@}    //Renderization related
 
 
@@ -430,6 +451,9 @@ public:
     void set_print_buffer(RenderingBuffer* rbuf) { m_pPrintBuf = rbuf; }
     void set_print_ppi(double ppi) { m_print_ppi = ppi; }
     virtual void print_page(int page, VPoint viewport);
+    virtual void print_pages(const std::vector<int>& pages,
+                             const std::vector<RenderingBuffer*>& buffers,
+                             int numThreads=0, VPoint viewport=VPoint(0, 0));
 
     ///@}    //Support for printing
 
@@ -447,6 +471,9 @@ protected:
 
     virtual void draw_all();
     void draw_graphic_model();
+    bool update_render_options();
+    void draw_graphic_model_using_tiles();
+    void draw_pages_in_area(Pixels x, Pixels y, Pixels width, Pixels height);
     void draw_time_grid();
     void generate_paths();
     virtual void collect_page_bounds() = 0;
@@ -121,6 +121,27 @@ public:
 };
 
 
+//---------------------------------------------------------------------------------------
+// TimeposLocation: auxiliary container
+//  page, system and x position in the graphic model for a given timepos
+class TimeposLocation
+{
+public:
+    GmoBoxSystem*   pSystem;        //system containing the timepos
+    int             iPage;          //score page index (0..n-1)
+    int             iSystem;        //system index (0..n-1)
+    LUnits          x;              //x position for the timepos
+
+    TimeposLocation()
+        : pSystem(nullptr)
+        , iPage(-1)
+        , iSystem(-1)
+        , x(0.0f)
+    {
+    }
+};
+
+
 //---------------------------------------------------------------------------------------
 // GraphicModel: storage for the graphic objects
 //
@@ -130,6 +151,7 @@ protected:
     GmoBoxDocument* m_root;
     long m_modelId;
     bool m_modified;
+    long m_modificationStamp;
     map<ImoId, GmoBox*> m_imoToBox;
     map<ImoId, GmoShape*> m_imoToMainShape;
     map< pair<ImoId, ShapeId>, GmoShape*> m_imoToSecondaryShape;
@@ -145,9 +167,16 @@ public:
     inline GmoBoxDocument* get_root() { return m_root; }
     int get_num_pages();
     GmoBoxDocPage* get_page(int i);
-    inline void set_modified(bool value) { m_modified = value; }
+    inline void set_modified(bool value) {
+        m_modified = value;
+        if (value)
+            ++m_modificationStamp;
+    }
     inline bool is_modified() { return m_modified; }
     inline long get_model_id() { return m_modelId; }
+    /** Returns a counter that is incremented each time the model is marked as
+        modified. It is not reset by set_modified(false).   */
+    inline long get_modification_stamp() { return m_modificationStamp; }
     int get_page_number_containing(GmoObj* pGmo);
     GmMeasuresTable* get_measures_table(ImoId scoreId);
 
@@ -172,7 +201,9 @@ public:
 
     //creation
     ScoreStub* add_stub_for(ImoScore* pScore);
+    ScoreStub* get_stub_for(ImoId scoreId);
     void store_in_map_imo_shape(ImoObj* pImo, GmoShape* pShape);
+    void remove_from_map_imo_shape(ImoObj* pImo, GmoShape* pShape);
     void add_to_map_imo_to_box(GmoBox* child);
     void add_to_map_ref_to_box(GmoBox* pBox);
     GmoShape* get_shape_for_imo(ImoId imoId, ShapeId shapeId);
@@ -180,6 +211,14 @@ public:
     GmoBox* get_box_for_imo(ImoId id);
     GmoObj* get_box_for_control(GmoRef gref);
     void build_main_boxes_table();
+    void take_pages_from(GraphicModel* pSource, int numPages);
+
+    /** Deletes the pages from page @c iPage (0..n-1) to the end of the model, for
+        replacing them by the pages of a resumed layout. Shapes in the deleted pages
+        are removed from the tables and the stubs are updated. Tables for boxes and
+        controls are cleared: they will be rebuilt by build_main_boxes_table().
+    */
+    void delete_pages_from(int iPage);
 
     //active and pointed elements
 
@@ -197,16 +236,29 @@ public:
     GmoBoxSystem* get_system_for(ImoId scoreId, TimeUnits timepos);
     GmoBoxSystem* get_system_box(int iSystem);
 
+    /** Locates the requested timepos in the graphic model: the system containing it,
+        the page and system numbers and the x position for the timepos. Returns
+        @false if there is no system for the given timepos.
+
+        Systems are located by binary search on the score timeline, and the x position
+        by binary search on the system TimeGridTable, so this method is suitable for
+        being invoked for each played note (i.e. for moving the tempo line).
+
+        @param scoreId
+        @param timepos The time position (absolute time units) to locate.
+        @param pLocation Container for returning the information.
+        @param fBarline If @true, the x position is that of the barline at timepos.
+            Otherwise, the x position is that of the notes and rests at timepos.
+    */
+    bool locate_timepos(ImoId scoreId, TimeUnits timepos, TimeposLocation* pLocation,
+                        bool fBarline=false);
+
     GmoBoxSystem* get_system_for_staffobj(ImoId id);
 
 
     //tests
     void dump_page(int iPage, ostream& outStream);
 
-
-protected:
-    ScoreStub* get_stub_for(ImoId scoreId);
-
 };
 
 //---------------------------------------------------------------------------------------
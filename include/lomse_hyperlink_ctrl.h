@@ -79,7 +79,7 @@ public:
     void change_label(const string& text);
 
 protected:
-    URect determine_text_position_and_size();
+    URect determine_text_position_and_size(Drawer* pDrawer);
     ImoStyle* create_default_style();
 
 };
@@ -166,6 +166,8 @@ protected:
 //    ImoFiguredBassLine*  m_pPrevFBLine;
 //    ImoFiguredBassLine*  m_pNextFBLine;
 
+    friend class ImoCloner;
+
 public:
     ImoFiguredBass() : ImoStaffObj(k_imo_figured_bass) {}
     ImoFiguredBass(ImoFiguredBassInfo& info);
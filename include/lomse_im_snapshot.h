@@ -0,0 +1,95 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2020. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+//---------------------------------------------------------------------------------------
+
+#ifndef __LOMSE_IM_SNAPSHOT_H__
+#define __LOMSE_IM_SNAPSHOT_H__
+
+#include <list>
+#include <cstddef>
+
+namespace lomse
+{
+
+//forward declarations
+class Document;
+class IdAssigner;
+class ImoObj;
+class ImoStyle;
+
+//---------------------------------------------------------------------------------------
+/** %ImSnapshot is a detached copy of an internal model subtree, used for saving undo
+    checkpoints without exporting the subtree to source text and compiling it again
+    for undo.
+
+    The snapshot owns a deep copy of the subtree (nodes, relations, styles and other
+    owned objects), and ImoIds are preserved. Snapshot objects are not linked to any
+    Document. Styles used by the subtree but not owned by it are saved as copies and,
+    on restore, they are replaced by the document style with the same name.
+
+    The subtree can be restored any number of times. Each restore creates a new copy
+    of the snapshot, linked to the Document.
+*/
+class ImSnapshot
+{
+protected:
+    ImoObj* m_pRoot;
+    std::list<ImoStyle*> m_externalStyles;
+    int m_numObjects;
+    size_t m_memorySize;
+
+    ImSnapshot();
+
+public:
+    ~ImSnapshot();
+
+    /** Creates a snapshot of the subtree whose root is `pImo`. Returns nullptr when
+        the subtree contains objects that can not be saved in a snapshot (controls and
+        transient DTO objects) or when the subtree is linked to objects external
+        to it, other than document styles. */
+    static ImSnapshot* capture(ImoObj* pImo);
+
+    /** Returns a new copy of the saved subtree, owned by the Document `pDoc`. The ids
+        of the copied objects are registered in `pAssigner`. The returned subtree is
+        not yet structurized. */
+    ImoObj* restore(Document* pDoc, IdAssigner* pAssigner);
+
+    //info
+    inline ImoObj* get_root() { return m_pRoot; }
+    inline int get_num_objects() { return m_numObjects; }
+    /** Returns the memory, in bytes, used by the copied objects, including the
+        strings, containers and attributes owned by them. Container nodes are
+        estimated from their usual size, so the value is approximate. */
+    inline size_t get_memory_size() { return m_memorySize; }
+
+};
+
+
+}   //namespace lomse
+
+#endif      //__LOMSE_IM_SNAPSHOT_H__
@@ -116,6 +116,9 @@ protected:
     //options
     bool m_fReplaceLocalMetronome;
     MusicXmlOptions m_importOptions;
+    int m_spacingThreads;           //threads for spacing columns. 0: one per core
+    bool m_fUndoSnapshots;          //use ImSnapshot for undo checkpoints
+    bool m_fQueuedEvents;           //dispatch events from the events thread
 
     //debug options
     bool m_fJustifySystems;         //if false, prevents systems justification
@@ -144,6 +147,7 @@ public:
     inline LomseDoorway* platform_interface() { return m_pDoorway; }
     LdpFactory* ldp_factory();
     FontStorage* font_storage();
+    static void use_font_storage_in_this_thread(FontStorage* pFonts);
     inline string& fonts_path() { return m_sFontsPath; }
     EventsDispatcher* get_events_dispatcher();
     FontSelector* get_font_selector();
@@ -185,6 +189,28 @@ public:
     inline bool global_metronome_replaces_local() { return m_fReplaceLocalMetronome; }
     inline MusicXmlOptions* get_musicxml_options() { return &m_importOptions; }
 
+    //Columns spacing can be done in parallel. By default it is done in the thread
+    //that creates the graphic model (value 1). Value 0 means one thread per core.
+    //Results are the same for any number of threads.
+    inline void set_spacing_threads(int numThreads) { m_spacingThreads = numThreads; }
+    inline int get_spacing_threads() { return m_spacingThreads; }
+
+    //Undo checkpoints are saved as structural snapshots of the internal model (see
+    //ImSnapshot). When disabled, checkpoints are saved as LMD source text. When the
+    //undo history exceeds its memory budget, checkpoints older than the last one are
+    //compressed as LMD source text (see DocCommandExecuter::set_undo_memory_budget()).
+    inline void set_undo_snapshots(bool value) { m_fUndoSnapshots = value; }
+    inline bool use_undo_snapshots() { return m_fUndoSnapshots; }
+
+    //By default, events are dispatched to the application in the thread that
+    //generates them. When queued events are enabled, events are enqueued and
+    //dispatched from the events thread, and redundant pending events are coalesced
+    //(see EventsDispatcher). It must be set when initializing the library, before
+    //creating any Document or Interactor. Once the events dispatcher is created
+    //the mode can not be changed.
+    void set_queued_events(bool value);
+    inline bool use_queued_events() { return m_fQueuedEvents; }
+
     //spacing and lines breaker algorithm parameters
     inline bool use_debug_values() { return m_fUseDbgValues; }
     inline float get_optimum_force() { return m_spacingOptForce; }
@@ -107,6 +107,7 @@ public:
     void set_position_and_width_for_staves(LUnits indent, UPoint org, GmoBoxSystem* pBox);
     void set_staves_width(LUnits width);
     void reposition_staves_in_engravers(const vector<LUnits>& yShifts);
+    void reset_staves_position();
 
     //info about instruments
     LUnits get_staff_top_position_for(ImoInstrument* pInstr);
@@ -40,6 +40,9 @@
 
 #include <iostream>
 #include <chrono>
+#include <thread>
+#include <atomic>
+#include <mutex>
 using namespace std;
 
 ///@cond INTERNALS
@@ -52,6 +55,7 @@ class CaretPositioner;
 class DocCommandExecuter;
 class DocCommand;
 class DocCursor;
+class DocLayouter;
 class GmoObj;
 class GmoBox;
 class GraphicModel;
@@ -63,6 +67,8 @@ class Task;
 class VisualEffect;
 class FragmentMark;
 class ApplicationMark;
+class FontStorage;
+class GraphicView;
 
 class Document;
 typedef std::shared_ptr<Document>     SpDocument;
@@ -191,6 +197,20 @@ protected:
     //to avoid problems during playback
     bool        m_fViewUpdatesEnabled;
 
+    //for updating the graphic model after document modifications
+    bool        m_fIncrementalRelayout;
+    DocLayouter* m_pDocLayouter;        //layouter for current graphic model, if kept
+
+    //progressive layout: remaining pages are laid out in a background thread
+    bool                m_fProgressiveLayout;
+    std::thread         m_layoutThread;
+    std::recursive_mutex m_layoutMutex;
+    std::atomic<bool>   m_fCancelLayout;
+    GraphicModel*       m_pFullModel;       //result of the background layout
+    DocLayouter*        m_pFullLayouter;    //layouter for m_pFullModel
+    bool                m_fLayoutResumed;   //m_pFullModel only has the remaining pages
+    FontStorage*        m_pLayoutFonts;     //font storage for the layout thread
+
     Handler*    m_pCurHandler;  //current handler being dragged, if any
     ImoId       m_idControlledImo;
 
@@ -345,6 +365,38 @@ public:
     GraphicModel* get_graphic_model();
 
 
+    /** Enables or disables the progressive layout mode. By default, the graphic
+        model is fully built before returning the first page. When this mode is
+        enabled, only the pages needed for filling the viewport are laid out before
+        returning, and the layout of the whole document continues in a background
+        thread. When it finishes, an EventLayout of type
+        <tt>k_layout_completed_event</tt> is sent to your application, and your
+        application must invoke on_layout_completed() for adding the remaining pages
+        to the graphic model.
+
+        @remarks Spacing and line breaking are computed for the whole score before
+        laying out the first page. Therefore, the time saved is the time for
+        engraving the remaining pages. The background thread continues the
+        interrupted layout, so the first pages are not laid out again.
+
+        @remarks The Document must not be modified while the background layout is in
+        progress, other than by executing edition commands via this %Interactor.
+        Before modifying the Document by direct manipulation of its internal data
+        structures invoke on_layout_completed(), that will wait for the background
+        layout to finish.
+    */
+    inline void set_progressive_layout(bool value) { m_fProgressiveLayout = value; }
+
+    /** Returns @true if the progressive layout mode is enabled.
+        See set_progressive_layout().    */
+    inline bool is_progressive_layout_enabled() { return m_fProgressiveLayout; }
+
+    /** Returns @true if the graphic model only contains the first pages and the
+        layout of the whole document has not yet been accepted by invoking
+        on_layout_completed(). See set_progressive_layout().    */
+    bool is_layout_in_progress();
+
+
     /** Returns the View associated to this %Interactor.    */
     inline View* get_view() { return m_pView; }
 
@@ -520,6 +572,20 @@ public:
     */
     void set_view_background(Color color);
 
+    /** Enables or disables the cache of rendered tiles. When enabled, the document
+        is rendered in square tiles that are kept in memory. When the viewport is
+        scrolled, cached tiles are reused and only the newly exposed areas are
+        rendered. Tiles are discarded when the graphic model is modified.
+        By default, the tile cache is disabled.
+    */
+    void enable_tile_cache(bool fValue);
+
+    /** Sets the maximum amount of memory, in bytes, to be used for caching
+        tiles. When exceeded, the least recently used tiles are discarded.
+        Default budget is 32 MB.
+    */
+    void set_tile_cache_budget(size_t bytes);
+
         //@}    //interface to GraphicView. Rendering
 
 
@@ -1120,6 +1186,23 @@ public:
     virtual void print_page(int page, VPoint viewport=VPoint(0, 0));
 
 
+    /** Request Lomse to render several pages, each one on its own buffer. Pages are
+        rendered concurrently by a pool of worker threads and the result is the same
+        than invoking print_page() for each page. All buffers must use the pixel
+        format specified when initializing the library.
+        @param pages The pages to print (0..num_pages - 1)
+        @param buffers The rendering buffers, one for each page in `pages`
+        @param numThreads Maximum number of threads to use. Zero means as many threads
+            as the hardware can run concurrently.
+        @param viewport The desired viewport, common to all pages.
+
+        See @subpage page-printing
+    */
+    virtual void print_pages(const std::vector<int>& pages,
+                             const std::vector<RenderingBuffer*>& buffers,
+                             int numThreads=0, VPoint viewport=VPoint(0, 0));
+
+
     /** Returns the number of pages in current document.
 
         See @subpage page-printing
@@ -1348,6 +1431,31 @@ public:
         @see exec_command(), exec_undo(), exec_redo(), should_enable_edit_undo(),
     */
     bool should_enable_edit_redo();
+
+    /** Enables or disables the incremental relayout mode. By default, the graphic
+        model is fully rebuilt after each document modification. When this mode is
+        enabled, after executing, undoing or redoing an edition command the pages
+        preceding the first modified top-level block (e.g. paragraph, music score) are
+        reused and only the following pages are laid out again. If the modified
+        objects are not known, the graphic model is fully rebuilt.
+
+        When the modified block is the last music score laid out (e.g. in a document
+        containing only one music score) its layout is resumed at the page containing
+        the first modified system, and the previous pages are reused. For this, the
+        layouter is kept in memory while the graphic model is valid.
+
+        @remarks Line breaks in the reused pages are not re-balanced. And a
+        modification in the first page of a score, or in other objects (e.g.
+        instruments or score options), requires to lay out the whole block.
+
+        See @ref edit-overview
+    */
+    inline void set_incremental_relayout(bool value) { m_fIncrementalRelayout = value; }
+
+    /** Returns @true if the incremental relayout mode is enabled.
+        See set_incremental_relayout().    */
+    inline bool is_incremental_relayout_enabled() { return m_fIncrementalRelayout; }
+
 //    void enable_edition(bool value);
 //    inline bool is_edition_enabled() { return m_fEditionEnabled; }
 
@@ -1368,6 +1476,19 @@ public:
     */
     virtual void on_document_updated();
 
+    /** Inform Lomse that an EventLayout of type <tt>k_layout_completed_event</tt> has
+        been received. The remaining pages are added to the graphic model containing
+        only the first pages, and the View is updated. If the background layout has
+        not yet finished, this method waits for it.
+
+        This method can also be invoked from the global handler for events. In this
+        case it is executed in the Lomse layout thread and, therefore, your
+        application must not be using this %Interactor in other threads.
+
+        See set_progressive_layout().
+    */
+    virtual void on_layout_completed();
+
     /** Inform Lomse that a mouse move event received by your application has to be handled
         by Lomse in accordance to current selected Task.
         @param x,y Current mouse position, as reported by the mouse event received by
@@ -1630,6 +1751,14 @@ protected:
 
     void create_graphic_model();
     void delete_graphic_model();
+    int num_pages_for_progressive_layout(GraphicView* pView, Document* pDoc);
+    void start_background_layout(DocLayouter* pLayouter);
+    void background_layout(DocLayouter* pLayouter, int numPrevPages,
+                           WpInteractor wpIntor);
+    void stop_background_layout();
+    void accept_background_layout();
+    bool update_graphic_model();
+    int find_first_dirty_block(Document* pDoc);
     bool graphic_model_must_be_updated();
     void request_window_update();
     VRect get_damaged_rectangle();
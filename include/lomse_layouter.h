@@ -82,6 +82,7 @@ public:
         k_layout_not_finished = 0,
         k_layout_success,
         k_layout_failed_auto_scale,        //auto-scaling applied. Need to re-layout
+        k_layout_interrupted,              //page limit reached or layout cancelled
     };
 
     virtual void layout_in_box() = 0;
@@ -94,6 +95,13 @@ public:
     virtual void save_score_layouter(Layouter* pLayouter) {
         m_pParentLayouter->save_score_layouter(pLayouter);
     }
+    virtual bool must_interrupt_layout() {
+        return m_pParentLayouter && m_pParentLayouter->must_interrupt_layout();
+    }
+    virtual void set_parent_layouter(Layouter* pParent) {
+        m_pParentLayouter = pParent;
+        m_pGModel = pParent->get_graphic_model();
+    }
     inline void set_constrains(int constrains) { m_constrains = constrains; }
 
     inline GraphicModel* get_graphic_model() { return m_pGModel; }
@@ -111,6 +119,11 @@ protected:
 
     Layouter* create_layouter(ImoContentObj* pItem, int constrains=0);
     int layout_item(ImoContentObj* pItem, GmoBox* pParentBox, int constrains);
+    int layout_item_with_current_layouter(ImoContentObj* pItem, GmoBox* pParentBox,
+                                          int constrains);
+    int resume_item_layout(Layouter* pLayouter, ImoContentObj* pItem,
+                           GmoBox* pParentBox);
+    int continue_with_current_layouter(ImoContentObj* pItem, GmoBox* pParentBox);
 
     void set_cursor_and_available_space();
 
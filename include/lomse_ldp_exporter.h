@@ -42,6 +42,7 @@ namespace lomse
 //forward declarations
 class ImoObj;
 class LdpGenerator;
+class ExportSink;
 
 
 // LdpExporter: Generates LDP source code for a basic model object
@@ -58,6 +59,8 @@ protected:
     //temporary
     ImoScore* m_pCurrScore;     //current score being exported
     bool m_fProcessingChord;
+    ExportSink* m_pSink;        //output for current export
+    ostream* m_pOut;            //stream built over m_pSink
 
 public:
     LdpExporter();
@@ -76,8 +79,9 @@ public:
     inline bool get_add_id() { return m_fAddId; }
     inline bool get_remove_newlines() { return m_fRemoveNewlines; }
 
-    //the main method
+    //the main methods
     string get_source(ImoObj* pImo, ImoObj* pParent=nullptr);
+    void write_source(ostream& out, ImoObj* pImo, ImoObj* pParent=nullptr);
 
     //static methods for ldp names to types conversion
     static string clef_type_to_ldp(int clefType);
@@ -95,8 +99,14 @@ public:
     inline void set_processing_chord(bool value) { m_fProcessingChord = value; }
     inline bool is_processing_chord() { return m_fProcessingChord; }
 
+    //for generators: output of the export in progress
+    void add_source(ImoObj* pImo, ImoObj* pParent=nullptr);
+    inline ostream& get_output_stream() { return *m_pOut; }
+    inline ExportSink* get_output_sink() { return m_pSink; }
+
 protected:
     LdpGenerator* new_generator(ImoObj* pImo);
+    void export_to_sink(ExportSink& sink, ImoObj* pImo, ImoObj* pParent);
 
 };
 
@@ -42,6 +42,7 @@ namespace lomse
 //forward declarations
 class ImoObj;
 class LmdGenerator;
+class ExportSink;
 
 
 //---------------------------------------------------------------------------------------
@@ -55,6 +56,7 @@ protected:
     bool m_fRemoveNewlines;
     string m_lomseVersion;
     string m_exportTime;
+    ostream* m_pOut;            //output for current export
 
     //controlling open tags
     stack<string> m_openTags;
@@ -82,8 +84,9 @@ public:
     inline int get_score_format() { return m_scoreFormat; }
     inline bool get_remove_newlines() { return m_fRemoveNewlines; }
 
-    //the main method
+    //the main methods
     string get_source(ImoObj* pImo);
+    void write_source(ostream& out, ImoObj* pImo);
 
     //auxiliary
     string get_version_and_time_string();
@@ -101,8 +104,13 @@ public:
     inline void push_tag(const string& tag) { m_openTags.push(tag); }
     inline void pop_tag() { m_openTags.pop(); }
 
+    //for generators: output of the export in progress
+    void add_source(ImoObj* pImo);
+    inline ostream& get_output_stream() { return *m_pOut; }
+
 protected:
     LmdGenerator* new_generator(ImoObj* pImo);
+    void export_to_sink(ExportSink& sink, ImoObj* pImo);
 
 };
 
@@ -42,6 +42,7 @@ namespace lomse
 //forward declarations
 class ImoObj;
 class MnxGenerator;
+class ExportSink;
 
 
 //---------------------------------------------------------------------------------------
@@ -57,6 +58,7 @@ protected:
 
     //temporary
     bool m_fProcessingChord;
+    ostream* m_pOut;            //output for current export
 
     //controlling open tags
     stack<string> m_openTags;
@@ -78,8 +80,9 @@ public:
     inline bool get_add_id() { return m_fAddId; }
     inline bool get_remove_newlines() { return m_fRemoveNewlines; }
 
-    //the main method
+    //the main methods
     string get_source(ImoObj* pImo);
+    void write_source(ostream& out, ImoObj* pImo);
 
     //auxiliary
     string get_version_and_time_string();
@@ -100,8 +103,13 @@ public:
     inline void push_tag(const string& tag) { m_openTags.push(tag); }
     inline void pop_tag() { m_openTags.pop(); }
 
+    //for generators: output of the export in progress
+    void add_source(ImoObj* pImo);
+    inline ostream& get_output_stream() { return *m_pOut; }
+
 protected:
     MnxGenerator* new_generator(ImoObj* pImo);
+    void export_to_sink(ExportSink& sink, ImoObj* pImo);
 
 };
 
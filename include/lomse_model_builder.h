@@ -67,6 +67,10 @@ public:
 
     ImoDocument* build_model(ImoDocument* pImoDoc);
     void structurize(ImoObj* pImo);
+    void structurize_subtree(ImoObj* pImo);
+
+protected:
+    void clear_dirty_flags(ImoObj* pImo);
 
 };
 
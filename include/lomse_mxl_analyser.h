@@ -297,9 +297,6 @@ protected:
 //    int m_nShowTupletBracket;
 //    int m_nShowTupletNumber;
 
-    //conversion from xml element name to int
-    std::map<std::string, int>	m_NameToEnum;
-
 public:
     MxlAnalyser(ostream& reporter, LibraryScope& libraryScope, Document* pDoc,
                 XmlParser* parser);
@@ -464,11 +461,12 @@ public:
 
 
     int name_to_enum(const string& name) const;
+    static int name_to_enum(const char* name);
     bool to_integer(const string& text, int* pResult);
 
 
 protected:
-    MxlElementAnalyser* new_analyser(const string& name, ImoObj* pAnchor=nullptr);
+    ImoObj* dispatch_analysis(XmlNode* pNode, ImoObj* pAnchor, bool* pValue);
     void delete_relation_builders();
     void add_marging_space_for_lyrics(ImoNote* pNote, ImoLyric* pLyric);
 };
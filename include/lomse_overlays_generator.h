@@ -36,6 +36,7 @@
 
 //other
 #include <iostream>
+#include <vector>
 using namespace std;
 
 
@@ -67,6 +68,8 @@ protected:
     URect m_damagedRect;
     URect m_prevDamagedRect;
     GmoObj* m_pHandlersOwner;           //object owning current defined handlers
+    int m_bytesPerPixel;                //0 if partial restore is not possible
+    std::vector<VRect> m_dirtyRects;    //pixels modified by each drawn effect
 
 public:
     OverlaysGenerator(GraphicView* view, LibraryScope& libraryScope);
@@ -88,6 +91,8 @@ public:
 protected:
     void save_rendering_buffer();
     void expand_damaged_rectangle();
+    void restore_background();
+    void add_dirty_rectangle(const URect& bounds, ScreenDrawer* pDrawer);
 
 
 };
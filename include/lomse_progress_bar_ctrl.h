@@ -88,7 +88,7 @@ public:
 
 
 protected:
-    URect determine_text_position_and_size();
+    URect determine_text_position_and_size(Drawer* pDrawer);
     ImoStyle* create_default_style();
 
 };
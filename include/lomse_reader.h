@@ -35,6 +35,7 @@
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <string>
 
 using namespace std;
 
@@ -69,47 +70,102 @@ public:
 
 
 //---------------------------------------------------------------------------------------
-// LdpFileReader: An LDP reader using a file as origin of source code
-class LdpFileReader : public LdpReader
+// LdpBufferedReader: Base class for LDP readers that hold all source code in a
+// contiguous buffer. Apart from the LdpReader virtual interface, it offers inline,
+// non-virtual methods and direct access to the pending data, so that the tokenizer
+// can scan it using pointer arithmetic
+class LdpBufferedReader : public LdpReader
+{
+protected:
+    std::string m_data;
+    const char* m_pNext;        //next char to return
+    const char* m_pEnd;
+    int m_numLine;
+    bool m_fCountLines;
+    bool m_fEofReturned;        //last returned char was EOF
+
+public:
+    LdpBufferedReader(bool fCountLines);
+    ~LdpBufferedReader() override {}
+
+    //fast path, non-virtual methods
+    inline char next_char()
+    {
+        if (m_pNext < m_pEnd)
+        {
+            char ch = *m_pNext++;
+            if (m_fCountLines && ch == 0x0a)
+                m_numLine++;
+            return ch;
+        }
+        m_fEofReturned = true;
+        return char(EOF);
+    }
+    inline void unget_char()
+    {
+        if (m_fEofReturned)
+            m_fEofReturned = false;
+        else if (m_pNext > m_data.data())
+        {
+            --m_pNext;
+            if (m_fCountLines && *m_pNext == 0x0a)
+                m_numLine--;
+        }
+    }
+    inline bool at_end() const { return m_pNext >= m_pEnd; }
+
+    //access to pending data. All chars in range [current(), end()) can be read
+    //directly. Method skip_to() moves the reading point forward to the given
+    //position, that must be in that range.
+    inline const char* current() const { return m_pNext; }
+    inline const char* end() const { return m_pEnd; }
+    void skip_to(const char* pos);
+
+    //LdpReader interface
+    char get_next_char() override { return next_char(); }
+    void repeat_last_char() override { unget_char(); }
+    bool end_of_data() override { return at_end(); }
+    int get_line_number() override { return m_numLine; }
+
+protected:
+    void set_data_ready();
+
+};
+
+
+//---------------------------------------------------------------------------------------
+// LdpFileReader: An LDP reader using a file as origin of source code. The whole file
+// is loaded in memory, by reading it in large blocks, when the reader is created
+class LdpFileReader : public LdpBufferedReader
 {
 private:
-    InputStream* m_file;
     const std::string m_locator;
-    int m_numLine;
-    bool m_repeating_last_char;
+    bool m_fReady;
 
 public:
     LdpFileReader(const std::string& locator);
-    ~LdpFileReader() override;
+    ~LdpFileReader() override {}
 
-    char get_next_char() override;
-    void repeat_last_char() override;
-    bool is_ready() override;
-    bool end_of_data() override;
-    int get_line_number() override { return m_numLine; }
+    bool is_ready() override { return m_fReady; }
     string get_locator() override { return m_locator; }
 
+protected:
+    void load_file(InputStream* file);
+
 };
 
 
 //---------------------------------------------------------------------------------------
 // LdpTextReader: an LDP reader using a string as origin of source code
-class LdpTextReader : public LdpReader
+class LdpTextReader : public LdpBufferedReader
 {
 public:
     LdpTextReader(const std::string& sourceText);
     ~LdpTextReader() override {}
 
-    char get_next_char() override;
-    void repeat_last_char() override;
-    bool is_ready() override;
-    bool end_of_data() override;
-    int get_line_number() override { return 0; }
+    bool is_ready() override { return true; }
     string get_locator() override { return "string:"; }
 
-private:
-    stringstream   m_stream;
-
 };
 
 
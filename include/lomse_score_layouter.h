@@ -150,6 +150,7 @@ protected:
 
     std::vector<SystemLayouter*> m_sysLayouters;
     std::vector<int> m_breaks;
+    std::vector<bool> m_fSysContinues;  //RelObjs or lyrics continue in next system
 
 
     //temporary data about current page being laid out
@@ -173,6 +174,7 @@ protected:
 
     //score stub and current boxes being laid out
     ScoreStub*          m_pStub;
+    ScoreStub*          m_pRestartStub;     //private stub while restarting the layout
     GmoBoxScorePage*    m_pCurBoxPage;
     GmoBoxSystem*       m_pCurBoxSystem;
 
@@ -188,8 +190,10 @@ public:
     void prepare_to_start_layout() override;
     void layout_in_box() override;
     void create_main_box(GmoBox* pParentBox, UPoint pos, LUnits width, LUnits height) override;
+    void set_parent_layouter(Layouter* pParent) override;
 
     //info
+    inline ImoScore* get_score() { return m_pScore; }
     virtual int get_num_columns();
     SystemLayouter* get_system_layouter(int iSys) { return m_sysLayouters[iSys]; }
     virtual TypeMeasureInfo* get_measure_info_for_column(int iCol);
@@ -203,6 +207,12 @@ public:
     //support for building the GmMeasuresTable
         //invoked when a non-middle barline is found
     void finish_measure(int iInstr, GmoShapeBarline* pBarlineShape);
+        //invoked when columns are created again after a modification
+    void restart_measures(const std::vector<int>& numMeasures);
+
+    //incremental relayout
+    GmoBoxScorePage* restart_at_modified_page(GraphicModel* pModel,
+                                              const std::list<ImoId>& dirtyIds);
 
     //support for debugging and unit tests
     void dump_column_data(int iCol, ostream& outStream=logger.get_stream());
@@ -237,7 +247,7 @@ protected:
     bool enough_space_for_empty_system();
     void create_system();
     void add_system_to_page();
-    void decide_line_breaks();
+    void decide_line_breaks(int iFirstSystem=0);
     void page_initializations(GmoBox* pContainerBox);
     void decide_line_sizes();
     void final_touches();
@@ -247,6 +257,7 @@ protected:
     void remove_unused_space();
     void center_score_if_requested();
     void delete_system_layouters();
+    void delete_not_engraved_objects();
     void get_score_renderization_options();
     void auto_scale();
 
@@ -292,6 +303,9 @@ protected:
 
     //---------------------------------------------------------------
     int get_system_containing_column(int iCol);
+    bool collect_modified_staffobjs(const std::list<ImoId>& dirtyIds,
+                                    std::set<ImoId>* pModified);
+    int find_first_system_to_restart(int iSystem);
 
     bool is_system_empty(int iSystem);
 
@@ -439,7 +453,9 @@ public:
     }
     virtual ~LinesBreaker() {}
 
-    virtual void decide_line_breaks() = 0;
+    //Decides breaks for systems [iFirstSystem, n]. Breaks for previous systems are
+    //preserved and system iFirstSystem starts at column m_breaks[iFirstSystem]
+    virtual void decide_line_breaks(int iFirstSystem=0) = 0;
 };
 
 
@@ -452,7 +468,7 @@ public:
                        SpacingAlgorithm* pSpAlgorithm, std::vector<int>& breaks);
     virtual ~LinesBreakerSimple() {}
 
-    void decide_line_breaks() override;
+    void decide_line_breaks(int iFirstSystem=0) override;
 };
 
 
@@ -465,10 +481,11 @@ public:
                         SpacingAlgorithm* pSpAlgorithm, std::vector<int>& breaks);
     virtual ~LinesBreakerOptimal() {}
 
-    void decide_line_breaks() override;
+    void decide_line_breaks(int iFirstSystem=0) override;
 
     //support for debug and tests
     void dump_entries(ostream& outStream=logger.get_stream());
+    inline void use_pruning(bool value) { m_fPruning = value; }
 
 protected:
     struct Entry
@@ -480,10 +497,23 @@ protected:
     std::vector<Entry> m_entries;
     int m_numCols;
     bool m_fJustifyLastLine;
+    int m_iFirstSystem;     //first system to decide
+    int m_iFirstCol;        //column starting that system
+
+    //Pruning. When line {ci,...,cj} is overfull, longer lines starting at ci are
+    //not evaluated. But all of them have the same penalty, so a single candidate
+    //entry is saved, to be applied to entries j+1 and next ones, up to next system
+    //break.
+    bool m_fPruning;
+    std::vector<int> m_nextBreak;                   //next entry with system break
+    std::vector< std::vector<Entry> > m_overfull;   //candidates, by first entry
+    Entry m_bestOverfull;                           //best candidate applicable now
 
     void initialize_entries_table();
     void compute_optimal_break_sequence();
     void retrieve_breaks_sequence();
+    void add_overfull_candidate(int iFirst, const Entry& candidate);
+    void apply_overfull_candidates(int j);
 
 };
 
@@ -36,6 +36,8 @@
 #include <vector>
 #include <thread>
 #include <condition_variable>
+#include <chrono>
+#include <atomic>
 
 ///@cond INTERNALS
 namespace lomse
@@ -136,6 +138,64 @@ public:
 };
 
 
+///@cond INTERNALS
+//---------------------------------------------------------------------------------------
+// PlaybackScheduler: computes absolute deadlines for playback events.
+// Events time is expressed in milliseconds from an epoch, measured with a steady clock.
+// As each wait is done until an absolute deadline, timing errors do not accumulate
+// along the piece. When the relation between events time and real time changes
+// (i.e. tempo change, jump) the timeline is re-anchored at the deadline of the last
+// event, not at current time, so that no drift is introduced.
+class PlaybackScheduler
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+protected:
+    Clock::time_point   m_epoch;            //real time for m_epochTime
+    long                m_epochTime;        //events time (millisecs) at the epoch
+    Clock::time_point   m_lastDeadline;     //deadline for last event
+    bool                m_fSpin;            //spin for the last part of the wait
+    std::chrono::microseconds m_spinMargin; //time to spin before the deadline
+
+    //lateness statistics, in microseconds. Updated by the playback thread and
+    //read by the application
+    std::atomic<long>       m_numEvents;
+    std::atomic<long long>  m_totalLateness;
+    std::atomic<long>       m_maxLateness;
+    std::atomic<long>       m_lastLateness;
+
+public:
+    PlaybackScheduler();
+
+    //timeline
+    void start(long time);
+    void reanchor(long time);
+    void resume(long time);
+    void wait_until(long time);
+    Clock::time_point deadline_for(long time) const;
+
+    //options
+    inline void enable_spin(bool value) { m_fSpin = value; }
+    inline bool is_spin_enabled() const { return m_fSpin; }
+    inline void set_spin_margin(long microsecs) {
+        m_spinMargin = std::chrono::microseconds(microsecs);
+    }
+
+    //lateness statistics, in microseconds
+    inline long num_events() const { return m_numEvents; }
+    inline long max_lateness() const { return m_maxLateness; }
+    inline long last_lateness() const { return m_lastLateness; }
+    inline long mean_lateness() const {
+        long numEvents = m_numEvents;
+        return (numEvents > 0 ? long(m_totalLateness / numEvents) : 0L);
+    }
+    void reset_statistics();
+
+};
+///@endcond
+
+
 //---------------------------------------------------------------------------------------
 /** %ScorePlayer class is responsible for managing score playback.
     It provides the necessary methods for controlling all playback (start, stop, pause,
@@ -188,6 +248,9 @@ protected:
     int m_MtrTone1;
     int m_MtrTone2;
 
+    //events timing
+    PlaybackScheduler   m_scheduler;
+
     //current play parameters
     bool            m_fVisualTracking;
     long            m_nMM;
@@ -331,6 +394,11 @@ public:
     //For selecting method to send events to user application
     inline void post_tracking_events(bool value) { m_fPostEvents = value; }
 
+    //events timing. Spinning for the last part of each wait reduces jitter, at the
+    //cost of CPU usage. Lateness statistics are for last playback.
+    inline void enable_spin_wait(bool value) { m_scheduler.enable_spin(value); }
+    inline const PlaybackScheduler& get_scheduler() const { return m_scheduler; }
+
     //only to be used by SoundThread
     void do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
                  long nMM, Interactor* pInteractor );
@@ -72,6 +72,9 @@ private:
 
 public:
     ScreenDrawer(LibraryScope& libraryScope);
+    //use a private font storage instead of the shared one in LibraryScope, e.g.
+    //for rendering in a worker thread. Ownership is not transferred
+    ScreenDrawer(LibraryScope& libraryScope, FontStorage* pFonts);
     virtual ~ScreenDrawer();
 
     // SVG path commands
@@ -55,6 +55,7 @@ protected:
     FontStorage* m_pFontStorage;
     LibraryScope& m_libraryScope;
     LUnits m_space;
+    LUnits m_ascender;
 
     friend class TextEngraver;
     friend class LyricEngraver;
@@ -72,6 +73,7 @@ public:
 
 protected:
     void select_font();
+    void select_font(Drawer* pDrawer);
     Color get_normal_color() override;
 
 };
@@ -104,6 +106,7 @@ public:
 
 protected:
     void select_font();
+    void select_font(Drawer* pDrawer);
     Color get_normal_color() override;
 
 };
@@ -173,6 +176,7 @@ private:
 
     void draw_text(Drawer* pDrawer, RenderOptions& opt);
     void select_font();
+    void select_font(Drawer* pDrawer);
 
 //    void ComputeTextPosition(lmPaper* pPaper);
 //    LUnits ApplyHAlign(LUnits uAvailableWidth, LUnits uLineWidth, lmEHAlign nHAlign);
@@ -35,6 +35,7 @@
 
 //std
 #include <list>
+#include <set>
 using namespace std;
 
 namespace lomse
@@ -123,9 +124,36 @@ public:
     virtual bool is_better_option(float prevPenalty, float newPenalty, float nextPenalty,
                                   int i, int j) = 0;
 
+    ///Optional, for speeding up line breaking. Return true if line {ci,...,cj}
+    ///and all longer lines {ci,...,ck}, k > j, do not fit in the system, and
+    ///determine_penalty_for_line() will return for all them the same penalty than
+    ///for line {ci,...,cj}, except for lines ending in a column with a system
+    ///break. The lines breaker will then not evaluate longer lines. Returning true
+    ///requires that is_better_option() just compares total penalties.
+    virtual bool is_overfull_line(int UNUSED(iSystem), int UNUSED(i), int UNUSED(j)) {
+        return false;
+    }
+
     ///Finally, if justification is required this method will be invoked
     virtual void justify_system(int iFirstCol, int iLastCol, LUnits uSpaceIncrement) = 0;
 
+    //incremental relayout ---------
+
+    ///Optional, for laying out again only the end of a modified score. Return the
+    ///index of the first column whose content could have changed, taking into
+    ///account that the staff objects in @c modified have been modified, or -1 if
+    ///it can not be determined.
+    virtual int find_first_modified_column(const std::set<ImoId>& UNUSED(modified)) {
+        return -1;
+    }
+
+    ///Optional. Discard columns [iCol, n-1], preserving the data for previous
+    ///columns, so that next invocations of split_content_in_columns() and
+    ///do_spacing_algorithm() only create and space the columns for the modified
+    ///content starting at iCol. Return false, without changing anything, if this
+    ///is not possible.
+    virtual bool restart_at_column(int UNUSED(iCol)) { return false; }
+
 
     //provide information -----------
 
@@ -288,6 +316,9 @@ public:
     //other
     TypeMeasureInfo* get_measure_info_for_column(int iCol) override;
     GmoShapeBarline* get_start_barline_shape_for_column(int iCol) override;
+    //incremental relayout
+    int find_first_modified_column(const std::set<ImoId>& modified) override;
+    bool restart_at_column(int iCol) override;
 
 
     //methods in base class SpacingAlgorithm that still need to be created
@@ -409,6 +440,27 @@ protected:
     int m_maxColumn;
     std::vector<ColumnData*>& m_colsData;
 
+    //support for incremental relayout. The included entries are saved, as well as
+    //the builder state at the start of each column, for restarting the creation of
+    //columns after a modification in the score
+    struct EntryInfo
+    {
+        ImoStaffObj*    pSO;
+        ImoId           id;
+        TimeUnits       time;
+    };
+    struct ColumnStart
+    {
+        int                 iFirstEntry;        //index in m_entries
+        int                 iColStartMeasure;
+        GmoShapeBarline*    pStartBarlineShape;
+        std::vector<int>    numMeasures;
+    };
+    std::vector<EntryInfo> m_entries;
+    std::vector<ColumnStart> m_colStarts;
+    std::vector<int> m_numMeasures;     //measures finished in each instrument
+    int m_iFirstColumn;                 //first column to create: >0 when restarting
+
 public:
     ColumnsBuilder(ScoreMeter* pScoreMeter, vector<ColumnData*>& colsData,
                    ScoreLayouter* pScoreLyt, ImoScore* pScore,
@@ -420,7 +472,13 @@ public:
 
 
     void create_columns();
-    void do_spacing_algorithm();
+    void do_spacing_algorithm(int iFirstCol=0, int numThreads=1);
+    void layout_column(int iCol);
+    inline int get_first_column() { return m_iFirstColumn; }
+
+    //support for incremental relayout
+    int find_first_modified_column(const std::set<ImoId>& modified);
+    bool restart_at_column(int iCol);
     inline LUnits get_staves_height()
     {
         return m_stavesHeight;
@@ -443,7 +501,6 @@ protected:
 
     void prepare_for_new_column();
     void collect_content_for_this_column();
-    void layout_column();
 
     GmoBoxSlice* create_slice_box();
     void find_and_save_context_info_for_this_column();
@@ -454,6 +511,7 @@ protected:
 
     bool determine_if_is_in_prolog(ImoStaffObj* pSO, TimeUnits rTime, int iInstr,
                                    int idx);
+    bool is_same_entry(int iEntry, StaffObjsCursor* pCursor);
     vector<bool> m_fNoSignatures;   //key/time signature not yet found, for each instrument
     vector<bool> m_fClefFound;      //for each instrument
 
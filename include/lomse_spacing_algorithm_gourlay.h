@@ -101,6 +101,13 @@ protected:
     float  m_log2dmin;  //precomputed value for log2(dmin)
     float  m_Fopt;      //Optimum force (user defined and dependent on personal taste)
 
+    //for lines break algorithm: sums for columns [m_iAccFirst, m_iAccLast]
+    int     m_iAccFirst;
+    int     m_iAccLast;
+    float   m_accSlope;
+    LUnits  m_accFixed;
+    LUnits  m_accMinWidth;
+
 public:
     SpAlgGourlay(LibraryScope& libraryScope, ScoreMeter* pScoreMeter,
                  ScoreLayouter* pScoreLyt, ImoScore* pScore,
@@ -110,13 +117,18 @@ public:
 
 
     //spacing algorithm main actions
+    void do_spacing_algorithm() override;
     void do_spacing(int iCol, bool fTrace=false) override;
     void justify_system(int iFirstCol, int iLastCol, LUnits uSpaceIncrement) override;
 
+    //incremental relayout
+    bool restart_at_column(int iCol) override;
+
     //for lines break algorithm
     float determine_penalty_for_line(int iSystem, int i, int j) override;
     bool is_better_option(float prevPenalty, float newPenalty, float nextPenalty,
                           int i, int j) override;
+    bool is_overfull_line(int iSystem, int i, int j) override;
 
     //information about a column
     bool is_empty_column(int iCol) override;
@@ -149,10 +161,14 @@ protected:
     void new_slice(ColStaffObjsEntry* pEntry, int entryType, int iColumn, int iData);
     void finish_slice(ColStaffObjsEntry* pLastEntry, int numEntries);
     void compute_springs();
-    void order_slices_in_columns();
-    void apply_force(float F);
+    void compute_springs(list<TimeSlice*>::iterator itStart);
+    int compute_final_springs();
+    bool apply_force_to_slices(float F);
+    bool apply_force_to_slices(float F, list<TimeSlice*>::iterator itStart);
     void determine_spacing_parameters();
     bool accept_for_prolog_slice(ColStaffObjsEntry* pEntry);
+    void accumulate_columns(int iFirstCol, int iLastCol);
+    LUnits determine_line_width(int iSystem);
 
 };
 
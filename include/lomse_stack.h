@@ -146,6 +146,20 @@ public:
         return (it != m_list.end() ? *it : nullptr);
     }
 
+    T top() { return (m_list.size() > 0 ? m_list.back() : nullptr); }
+
+    void remove_oldest() {
+        if (m_list.size() > 0)
+        {
+            delete m_list.front();
+            m_list.pop_front();
+        }
+    }
+
+    //direct access, for inspecting all elements
+    const std::list<T>& get_items() { return m_list; }
+    const std::list<T>& get_history() { return m_history; }
+
 protected:
     void remove_history() {
         typename std::list<T>::iterator it;
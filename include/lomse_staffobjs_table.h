@@ -37,6 +37,7 @@
 #include <vector>
 #include <ostream>
 #include <map>
+#include <unordered_map>
 
 namespace lomse
 {
@@ -135,6 +136,28 @@ protected:
     ColStaffObjsEntry* m_pFirst;
     ColStaffObjsEntry* m_pLast;
 
+    //entries storage. Entries created by the builders are loaded in bulk, sorted once
+    //and stored contiguously, in table order. Entries added later are individually
+    //allocated. Deleted entries are unlinked from the list but their memory is not
+    //released until the table is deleted.
+    bool m_fBulkLoad;
+    std::vector<ColStaffObjsEntry> m_entries;
+    std::vector<ColStaffObjsEntry*> m_added;
+
+    //first entry for each staffobj, indexed by staffobj id
+    std::unordered_map<ImoId, ColStaffObjsEntry*> m_index;
+
+    //note/rest entries for each instrument voice, in table order, and the maximum
+    //end time of the note/rests up to each entry. As end times are non-decreasing,
+    //the first note/rest sounding at a given timepos is found by binary search.
+    struct VoiceNoteRests
+    {
+        std::vector<ColStaffObjsEntry*> entries;
+        std::vector<TimeUnits> maxEndTime;
+    };
+    std::map<std::pair<int, int>, VoiceNoteRests> m_voices;   //key = (instr, voice)
+    bool m_fVoicesValid;
+
 public:
     ColStaffObjs();
     ~ColStaffObjs();
@@ -152,6 +175,11 @@ public:
                                  ImoStaffObj* pImo);
     void delete_entry_for(ImoStaffObj* pSO);
 
+    //note/rests lookup
+    ColStaffObjsEntry* find_noterest_at(int instr, int voice, TimeUnits time);
+    void find_noterests_in(int instr, int voice, TimeUnits startTime, TimeUnits endTime,
+                           std::vector<ColStaffObjsEntry*>& found);
+
     //iterator related
     class iterator
     {
@@ -245,10 +273,21 @@ protected:
     inline void set_anacruxis_extra_time(TimeUnits rTime) { m_rAnacruxisExtraTime = rTime; }
     void sort_table();
     static bool is_lower_entry(ColStaffObjsEntry* b, ColStaffObjsEntry* a);
+    static void sort_entries(std::vector<ColStaffObjsEntry*>& entries);
+    void start_bulk_load();
+    void finish_bulk_load();
     inline void set_min_note(TimeUnits duration) { m_minNoteDuration = duration; }
 
     void add_entry_to_list(ColStaffObjsEntry* pEntry);
+    void link_entries(std::vector<ColStaffObjsEntry*>& entries);
     ColStaffObjsEntry* find_entry_for(ImoStaffObj* pSO);
+    void add_to_index(ColStaffObjsEntry* pEntry);
+    void remove_from_index(ColStaffObjsEntry* pEntry);
+    void build_voices_index();
+    void remove_from_voices_index(ColStaffObjsEntry* pEntry);
+    VoiceNoteRests* get_voice_noterests(int instr, int voice);
+    static size_t first_sounding_at(VoiceNoteRests* pVoice, TimeUnits time,
+                                    bool fIncludeEnd);
 
 };
 
@@ -312,7 +351,7 @@ protected:
     TimeUnits   m_minNoteDuration;
     TimeUnits   m_gracesAnacruxisTime;
     StaffVoiceLineTable  m_lines;
-    std::vector<ColStaffObjsEntry*> m_graces;       //entries for grace notes
+    std::vector<ImoGraceNote*> m_graces;            //grace notes added to the table
 
     ColStaffObjsBuilderEngine(ImoScore* pScore)
         : m_pColStaffObjs(nullptr)
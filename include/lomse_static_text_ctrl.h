@@ -71,7 +71,7 @@ public:
     void set_tooltip(const string& text);
 
 protected:
-    URect determine_text_position_and_size();
+    URect determine_text_position_and_size(Drawer* pDrawer);
     ImoStyle* create_default_style();
 
 };
@@ -0,0 +1,173 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2020. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+//---------------------------------------------------------------------------------------
+
+#ifndef __LOMSE_TILE_CACHE_H__
+#define __LOMSE_TILE_CACHE_H__
+
+#include "lomse_agg_types.h"
+
+#include <vector>
+#include <list>
+#include <map>
+
+namespace lomse
+{
+
+//---------------------------------------------------------------------------------------
+/** %TileCache stores pre-rasterized square tiles of a GraphicView, so that when the
+    viewport is scrolled only the newly exposed tiles have to be rendered.
+
+    Tiles are identified by the view scale and by the tile column and row. The grid
+    of tiles is anchored at the origin of the view in pixels, that is, tile (c, r)
+    covers pixels [c*size, (c+1)*size) x [r*size, (r+1)*size) for the given scale.
+
+    All tiles are valid for one graphic model state, identified by the model id. and
+    its modification stamp. When any of them changes, all tiles are discarded. The
+    memory used by the tiles is limited by a budget. When adding a tile would exceed
+    the budget, the least recently used tiles are evicted.
+
+    Tiles have the same pixel format than the rendering buffer, so blitting them is
+    just a copy of rows.
+*/
+class TileCache
+{
+protected:
+    struct TileKey
+    {
+        double scale;
+        int col;
+        int row;
+
+        TileKey(double s, int c, int r) : scale(s), col(c), row(r) {}
+
+        bool operator<(const TileKey& k) const
+        {
+            if (scale != k.scale)
+                return scale < k.scale;
+            if (row != k.row)
+                return row < k.row;
+            return col < k.col;
+        }
+    };
+
+    struct Tile
+    {
+        TileKey key;
+        std::vector<unsigned char> pixels;
+        RenderingBuffer rbuf;
+
+        Tile(const TileKey& k) : key(k) {}
+    };
+
+    typedef std::list<Tile*>::iterator TileIterator;
+
+    int m_tileSize;                 //pixels
+    int m_bytesPerPixel;
+    size_t m_budget;                //bytes
+    size_t m_used;                  //bytes
+    long m_modelId;
+    long m_modelStamp;
+    std::list<Tile*> m_tiles;       //LRU order: most recently used first
+    std::map<TileKey, TileIterator> m_index;
+    std::vector<unsigned char> m_scratch;
+    RenderingBuffer m_scratchBuf;
+    int m_numHits;
+    int m_numMisses;
+
+public:
+    enum {
+        k_default_tile_size = 256,                  //pixels
+        k_default_memory_budget = 32*1024*1024,     //bytes
+    };
+
+    TileCache(int tileSize=k_default_tile_size,
+              size_t budget=k_default_memory_budget);
+    ~TileCache();
+
+    //settings
+    /** Sets the maximum memory (in bytes) to be used by the tiles. Tiles exceeding
+        the new budget are evicted.   */
+    void set_memory_budget(size_t bytes);
+    /** Sets the number of bytes per pixel in the tiles. It must match the pixel
+        format of the rendering buffer. If it changes, all tiles are discarded.  */
+    void set_bytes_per_pixel(int bytes);
+
+    //invalidation
+    /** Discards all tiles if the graphic model identified by @c modelId and its
+        modification @c stamp is not the one for which tiles were rendered.   */
+    void validate(long modelId, long stamp);
+    void clear();
+
+    //tiles
+    /** Returns the rendering buffer for the requested tile, or @nullptr if the tile
+        is not in the cache. The tile is marked as most recently used.    */
+    RenderingBuffer* get_tile(double scale, int col, int row);
+
+    /** Adds a tile to the cache. Its content is copied from the square area at
+        (xSrc, ySrc) in buffer @c src. Least recently used tiles are evicted if
+        necessary to keep memory in budget.    */
+    void add_tile(double scale, int col, int row, RenderingBuffer& src,
+                  int xSrc, int ySrc);
+
+    /** Returns an auxiliary buffer, owned by the cache, for rendering the missing
+        tiles. Its content is undefined.  */
+    RenderingBuffer& get_scratch_buffer(int width, int height);
+
+    //info
+    inline int get_tile_size() { return m_tileSize; }
+    inline int get_bytes_per_pixel() { return m_bytesPerPixel; }
+    inline size_t get_memory_budget() { return m_budget; }
+    inline size_t get_memory_used() { return m_used; }
+    inline int get_num_tiles() { return int(m_tiles.size()); }
+    inline int get_num_hits() { return m_numHits; }
+    inline int get_num_misses() { return m_numMisses; }
+    inline void reset_statistics() { m_numHits = 0; m_numMisses = 0; }
+
+    //utility
+    /** Copies a rectangle of pixels between buffers of the same pixel format. The
+        rectangle is clipped to the bounds of both buffers.   */
+    static void copy_pixels(RenderingBuffer& src, int xSrc, int ySrc,
+                            RenderingBuffer& dest, int xDest, int yDest,
+                            int width, int height, int bytesPerPixel);
+
+    /** Returns the number of bytes per pixel for a pixel format (a value from
+        enum EPixelFormat), or 0 if the format is not supported by the cache.  */
+    static int bytes_per_pixel(int pixelFormat);
+
+protected:
+    void evict_until(size_t bytes);
+    inline size_t tile_bytes() { return size_t(m_tileSize) * size_t(m_tileSize)
+                                        * size_t(m_bytesPerPixel); }
+
+};
+
+
+}   //namespace lomse
+
+#endif      //__LOMSE_TILE_CACHE_H__
@@ -125,6 +125,7 @@ public:
     string dump();
 
 protected:
+    int find_first_entry_at_or_after(TimeUnits timepos);
 
 };
 
@@ -33,7 +33,6 @@
 #include "lomse_basic.h"
 
 #include <vector>
-#include <list>
 
 namespace lomse
 {
@@ -59,8 +58,29 @@ public:
     bool operator ==(const VProfilePoint &p) const { return x==p.x && y==p.y && shape==p.shape; }
 };
 
-//to simplify writing code
-typedef list<VProfilePoint>::iterator  PointsIterator;
+//---------------------------------------------------------------------------------------
+/**	Helper class to store the points defining a profile for one staff. Points are
+	sorted by x position and are stored in contiguous arrays (one for each member of
+	VProfilePoint), so that positions can be located by binary search.
+*/
+class VProfileRow
+{
+public:
+    std::vector<LUnits> x;
+    std::vector<LUnits> y;
+    std::vector<GmoShape*> shape;
+
+    inline int size() const { return int(x.size()); }
+    inline VProfilePoint point(int i) const { return VProfilePoint(x[i], y[i], shape[i]); }
+
+    void push_back(LUnits xp, LUnits yp, GmoShape* sp);
+    void insert(int i, LUnits xp, LUnits yp, GmoShape* sp);
+    void erase(int iFirst, int iLast);
+
+    /** Return index to first point whose x position is greater or equal than xPos.
+        Returns size() if none. */
+    int lower_bound(LUnits xPos) const;
+};
 
 //---------------------------------------------------------------------------------------
 /**	VerticalProfile is responsible for maintaining and managing the information about
@@ -90,9 +110,8 @@ protected:
 	std::vector<LUnits> m_yStaffTop;        //top line position for each staff
 	std::vector<LUnits> m_yStaffBottom;     //bottom line position for each staff
 
-    typedef std::list<VProfilePoint> PointsRow;  //data for a profile change, for one staff
-	std::vector<PointsRow*> m_xMax;         //ptrs. to max x pos vector for each staff
-	std::vector<PointsRow*> m_xMin;         //ptrs. to min x pos vector for each staff
+	std::vector<VProfileRow> m_xMax;        //max profile points, for each staff
+	std::vector<VProfileRow> m_xMin;        //min profile points, for each staff
 
 public:
     VerticalProfile(LUnits xStart, LUnits xEnd, int numStaves);
@@ -126,18 +145,16 @@ public:
     std::string dump_min(int idxStaff);
 
 protected:
-    void update_profile(list<VProfilePoint>* pPoints, LUnits yPos, bool fMax,
+    void update_profile(VProfileRow& points, LUnits yPos, bool fMax,
                         LUnits xLeft, LUnits xRight, GmoShape* pShape);
-    PointsIterator locate_insertion_point(std::list<VProfilePoint>* pPoints, LUnits xLeft);
-    void update_point(std::list<VProfilePoint>* pPointsMin, LUnits xPos,
-                      LUnits yPos, GmoShape* pShape, PointsIterator itNext);
+    int locate_start_point(VProfileRow& points, LUnits xStart);
 
 
     void update_shape(GmoShape* pShape, int idxStaff);
 
     //debug
     GmoShape* dbg_generate_shape(bool fMax, int idxStaff);
-    std::string dump(list<VProfilePoint>* pPoints);
+    std::string dump(VProfileRow& points);
 
 };
 
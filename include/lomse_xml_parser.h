@@ -64,6 +64,7 @@ public:
     XmlNode(const XmlNode* node) : m_node(node->m_node) {}
 
     string name() { return string(m_node.name()); }
+    const char* name_ptr() { return m_node.name(); }
     string value();
     XmlAttribute attribute(const string& name) {
         return m_node.attribute(name.c_str());
@@ -130,6 +131,8 @@ public:
     void parse_file(const std::string& filename, bool fErrorMsg = true) override;
     void parse_text(const std::string& sourceText) override;
     void parse_cstring(char* sourceText);
+    void parse_buffer_own(char* buffer, size_t size);
+    static char* allocate_buffer(size_t size);
 
     inline const string& get_error() { return m_errorMsg; }
     inline const string& get_encoding() { return m_encoding; }
@@ -137,9 +140,10 @@ public:
     int get_line_number(XmlNode* node);
 
 protected:
-    void parse_char_string(char* string);
+    void parse_char_string(char* string, size_t size);
+    char* load_file(const std::string& filename, size_t* pSize);
     void find_root();
-    bool build_offset_data(const char* file);
+    void build_offset_data(const char* buffer, size_t size);
     std::pair<int, int> get_location(ptrdiff_t offset);
 
 };
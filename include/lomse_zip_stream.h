@@ -103,12 +103,23 @@ struct ZipEntryInfo
 
 //---------------------------------------------------------------------------------------
 // ZipInputStream: A stream for reading an entry in a zip file in the local file system
+// or in a zip archive already loaded in memory
 class ZipInputStream : public InputStream
 {
+public:
+    //a zip archive held in memory
+    struct MemoryArchive
+    {
+        const char* data;
+        unsigned long size;
+        unsigned long pos;
+    };
+
 protected:
     enum { k_buffersize = 4096, };
 
     void* m_uzFile;
+    MemoryArchive m_memory;
     bool m_fIsLastBuffer;
     long m_remainingBytes;
     char m_buffer[k_buffersize];
@@ -118,6 +129,7 @@ protected:
 
 public:
 	ZipInputStream(const std::string& filelocator);
+    ZipInputStream(const char* data, size_t size);
 	virtual ~ZipInputStream();
 
     //mandatory overrides inherited from InputStream
@@ -149,6 +161,7 @@ public:
 
 protected:
     bool open_zip_archive(const std::string& filelocator);
+    bool open_memory_archive(const char* data, size_t size);
     void open_specified_entry_or_first(const std::string& filelocator);
     bool read_buffer();
     void close_current_entry();
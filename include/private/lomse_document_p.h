@@ -77,6 +77,7 @@ class ImoMusicData;
 class ImoScore;
 class ImoStyle;
 class ImoObj;
+class ImSnapshot;
 
 class ImoButton;
 class ImoParagraph;
@@ -589,7 +590,12 @@ public:
     //protected as soon as buttons changed to controls
     inline void set_dirty() { m_flags |= k_dirty; }
 
-    inline void clear_dirty() { m_flags &= ~k_dirty; }
+    inline void clear_dirty()
+    {
+        m_flags &= ~k_dirty;
+        if (m_pImoDoc)
+            m_pImoDoc->clear_dirty();   //also dirty flags in the internal model
+    }
 
         //events
     /** Mandatory override from Observable. Returns the EventNotifier associated to
@@ -609,6 +615,11 @@ public:
     int replace_object_from_checkpoint_data(ImoId id, const string& data);
     string get_checkpoint_data();
     string get_checkpoint_data_for(ImoId id);
+    string get_checkpoint_data(ImSnapshot* pSnapshot);
+    ImSnapshot* get_snapshot();
+    ImSnapshot* get_snapshot_for(ImoId id);
+    void from_snapshot(ImSnapshot* pSnapshot);
+    void replace_object_from_snapshot(ImoId id, ImSnapshot* pSnapshot);
 
     //modified since last 'save to file' operation
     inline void clear_modified() { m_modified = 0; }
@@ -631,6 +642,7 @@ protected:
     void initialize();
     Compiler* get_compiler_for_format(int format);
     void fix_malformed_musicxml();
+    string export_checkpoint_data(ImoObj* pImo);
 
     friend class ImFactory;
     friend class InstrumentAnalyser;
@@ -917,6 +917,8 @@ protected:
         m_pParent = parent;
     }
 
+    friend class ImoCloner;
+
 public:
     InlineLevelCreatorApi() : m_pParent(nullptr) {}
     virtual ~InlineLevelCreatorApi() {}
@@ -946,6 +948,8 @@ protected:
         m_pParent = parent;
     }
 
+    friend class ImoCloner;
+
 public:
     BlockLevelCreatorApi() : m_pParent(nullptr) {}
     virtual ~BlockLevelCreatorApi() {}
@@ -987,8 +991,11 @@ private:
 
 public:
     AttribValue() {}
+    AttribValue(const AttribValue& a) { CopyFrom(a); }
     ~AttribValue() { Cleanup(); }
 
+    inline bool is_string() const { return m_type == vt_string; }
+
     explicit operator int() const
     {
         CheckType(vt_int);
@@ -1075,6 +1082,22 @@ private:
         m_type = vt_empty;
     }
 
+    void CopyFrom(const AttribValue& a)
+    {
+        switch (a.m_type)
+        {
+            case vt_int:    intValue = a.intValue;                  break;
+            case vt_bool:   boolValue = a.boolValue;                break;
+            case vt_float:  floatValue = a.floatValue;              break;
+            case vt_double: doubleValue = a.doubleValue;            break;
+            case vt_string: new (&stringValue) string(a.stringValue); break;
+            case vt_color:  new (&colorValue) Color(a.colorValue);  break;
+            default:
+                break;
+        }
+        m_type = a.m_type;
+    }
+
     void CheckType(AttribType type) const
     {
         if (type != m_type)
@@ -1165,6 +1188,10 @@ public:
     {
         return m_next;
     }
+    inline bool is_string_value()
+    {
+        return m_value.is_string();
+    }
 
     static const std::string get_name(int idx);
 
@@ -1259,8 +1286,10 @@ protected:
 
 protected:
     ImoObj(int objtype, ImoId id=k_no_imoid);
+    ImoObj(const ImoObj& a);
 
     friend class ImFactory;
+    friend class ImoCloner;
     inline void set_owner_document(Document* pDoc)
     {
         m_pDoc = pDoc;
@@ -1292,6 +1321,7 @@ public:
         return (m_flags & k_children_dirty) != 0;
     }
     void set_children_dirty(bool value);
+    void clear_dirty(std::list<ImoId>* pDirtyIds=nullptr);
 
     //edition flags
     inline bool is_edit_terminal()
@@ -1702,6 +1732,7 @@ protected:
     std::map<int, Color> m_colorProps;
 
     friend class ImFactory;
+    friend class ImoCloner;
     ImoStyle() : ImoSimpleObj(k_imo_style), m_name(), m_pParent(nullptr) {}
 
 public:
@@ -2332,6 +2363,8 @@ protected:
     ImoContentObj(int objtype);
     ImoContentObj(ImoId id, int objtype);
 
+    friend class ImoCloner;
+
 public:
     ~ImoContentObj() override;
 
@@ -2666,6 +2699,7 @@ private:
     std::string m_language;
 
     friend class ImFactory;
+    friend class ImoCloner;
     ImoLink() : ImoBoxInline(k_imo_link) {}
 
 public:
@@ -2807,6 +2841,7 @@ protected:
     {
     }
 
+    friend class ImoCloner;
 
 public:
     virtual ~ImoAuxRelObj();
@@ -3211,6 +3246,7 @@ protected:
     TPoint      m_endPoint;
 
     friend class ImFactory;
+    friend class ImoCloner;
     friend class ImoTextBox;
     friend class ImoLine;
     friend class ImoScoreLine;
@@ -3618,6 +3654,7 @@ protected:
     bool    m_fPortrait;
 
     friend class ImFactory;
+    friend class ImoCloner;
     friend class ImoDocument;
     friend class ImoScore;
     ImoPageInfo();
@@ -3693,6 +3730,7 @@ protected:
 
 
     friend class ImFactory;
+    friend class ImoCloner;
     ImoBarline()
         : ImoStaffObj(k_imo_barline)
         , m_barlineType(k_barline_simple)
@@ -3741,6 +3779,7 @@ protected:
     void set_stems_direction(vector<int>* pStemsDir);
 
     friend class ImFactory;
+    friend class ImoCloner;
     ImoBeam() : ImoRelObj(k_imo_beam), m_pStemsDir(nullptr) {}
 
 public:
@@ -3782,6 +3821,7 @@ protected:
     //TPoint m_anchorJoinPoint;     //point on the box rectangle
 
     friend class ImFactory;
+    friend class ImoCloner;
     ImoTextBox() : ImoBlock(k_imo_text_box), m_fHasAnchorLine(false) {}
     ImoTextBox(ImoTextBlockInfo& box) : ImoBlock(k_imo_text_box, box)
         , m_fHasAnchorLine(false) {}
@@ -4145,6 +4185,7 @@ protected:
     std::list<ImoParamInfo*> m_params;
 
     friend class ImFactory;
+    friend class ImoCloner;
     ImoDynamic() : ImoContent(k_imo_dynamic), m_classid("") {}
 
 public:
@@ -4198,6 +4239,7 @@ protected:
     std::list<ImoStyle*> m_privateStyles;
 
     friend class ImFactory;
+    friend class ImoCloner;
     ImoDocument(const std::string& version="");
 
 public:
@@ -4465,6 +4507,7 @@ protected:
 //    %enclosure;
 
     friend class ImFactory;
+    friend class ImoCloner;
     ImoDynamicsMark()
         : ImoAuxObj(k_imo_dynamics_mark)
         , m_markType("")
@@ -4691,6 +4734,7 @@ protected:
     ImoTextInfo m_text;
 
     friend class ImFactory;
+    friend class ImoCloner;
     friend class ImoInstrument;
     friend class ImoInstrGroup;
     ImoScoreText() : ImoAuxObj(k_imo_score_text), m_text() {}
@@ -4947,6 +4991,7 @@ protected:
     int m_iFirstInstr;      //index to first instrument
 
     friend class ImFactory;
+    friend class ImoCloner;
     ImoInstrGroup();
 
 public:
@@ -5018,6 +5063,7 @@ protected:
                                             //has no metric. Otherwise it will be nullptr.
 
     friend class ImFactory;
+    friend class ImoCloner;
     ImoInstrument();
 
     friend class ImoScore;
@@ -5215,6 +5261,7 @@ class ImoLine : public ImoAuxObj
     ImoLineStyle* m_pStyle;
 
     friend class ImFactory;
+    friend class ImoCloner;
     ImoLine() : ImoAuxObj(k_imo_line), m_pStyle(nullptr) {}
 
 public:
@@ -5376,6 +5423,7 @@ protected:
     std::vector<float> m_widths;
 
     friend class ImFactory;
+    friend class ImoCloner;
     ImoMultiColumn(Document* pDoc);
 
 public:
@@ -5425,6 +5473,7 @@ protected:
     float       m_rValue;
 
     friend class ImFactory;
+    friend class ImoCloner;
     ImoOptionInfo()
         : ImoSimpleObj(k_imo_option), m_type(k_boolean), m_name("")
         , m_fValue(false), m_nValue(0L), m_rValue(0.0f)  {}
@@ -5638,6 +5687,7 @@ protected:
     ImoLineStyle m_style;
 
     friend class ImFactory;
+    friend class ImoCloner;
     ImoScoreLine()
         : ImoAuxObj(k_imo_score_line)
         , m_startPoint(0.0f, 0.0f)
@@ -5852,6 +5902,7 @@ protected:
     LUnits   m_topSystemDistance;
 
     friend class ImFactory;
+    friend class ImoCloner;
     friend class ImoScore;
     ImoSystemInfo();
     ImoSystemInfo(ImoSystemInfo& dto);
@@ -5919,6 +5970,7 @@ protected:
     std::map<string, ImoStyle*> m_nameToStyle;
 
     friend class ImFactory;
+    friend class ImoCloner;
     ImoScore(Document* pDoc);
     void initialize();
 
@@ -6081,6 +6133,7 @@ protected:
     ImoBezierInfo* m_pBezier;
 
     friend class ImFactory;
+    friend class ImoCloner;
     ImoSlurData(ImoSlurDto* pDto);
 
 public:
@@ -6327,6 +6380,7 @@ protected:
     std::map<std::string, ImoStyle*> m_nameToStyle;
 
     friend class ImFactory;
+    friend class ImoCloner;
     ImoStyles(Document* pDoc);
 
 public:
@@ -6371,6 +6425,7 @@ protected:
     }
 
     friend class ImFactory;
+    friend class ImoCloner;
     ImoTable() : ImoBlocksContainer(k_imo_table) {}
 
 public:
@@ -6518,6 +6573,7 @@ protected:
     friend class ImFactory;
     friend class TextItemAnalyser;
     friend class TextItemLmdAnalyser;
+    friend class ImoCloner;
 
     ImoTextItem() : ImoInlineLevelObj(k_imo_text_item), m_text("") {}
 
@@ -6553,6 +6609,7 @@ protected:
     ImoBezierInfo* m_pBezier;
 
     friend class ImFactory;
+    friend class ImoCloner;
     ImoTieData(ImoTieDto* pDto);
 
 public:
@@ -7181,6 +7238,7 @@ protected:
 //    Color m_elisionColor;
 
     friend class ImFactory;
+    friend class ImoCloner;
     ImoLyricsTextInfo()
         : ImoSimpleObj(k_imo_lyrics_text_info)
         , m_syllableType(k_single)
@@ -7345,6 +7403,7 @@ protected:
     int m_numVoltas;                //number of voltas in the set
 
     friend class ImFactory;
+    friend class ImoCloner;
     ImoVoltaBracket()
         : ImoRelObj(k_imo_volta_bracket)
         , m_fStopJog(true)
@@ -0,0 +1,112 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2020. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+
+#define LOMSE_INTERNAL_API
+#include "lomse_benchmarks.h"
+
+#include "lomse_vertical_profile.h"
+#include "lomse_shapes.h"
+
+#include <iomanip>
+
+using namespace std;
+using namespace lomse;
+using namespace lomse::bench;
+
+//---------------------------------------------------------------------------------------
+//measures the VerticalProfile operations used while engraving a system: adding shapes
+//and looking for the max/min position in a range. Shapes are many and overlap, as in
+//a long system with lyrics, dynamics and other auxiliary notations
+LOMSE_BENCHMARK(vertical_profile)
+{
+    const int numShapes = 4000;         //per staff
+    const int numQueries = 20000;
+    const LUnits width = 40.0f * LUnits(numShapes);
+
+    //shapes with pseudo-random vertical positions
+    vector<GmoShape*> shapes;
+    unsigned int seed = 12345;
+    for (int iStaff=0; iStaff < 2; ++iStaff)
+    {
+        for (int i=0; i < numShapes; ++i)
+        {
+            seed = seed * 1103515245 + 12345;
+            LUnits y = LUnits((seed >> 16) % 3000) - 1000.0f + 5000.0f * iStaff;
+            LUnits height = LUnits((seed >> 8) % 400) + 50.0f;
+            shapes.push_back( LOMSE_NEW GmoShapeRectangle(nullptr, GmoObj::k_shape_rectangle,
+                                    0, UPoint(40.0f * LUnits(i), y), USize(70.0f, height)) );
+        }
+    }
+
+    const int numRounds = 5;
+    double updateTime = 0.0;
+    double queryTime = 0.0;
+    double distanceTime = 0.0;
+    LUnits sum = 0.0f;
+    for (int r=0; r < numRounds; ++r)
+    {
+        VerticalProfile profile(0.0f, width, 2);
+        profile.initialize(0, 0.0f, 1000.0f);
+        profile.initialize(1, 5000.0f, 6000.0f);
+
+        BenchTimer timer;
+        for (int i=0; i < 2 * numShapes; ++i)
+            profile.update(shapes[i], i / numShapes);
+        updateTime += timer.elapsed_ms();
+
+        timer.restart();
+        seed = 6789;
+        for (int i=0; i < numQueries; ++i)
+        {
+            seed = seed * 1103515245 + 12345;
+            LUnits xStart = LUnits((seed >> 8) % (40 * numShapes));
+            LUnits xEnd = xStart + 500.0f;
+            sum += profile.get_max_for(xStart, xEnd, i % 2).first;
+            sum += profile.get_min_for(xStart, xEnd, i % 2).first;
+        }
+        queryTime += timer.elapsed_ms();
+
+        timer.restart();
+        for (int i=0; i < 100; ++i)
+            sum += profile.get_staves_distance(1);
+        distanceTime += timer.elapsed_ms();
+    }
+
+    vector<GmoShape*>::iterator it;
+    for (it = shapes.begin(); it != shapes.end(); ++it)
+        delete *it;
+
+    reporter << fixed << setprecision(3)
+             << "shapes: " << 2 * numShapes << ", queries: " << 2 * numQueries
+             << ", checksum: " << sum << endl
+             << "update, all shapes (ms): " << updateTime / double(numRounds) << endl
+             << "get_max_for + get_min_for, all queries (ms): "
+             << queryTime / double(numRounds) << endl
+             << "get_staves_distance x 100 (ms): " << distanceTime / double(numRounds)
+             << endl;
+}
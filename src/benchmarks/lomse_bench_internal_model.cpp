@@ -0,0 +1,369 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2020. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+
+#define LOMSE_INTERNAL_API
+#include "lomse_benchmarks.h"
+
+#include "lomse_injectors.h"
+#include "private/lomse_document_p.h"
+#include "lomse_command.h"
+#include "lomse_document_cursor.h"
+#include "lomse_selections.h"
+#include "lomse_im_snapshot.h"
+#include "lomse_score_algorithms.h"
+#include "lomse_ldp_exporter.h"
+#include "lomse_lmd_exporter.h"
+#include "lomse_mnx_exporter.h"
+#include "lomse_document_layouter.h"
+#include "lomse_graphical_model.h"
+#include "lomse_box_system.h"
+
+#include <sstream>
+#include <iomanip>
+#if (LOMSE_PLATFORM_WIN32 == 0)
+    #include <sys/resource.h>
+#endif
+
+using namespace std;
+using namespace lomse;
+using namespace lomse::bench;
+
+//---------------------------------------------------------------------------------------
+//generates a long two staves score, with many small objects per measure
+static string generate_long_score(int numMeasures)
+{
+    stringstream ss;
+    ss << "(lenmusdoc (vers 0.0)(content (score (vers 2.0)"
+       << "(instrument (staves 2)(musicData (clef G p1)(clef F4 p2)(key D)(time 4 4)";
+    for (int i=0; i < numMeasures; ++i)
+    {
+        ss << "(n d4 e p1 v1 g+ (t + 2 3))(n f4 e)(n a4 e g- (t -))"
+           << "(n a4 q (dyn \"p\"))"
+           << "(chord (n d5 q)(n f5 q))(n +c5 q (lyric 1 \"la\"))"
+           << "(goBack w)"
+           << "(n d3 q p2 v2 (slur 1 start))(n a3 e g+)(n f3 e g-)(n d3 h (slur 1 stop))"
+           << "(barline)";
+    }
+    ss << ")))))";
+    return ss.str();
+}
+
+//---------------------------------------------------------------------------------------
+//returns the peak resident set size in KB, or -1 if not available
+static long peak_rss_kb()
+{
+#if (LOMSE_PLATFORM_WIN32 == 0)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        return usage.ru_maxrss;
+#endif
+    return -1;
+}
+
+//---------------------------------------------------------------------------------------
+//executes and undoes a command on a long score. Returns the mean times for execute
+//(it includes saving the undo checkpoint) and for undo
+static void time_execute_undo(LibraryScope& libraryScope, const string& source,
+                              bool fDelete, double* pExecTime, double* pUndoTime)
+{
+    stringstream errors;
+    Document doc(libraryScope, errors);
+    doc.from_string(source);
+    DocCommandExecuter executer(&doc);
+
+    const int numRounds = 5;
+    *pExecTime = 0.0;
+    *pUndoTime = 0.0;
+    for (int r=0; r < numRounds; ++r)
+    {
+        DocCursor cursor(&doc);
+        cursor.enter_element();     //points to clef G
+        for (int i=0; i < 4; ++i)
+            cursor.move_next();     //points to first note
+        SelectionSet sel(&doc);
+        DocCommand* pCmd;
+        if (fDelete)
+        {
+            sel.add((*cursor)->get_id());
+            pCmd = LOMSE_NEW CmdDeleteSelection();
+        }
+        else
+            pCmd = LOMSE_NEW CmdAddNoteRest("(n a4 e v1)", k_edit_mode_replace);
+
+        BenchTimer timer;
+        executer.execute(&cursor, pCmd, &sel);
+        *pExecTime += timer.elapsed_ms();
+
+        timer.restart();
+        executer.undo(&cursor, &sel);
+        *pUndoTime += timer.elapsed_ms();
+    }
+    *pExecTime /= double(numRounds);
+    *pUndoTime /= double(numRounds);
+}
+
+//---------------------------------------------------------------------------------------
+//compares undo checkpoints saved as snapshots with checkpoints saved as source code
+LOMSE_BENCHMARK(undo_checkpoints)
+{
+    LibraryScope libraryScope(reporter);
+    libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    string source = generate_long_score(500);
+    reporter << fixed << setprecision(2)
+             << "measures: 500, source size (KB): " << source.size() / 1024 << endl;
+
+    //save and restore the whole document
+    stringstream errors;
+    Document doc(libraryScope, errors);
+    doc.from_string(source);
+    const int numRounds = 5;
+    double saveText = 0.0, restoreText = 0.0, saveSnapshot = 0.0, restoreSnapshot = 0.0;
+    for (int r=0; r < numRounds; ++r)
+    {
+        BenchTimer timer;
+        string checkpoint = doc.get_checkpoint_data();
+        saveText += timer.elapsed_ms();
+        timer.restart();
+        doc.from_checkpoint(checkpoint);
+        restoreText += timer.elapsed_ms();
+
+        timer.restart();
+        ImSnapshot* pSnapshot = doc.get_snapshot();
+        saveSnapshot += timer.elapsed_ms();
+        timer.restart();
+        doc.from_snapshot(pSnapshot);
+        restoreSnapshot += timer.elapsed_ms();
+        delete pSnapshot;
+    }
+    reporter << "Document, source code. Save (ms): " << saveText / double(numRounds)
+             << ", restore (ms): " << restoreText / double(numRounds) << endl
+             << "Document, snapshots. Save (ms): " << saveSnapshot / double(numRounds)
+             << ", restore (ms): " << restoreSnapshot / double(numRounds) << endl;
+
+    const char* cmds[] = { "CmdAddNoteRest", "CmdDeleteSelection" };
+    for (int i=0; i < 2; ++i)
+    {
+        for (int mode=0; mode < 2; ++mode)
+        {
+            libraryScope.set_undo_snapshots(mode == 1);
+            double execTime, undoTime;
+            time_execute_undo(libraryScope, source, i == 1, &execTime, &undoTime);
+            reporter << cmds[i] << (mode == 1 ? ", snapshots" : ", source code")
+                     << ". Execute (ms): " << execTime
+                     << ", undo (ms): " << undoTime << endl;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------------
+//memory used by the undo history, with and without a memory budget
+LOMSE_BENCHMARK(undo_history_memory)
+{
+    for (int mode=0; mode < 4; ++mode)
+    {
+        bool fSnapshots = (mode % 2 == 1);
+        bool fBudget = (mode >= 2);
+        LibraryScope libraryScope(reporter);
+        libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+        libraryScope.set_undo_snapshots(fSnapshots);
+        stringstream errors;
+        Document doc(libraryScope, errors);
+        doc.from_string( generate_long_score(500) );
+        size_t checkpointSize = doc.get_checkpoint_data().size();
+        DocCommandExecuter executer(&doc);
+        if (fBudget)
+            executer.set_undo_memory_budget(5 * checkpointSize);
+        DocCursor cursor(&doc);
+        SelectionSet sel(&doc);
+        cursor.enter_element();     //points to clef G
+
+        const int numCmds = 20;
+        BenchTimer timer;
+        for (int i=0; i < numCmds; ++i)
+        {
+            cursor.move_next();
+            executer.execute(&cursor, LOMSE_NEW CmdAddNoteRest("(n a4 e v1)",
+                                                               k_edit_mode_replace), &sel);
+        }
+        double execTime = timer.elapsed_ms() / double(numCmds);
+        size_t memory = executer.get_undo_memory_size();
+
+        timer.restart();
+        for (int i=0; i < numCmds; ++i)
+            executer.undo(&cursor, &sel);
+        double undoTime = timer.elapsed_ms() / double(numCmds);
+
+        reporter << fixed << setprecision(2)
+                 << (fSnapshots ? "snapshots" : "text checkpoints")
+                 << (fBudget ? ", budget (KB): " : ", no budget")
+                 << (fBudget ? to_string(5 * checkpointSize / 1024) : string())
+                 << ". commands: " << numCmds << ", checkpoint size (KB): "
+                 << checkpointSize / 1024 << endl
+                 << "undo history (KB): " << memory / 1024 << endl
+                 << "execute (ms): " << execTime << ", undo (ms): " << undoTime << endl;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+//measures the time for exporting a long score in the supported formats
+LOMSE_BENCHMARK(score_export)
+{
+    LibraryScope libraryScope(reporter);
+    libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    stringstream errors;
+    Document doc(libraryScope, errors);
+    doc.from_string( generate_long_score(2000) );
+    ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+
+    const int numRounds = 5;
+    double ldpTime = 0.0, streamTime = 0.0, lmdTime = 0.0, mnxTime = 0.0;
+    size_t ldpSize = 0;
+    for (int r=0; r < numRounds; ++r)
+    {
+        LdpExporter ldp(&libraryScope);
+        ldp.set_current_score(pScore);
+        BenchTimer timer;
+        ldpSize = ldp.get_source(pScore).size();
+        ldpTime += timer.elapsed_ms();
+
+        stringstream out;
+        timer.restart();
+        ldp.write_source(out, pScore);
+        streamTime += timer.elapsed_ms();
+
+        LmdExporter lmd(libraryScope);
+        timer.restart();
+        lmd.get_source(pScore);
+        lmdTime += timer.elapsed_ms();
+
+        MnxExporter mnx(libraryScope);
+        timer.restart();
+        mnx.get_source(pScore);
+        mnxTime += timer.elapsed_ms();
+    }
+
+    reporter << fixed << setprecision(2)
+             << "measures: 2000, LDP source size (KB): " << ldpSize / 1024 << endl
+             << "LDP, get_source (ms): " << ldpTime / double(numRounds)
+             << ", write_source (ms): " << streamTime / double(numRounds) << endl
+             << "LMD (ms): " << lmdTime / double(numRounds) << endl
+             << "MNX (ms): " << mnxTime / double(numRounds) << endl
+             << "peak RSS (KB): " << peak_rss_kb() << endl;
+}
+
+//---------------------------------------------------------------------------------------
+//measures the time for locating the note/rests at a timepos near the end of a long score
+LOMSE_BENCHMARK(noterest_lookup)
+{
+    LibraryScope libraryScope(reporter);
+    libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    stringstream errors;
+    Document doc(libraryScope, errors);
+    doc.from_string( generate_long_score(2000) );
+    ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+
+    const int numQueries = 200;
+    TimeUnits lastMeasure = 1999.0 * 256.0;
+    int found = 0;
+    BenchTimer timer;
+    for (int i=0; i < numQueries; ++i)
+    {
+        if (ScoreAlgorithms::find_noterest_at(pScore, 0, 2, lastMeasure + TimeUnits(i % 8) * 32.0))
+            ++found;
+    }
+    double findTime = timer.elapsed_ms() / double(numQueries);
+
+    timer.restart();
+    for (int i=0; i < numQueries; ++i)
+    {
+        list<OverlappedNoteRest*> overlaps =
+            ScoreAlgorithms::find_and_classify_overlapped_noterests_at(pScore, 0, 1,
+                                        lastMeasure + TimeUnits(i % 8) * 16.0, 64.0);
+        found += int(overlaps.size());
+        list<OverlappedNoteRest*>::iterator it;
+        for (it=overlaps.begin(); it != overlaps.end(); ++it)
+            delete *it;
+    }
+    double classifyTime = timer.elapsed_ms() / double(numQueries);
+
+    reporter << fixed << setprecision(4)
+             << "measures: 2000, queries: " << numQueries << ", found: " << found << endl
+             << "find_noterest_at (ms): " << findTime << endl
+             << "find_and_classify_overlapped_noterests_at (ms): " << classifyTime << endl;
+}
+
+//---------------------------------------------------------------------------------------
+//measures the time for locating the system and the x position for a timepos near the
+//end of a long score, as done by the tempo line for each played note
+LOMSE_BENCHMARK(timeline_lookup)
+{
+    LibraryScope libraryScope(reporter);
+    libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+    stringstream errors;
+    Document doc(libraryScope, errors);
+    doc.from_string( generate_long_score(1000) );
+    ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+    ImoId scoreId = pScore->get_id();
+
+    BenchTimer timer;
+    DocLayouter layouter(&doc, libraryScope);
+    layouter.layout_document();
+    GraphicModel* pGModel = layouter.get_graphic_model();
+    double layoutTime = timer.elapsed_ms();
+
+    const int numQueries = 2000;
+    TimeUnits lastMeasure = 999.0 * 256.0;
+    LUnits xSum = 0.0f;
+    timer.restart();
+    for (int i=0; i < numQueries; ++i)
+    {
+        TimeUnits timepos = lastMeasure + TimeUnits(i % 8) * 32.0;
+        GmoBoxSystem* pSystem = pGModel->get_system_for(scoreId, timepos);
+        if (pSystem)
+            xSum += pSystem->get_x_for_note_rest_at_time(timepos);
+    }
+    double lookupTime = timer.elapsed_ms() / double(numQueries);
+
+    timer.restart();
+    TimeposLocation loc;
+    for (int i=0; i < numQueries; ++i)
+    {
+        TimeUnits timepos = lastMeasure + TimeUnits(i % 8) * 32.0;
+        if (pGModel->locate_timepos(scoreId, timepos, &loc))
+            xSum += loc.x;
+    }
+    double locateTime = timer.elapsed_ms() / double(numQueries);
+
+    reporter << fixed << setprecision(4)
+             << "measures: 1000, queries: " << numQueries << ", x sum: " << xSum << endl
+             << "layout (ms): " << layoutTime << endl
+             << "get_system_for + get_x_for_note_rest_at_time (ms): " << lookupTime << endl
+             << "locate_timepos (ms): " << locateTime << endl;
+
+    delete pGModel;
+}
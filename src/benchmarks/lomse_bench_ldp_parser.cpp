@@ -0,0 +1,97 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2020. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+
+#define LOMSE_INTERNAL_API
+#include "lomse_benchmarks.h"
+
+#include "lomse_injectors.h"
+#include "lomse_ldp_parser.h"
+
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+
+using namespace std;
+using namespace lomse;
+using namespace lomse::bench;
+
+//---------------------------------------------------------------------------------------
+//parses (lexical and syntax analysis) all LDP scores in the test-scores folder, both
+//from the files and from strings with their content
+LOMSE_BENCHMARK(ldp_parser)
+{
+    vector<string> extensions;
+    extensions.push_back(".lms");
+    vector<string> files;
+    collect_files(TESTLIB_SCORES_PATH, extensions, files);
+
+    vector<string> sources;
+    size_t totalBytes = 0;
+    for (size_t i=0; i < files.size(); ++i)
+    {
+        ifstream file(files[i].c_str(), ios::binary);
+        stringstream ss;
+        ss << file.rdbuf();
+        sources.push_back(ss.str());
+        totalBytes += sources.back().size();
+    }
+    if (sources.empty())
+    {
+        reporter << "No LDP files found in " << TESTLIB_SCORES_PATH << endl;
+        return;
+    }
+
+    LibraryScope libraryScope(reporter);
+    stringstream errors;
+    LdpParser parser(errors, libraryScope.ldp_factory());
+    double mbytes = double(totalBytes) / (1024.0 * 1024.0);
+    const int numRounds = 20;
+
+    BenchTimer timer;
+    for (int r=0; r < numRounds; ++r)
+    {
+        for (size_t i=0; i < files.size(); ++i)
+            parser.parse_file(files[i]);
+    }
+    double fileTime = timer.elapsed_ms() / double(numRounds);
+
+    timer.restart();
+    for (int r=0; r < numRounds; ++r)
+    {
+        for (size_t i=0; i < sources.size(); ++i)
+            parser.parse_text(sources[i]);
+    }
+    double textTime = timer.elapsed_ms() / double(numRounds);
+
+    reporter << fixed << setprecision(2)
+             << "files: " << sources.size() << ", size (MB): " << mbytes << endl
+             << "from files (ms): " << fileTime
+             << ", throughput (MB/s): " << mbytes / (fileTime / 1000.0) << endl
+             << "from strings (ms): " << textTime
+             << ", throughput (MB/s): " << mbytes / (textTime / 1000.0) << endl;
+}
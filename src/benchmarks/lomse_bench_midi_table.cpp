@@ -0,0 +1,126 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2020. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+//---------------------------------------------------------------------------------------
+
+#define LOMSE_INTERNAL_API
+#include "lomse_benchmarks.h"
+
+#include "lomse_injectors.h"
+#include "lomse_midi_table.h"
+#include "private/lomse_document_p.h"
+#include "lomse_internal_model.h"
+
+#include <sstream>
+#include <iomanip>
+
+using namespace std;
+using namespace lomse;
+using namespace lomse::bench;
+
+//---------------------------------------------------------------------------------------
+//Helper, to access protected members
+class BenchSoundEventsTable : public SoundEventsTable
+{
+public:
+    BenchSoundEventsTable(ImoScore* pScore) : SoundEventsTable(pScore) {}
+    virtual ~BenchSoundEventsTable() {}
+
+    void my_program_sounds_for_instruments() { program_sounds_for_instruments(); }
+    void my_create_events() { create_events(); }
+    void my_close_table() { close_table(); }
+    void my_sort_by_time() { sort_by_time(); }
+};
+
+//---------------------------------------------------------------------------------------
+//generates an LDP score with eight instruments and numMeasures measures. Instruments
+//mix short and long notes, so that many note-off events are created far from their
+//final position in the table.
+static string generate_score(int numMeasures)
+{
+    stringstream ss;
+    ss << "(score (vers 2.0)";
+    for (int iInstr=0; iInstr < 8; ++iInstr)
+    {
+        ss << "(instrument (musicData (clef " << (iInstr < 4 ? "G" : "F4") << ")"
+           << "(time 4 4)";
+        for (int i=0; i < numMeasures; ++i)
+        {
+            switch (iInstr % 4)
+            {
+                case 0:  ss << "(n c4 e)(n d4 e)(n e4 q)(n g4 q)(n f4 s)(n e4 s)(n d4 e)";  break;
+                case 1:  ss << "(n c3 h)(n g3 h)";  break;
+                case 2:  ss << "(n c3 w)";  break;
+                default: ss << "(chord (n c4 q)(n e4 q))(chord (n d4 h)(n f4 h))(r q)";
+            }
+            ss << "(barline)";
+        }
+        ss << "))";
+    }
+    ss << ")";
+    return ss.str();
+}
+
+//---------------------------------------------------------------------------------------
+LOMSE_BENCHMARK(midi_table_build)
+{
+    LibraryScope libraryScope(reporter);
+    libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+
+    reporter << " measures     events   create (ms)   sort (ms)   total (ms)" << endl;
+
+    const int sizes[] = { 100, 250, 500, 1000, 2000 };
+    for (int k=0; k < 5; ++k)
+    {
+        Document doc(libraryScope, reporter);
+        doc.from_string("(lenmusdoc (vers 0.0) (content " + generate_score(sizes[k])
+                        + "))" );
+        ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+
+        BenchSoundEventsTable table(pScore);
+        BenchTimer timer;
+        table.my_program_sounds_for_instruments();
+        table.my_create_events();
+        double createTime = timer.elapsed_ms();
+        timer.restart();
+        table.my_sort_by_time();
+        double sortTime = timer.elapsed_ms();
+        table.my_close_table();
+
+        BenchSoundEventsTable fullTable(pScore);
+        timer.restart();
+        fullTable.create_table();
+        double totalTime = timer.elapsed_ms();
+
+        reporter << fixed << setprecision(2)
+                 << setw(9) << sizes[k]
+                 << setw(11) << table.num_events()
+                 << setw(14) << createTime
+                 << setw(12) << sortTime
+                 << setw(13) << totalTime << endl;
+    }
+}
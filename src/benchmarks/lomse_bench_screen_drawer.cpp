@@ -0,0 +1,125 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2020. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+
+#define LOMSE_INTERNAL_API
+#include "lomse_benchmarks.h"
+
+#include "lomse_injectors.h"
+#include "lomse_doorway.h"
+#include "lomse_graphic_view.h"
+#include "lomse_interactor.h"
+#include "private/lomse_document_p.h"
+
+#include <sstream>
+#include <iomanip>
+
+using namespace std;
+using namespace lomse;
+using namespace lomse::bench;
+
+//---------------------------------------------------------------------------------------
+class BenchDoorway : public LomseDoorway
+{
+public:
+    BenchDoorway()
+        : LomseDoorway()
+    {
+        init_library(k_pix_format_rgba32, 96, false);
+    }
+    virtual ~BenchDoorway() {}
+
+    double get_screen_ppi() const { return 96.0; }
+};
+
+//---------------------------------------------------------------------------------------
+//generates a dense LDP score: four instruments with beamed sixteenth notes, many
+//accidentals and chords, so that a page contains thousands of glyphs
+static string generate_dense_score(int numMeasures)
+{
+    stringstream ss;
+    ss << "(score (vers 2.0)";
+    for (int iInstr=0; iInstr < 4; ++iInstr)
+    {
+        ss << "(instrument (musicData (clef " << (iInstr < 2 ? "G" : "F4") << ")"
+           << "(key A)(time 4 4)";
+        for (int i=0; i < numMeasures; ++i)
+        {
+            if (iInstr % 2 == 0)
+            {
+                for (int j=0; j < 4; ++j)
+                    ss << "(n +c4 s g+)(n -d4 s)(n =e4 s)(n f4 s g-)";
+            }
+            else
+            {
+                ss << "(chord (n c4 q)(n e4 q)(n g4 q))(chord (n d4 q)(n f4 q)(n a4 q))"
+                   << "(chord (n +c4 h)(n e4 h)(n g4 h))";
+            }
+            ss << "(barline)";
+        }
+        ss << "))";
+    }
+    ss << ")";
+    return ss.str();
+}
+
+//---------------------------------------------------------------------------------------
+LOMSE_BENCHMARK(render_dense_page)
+{
+    BenchDoorway platform;
+    LibraryScope libraryScope(reporter, &platform);
+    libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+
+    SpDocument spDoc( new Document(libraryScope, reporter) );
+    spDoc->from_string("(lenmusdoc (vers 0.0) (content "
+                       + generate_dense_score(60) + "))" );
+    VerticalBookView* pView = Injector::inject_VerticalBookView(libraryScope,
+                                                                spDoc.get());
+    Interactor* pIntor = Injector::inject_Interactor(libraryScope, spDoc, pView,
+                                                     nullptr);
+    pView->set_interactor(pIntor);
+
+    int width = 1000;
+    int height = 1400;
+    vector<unsigned char> pixels(width*height*4);
+    RenderingBuffer rbuf;
+    rbuf.attach(&pixels[0], width, height, width*4);
+    pView->set_rendering_buffer(&rbuf);
+    pView->new_viewport(0, 0);
+    pView->redraw_bitmap();     //first render also lays out the document
+
+    const int numRenders = 20;
+    BenchTimer timer;
+    for (int i=0; i < numRenders; ++i)
+        pView->redraw_bitmap();
+    double pageTime = timer.elapsed_ms() / double(numRenders);
+
+    reporter << fixed << setprecision(2)
+             << "page render (ms): " << pageTime << endl;
+
+    delete pIntor;
+}
@@ -0,0 +1,178 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2020. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+//---------------------------------------------------------------------------------------
+
+#ifndef __LOMSE_BENCHMARKS_H__
+#define __LOMSE_BENCHMARKS_H__
+
+#include "lomse_build_options.h"
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+#if (LOMSE_PLATFORM_WIN32 == 1)
+    #include <windows.h>
+#else
+    #include <dirent.h>
+#endif
+
+namespace lomse
+{
+namespace bench
+{
+
+//---------------------------------------------------------------------------------------
+/** A benchmark is a function that runs some library algorithm, measures the time
+    and reports results on the received stream. Benchmarks are registered with macro
+    LOMSE_BENCHMARK and are run by the 'benchlib' program.
+*/
+typedef void (*BenchmarkFunction)(std::ostream& reporter);
+
+struct Benchmark
+{
+    const char* name;
+    const char* filename;
+    BenchmarkFunction function;
+};
+
+inline std::vector<Benchmark>& get_benchmarks()
+{
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+//---------------------------------------------------------------------------------------
+struct BenchmarkRegistrar
+{
+    BenchmarkRegistrar(const char* name, const char* filename, BenchmarkFunction fn)
+    {
+        Benchmark b = { name, filename, fn };
+        get_benchmarks().push_back(b);
+    }
+};
+
+#define LOMSE_BENCHMARK(Name)                                                       \
+    static void bench_##Name(std::ostream& reporter);                               \
+    static lomse::bench::BenchmarkRegistrar registrar_##Name(#Name, __FILE__,       \
+                                                             bench_##Name);         \
+    static void bench_##Name(std::ostream& reporter)
+
+//---------------------------------------------------------------------------------------
+/** Helper for measuring elapsed time */
+class BenchTimer
+{
+protected:
+    std::chrono::steady_clock::time_point m_start;
+
+public:
+    BenchTimer() : m_start(std::chrono::steady_clock::now()) {}
+
+    inline void restart() { m_start = std::chrono::steady_clock::now(); }
+
+    /** Returns the elapsed time since creation or last restart, in milliseconds */
+    inline double elapsed_ms() const
+    {
+        std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - m_start;
+        return elapsed.count();
+    }
+};
+
+//---------------------------------------------------------------------------------------
+/** Recursively collects the files in a folder having any of the given extensions,
+    e.g. ".lms". Folder must end with a path separator.
+*/
+inline void collect_files(const std::string& folder,
+                          const std::vector<std::string>& extensions,
+                          std::vector<std::string>& files)
+{
+    struct Helper
+    {
+        static bool has_extension(const std::string& name,
+                                  const std::vector<std::string>& extensions)
+        {
+            size_t dot = name.rfind('.');
+            if (dot == std::string::npos)
+                return false;
+            std::string ext = name.substr(dot);
+            for (size_t i=0; i < extensions.size(); ++i)
+            {
+                if (ext == extensions[i])
+                    return true;
+            }
+            return false;
+        }
+    };
+
+#if (LOMSE_PLATFORM_WIN32 == 1)
+    WIN32_FIND_DATAA data;
+    HANDLE hFind = FindFirstFileA((folder + "*").c_str(), &data);
+    if (hFind == INVALID_HANDLE_VALUE)
+        return;
+    do
+    {
+        std::string name(data.cFileName);
+        if (name == "." || name == "..")
+            continue;
+        if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+            collect_files(folder + name + "/", extensions, files);
+        else if (Helper::has_extension(name, extensions))
+            files.push_back(folder + name);
+    }
+    while (FindNextFileA(hFind, &data));
+    FindClose(hFind);
+#else
+    DIR* dir = opendir(folder.c_str());
+    if (!dir)
+        return;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr)
+    {
+        std::string name(entry->d_name);
+        if (name == "." || name == "..")
+            continue;
+        std::string path = folder + name;
+        DIR* subdir = opendir(path.c_str());
+        if (subdir)
+        {
+            closedir(subdir);
+            collect_files(path + "/", extensions, files);
+        }
+        else if (Helper::has_extension(name, extensions))
+            files.push_back(path);
+    }
+    closedir(dir);
+#endif
+}
+
+
+}   //namespace bench
+}   //namespace lomse
+
+#endif      //__LOMSE_BENCHMARKS_H__
@@ -0,0 +1,74 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2020. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+//---------------------------------------------------------------------------------------
+
+#include "lomse_benchmarks.h"
+
+#include "lomse_build_options.h"
+#include "lomse_injectors.h"
+
+#include <iostream>
+#include <string.h>
+
+using namespace std;
+using namespace lomse;
+using namespace lomse::bench;
+
+int main(int argc, char** argv)
+{
+    //invoke without arguments to run all benchmarks:
+    //  benchlib
+    //
+    //invoke with arguments to run only the named benchmarks:
+    //  benchlib MyBenchmarkName [OtherBenchmarkName ...]
+
+    cout << "Lomse version " << LibraryScope::get_version_long_string()
+         << ". Library benchmarks runner." << endl;
+    cout << "Path for tests scores: '" << TESTLIB_SCORES_PATH << "'" << endl << endl;
+
+    int numRun = 0;
+    vector<Benchmark>& benchmarks = get_benchmarks();
+    vector<Benchmark>::iterator it;
+    for (it = benchmarks.begin(); it != benchmarks.end(); ++it)
+    {
+        bool fRun = (argc < 2);
+        for (int i=1; i < argc && !fRun; ++i)
+            fRun = (strcmp(argv[i], it->name) == 0);
+
+        if (fRun)
+        {
+            cout << "---- " << it->name << endl;
+            it->function(cout);
+            cout << endl;
+            ++numRun;
+        }
+    }
+
+    cout << numRun << " benchmarks run." << endl;
+    return 0;
+}
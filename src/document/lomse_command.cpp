@@ -34,6 +34,7 @@
 #include "private/lomse_document_p.h"
 #include "lomse_document_cursor.h"
 #include "lomse_im_factory.h"
+#include "lomse_im_snapshot.h"
 #include "lomse_logger.h"
 #include "lomse_ldp_analyser.h"         //ldp_pitch_to_components
 #include "lomse_autobeamer.h"
@@ -48,24 +49,253 @@
 #include "lomse_score_utilities.h"
 
 #include <sstream>
+#include <cstring>
+#include <unordered_map>
+#if (LOMSE_ENABLE_COMPRESSION == 1)
+    #include <zlib.h>
+#endif
 using namespace std;
 
 namespace lomse
 {
 
+//=======================================================================================
+// Checkpoints compression
+//
+// A packed checkpoint is a list of operations for rebuilding the checkpoint text from
+// a base text, normally the checkpoint of the next command for the same object:
+// 'C' <offset> <length> copies text from the base and 'I' <length> <bytes> inserts
+// new text. When there is no base the list is just an insertion of the whole text.
+// The list is compressed with zlib, when available.
+//=======================================================================================
+static const size_t k_delta_block = 32;     //size of blocks for matching base text
+static const uint32_t k_hash_base = 257;
+
+//---------------------------------------------------------------------------------------
+static void put_varint(string& out, size_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back( char((value & 0x7F) | 0x80) );
+        value >>= 7;
+    }
+    out.push_back( char(value) );
+}
+
+//---------------------------------------------------------------------------------------
+static size_t get_varint(const string& in, size_t& i)
+{
+    size_t value = 0;
+    int shift = 0;
+    while (i < in.size())
+    {
+        unsigned char c = static_cast<unsigned char>(in[i++]);
+        value |= size_t(c & 0x7F) << shift;
+        if ((c & 0x80) == 0)
+            break;
+        shift += 7;
+    }
+    return value;
+}
+
+//---------------------------------------------------------------------------------------
+static uint32_t block_hash(const char* p)
+{
+    uint32_t h = 0;
+    for (size_t i=0; i < k_delta_block; ++i)
+        h = h * k_hash_base + static_cast<unsigned char>(p[i]);
+    return h;
+}
+
+//---------------------------------------------------------------------------------------
+static void add_insertion(string& ops, const string& text, size_t start, size_t end)
+{
+    if (end > start)
+    {
+        ops.push_back('I');
+        put_varint(ops, end - start);
+        ops.append(text, start, end - start);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+static string encode_delta(const string& text, const string* pBase)
+{
+    string ops;
+    size_t literal = 0;     //start of text not yet encoded
+    if (pBase && pBase->size() >= k_delta_block && text.size() >= k_delta_block)
+    {
+        const string& base = *pBase;
+
+        //index the base blocks
+        unordered_map<uint32_t, size_t> blocks;
+        blocks.reserve(base.size() / k_delta_block);
+        for (size_t i=0; i + k_delta_block <= base.size(); i += k_delta_block)
+            blocks.insert( make_pair(block_hash(&base[i]), i) );
+
+        uint32_t power = 1;     //k_hash_base ^ (k_delta_block - 1)
+        for (size_t i=1; i < k_delta_block; ++i)
+            power *= k_hash_base;
+
+        //look for base blocks in text, using a rolling hash
+        size_t i = 0;
+        uint32_t h = block_hash(&text[0]);
+        while (i + k_delta_block <= text.size())
+        {
+            unordered_map<uint32_t, size_t>::iterator it = blocks.find(h);
+            if (it != blocks.end()
+                && memcmp(&text[i], &base[it->second], k_delta_block) == 0)
+            {
+                //extend the match backwards and forwards
+                size_t src = it->second;
+                size_t dst = i;
+                size_t len = k_delta_block;
+                while (dst > literal && src > 0 && text[dst-1] == base[src-1])
+                {
+                    --dst;
+                    --src;
+                    ++len;
+                }
+                while (dst + len < text.size() && src + len < base.size()
+                       && text[dst + len] == base[src + len])
+                {
+                    ++len;
+                }
+
+                add_insertion(ops, text, literal, dst);
+                ops.push_back('C');
+                put_varint(ops, src);
+                put_varint(ops, len);
+
+                i = dst + len;
+                literal = i;
+                if (i + k_delta_block <= text.size())
+                    h = block_hash(&text[i]);
+            }
+            else
+            {
+                if (i + k_delta_block < text.size())
+                {
+                    h -= static_cast<unsigned char>(text[i]) * power;
+                    h = h * k_hash_base
+                        + static_cast<unsigned char>(text[i + k_delta_block]);
+                }
+                ++i;
+            }
+        }
+    }
+    add_insertion(ops, text, literal, text.size());
+    return ops;
+}
+
+//---------------------------------------------------------------------------------------
+static string decode_delta(const string& ops, const string* pBase)
+{
+    string text;
+    size_t i = 0;
+    while (i < ops.size())
+    {
+        char op = ops[i++];
+        if (op == 'C' && pBase)
+        {
+            size_t src = get_varint(ops, i);
+            size_t len = get_varint(ops, i);
+            text.append(*pBase, src, len);
+        }
+        else if (op == 'I')
+        {
+            size_t len = get_varint(ops, i);
+            text.append(ops, i, len);
+            i += len;
+        }
+        else
+        {
+            LOMSE_LOG_ERROR("Invalid checkpoint data.");
+            break;
+        }
+    }
+    return text;
+}
+
+//---------------------------------------------------------------------------------------
+static string pack_text(const string& text, const string* pBase)
+{
+    string ops = encode_delta(text, pBase);
+
+    //packed data: 'z' <size of ops> <compressed ops>, or 'r' <ops>
+#if (LOMSE_ENABLE_COMPRESSION == 1)
+    string packed("z");
+    put_varint(packed, ops.size());
+    size_t header = packed.size();
+    uLongf size = compressBound(uLong(ops.size()));
+    packed.resize(header + size);
+    if (compress2(reinterpret_cast<Bytef*>(&packed[header]), &size,
+                  reinterpret_cast<const Bytef*>(ops.data()), uLong(ops.size()),
+                  Z_BEST_SPEED) == Z_OK)
+    {
+        packed.resize(header + size);
+        return string(packed);      //copy, to release unused capacity
+    }
+#endif
+    return "r" + ops;
+}
+
+//---------------------------------------------------------------------------------------
+static string unpack_text(const string& packed, const string* pBase)
+{
+    if (packed.empty())
+        return string();
+
+    if (packed[0] == 'r')
+        return decode_delta(packed.substr(1), pBase);
+
+#if (LOMSE_ENABLE_COMPRESSION == 1)
+    size_t header = 1;
+    uLongf size = uLongf( get_varint(packed, header) );
+    string ops(size, '\0');
+    if (size == 0
+        || uncompress(reinterpret_cast<Bytef*>(&ops[0]), &size,
+                      reinterpret_cast<const Bytef*>(&packed[header]),
+                      uLong(packed.size() - header)) == Z_OK)
+    {
+        return decode_delta(ops, pBase);
+    }
+#endif
+
+    LOMSE_LOG_ERROR("Invalid checkpoint data.");
+    return string();
+}
+
+
 //=======================================================================================
 // DocCommand
 //=======================================================================================
+DocCommand::~DocCommand()
+{
+    delete m_pSnapshot;
+}
+
+//---------------------------------------------------------------------------------------
 void DocCommand::create_checkpoint(Document* pDoc)
 {
     if (!is_included_in_composite_cmd())
     {
-        if (m_checkpoint.empty())
+        if (m_checkpoint.empty() && m_packed.empty() && !m_pSnapshot)
         {
-            if (get_undo_policy() == k_undo_policy_partial_checkpoint)
-                m_checkpoint = pDoc->get_checkpoint_data_for(m_idChk);
-            else
-                m_checkpoint = pDoc->get_checkpoint_data();
+            bool fPartial = (get_undo_policy() == k_undo_policy_partial_checkpoint);
+
+            if (pDoc->get_library_scope().use_undo_snapshots())
+                m_pSnapshot = (fPartial ? pDoc->get_snapshot_for(m_idChk)
+                                        : pDoc->get_snapshot());
+
+            //when the model can not be saved in a snapshot use source code
+            if (!m_pSnapshot)
+            {
+                if (fPartial)
+                    m_checkpoint = pDoc->get_checkpoint_data_for(m_idChk);
+                else
+                    m_checkpoint = pDoc->get_checkpoint_data();
+            }
         }
     }
 }
@@ -90,10 +320,20 @@ void DocCommand::undo_action(Document* pDoc, DocCursor* UNUSED(pCursor))
     logger << "IdAssigner. Before: " << pDoc->dump_ids() << endl;
 
     //execute undo
-    if (get_undo_policy() == k_undo_policy_partial_checkpoint)
-        pDoc->replace_object_from_checkpoint_data(m_idChk, m_checkpoint);
+    if (m_pSnapshot)
+    {
+        if (get_undo_policy() == k_undo_policy_partial_checkpoint)
+            pDoc->replace_object_from_snapshot(m_idChk, m_pSnapshot);
+        else
+            pDoc->from_snapshot(m_pSnapshot);
+    }
     else
-        pDoc->from_checkpoint(m_checkpoint);
+    {
+        if (get_undo_policy() == k_undo_policy_partial_checkpoint)
+            pDoc->replace_object_from_checkpoint_data(m_idChk, get_checkpoint_source());
+        else
+            pDoc->from_checkpoint( get_checkpoint_source() );
+    }
 
     logger << "IdAssigner. After: " << pDoc->dump_ids() << endl;
     get_global_logger().close_forensic_log();
@@ -112,11 +352,98 @@ void DocCommand::log_forensic_data(Document* UNUSED(pDoc), DocCursor* pCursor)
            << to_simple_string(chrono::system_clock::now()) << endl;
     log_command(logger);
     logger << "Cursor: " << pCursor->dump_cursor();
-    logger << "Checkpoint data (last id " << m_idChk << "):" << endl;
-    logger << m_checkpoint << endl;
+    if (m_pSnapshot)
+    {
+        logger << "Checkpoint snapshot (last id " << m_idChk << "): "
+               << m_pSnapshot->get_num_objects() << " objects, "
+               << m_pSnapshot->get_memory_size() << " bytes" << endl;
+    }
+    else
+    {
+        logger << "Checkpoint data (last id " << m_idChk << "):" << endl;
+        logger << get_checkpoint_source() << endl;
+    }
     get_global_logger().close_forensic_log();
 }
 
+//---------------------------------------------------------------------------------------
+string DocCommand::get_checkpoint_source()
+{
+    if (m_packed.empty())
+        return m_checkpoint;
+
+    if (m_pDeltaBase)
+    {
+        string base = m_pDeltaBase->get_checkpoint_source();
+        return unpack_text(m_packed, &base);
+    }
+    return unpack_text(m_packed, nullptr);
+}
+
+//---------------------------------------------------------------------------------------
+void DocCommand::pack_checkpoint(Document* pDoc, DocCommand* pBase)
+{
+    //Compress the checkpoint source code. A snapshot is first replaced by its source
+    //code. When pBase is not nullptr and it has a checkpoint for the same object, only
+    //the differences with pBase checkpoint are saved and pBase must not be deleted
+    //before this command.
+
+    if (m_pSnapshot)
+    {
+        save_snapshot_source(pDoc);
+        delete m_pSnapshot;
+        m_pSnapshot = nullptr;
+    }
+
+    if (m_checkpoint.empty())
+        return;
+
+    if (pBase && ((pBase->m_checkpoint.empty() && !pBase->m_pSnapshot)
+                  || pBase->get_undo_policy() != get_undo_policy()
+                  || pBase->m_idChk != m_idChk) )
+    {
+        pBase = nullptr;
+    }
+
+    if (pBase)
+        pBase->save_snapshot_source(pDoc);
+
+    m_packed = pack_text(m_checkpoint, pBase ? &(pBase->m_checkpoint) : nullptr);
+    m_pDeltaBase = pBase;
+    string().swap(m_checkpoint);
+}
+
+//---------------------------------------------------------------------------------------
+void DocCommand::save_snapshot_source(Document* pDoc)
+{
+    //The source code of a snapshot is needed for packing it and when it is the base
+    //for the delta of the previous command. The snapshot is kept for undo, and the
+    //source code is saved to export the snapshot only once.
+
+    if (m_pSnapshot && m_checkpoint.empty())
+        m_checkpoint = pDoc->get_checkpoint_data(m_pSnapshot);
+}
+
+//---------------------------------------------------------------------------------------
+void DocCommand::unpack_checkpoint()
+{
+    if (!m_packed.empty())
+    {
+        m_checkpoint = get_checkpoint_source();
+        string().swap(m_packed);
+        m_pDeltaBase = nullptr;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+size_t DocCommand::get_checkpoint_memory()
+{
+    size_t bytes = m_checkpoint.capacity() + m_packed.capacity();
+    if (m_pSnapshot)
+        bytes += m_pSnapshot->get_memory_size();
+    return bytes;
+}
+
 //---------------------------------------------------------------------------------------
 void DocCommand::log_command(ostream &logger)
 {
@@ -298,6 +625,7 @@ void DocCmdComposite::update_selection(SelectionSet* pSelection,
 //=======================================================================================
 DocCommandExecuter::DocCommandExecuter(Document* target)
     : m_pDoc(target)
+    , m_budget(0)
 {
 }
 
@@ -323,9 +651,16 @@ int DocCommandExecuter::execute(DocCursor* pCursor, DocCommand* pCmd,
 
         result = pCmd->perform_action(m_pDoc, pCursor);
         m_error = pCmd->get_error();
+        save_dirty_ids();
         if ( result == k_success && pCmd->is_reversible())
         {
+            //redo history is going to be deleted. The last command could be using a
+            //command in the redo history as base for its checkpoint
+            if (m_stack.history_size() > 0 && m_stack.top())
+                m_stack.top()->pCmd->unpack_checkpoint();
+
             m_stack.push( pUE );
+            enforce_memory_budget();
             update_cursor(pCursor, pCmd);
             update_selection(pSelection, pCmd);
             m_pDoc->set_modified();
@@ -431,6 +766,95 @@ void DocCommandExecuter::update_selection(SelectionSet* pSelection, DocCommand*
     }
 }
 
+//---------------------------------------------------------------------------------------
+void DocCommandExecuter::save_dirty_ids(bool fKnown)
+{
+    //Collect the ids of the objects marked as dirty by the command and reset the
+    //dirty flags, so that next command only reports its own modifications. When the
+    //modified objects are not known (e.g. they have been replaced) k_no_imoid is
+    //saved to inform that the whole document must be considered modified.
+
+    ImoDocument* pImoDoc = m_pDoc->get_im_root();
+    if (!pImoDoc)
+        return;
+
+    if (fKnown)
+        pImoDoc->clear_dirty(&m_dirtyIds);
+    else
+    {
+        pImoDoc->clear_dirty();
+        m_dirtyIds.push_back(k_no_imoid);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void DocCommandExecuter::pack_checkpoints()
+{
+    //Compress the checkpoints of all commands in the undo history, except the last
+    //one. Snapshots are replaced by their source code, to be compressed. The
+    //checkpoints of consecutive commands for the same object are saved as deltas: each
+    //one is saved as its differences with the checkpoint of the next command, so
+    //commands are packed from oldest to newest, while the base is not yet packed. To
+    //limit the time for unpacking old checkpoints, a full checkpoint is saved after
+    //k_max_deltas consecutive deltas.
+
+    const int k_max_deltas = 8;
+
+    const list<UndoElement*>& items = m_stack.get_items();
+    if (items.size() < 2)
+        return;
+
+    int numDeltas = 0;
+    list<UndoElement*>::const_iterator itLast = --items.end();
+    list<UndoElement*>::const_iterator it;
+    for (it = items.begin(); it != itLast; ++it)
+    {
+        DocCommand* pCmd = (*it)->pCmd;
+        if (!pCmd->is_checkpoint_packed())
+        {
+            list<UndoElement*>::const_iterator itNext = it;
+            DocCommand* pBase = (numDeltas < k_max_deltas ? (*(++itNext))->pCmd : nullptr);
+            pCmd->pack_checkpoint(m_pDoc, pBase);
+        }
+        numDeltas = (pCmd->is_checkpoint_delta() ? numDeltas + 1 : 0);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void DocCommandExecuter::enforce_memory_budget()
+{
+    //When the undo history exceeds the memory budget, compress the checkpoints and,
+    //if not enough, remove the oldest undo elements. No other command uses the oldest
+    //one as base for its checkpoint.
+
+    if (m_budget == 0 || get_undo_memory_size() <= m_budget)
+        return;
+
+    pack_checkpoints();
+
+    while (m_stack.size() > 1 && get_undo_memory_size() > m_budget)
+        m_stack.remove_oldest();
+}
+
+//---------------------------------------------------------------------------------------
+void DocCommandExecuter::set_undo_memory_budget(size_t bytes)
+{
+    m_budget = bytes;
+    enforce_memory_budget();
+}
+
+//---------------------------------------------------------------------------------------
+size_t DocCommandExecuter::get_undo_memory_size()
+{
+    size_t bytes = 0;
+    list<UndoElement*>::const_iterator it;
+    for (it = m_stack.get_items().begin(); it != m_stack.get_items().end(); ++it)
+        bytes += (*it)->pCmd->get_checkpoint_memory();
+    for (it = m_stack.get_history().begin(); it != m_stack.get_history().end(); ++it)
+        bytes += (*it)->pCmd->get_checkpoint_memory();
+    return bytes;
+}
+
 //---------------------------------------------------------------------------------------
 void DocCommandExecuter::undo(DocCursor* pCursor, SelectionSet* pSelection)
 {
@@ -440,6 +864,9 @@ void DocCommandExecuter::undo(DocCursor* pCursor, SelectionSet* pSelection)
         DocCommand* cmd = pUE->pCmd;
         cmd->undo_action(m_pDoc, pCursor);
 
+        //undo based on checkpoints replaces the modified objects
+        save_dirty_ids(cmd->get_undo_policy() == DocCommand::k_undo_policy_specific);
+
         pCursor->restore_state( pUE->cursorState );
         pSelection->restore_state( pUE->selState );
 
@@ -458,6 +885,7 @@ void DocCommandExecuter::redo(DocCursor* pCursor, SelectionSet* pSelection)
         pSelection->restore_state( pUE->selState );
         DocCommand* cmd = pUE->pCmd;
         cmd->perform_action(m_pDoc, pCursor);
+        save_dirty_ids();
 
         update_cursor(pCursor, cmd);
         update_selection(pSelection, cmd);
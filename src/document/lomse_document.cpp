@@ -42,6 +42,7 @@
 #include "lomse_mnx_compiler.h"
 #include "lomse_injectors.h"
 #include "lomse_id_assigner.h"
+#include "lomse_im_snapshot.h"
 #include "lomse_ldp_exporter.h"
 #include "lomse_lmd_exporter.h"
 #include "lomse_model_builder.h"
@@ -287,6 +288,48 @@ int Document::replace_object_from_checkpoint_data(ImoId id, const string& data)
     return 0;
 }
 
+//---------------------------------------------------------------------------------------
+void Document::from_snapshot(ImSnapshot* pSnapshot)
+{
+    //delete old internal model
+    delete m_pImoDoc;
+    m_pImoDoc = nullptr;
+    m_flags = k_dirty;
+
+    //reset IdAssigner
+    m_pIdAssigner->reset();
+
+    //restore the internal model, preserving ids, and build it
+    set_imo_doc( static_cast<ImoDocument*>( pSnapshot->restore(this, m_pIdAssigner) ) );
+    ModelBuilder builder;
+    builder.build_model(m_pImoDoc);
+}
+
+//---------------------------------------------------------------------------------------
+void Document::replace_object_from_snapshot(ImoId id, ImSnapshot* pSnapshot)
+{
+    //object to replace
+    ImoObj* pOldImo = get_pointer_to_imo(id);
+    ImoObj* pParent = pOldImo->get_parent();
+
+    //new object. Ids are the same than those of the old objects. Therefore, they
+    //can not be registered until the old object is deleted
+    IdAssigner assigner;
+    ImoObj* pNewImo = pSnapshot->restore(this, &assigner);
+
+    //replace old object
+    ImoObj::depth_first_iterator it(pOldImo);
+    pParent->replace_node(it, pNewImo);
+    delete pOldImo;
+
+    //add new ids
+    assigner.copy_ids_to(m_pIdAssigner, k_no_imoid);
+
+    ModelBuilder builder;
+    builder.structurize(pNewImo);
+    pNewImo->set_dirty(true);
+}
+
 //---------------------------------------------------------------------------------------
 int Document::from_input(LdpReader& reader)
 {
@@ -369,7 +412,24 @@ string Document::get_checkpoint_data_for(ImoId id)
 {
     ImoObj* pImo = get_pointer_to_imo(id);
     //TODO: check that ImoObj is a terminal node?
+    return export_checkpoint_data(pImo);
+}
+
+//---------------------------------------------------------------------------------------
+string Document::get_checkpoint_data(ImSnapshot* pSnapshot)
+{
+    //source code for the subtree saved in the snapshot. It is the same than the
+    //checkpoint data for the subtree when the snapshot was taken. The saved subtree
+    //is not structurized, but exporters need the staffobjs table
+    ImoObj* pRoot = pSnapshot->get_root();
+    ModelBuilder builder;
+    builder.structurize_subtree(pRoot);
+    return export_checkpoint_data(pRoot);
+}
 
+//---------------------------------------------------------------------------------------
+string Document::export_checkpoint_data(ImoObj* pImo)
+{
     LmdExporter exporter(m_libraryScope);
     //exporter.set_remove_newlines(true);   //TODO: Commented out to facilitate debugging
     exporter.set_add_id(true);
@@ -383,6 +443,19 @@ string Document::get_checkpoint_data_for(ImoId id)
         //return exporter.get_source(m_pImo);
 }
 
+//---------------------------------------------------------------------------------------
+ImSnapshot* Document::get_snapshot()
+{
+    return get_snapshot_for( m_pImoDoc->get_id() );
+}
+
+//---------------------------------------------------------------------------------------
+ImSnapshot* Document::get_snapshot_for(ImoId id)
+{
+    //returns nullptr if the object can not be saved in a snapshot
+    return ImSnapshot::capture( get_pointer_to_imo(id) );
+}
+
 //---------------------------------------------------------------------------------------
 Compiler* Document::get_compiler_for_format(int format)
 {
@@ -0,0 +1,95 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2020. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+//---------------------------------------------------------------------------------------
+
+#include "lomse_export_sink.h"
+
+using namespace std;
+
+namespace lomse
+{
+
+//=======================================================================================
+// ExportSink implementation
+//=======================================================================================
+ExportSink::ExportSink(string& buffer)
+    : m_pBuffer(&buffer)
+    , m_pTarget(nullptr)
+    , m_numWritten(0)
+{
+}
+
+//---------------------------------------------------------------------------------------
+ExportSink::ExportSink(ostream& out)
+    : m_pBuffer(nullptr)
+    , m_pTarget(out.rdbuf())
+    , m_numWritten(0)
+{
+}
+
+//---------------------------------------------------------------------------------------
+ExportSink::int_type ExportSink::overflow(int_type c)
+{
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+        char ch = traits_type::to_char_type(c);
+        write(&ch, 1);
+    }
+    return traits_type::not_eof(c);
+}
+
+//---------------------------------------------------------------------------------------
+streamsize ExportSink::xsputn(const char* s, streamsize n)
+{
+    write(s, size_t(n));
+    return n;
+}
+
+//---------------------------------------------------------------------------------------
+void ExportSink::write(const char* s, size_t n)
+{
+    if (n == 0)
+        return;
+
+    if (!m_pending.empty())
+    {
+        string pending;
+        pending.swap(m_pending);
+        write(pending.data(), pending.size());
+    }
+
+    if (m_pBuffer)
+        m_pBuffer->append(s, n);
+    else if (m_pTarget)
+        m_pTarget->sputn(s, streamsize(n));
+
+    m_numWritten += n;
+}
+
+
+}   //namespace lomse
@@ -35,6 +35,7 @@
 #include "lomse_im_note.h"
 #include "lomse_staffobjs_table.h"
 #include "lomse_logger.h"
+#include "lomse_export_sink.h"
 
 #include <sstream>
 using namespace std;
@@ -49,18 +50,19 @@ class LdpGenerator
 {
 protected:
     LdpExporter* m_pExporter;
-    stringstream m_source;
+    ostream& m_source;          //the exporter output
     bool m_fAddSpace;           //add space when opening new element
 
 public:
     LdpGenerator(LdpExporter* pExporter, bool fSpaceNeeded=false)
         : m_pExporter(pExporter)
+        , m_source( pExporter->get_output_stream() )
         , m_fAddSpace(fSpaceNeeded)
     {
     }
     virtual ~LdpGenerator() {}
 
-    virtual string generate_source(ImoObj* pParent=nullptr) = 0;
+    virtual void generate_source(ImoObj* pParent=nullptr) = 0;
 
 protected:
     void start_element(const string& name, ImoId id, bool fInNewLine=true);
@@ -83,11 +85,13 @@ protected:
     void source_for_base_imobj(ImoObj* pImo);
     void source_for_auxobj(ImoObj* pImo);
     void source_for_relobj(ImoObj* pImo, ImoObj* pParent);
+    size_t start_optional_source();
+    void end_optional_source(size_t written);
 
     void increment_indent();
     void decrement_indent();
 
-    void add_duration(stringstream& source, int noteType, int dots);
+    void add_duration(ostream& source, int noteType, int dots);
     void add_visible(bool fVisible);
     void add_color_if_not_black(Color color);
     void add_location_if_not_zero(Tenths x, Tenths y);
@@ -128,11 +132,10 @@ public:
         //m_pObj = static_cast<ImoXXXXX*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         //start_element("xxxxx", m_pObj->get_id());
         end_element();
-        return m_source.str();
     }
 };
 
@@ -149,14 +152,13 @@ public:
         m_pObj = static_cast<ImoArticulationSymbol*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         start_articulation();
         if (m_pObj->is_accent() || m_pObj->is_stress())
             add_placement( m_pObj->get_placement() );
         source_for_base_scoreobj(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -326,14 +328,13 @@ public:
         m_pObj = static_cast<ImoBarline*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         start_element("barline", m_pObj->get_id());
         add_barline_type_and_middle();
         source_for_staffobj_options(m_pObj);
         source_for_attachments(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -375,7 +376,7 @@ public:
     {
     }
 
-    string generate_source(ImoObj* pParent=nullptr) override
+    void generate_source(ImoObj* pParent=nullptr) override
     {
         m_pNR = static_cast<ImoNoteRest*>( pParent );
 
@@ -390,34 +391,32 @@ public:
         if (!fSkip)
         {
             if ( m_pNR == m_pRO->get_start_object() )
-                return source_for_first();
+                source_for_first();
             else if ( m_pNR == m_pRO->get_end_object() )
-                return source_for_last();
+                source_for_last();
             else
-                return source_for_middle();
+                source_for_middle();
         }
-        return m_source.str();
     }
 
 protected:
 
-    string source_for_first()
+    void source_for_first()
     {
         start_element("beam", m_pRO->get_id(), k_in_same_line);
         add_beam_number();
         add_segments_info();
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
-    string source_for_middle()
+    void source_for_middle()
     {
-        return source_for_first();
+        source_for_first();
     }
 
-    string source_for_last()
+    void source_for_last()
     {
-        return source_for_first();
+        source_for_first();
     }
 
     void add_beam_number()
@@ -461,7 +460,7 @@ public:
         m_pObj = static_cast<ImoClef*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         start_element("clef", m_pObj->get_id());
         add_type();
@@ -469,7 +468,6 @@ public:
         source_for_staffobj_options(m_pObj);
         source_for_attachments(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -511,12 +509,11 @@ public:
         m_pObj = static_cast<ImoContentObj*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         add_user_location();
         add_attachments();
         source_for_base_imobj(m_pObj);
-        return m_source.str();
     }
 
 protected:
@@ -587,13 +584,12 @@ public:
         m_pObj = static_cast<ImoStyle*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         start_element("defineStyle", k_no_imoid, k_in_new_line);
         add_name();
         add_properties();
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -865,21 +861,23 @@ public:
         m_pObj = static_cast<ImoDirection*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         if (m_pObj->has_attachments() || m_pObj->get_num_relations() > 0)
             start_element("dir", m_pObj->get_id());
         else if (m_pObj->get_width() > 0.0f)
             start_element("spacer", m_pObj->get_id());
         else
-            return string("(dir unknown)");
+        {
+            m_source << "(dir unknown)";
+            return;
+        }
 
         add_space_width();
         add_spanners();
         source_for_staffobj_options(m_pObj);
         source_for_attachments(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -918,7 +916,7 @@ public:
         m_pObj = static_cast<ImoDynamicsMark*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         start_element("dyn", m_pObj->get_id());
         add_dynamics_string();
@@ -926,7 +924,6 @@ public:
         add_placement( m_pObj->get_placement() );
         source_for_base_scoreobj(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -951,14 +948,13 @@ public:
     {
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         start_element("TODO: ", m_pImo->get_id());
         m_source << " No LdpGenerator for Imo. Imo name=" << m_pImo->get_name()
                  << ", Imo type=" << m_pImo->get_obj_type()
                  << ", id=" << m_pImo->get_id();
         end_element(k_in_same_line);
-        return m_source.str();
     }
 };
 
@@ -974,14 +970,13 @@ public:
         m_pObj = static_cast<ImoFermata*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         start_element("fermata", m_pObj->get_id());
         add_symbol();
         add_placement( m_pObj->get_placement() );
         source_for_base_scoreobj(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -1029,9 +1024,8 @@ public:
         m_pObj = pImo;
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
-        return m_source.str();
     }
 };
 
@@ -1049,7 +1043,7 @@ public:
 
     //TODO: This exporter must generate 2.0 code. Therefore, it is invalid to generate
     // goBack. Instead must convert it to 2.0
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         empty_line();
         bool fFwd = m_pObj->is_forward();
@@ -1057,7 +1051,6 @@ public:
         add_time(fFwd);
         source_for_base_staffobj(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -1091,7 +1084,7 @@ public:
         m_pObj = static_cast<ImoInstrument*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         start_element("instrument", m_pObj->get_id());
         add_part_id();
@@ -1100,7 +1093,6 @@ public:
         add_sound_info();
         add_music_data();
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -1270,7 +1262,7 @@ public:
         m_pObj = static_cast<ImoKeySignature*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         start_element("key", m_pObj->get_id());
 
@@ -1278,7 +1270,6 @@ public:
         source_for_staffobj_options(m_pObj);
         source_for_attachments(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -1304,7 +1295,7 @@ public:
         m_pObj = static_cast<ImoDocument*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         start_element("lenmusdoc", m_pObj->get_id());
         m_source << " ";
@@ -1312,7 +1303,6 @@ public:
         add_comment();
         add_content();
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -1368,7 +1358,7 @@ public:
         m_pObj = static_cast<ImoLyric*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         start_element("lyric", m_pObj->get_id());
         add_lyric_number();
@@ -1377,7 +1367,6 @@ public:
         add_placement( m_pObj->get_placement() );
         source_for_base_scoreobj(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -1429,13 +1418,12 @@ public:
         m_pScore = pExporter->get_current_score();
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         start_element("musicData", m_pObj->get_id());
         space_needed();
         add_staffobjs();
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -1773,14 +1761,13 @@ public:
         m_pImo = static_cast<ImoMetronomeMark*>( pImo );
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         start_element("metronome", m_pImo->get_id());
         add_marks();
         add_parenthesis();
         source_for_print_options(m_pImo);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -1839,7 +1826,7 @@ public:
         m_pObj = static_cast<ImoNote*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         if (m_pObj->is_start_of_chord())
         {
@@ -1872,7 +1859,6 @@ public:
             m_pExporter->set_processing_chord(false);
         }
 
-        return m_source.str();
     }
 
 protected:
@@ -1967,7 +1953,7 @@ protected:
                 if (pAO->is_lyric())
                 {
                     add_space_if_needed();
-                    m_source << m_pExporter->get_source(pAO);
+                    m_pExporter->add_source(pAO);
                 }
             }
         }
@@ -2001,12 +1987,11 @@ public:
         m_pObj = static_cast<ImoScoreObj*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         add_user_location();
         add_visible( m_pObj->is_visible() );
         add_color_if_not_black( m_pObj->get_color() );
-        return m_source.str();
     }
 
 protected:
@@ -2041,14 +2026,13 @@ public:
         m_pObj = static_cast<ImoRest*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         if (is_rest())
             generate_rest();
         else
             generate_go_fwd();
 
-        return m_source.str();
     }
 
 protected:
@@ -2101,7 +2085,7 @@ public:
         m_pObj = static_cast<ImoScoreLine*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         start_element("line", m_pObj->get_id());
         add_start_point();
@@ -2112,7 +2096,6 @@ public:
         add_cap("lineCapStart", m_pObj->get_start_cap());
         add_cap("lineCapEnd", m_pObj->get_end_cap());
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -2215,12 +2198,11 @@ public:
         m_pObj = static_cast<ImoScoreObj*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         add_visible( m_pObj->is_visible() );
         add_color_if_not_black( m_pObj->get_color() );
         source_for_base_contentobj(m_pObj);
-        return m_source.str();
     }
 
 };
@@ -2237,7 +2219,7 @@ public:
         m_pObj = static_cast<ImoScoreText*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         start_element("text", m_pObj->get_id());
         add_text();
@@ -2245,7 +2227,6 @@ public:
         add_location_if_not_zero(m_pObj->get_user_location_x(),
                                  m_pObj->get_user_location_y());
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -2273,7 +2254,7 @@ public:
     {
     }
 
-    string generate_source(ImoObj* pParent =nullptr) override
+    void generate_source(ImoObj* pParent =nullptr) override
     {
         m_pNote = static_cast<ImoNote*>( pParent );
 
@@ -2288,7 +2269,6 @@ public:
         add_bezier_info(pInfo);
 
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -2355,12 +2335,11 @@ public:
         m_pObj = static_cast<ImoStaffObj*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         add_staff_num();
         add_relobjs();
         source_for_base_scoreobj(m_pObj);
-        return m_source.str();
     }
 
 protected:
@@ -2423,11 +2402,10 @@ public:
         m_pObj = static_cast<ImoStaffObj*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         add_staff_num();
         source_for_print_options(m_pObj);
-        return m_source.str();
     }
 
 protected:
@@ -2460,11 +2438,10 @@ public:
         m_pImo = static_cast<ImoSystemBreak*>( pImo );
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         start_element("newSystem", m_pImo->get_id());
         end_element(k_in_same_line);
-        return m_source.str();
     }
 };
 
@@ -2483,7 +2460,7 @@ public:
     {
     }
 
-    string generate_source(ImoObj* pParent=nullptr) override
+    void generate_source(ImoObj* pParent=nullptr) override
     {
         m_pNote = static_cast<ImoNote*>( pParent );
 
@@ -2493,7 +2470,6 @@ public:
         add_tie_type(fStart);
         add_bezier_info(fStart);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -2565,14 +2541,13 @@ public:
         m_pObj = static_cast<ImoTimeSignature*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         start_element("time", m_pObj->get_id());
         add_content();
         source_for_staffobj_options(m_pObj);
         source_for_attachments(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -2607,7 +2582,7 @@ public:
         m_pObj = static_cast<ImoScoreTitle*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         start_element("title", m_pObj->get_id());
         add_text();
@@ -2615,7 +2590,6 @@ public:
         add_location_if_not_zero(m_pObj->get_user_location_x(),
                                  m_pObj->get_user_location_y());
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -2642,7 +2616,7 @@ public:
     {
     }
 
-    string generate_source(ImoObj* pParent=nullptr) override
+    void generate_source(ImoObj* pParent=nullptr) override
     {
         m_pNR = static_cast<ImoNoteRest*>( pParent );
 
@@ -2667,7 +2641,6 @@ public:
         {
             m_source.clear();
         }
-        return m_source.str();
     }
 
 protected:
@@ -2752,7 +2725,7 @@ public:
         m_pObj = static_cast<ImoTranspose*>(pImo);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         start_element("transpose", m_pObj->get_id());
         m_source << " " << m_pObj->get_applicable_staff();
@@ -2769,7 +2742,6 @@ public:
 
         source_for_attachments(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -2790,7 +2762,7 @@ public:
         pExporter->set_current_score(m_pObj);
     }
 
-    string generate_source(ImoObj* UNUSED(pParent) =nullptr) override
+    void generate_source(ImoObj* UNUSED(pParent) =nullptr) override
     {
         //TODO: commented elements
 
@@ -2807,7 +2779,6 @@ public:
         add_parts();
         add_instruments();
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -2850,7 +2821,7 @@ protected:
 //                ))
             {
                 DefineStyleLdpGenerator gen(it->second, m_pExporter, is_space_needed());
-                m_source << gen.generate_source();
+                gen.generate_source();
             }
         }
     }
@@ -2862,7 +2833,7 @@ protected:
         for (it = titles.begin(); it != titles.end(); ++it)
         {
             TitleLdpGenerator gen(*it, m_pExporter, is_space_needed());
-            m_source << gen.generate_source();
+            gen.generate_source();
         }
     }
 
@@ -3138,7 +3109,7 @@ void LdpGenerator::new_line()
 void LdpGenerator::add_source_for(ImoObj* pImo)
 {
     add_space_if_needed();
-    m_source << m_pExporter->get_source(pImo);
+    m_pExporter->add_source(pImo);
 }
 
 //---------------------------------------------------------------------------------------
@@ -3167,23 +3138,17 @@ void LdpGenerator::source_for_noterest_options(ImoNoteRest* pNR)
             if (pRO->is_tuplet() )
             {
                 TupletLdpGenerator gen(pRO, m_pExporter);
-                string src = gen.generate_source(pNR);
-                if (!src.empty())
-                {
-                    add_space_if_needed();
-                    m_source << src;
-                }
+                size_t written = start_optional_source();
+                gen.generate_source(pNR);
+                end_optional_source(written);
             }
 
             else if (pRO->is_beam() )
             {
                 BeamLdpGenerator gen(pRO, m_pExporter);
-                string src = gen.generate_source(pNR);
-                if (!src.empty())
-                {
-                    add_space_if_needed();
-                    m_source << src;
-                }
+                size_t written = start_optional_source();
+                gen.generate_source(pNR);
+                end_optional_source(written);
             }
         }
     }
@@ -3195,7 +3160,7 @@ void LdpGenerator::source_for_staffobj_options(ImoStaffObj* pSO)
 //@ <staffObjOptions> = { <staffNum> | <printOptions> }
 
     StaffObjOptionsLdpGenerator gen(pSO, m_pExporter, is_space_needed());
-    m_source << gen.generate_source();
+    gen.generate_source();
 }
 
 //---------------------------------------------------------------------------------------
@@ -3204,7 +3169,7 @@ void LdpGenerator::source_for_print_options(ImoScoreObj* pSO)
 //@ <printOptions> = { [<visible>] [<location>] [<color>] }
 
     PrintOptionsLdpGenerator gen(pSO, m_pExporter, is_space_needed());
-    m_source << gen.generate_source();
+    gen.generate_source();
 }
 
 //---------------------------------------------------------------------------------------
@@ -3227,21 +3192,21 @@ void LdpGenerator::source_for_attachments(ImoContentObj* pSO)
 void LdpGenerator::source_for_base_staffobj(ImoObj* pImo)
 {
     StaffObjLdpGenerator gen(pImo, m_pExporter, is_space_needed());
-    m_source << gen.generate_source();
+    gen.generate_source();
 }
 
 //---------------------------------------------------------------------------------------
 void LdpGenerator::source_for_base_scoreobj(ImoObj* pImo)
 {
     ScoreObjLdpGenerator gen(pImo, m_pExporter, is_space_needed());
-    m_source << gen.generate_source();
+    gen.generate_source();
 }
 
 //---------------------------------------------------------------------------------------
 void LdpGenerator::source_for_base_contentobj(ImoObj* pImo)
 {
     ContentObjLdpGenerator gen(pImo, m_pExporter, is_space_needed());
-    m_source << gen.generate_source();
+    gen.generate_source();
 }
 
 //---------------------------------------------------------------------------------------
@@ -3249,7 +3214,7 @@ void LdpGenerator::source_for_base_imobj(ImoObj* pImo)
 {
     increment_indent();
     ImObjLdpGenerator gen(pImo, m_pExporter, is_space_needed());
-    m_source << gen.generate_source();
+    gen.generate_source();
     decrement_indent();
 }
 
@@ -3259,24 +3224,41 @@ void LdpGenerator::source_for_auxobj(ImoObj* pImo)
     if (!pImo->is_lyric())
     {
         //AWARE: Lyrics are generated in note generator
-        string src = m_pExporter->get_source(pImo);
-        if (!src.empty())
-        {
-            add_space_if_needed();
-            m_source << src;
-        }
+        size_t written = start_optional_source();
+        m_pExporter->add_source(pImo);
+        end_optional_source(written);
     }
 }
 
 //---------------------------------------------------------------------------------------
 void LdpGenerator::source_for_relobj(ImoObj* pRO, ImoObj* pParent)
 {
-    string src = m_pExporter->get_source(pRO, pParent);
-    if (!src.empty())
-    {
-        add_space_if_needed();
-        m_source << src;
-    }
+    size_t written = start_optional_source();
+    m_pExporter->add_source(pRO, pParent);
+    end_optional_source(written);
+}
+
+//---------------------------------------------------------------------------------------
+size_t LdpGenerator::start_optional_source()
+{
+    //The separator space, if needed, is left pending in the sink so that it is only
+    //written if the optional element generates some source code. Returns the number
+    //of chars written before the optional element.
+
+    ExportSink* pSink = m_pExporter->get_output_sink();
+    if (m_fAddSpace)
+        pSink->add_pending(" ");
+    return pSink->get_num_written();
+}
+
+//---------------------------------------------------------------------------------------
+void LdpGenerator::end_optional_source(size_t written)
+{
+    ExportSink* pSink = m_pExporter->get_output_sink();
+    if (pSink->get_num_written() > written)
+        m_fAddSpace = false;
+    else if (m_fAddSpace)
+        pSink->remove_pending(pSink->get_pending_size() - 1);
 }
 
 //---------------------------------------------------------------------------------------
@@ -3292,7 +3274,7 @@ void LdpGenerator::decrement_indent()
 }
 
 //---------------------------------------------------------------------------------------
-void LdpGenerator::add_duration(stringstream& source, int noteType, int dots)
+void LdpGenerator::add_duration(ostream& source, int noteType, int dots)
 {
     source << " " << LdpExporter::notetype_to_string(noteType, dots);
 }
@@ -3394,6 +3376,8 @@ LdpExporter::LdpExporter(LibraryScope* pLibraryScope)
     , m_fRemoveNewlines(false)
     , m_pCurrScore(nullptr)
     , m_fProcessingChord(false)
+    , m_pSink(nullptr)
+    , m_pOut(nullptr)
 {
 }
 
@@ -3405,6 +3389,8 @@ LdpExporter::LdpExporter()
     , m_fRemoveNewlines(false)
     , m_pCurrScore(nullptr)
     , m_fProcessingChord(false)
+    , m_pSink(nullptr)
+    , m_pOut(nullptr)
 {
 }
 
@@ -3415,11 +3401,44 @@ LdpExporter::~LdpExporter()
 
 //---------------------------------------------------------------------------------------
 string LdpExporter::get_source(ImoObj* pImo, ImoObj* pParent)
+{
+    string source;
+    ExportSink sink(source);
+    export_to_sink(sink, pImo, pParent);
+    return source;
+}
+
+//---------------------------------------------------------------------------------------
+void LdpExporter::write_source(ostream& out, ImoObj* pImo, ImoObj* pParent)
+{
+    ExportSink sink(out);
+    export_to_sink(sink, pImo, pParent);
+}
+
+//---------------------------------------------------------------------------------------
+void LdpExporter::export_to_sink(ExportSink& sink, ImoObj* pImo, ImoObj* pParent)
+{
+    //AWARE: an exporter can be re-entered (i.e. a generator invoking get_source()),
+    //so previous output must be restored when finished
+    ExportSink* pPrevSink = m_pSink;
+    ostream* pPrevOut = m_pOut;
+
+    ostream out(&sink);
+    m_pSink = &sink;
+    m_pOut = &out;
+
+    add_source(pImo, pParent);
+
+    m_pSink = pPrevSink;
+    m_pOut = pPrevOut;
+}
+
+//---------------------------------------------------------------------------------------
+void LdpExporter::add_source(ImoObj* pImo, ImoObj* pParent)
 {
     LdpGenerator* pGen = new_generator(pImo);
-    string source = pGen->generate_source(pParent);
+    pGen->generate_source(pParent);
     delete pGen;
-    return source;
 }
 
 //---------------------------------------------------------------------------------------
@@ -37,6 +37,7 @@
 #include "lomse_mnx_exporter.h"
 #include "lomse_logger.h"
 #include "lomse_time.h"
+#include "lomse_export_sink.h"
 
 #include <stack>
 using namespace std;
@@ -51,7 +52,7 @@ class LmdGenerator
 {
 protected:
     LmdExporter* m_pExporter;
-    stringstream m_source;
+    ostream& m_source;          //the exporter output
     bool m_fTagOpen;
     stack<string> m_openTags;
 
@@ -59,7 +60,7 @@ public:
     LmdGenerator(LmdExporter* pExporter);
     virtual ~LmdGenerator() {}
 
-    virtual string generate_source() = 0;
+    virtual void generate_source() = 0;
 
 protected:
     void start_element(const string& name, ImoObj* pImo);
@@ -84,7 +85,7 @@ protected:
     void increment_indent();
     void decrement_indent();
 
-    void add_duration(stringstream& source, int noteType, int dots);
+    void add_duration(ostream& source, int noteType, int dots);
     void add_optional_style(ImoContentObj* pObj);
 
 };
@@ -111,12 +112,11 @@ public:
         //m_pObj = static_cast<ImoXXXXX*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         //start_element("xxxxx", m_pObj);
         close_start_tag();
         end_element();
-        return m_source.str();
     }
 };
 
@@ -133,14 +133,13 @@ public:
         m_pObj = static_cast<ImoBarline*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         start_element("barline", m_pObj);
         close_start_tag();
         add_barline_type();
         source_for_base_staffobj(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -165,14 +164,13 @@ public:
         m_pObj = static_cast<ImoClef*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         start_element("clef", m_pObj);
         close_start_tag();
         add_type();
         source_for_base_staffobj(m_pObj);
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -197,7 +195,7 @@ public:
         m_pObj = static_cast<ImoContent*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         start_element("content", m_pObj);
         add_optional_style(m_pObj);
@@ -206,7 +204,6 @@ public:
         add_contained_objects();
 
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -235,7 +232,7 @@ public:
         m_pObj = static_cast<ImoControl*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         start_element("control", m_pObj);
         add_optional_style(m_pObj);
@@ -245,7 +242,6 @@ public:
         //add_contained_objects();
 
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -274,12 +270,11 @@ public:
         m_pObj = static_cast<ImoContentObj*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         add_user_location();
         add_attachments();
         source_for_base_imobj(m_pObj);
-        return m_source.str();
     }
 
 protected:
@@ -364,14 +359,13 @@ public:
         m_pObj = static_cast<ImoStyle*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         start_element("defineStyle", m_pObj);
         close_start_tag();
         add_name();
         add_properties();
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -661,7 +655,7 @@ public:
         m_pObj = static_cast<ImoDynamic*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         start_element("dynamic", m_pObj);
         add_optional_style(m_pObj);
@@ -670,7 +664,6 @@ public:
         add_contained_objects();
 
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -700,7 +693,7 @@ public:
     {
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         start_element("TODO", m_pImo);
         close_start_tag();
@@ -708,7 +701,6 @@ public:
                  << ", Imo type=" << m_pImo->get_obj_type()
                  << ", id=" << m_pImo->get_id();
         end_element(k_in_same_line);
-        return m_source.str();
     }
 };
 
@@ -725,9 +717,8 @@ public:
         m_pObj = pImo;
     }
 
-    string generate_source() override
+    void generate_source() override
     {
-        return m_source.str();
     }
 };
 
@@ -744,7 +735,7 @@ public:
         m_pObj = static_cast<ImoInstrument*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         start_element("instrument", m_pObj);
         close_start_tag();
@@ -753,7 +744,6 @@ public:
         add_name_abbreviation();
         add_music_data();
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -808,14 +798,13 @@ public:
         m_pObj = static_cast<ImoKeySignature*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         start_element("key", m_pObj);
         close_start_tag();
         add_key_type();
 
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -873,7 +862,7 @@ public:
         m_pObj = static_cast<ImoDocument*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         m_source << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
         start_element("lenmusdoc", m_pObj);
@@ -890,7 +879,6 @@ public:
         add_content();
 
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -942,14 +930,13 @@ public:
         m_pObj = static_cast<ImoMusicData*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         start_element("musicData", m_pObj);
         close_start_tag();
         add_staffobjs();
         empty_line();
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -1079,7 +1066,7 @@ public:
         m_pObj = static_cast<ImoNote*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         start_element("note", m_pObj);
         close_start_tag();
@@ -1087,7 +1074,6 @@ public:
         add_duration(m_source, m_pObj->get_note_type(), m_pObj->get_dots());
         source_for_base_staffobj(m_pObj);
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -1144,7 +1130,7 @@ public:
         m_pObj = static_cast<ImoParagraph*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         start_element("para", m_pObj);
         add_optional_style(m_pObj);
@@ -1153,7 +1139,6 @@ public:
         add_inline_objects();
 
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -1185,14 +1170,13 @@ public:
         m_pObj = static_cast<ImoRest*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         start_element("rest", m_pObj);
         close_start_tag();
         add_duration(m_source, m_pObj->get_note_type(), m_pObj->get_dots());
         source_for_base_staffobj(m_pObj);
         end_element();
-        return m_source.str();
     }
 
 };
@@ -1210,19 +1194,23 @@ public:
         m_pObj = static_cast<ImoScore*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         int format = m_pExporter->get_score_format();
         switch(format)
         {
             case LmdExporter::k_format_ldp:
-                return generate_ldp();
+                generate_ldp();
+                break;
             case LmdExporter::k_format_lmd:
-                return generate_lmd();
+                generate_lmd();
+                break;
             case LmdExporter::k_format_musicxml:
-                return generate_musicxml();
+                generate_musicxml();
+                break;
             case LmdExporter::k_format_mnx:
-                return generate_mnx();
+                generate_mnx();
+                break;
             default:
             {
                 stringstream s;
@@ -1236,7 +1224,7 @@ public:
 
 protected:
 
-    string generate_ldp()
+    void generate_ldp()
     {
         start_element("ldpmusic", nullptr);
         close_start_tag();
@@ -1244,20 +1232,19 @@ protected:
         LdpExporter exporter;
         exporter.set_indent( m_pExporter->get_indent() );
         exporter.set_add_id( m_pExporter->get_add_id() );
-        m_source << exporter.get_source(m_pObj);
+        exporter.write_source(m_source, m_pObj);
 
         end_element();
-        return m_source.str();
     }
 
-    string generate_musicxml()
+    void generate_musicxml()
     {
 //        start_element("musicxml", m_pObj);
 //        close_start_tag();
 //
 //        MusicXmlExporter exporter;
 //        exporter.set_indent( m_pExporter->get_indent() );
-//        m_source << exporter.get_source(m_pObj);
+//        exporter.write_source(m_source, m_pObj);
 //
 //        end_element();
 
@@ -1265,10 +1252,9 @@ protected:
         start_element("TODO: MusicXml exporter", m_pObj);
         close_start_tag();
         end_element();
-        return m_source.str();
     }
 
-    string generate_lmd()
+    void generate_lmd()
     {
         start_element("score", m_pObj);
         close_start_tag();
@@ -1283,10 +1269,9 @@ protected:
         add_options();
         add_instruments_and_groups();
         end_element();
-        return m_source.str();
     }
 
-    string generate_mnx()
+    void generate_mnx()
     {
         start_element("mnx-music", nullptr);
         close_start_tag();
@@ -1294,10 +1279,9 @@ protected:
         MnxExporter exporter( m_pExporter->get_library_scope() );
         exporter.set_indent( m_pExporter->get_indent() );
         //exporter.set_add_id( m_pExporter->get_add_id() );
-        m_source << exporter.get_source(m_pObj);
+        exporter.write_source(m_source, m_pObj);
 
         end_element();
-        return m_source.str();
     }
 
     void add_version()
@@ -1441,12 +1425,11 @@ public:
         m_pObj = static_cast<ImoScoreObj*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         add_visible();
         add_color();
         source_for_base_contentobj(m_pObj);
-        return m_source.str();
     }
 
 protected:
@@ -1479,7 +1462,7 @@ public:
         m_pObj = static_cast<ImoHeading*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         start_element("section", m_pObj);
         add_level();
@@ -1487,7 +1470,6 @@ public:
         close_start_tag();
         add_inline_objects();
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -1524,13 +1506,12 @@ public:
         m_pObj = static_cast<ImoDirection*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         start_element("spacer", m_pObj);
         close_start_tag();
         //TODO: details
         end_element(k_in_same_line);
-        return m_source.str();
     }
 };
 
@@ -1547,11 +1528,10 @@ public:
         m_pObj = static_cast<ImoStaffObj*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         add_staff_num();
         source_for_base_scoreobj(m_pObj);
-        return m_source.str();
     }
 
 protected:
@@ -1586,7 +1566,7 @@ public:
         m_pObj = static_cast<ImoStyles*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         if (there_is_any_non_default_style())
         {
@@ -1595,9 +1575,7 @@ public:
             add_styles();
             end_element();
             empty_line();
-            return m_source.str();
         }
-        return "";
     }
 
 protected:
@@ -1638,6 +1616,7 @@ protected:
 //=======================================================================================
 LmdGenerator::LmdGenerator(LmdExporter* pExporter)
     : m_pExporter(pExporter)
+    , m_source( pExporter->get_output_stream() )
     , m_fTagOpen(false)
 {
 }
@@ -1736,28 +1715,28 @@ void LmdGenerator::new_line()
 //---------------------------------------------------------------------------------------
 void LmdGenerator::add_source_for(ImoObj* pImo)
 {
-    m_source << m_pExporter->get_source(pImo);
+    m_pExporter->add_source(pImo);
 }
 
 //---------------------------------------------------------------------------------------
 void LmdGenerator::source_for_base_staffobj(ImoObj* pImo)
 {
     StaffObjLmdGenerator gen(pImo, m_pExporter);
-    m_source << gen.generate_source();
+    gen.generate_source();
 }
 
 //---------------------------------------------------------------------------------------
 void LmdGenerator::source_for_base_scoreobj(ImoObj* pImo)
 {
     ScoreObjLmdGenerator gen(pImo, m_pExporter);
-    m_source << gen.generate_source();
+    gen.generate_source();
 }
 
 //---------------------------------------------------------------------------------------
 void LmdGenerator::source_for_base_contentobj(ImoObj* pImo)
 {
     ContentObjLmdGenerator gen(pImo, m_pExporter);
-    m_source << gen.generate_source();
+    gen.generate_source();
 }
 
 //---------------------------------------------------------------------------------------
@@ -1765,14 +1744,14 @@ void LmdGenerator::source_for_base_imobj(ImoObj* pImo)
 {
     increment_indent();
     ImObjLmdGenerator gen(pImo, m_pExporter);
-    m_source << gen.generate_source();
+    gen.generate_source();
     decrement_indent();
 }
 
 //---------------------------------------------------------------------------------------
 void LmdGenerator::source_for_auxobj(ImoObj* pImo)
 {
-    m_source <<  m_pExporter->get_source(pImo);
+    m_pExporter->add_source(pImo);
 }
 
 //---------------------------------------------------------------------------------------
@@ -1835,7 +1814,7 @@ void LmdGenerator::decrement_indent()
 }
 
 //---------------------------------------------------------------------------------------
-void LmdGenerator::add_duration(stringstream& source, int noteType, int dots)
+void LmdGenerator::add_duration(ostream& source, int noteType, int dots)
 {
     start_element("type", nullptr);
     close_start_tag();
@@ -1873,6 +1852,7 @@ LmdExporter::LmdExporter(LibraryScope& libScope)
     , m_fAddId(false)
     , m_scoreFormat(k_format_lmd)
     , m_fRemoveNewlines(false)
+    , m_pOut(nullptr)
 {
     m_lomseVersion = libScope.get_version_string();
     m_exportTime = to_simple_string(chrono::system_clock::now());
@@ -1894,11 +1874,38 @@ string LmdExporter::get_version_and_time_string()
 
 //---------------------------------------------------------------------------------------
 string LmdExporter::get_source(ImoObj* pImo)
+{
+    string source;
+    ExportSink sink(source);
+    export_to_sink(sink, pImo);
+    return source;
+}
+
+//---------------------------------------------------------------------------------------
+void LmdExporter::write_source(ostream& out, ImoObj* pImo)
+{
+    ExportSink sink(out);
+    export_to_sink(sink, pImo);
+}
+
+//---------------------------------------------------------------------------------------
+void LmdExporter::export_to_sink(ExportSink& sink, ImoObj* pImo)
+{
+    ostream* pPrevOut = m_pOut;
+    ostream out(&sink);
+    m_pOut = &out;
+
+    add_source(pImo);
+
+    m_pOut = pPrevOut;
+}
+
+//---------------------------------------------------------------------------------------
+void LmdExporter::add_source(ImoObj* pImo)
 {
     LmdGenerator* pGen = new_generator(pImo);
-    string source = pGen->generate_source();
+    pGen->generate_source();
     delete pGen;
-    return source;
 }
 
 //---------------------------------------------------------------------------------------
@@ -36,6 +36,7 @@
 #include "lomse_mnx_exporter.h"
 #include "lomse_logger.h"
 #include "lomse_time.h"
+#include "lomse_export_sink.h"
 
 #include <stack>
 using namespace std;
@@ -50,13 +51,13 @@ class MnxGenerator
 {
 protected:
     MnxExporter* m_pExporter;
-    stringstream m_source;
+    ostream& m_source;          //the exporter output
 
 public:
     MnxGenerator(MnxExporter* pExporter);
     virtual ~MnxGenerator() {}
 
-    virtual string generate_source() = 0;
+    virtual void generate_source() = 0;
 
 protected:
     void start_element(const string& name, ImoObj* pImo);
@@ -81,7 +82,7 @@ protected:
     void increment_indent();
     void decrement_indent();
 
-    void add_duration(stringstream& source, int noteType, int dots);
+    void add_duration(ostream& source, int noteType, int dots);
     void add_optional_style(ImoContentObj* pObj);
 
 };
@@ -110,12 +111,11 @@ public:
         //m_pObj = static_cast<ImoXXXXX*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         //start_element("xxxxx", m_pObj);
         close_start_tag();
         end_element();
-        return m_source.str();
     }
 };
 
@@ -132,14 +132,13 @@ public:
         m_pObj = static_cast<ImoBarline*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         start_element("barline", m_pObj);
         close_start_tag();
         add_barline_type();
         source_for_base_staffobj(m_pObj);
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -164,7 +163,7 @@ public:
         m_pObj = static_cast<ImoClef*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         if (m_pExporter->current_open_tag() != "directions")
         {
@@ -175,7 +174,6 @@ public:
         add_line_sign();
         //source_for_base_staffobj(m_pObj);
         end_element(k_in_same_line, k_add_close_tag);
-        return m_source.str();
     }
 
 protected:
@@ -207,12 +205,11 @@ public:
         m_pObj = static_cast<ImoContentObj*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         add_user_location();
         add_attachments();
         source_for_base_imobj(m_pObj);
-        return m_source.str();
     }
 
 protected:
@@ -297,14 +294,13 @@ public:
         m_pObj = static_cast<ImoStyle*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         start_element("defineStyle", m_pObj);
         close_start_tag();
         add_name();
         add_properties();
         end_element();
-        return m_source.str();
     }
 
 protected:
@@ -595,7 +591,7 @@ public:
     {
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         start_element("TODO", m_pImo);
         close_start_tag();
@@ -603,7 +599,6 @@ public:
                  << ", Imo type=" << m_pImo->get_obj_type()
                  << ", id=" << m_pImo->get_id();
         end_element(k_in_same_line);
-        return m_source.str();
     }
 };
 
@@ -620,9 +615,8 @@ public:
         m_pObj = pImo;
     }
 
-    string generate_source() override
+    void generate_source() override
     {
-        return m_source.str();
     }
 };
 
@@ -639,7 +633,7 @@ public:
         m_pObj = static_cast<ImoInstrument*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         start_element("part", m_pObj);
         close_start_tag();
@@ -649,7 +643,6 @@ public:
         add_music_data();
         end_element();
         empty_line();
-        return m_source.str();
     }
 
 protected:
@@ -704,14 +697,13 @@ public:
         m_pObj = static_cast<ImoKeySignature*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         start_element("key", m_pObj);
         close_start_tag();
         add_key_type();
 
         end_element(k_in_same_line);
-        return m_source.str();
     }
 
 protected:
@@ -769,7 +761,7 @@ public:
         m_pObj = static_cast<ImoDocument*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         m_source << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
         add_comment();
@@ -783,7 +775,6 @@ public:
         add_content();
 
         end_element();    //mnx
-        return m_source.str();
     }
 
 protected:
@@ -841,11 +832,10 @@ public:
         m_pObj = static_cast<ImoMusicData*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         add_staffobjs();
         empty_line();
-        return m_source.str();
     }
 
 protected:
@@ -990,7 +980,7 @@ public:
         m_pObj = static_cast<ImoNote*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         if (m_pExporter->current_open_tag() == "directions")
             end_element();
@@ -1024,7 +1014,6 @@ public:
             m_pExporter->set_processing_chord(false);
         }
 
-        return m_source.str();
     }
 
 protected:
@@ -1083,7 +1072,7 @@ public:
         m_pObj = static_cast<ImoRest*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         if (m_pExporter->current_open_tag() == "directions")
             end_element();
@@ -1105,7 +1094,6 @@ public:
         //source_for_base_staffobj(m_pObj);
         end_element(k_in_same_line, k_add_close_tag);
         end_element();  //event
-        return m_source.str();
     }
 
 };
@@ -1123,7 +1111,7 @@ public:
         m_pObj = static_cast<ImoScore*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         start_element("score", m_pObj);
         close_start_tag();
@@ -1137,7 +1125,6 @@ public:
         add_instruments_and_groups();
         end_element();  //cwmnx
         end_element();  //score
-        return m_source.str();
     }
 
 protected:
@@ -1273,12 +1260,11 @@ public:
         m_pObj = static_cast<ImoScoreObj*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         add_visible();
         add_color();
         source_for_base_contentobj(m_pObj);
-        return m_source.str();
     }
 
 protected:
@@ -1311,13 +1297,12 @@ public:
         m_pObj = static_cast<ImoDirection*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         start_element("spacer", m_pObj);
         close_start_tag();
         //TODO: details
         end_element(k_in_same_line);
-        return m_source.str();
     }
 };
 
@@ -1334,11 +1319,10 @@ public:
         m_pObj = static_cast<ImoStaffObj*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         add_staff_num();
         source_for_base_scoreobj(m_pObj);
-        return m_source.str();
     }
 
 protected:
@@ -1373,7 +1357,7 @@ public:
         m_pObj = static_cast<ImoStyles*>(pImo);
     }
 
-    string generate_source() override
+    void generate_source() override
     {
         if (there_is_any_non_default_style())
         {
@@ -1382,9 +1366,7 @@ public:
             add_styles();
             end_element();
             empty_line();
-            return m_source.str();
         }
-        return "";
     }
 
 protected:
@@ -1425,6 +1407,7 @@ protected:
 //=======================================================================================
 MnxGenerator::MnxGenerator(MnxExporter* pExporter)
     : m_pExporter(pExporter)
+    , m_source( pExporter->get_output_stream() )
 {
 }
 
@@ -1535,28 +1518,28 @@ void MnxGenerator::new_line()
 //---------------------------------------------------------------------------------------
 void MnxGenerator::add_source_for(ImoObj* pImo)
 {
-    m_source << m_pExporter->get_source(pImo);
+    m_pExporter->add_source(pImo);
 }
 
 //---------------------------------------------------------------------------------------
 void MnxGenerator::source_for_base_staffobj(ImoObj* pImo)
 {
     StaffObjMnxGenerator gen(pImo, m_pExporter);
-    m_source << gen.generate_source();
+    gen.generate_source();
 }
 
 //---------------------------------------------------------------------------------------
 void MnxGenerator::source_for_base_scoreobj(ImoObj* pImo)
 {
     ScoreObjMnxGenerator gen(pImo, m_pExporter);
-    m_source << gen.generate_source();
+    gen.generate_source();
 }
 
 //---------------------------------------------------------------------------------------
 void MnxGenerator::source_for_base_contentobj(ImoObj* pImo)
 {
     ContentObjMnxGenerator gen(pImo, m_pExporter);
-    m_source << gen.generate_source();
+    gen.generate_source();
 }
 
 //---------------------------------------------------------------------------------------
@@ -1564,14 +1547,14 @@ void MnxGenerator::source_for_base_imobj(ImoObj* pImo)
 {
     increment_indent();
     ImObjMnxGenerator gen(pImo, m_pExporter);
-    m_source << gen.generate_source();
+    gen.generate_source();
     decrement_indent();
 }
 
 //---------------------------------------------------------------------------------------
 void MnxGenerator::source_for_auxobj(ImoObj* pImo)
 {
-    m_source <<  m_pExporter->get_source(pImo);
+    m_pExporter->add_source(pImo);
 }
 
 //---------------------------------------------------------------------------------------
@@ -1634,7 +1617,7 @@ void MnxGenerator::decrement_indent()
 }
 
 //---------------------------------------------------------------------------------------
-void MnxGenerator::add_duration(stringstream& source, int noteType, int dots)
+void MnxGenerator::add_duration(ostream& source, int noteType, int dots)
 {
     start_attrib("value");
     switch(noteType)
@@ -1671,6 +1654,7 @@ MnxExporter::MnxExporter(LibraryScope& libScope)
     , m_fAddId(false)
     , m_fRemoveNewlines(false)
     , m_fProcessingChord(false)
+    , m_pOut(nullptr)
 {
     m_lomseVersion = libScope.get_version_string();
     m_exportTime = to_simple_string(chrono::system_clock::now());
@@ -1692,11 +1676,38 @@ string MnxExporter::get_version_and_time_string()
 
 //---------------------------------------------------------------------------------------
 string MnxExporter::get_source(ImoObj* pImo)
+{
+    string source;
+    ExportSink sink(source);
+    export_to_sink(sink, pImo);
+    return source;
+}
+
+//---------------------------------------------------------------------------------------
+void MnxExporter::write_source(ostream& out, ImoObj* pImo)
+{
+    ExportSink sink(out);
+    export_to_sink(sink, pImo);
+}
+
+//---------------------------------------------------------------------------------------
+void MnxExporter::export_to_sink(ExportSink& sink, ImoObj* pImo)
+{
+    ostream* pPrevOut = m_pOut;
+    ostream out(&sink);
+    m_pOut = &out;
+
+    add_source(pImo);
+
+    m_pOut = pPrevOut;
+}
+
+//---------------------------------------------------------------------------------------
+void MnxExporter::add_source(ImoObj* pImo)
 {
     MnxGenerator* pGen = new_generator(pImo);
-    string source = pGen->generate_source();
+    pGen->generate_source();
     delete pGen;
-    return source;
 }
 
 //---------------------------------------------------------------------------------------
@@ -44,6 +44,79 @@ using namespace std;
 namespace lomse
 {
 
+//=======================================================================================
+// minizip i/o functions for reading a zip archive held in memory
+//=======================================================================================
+static voidpf ZCALLBACK mem_open(voidpf opaque, const char* UNUSED(filename),
+                                 int UNUSED(mode))
+{
+    ZipInputStream::MemoryArchive* mem =
+        static_cast<ZipInputStream::MemoryArchive*>(opaque);
+    mem->pos = 0;
+    return opaque;
+}
+
+//---------------------------------------------------------------------------------------
+static uLong ZCALLBACK mem_read(voidpf UNUSED(opaque), voidpf stream, void* buf,
+                                uLong size)
+{
+    ZipInputStream::MemoryArchive* mem =
+        static_cast<ZipInputStream::MemoryArchive*>(stream);
+    uLong available = mem->size - mem->pos;
+    if (size > available)
+        size = available;
+    memcpy(buf, mem->data + mem->pos, size);
+    mem->pos += size;
+    return size;
+}
+
+//---------------------------------------------------------------------------------------
+static uLong ZCALLBACK mem_write(voidpf UNUSED(opaque), voidpf UNUSED(stream),
+                                 const void* UNUSED(buf), uLong UNUSED(size))
+{
+    return 0;
+}
+
+//---------------------------------------------------------------------------------------
+static long ZCALLBACK mem_tell(voidpf UNUSED(opaque), voidpf stream)
+{
+    return long( static_cast<ZipInputStream::MemoryArchive*>(stream)->pos );
+}
+
+//---------------------------------------------------------------------------------------
+static long ZCALLBACK mem_seek(voidpf UNUSED(opaque), voidpf stream, uLong offset,
+                               int origin)
+{
+    ZipInputStream::MemoryArchive* mem =
+        static_cast<ZipInputStream::MemoryArchive*>(stream);
+    uLong pos;
+    switch (origin)
+    {
+        case ZLIB_FILEFUNC_SEEK_SET:    pos = offset;               break;
+        case ZLIB_FILEFUNC_SEEK_CUR:    pos = mem->pos + offset;    break;
+        case ZLIB_FILEFUNC_SEEK_END:    pos = mem->size + offset;   break;
+        default:
+            return -1;
+    }
+    if (pos > mem->size)
+        return -1;
+    mem->pos = pos;
+    return 0;
+}
+
+//---------------------------------------------------------------------------------------
+static int ZCALLBACK mem_close(voidpf UNUSED(opaque), voidpf UNUSED(stream))
+{
+    return 0;
+}
+
+//---------------------------------------------------------------------------------------
+static int ZCALLBACK mem_error(voidpf UNUSED(opaque), voidpf UNUSED(stream))
+{
+    return 0;
+}
+
+
 //=======================================================================================
 // ZipInputStream implementation
 //=======================================================================================
@@ -68,6 +141,29 @@ ZipInputStream::ZipInputStream(const std::string& filelocator)
         m_curEntry.fEOF = true;
 }
 
+//---------------------------------------------------------------------------------------
+ZipInputStream::ZipInputStream(const char* data, size_t size)
+    : InputStream()
+    , m_fIsLastBuffer(true)
+    , m_remainingBytes(0)
+    , m_pNextChar(nullptr)
+{
+    //The zip archive is read directly from the received buffer. It is not copied
+    //and, therefore, the buffer must remain valid while this stream is in use.
+
+    if (!open_memory_archive(data, size))
+    {
+        string msg("[ZipInputStream::ZipInputStream] Invalid zip archive in memory");
+        LOMSE_LOG_ERROR(msg);
+        throw runtime_error(msg);
+    }
+
+    if (get_num_entries() != 0 && move_to_first_entry())
+        open_current_entry();
+    else
+        m_curEntry.fEOF = true;
+}
+
 //---------------------------------------------------------------------------------------
 ZipInputStream::~ZipInputStream()
 {
@@ -86,6 +182,27 @@ bool ZipInputStream::open_zip_archive(const std::string& filelocator)
     return (m_uzFile != nullptr);
 }
 
+//---------------------------------------------------------------------------------------
+bool ZipInputStream::open_memory_archive(const char* data, size_t size)
+{
+    m_memory.data = data;
+    m_memory.size = static_cast<unsigned long>(size);
+    m_memory.pos = 0;
+
+    zlib_filefunc_def functions;
+    functions.zopen_file = mem_open;
+    functions.zread_file = mem_read;
+    functions.zwrite_file = mem_write;
+    functions.ztell_file = mem_tell;
+    functions.zseek_file = mem_seek;
+    functions.zclose_file = mem_close;
+    functions.zerror_file = mem_error;
+    functions.opaque = &m_memory;
+
+    m_uzFile = unzOpen2("memory:", &functions);
+    return (m_uzFile != nullptr);
+}
+
 //---------------------------------------------------------------------------------------
 void ZipInputStream::close_zip_archive()
 {
@@ -395,6 +395,31 @@ void PartsEngraver::reposition_staves_in_engravers(const vector<LUnits>& yShifts
     }
 }
 
+//---------------------------------------------------------------------------------------
+void PartsEngraver::reset_staves_position()
+{
+    //Restores the staves position that engravers have before engraving the first
+    //system. It is required for creating again the columns after a modification.
+
+    UPoint org(0.0f, 0.0f);
+    std::vector<GroupEngraver*>::iterator itG;
+    for (itG = m_groupEngravers.begin(); itG != m_groupEngravers.end(); ++itG)
+    {
+        (*itG)->set_slice_instr_origin(org);
+    }
+
+    int numStaves = 0;
+    std::vector<InstrumentEngraver*>::iterator it;
+    for (it = m_instrEngravers.begin(); it != m_instrEngravers.end(); ++it)
+    {
+        (*it)->set_staves_horizontal_position(0.0f, 0.0f, 0.0f);
+        (*it)->set_slice_instr_origin(org);
+        numStaves += (*it)->get_num_staves();
+    }
+
+    vector<LUnits> yShifts(numStaves, 0.0f);
+    reposition_staves_in_engravers(yShifts);
+}
 
 //---------------------------------------------------------------------------------------
 // GroupEngraver implementation
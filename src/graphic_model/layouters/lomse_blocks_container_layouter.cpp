@@ -51,6 +51,8 @@ ContentLayouter::ContentLayouter(ImoContentObj* pItem, Layouter* pParent,
                                  ImoStyles* pStyles, bool fAddShapesToModel)
     : Layouter(pItem, pParent, pGModel, libraryScope, pStyles, fAddShapesToModel)
     , m_pContent( dynamic_cast<ImoContent*>(pItem) )
+    , m_iFirstItem(0)
+    , m_pFirstItemLayouter(nullptr)
 {
 }
 
@@ -61,12 +63,22 @@ void ContentLayouter::layout_in_box()
 
     set_cursor_and_available_space();
 
-    TreeNode<ImoObj>::children_iterator it;
+    TreeNode<ImoObj>::children_iterator it = m_pContent->begin();
+    for (int i=0; i < m_iFirstItem && it != m_pContent->end(); ++i)
+        ++it;
+
     int result = k_layout_success;
-    for (it = m_pContent->begin(); it != m_pContent->end(); ++it)
+    for (; it != m_pContent->end(); ++it)
     {
-        result = layout_item(static_cast<ImoContentObj*>( *it ), m_pItemMainBox, m_constrains);
-        if (result == k_layout_failed_auto_scale)
+        ImoContentObj* pItem = static_cast<ImoContentObj*>( *it );
+        if (m_pFirstItemLayouter)
+        {
+            result = resume_item_layout(m_pFirstItemLayouter, pItem, m_pItemMainBox);
+            m_pFirstItemLayouter = nullptr;
+        }
+        else
+            result = layout_item(pItem, m_pItemMainBox, m_constrains);
+        if (result == k_layout_failed_auto_scale || result == k_layout_interrupted)
             break;
     }
     set_layout_result(result);
@@ -156,7 +168,12 @@ void MultiColumnLayouter::layout_in_box()
         }
 
         //start new page if layout not finished
-        if (!fLayoutFinished)
+        if (!fLayoutFinished && must_interrupt_layout())
+        {
+            layoutResult = k_layout_interrupted;
+            break;
+        }
+        else if (!fLayoutFinished)
         {
             m_pItemMainBox = start_new_page();
             for (int i=0; i < numCols; ++i)
@@ -259,7 +276,13 @@ void BlocksContainerLayouter::layout_in_box()
     {
         ImoContentObj* pObj = dynamic_cast<ImoContentObj*>( *it );
         if (pObj)
-            layout_item(pObj, m_pItemMainBox, m_constrains);
+        {
+            if (layout_item(pObj, m_pItemMainBox, m_constrains) == k_layout_interrupted)
+            {
+                set_layout_result(k_layout_interrupted);
+                return;
+            }
+        }
         else
             LOMSE_LOG_ERROR("Invalid IMO tree. Child of ImoBlocksContainer "
                             "is not ImoContentObj");
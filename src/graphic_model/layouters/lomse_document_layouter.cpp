@@ -33,6 +33,7 @@
 #include "lomse_gm_basic.h"
 #include "private/lomse_document_p.h"
 #include "lomse_layouter.h"
+#include "lomse_blocks_container_layouter.h"
 #include "lomse_score_layouter.h"
 #include "lomse_calligrapher.h"
 #include "lomse_box_system.h"
@@ -54,6 +55,9 @@ DocLayouter::DocLayouter(Document* pDoc, LibraryScope& libraryScope, int constra
     : Layouter(libraryScope)
     , m_pDoc( pDoc->get_im_root() )
     , m_viewWidth(width)
+    , m_maxPages(0)
+    , m_pCancel(nullptr)
+    , m_numPrevPages(0)
     , m_pScoreLayouter(nullptr)
 {
     m_pStyles = m_pDoc->get_styles();
@@ -92,8 +96,220 @@ void DocLayouter::layout_document()
     }
     if (result == k_layout_not_finished)
         layout_empty_document();
-    else
+    else if (result != k_layout_interrupted)
         fix_document_size();
+
+    m_result = result;
+}
+
+//---------------------------------------------------------------------------------------
+bool DocLayouter::layout_document_reusing(GraphicModel* pOldModel, int iDirtyBlock)
+{
+    //Incremental layout after a modification in top-level block iDirtyBlock. The pages
+    //in pOldModel preceding the first page that must be laid out again are moved to
+    //the new graphic model, and the layout is resumed there. pOldModel looses the
+    //moved pages and must be deleted by the caller.
+    //Returns false when no page could be reused and the whole document has been
+    //laid out again.
+
+    int iFirstBlock = 0;
+    int iPage = 0;
+    if (!(m_constrains & (k_infinite_width | k_infinite_height)))
+        iPage = find_page_for_resuming_layout(pOldModel, iDirtyBlock, &iFirstBlock);
+
+    if (iPage > 0)
+    {
+        m_pGModel->take_pages_from(pOldModel, iPage);
+        start_new_page();
+        if (layout_content_from(iFirstBlock) == k_layout_success)
+            return true;
+
+        //auto-scaling applied. Reused pages are no longer valid
+        int constrains = m_constrains;
+        delete_last_trial();
+        m_constrains = constrains;
+    }
+
+    layout_document();
+    return false;
+}
+
+//---------------------------------------------------------------------------------------
+int DocLayouter::relayout_score(GraphicModel* pModel, int iBlock,
+                                const list<ImoId>& dirtyIds)
+{
+    //Incremental layout after modifying the objects in dirtyIds, contained in the
+    //score that is top-level block iBlock. pModel is the graphic model with the
+    //previous layout, created by this layouter, and the score must be the last block
+    //laid out by it. The score layout is resumed at the page containing the first
+    //modified system: the previous pages in pModel are preserved and the next ones are
+    //deleted. The new pages are laid out in a new graphic model, that must be
+    //appended to pModel by GraphicModel::take_pages_from().
+    //Returns the index of the first new page, or 0 when the whole document has been
+    //laid out again in the new graphic model, as when auto-scaling is applied. In both
+    //cases the new graphic model is owned by the caller. Returns -1 when the layout
+    //can not be resumed. In this case, no new graphic model is created, pModel is
+    //not modified and this layouter must not be used again.
+
+    ScoreLayouter* pScoreLyt = get_score_layouter();
+    if (m_result != k_layout_success || !pScoreLyt
+        || (m_constrains & (k_infinite_width | k_infinite_height)))
+    {
+        return -1;
+    }
+
+    ImoContent* pContent = m_pDoc->get_content();
+    if (iBlock < 0 || iBlock >= pContent->get_num_children()
+        || pContent->get_child(iBlock) != pScoreLyt->get_score())
+    {
+        return -1;
+    }
+
+    GmoBoxScorePage* pScorePage = pScoreLyt->restart_at_modified_page(pModel, dirtyIds);
+    if (!pScorePage)
+        return -1;
+
+    GmoBox* pBDPC = pScorePage->get_parent_box();      //DocPageContent
+    GmoBoxDocPage* pPage = static_cast<GmoBoxDocPage*>( pBDPC->get_parent_box() );
+    int iPage = pPage->get_number() - 1;
+    pModel->delete_pages_from(iPage);
+
+    m_maxPages = 0;
+    m_pCancel = nullptr;
+    m_numPrevPages = iPage;
+    m_pGModel = LOMSE_NEW GraphicModel();
+    m_result = k_layout_not_finished;
+
+    start_new_page();
+    int result = layout_content_from(iBlock, pScoreLyt);
+    if (result != k_layout_failed_auto_scale)
+    {
+        m_result = result;
+        return iPage;
+    }
+
+    int constrains = m_constrains;
+    delete_last_trial();
+    m_constrains = constrains;
+    m_numPrevPages = 0;
+    layout_document();
+    return 0;
+}
+
+//---------------------------------------------------------------------------------------
+bool DocLayouter::resume_layout()
+{
+    //Continues an interrupted layout (progressive layout). The graphic model with the
+    //pages laid out so far is not modified and remains owned by the caller: a new
+    //graphic model, containing only the remaining pages, is created. It must be
+    //appended to the previous one by GraphicModel::take_pages_from().
+    //The layout is resumed from the saved state of the interrupted score. Returns false
+    //when this is not possible and the whole document has been laid out again in
+    //the new graphic model.
+
+    int iBlock = find_interrupted_block();
+    m_numPrevPages = m_pGModel->get_num_pages();
+    m_pGModel = LOMSE_NEW GraphicModel();
+    m_result = k_layout_not_finished;
+
+    if (iBlock >= 0)
+    {
+        start_new_page();
+        int result = layout_content_from(iBlock, m_pScoreLayouter);
+        if (result != k_layout_failed_auto_scale)
+        {
+            if (result != k_layout_interrupted)
+                fix_document_size();
+            m_result = result;
+            return true;
+        }
+    }
+
+    int constrains = m_constrains;
+    delete_last_trial();
+    m_constrains = constrains;
+    m_numPrevPages = 0;
+    layout_document();
+    return false;
+}
+
+//---------------------------------------------------------------------------------------
+int DocLayouter::find_interrupted_block()
+{
+    //Layout can only be resumed when it was interrupted while laying out a score that
+    //is a top-level block. Returns the index of this block or -1 if none.
+
+    ScoreLayouter* pLayouter = get_score_layouter();
+    if (m_result != k_layout_interrupted || !pLayouter
+        || pLayouter->get_layout_result() != k_layout_interrupted)
+    {
+        return -1;
+    }
+
+    ImoContent* pContent = m_pDoc->get_content();
+    TreeNode<ImoObj>::children_iterator it;
+    int i = 0;
+    for (it = pContent->begin(); it != pContent->end(); ++it, ++i)
+    {
+        if (*it == pLayouter->get_score())
+            return i;
+    }
+    return -1;
+}
+
+//---------------------------------------------------------------------------------------
+int DocLayouter::find_page_for_resuming_layout(GraphicModel* pOldModel,
+                                               int iDirtyBlock, int* pFirstBlock)
+{
+    //Layout can be resumed at the top of a page when the page starts with the first
+    //box of a top-level block not after the modified one. Returns the index of the
+    //last page satisfying this condition or 0 if no page can be reused.
+
+    map<ImoId, int> blocks;
+    ImoContent* pContent = m_pDoc->get_content();
+    TreeNode<ImoObj>::children_iterator it;
+    int i = 0;
+    for (it = pContent->begin(); it != pContent->end(); ++it, ++i)
+        blocks[(*it)->get_id()] = i;
+
+    int iPage = 0;
+    int iLastBlock = -1;        //last block in previous pages
+    int numPages = pOldModel->get_num_pages();
+    for (int iP=0; iP < numPages; ++iP)
+    {
+        GmoBox* pBDPC = pOldModel->get_page(iP)->get_child_box(0);     //DocPageContent
+        if (!pBDPC || pBDPC->get_num_boxes() == 0)
+            break;
+
+        //AWARE: when a block doesn't fit, an empty box for it could remain at the
+        //end of the page. It must be ignored for determining the last block.
+        vector<GmoBox*>& boxes = pBDPC->get_child_boxes();
+        vector<GmoBox*>::reverse_iterator itLast = boxes.rbegin();
+        while (itLast + 1 != boxes.rend() && (*itLast)->get_height() == 0.0f
+               && (*itLast)->get_num_shapes() == 0 && (*itLast)->get_num_boxes() == 0)
+        {
+            ++itLast;
+        }
+        ImoObj* pFirst = boxes.front()->get_creator_imo();
+        ImoObj* pLast = (*itLast)->get_creator_imo();
+        if (!pFirst || !pLast)
+            break;
+        map<ImoId, int>::iterator itF = blocks.find(pFirst->get_id());
+        map<ImoId, int>::iterator itL = blocks.find(pLast->get_id());
+        if (itF == blocks.end() || itL == blocks.end() || itF->second > iDirtyBlock)
+            break;
+
+        if (itF->second > iLastBlock)
+        {
+            iPage = iP;
+            *pFirstBlock = itF->second;
+        }
+
+        iLastBlock = itL->second;
+        if (iLastBlock >= iDirtyBlock)
+            break;
+    }
+    return iPage;
 }
 
 //---------------------------------------------------------------------------------------
@@ -129,6 +345,19 @@ GmoBox* DocLayouter::start_new_page()
     return pPage;
 }
 
+//---------------------------------------------------------------------------------------
+bool DocLayouter::must_interrupt_layout()
+{
+    //Invoked when a new page is required. The layout is interrupted when the page
+    //limit has been reached or when the layout has been cancelled. In both cases,
+    //the graphic model will only contain the pages laid out so far.
+
+    if (m_pCancel && m_pCancel->load())
+        return true;
+
+    return m_maxPages > 0 && m_pGModel->get_num_pages() >= m_maxPages;
+}
+
 //---------------------------------------------------------------------------------------
 GmoBoxDocPage* DocLayouter::create_document_page()
 {
@@ -166,7 +395,7 @@ void DocLayouter::add_margins_to_page(GmoBoxDocPage* pPage)
     LUnits bottom = pInfo->get_bottom_margin() / m_pDoc->get_page_content_scale();
     LUnits left = pInfo->get_left_margin() / m_pDoc->get_page_content_scale();
     LUnits right = pInfo->get_right_margin() / m_pDoc->get_page_content_scale();
-    if (pPage->get_number() % 2 == 0)
+    if ((pPage->get_number() + m_numPrevPages) % 2 == 0)
         left += pInfo->get_binding_margin() / m_pDoc->get_page_content_scale();
     else
         right += pInfo->get_binding_margin() / m_pDoc->get_page_content_scale();
@@ -250,6 +479,16 @@ int DocLayouter::layout_content()
     return layout_item(m_pDoc->get_content(), m_pItemMainBox, m_constrains);
 }
 
+//---------------------------------------------------------------------------------------
+int DocLayouter::layout_content_from(int iFirstBlock, Layouter* pFirstLayouter)
+{
+    ImoContent* pContent = m_pDoc->get_content();
+    ContentLayouter* pLayouter = static_cast<ContentLayouter*>( create_layouter(pContent) );
+    pLayouter->set_first_item(iFirstBlock, pFirstLayouter);
+    m_pCurLayouter = pLayouter;
+    return layout_item_with_current_layouter(pContent, m_pItemMainBox, m_constrains);
+}
+
 //---------------------------------------------------------------------------------------
 void DocLayouter::save_score_layouter(Layouter* pLayouter)
 {
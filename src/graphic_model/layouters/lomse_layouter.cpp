@@ -102,24 +102,56 @@ int Layouter::layout_item(ImoContentObj* pItem, GmoBox* pParentBox, int constrai
         "Laying out id %d %s", pItem->get_id(), pItem->get_name().c_str());
 
     m_pCurLayouter = create_layouter(pItem);
-    m_pCurLayouter->set_constrains(constrains);
+    return layout_item_with_current_layouter(pItem, pParentBox, constrains);
+}
 
+//---------------------------------------------------------------------------------------
+int Layouter::layout_item_with_current_layouter(ImoContentObj* pItem, GmoBox* pParentBox,
+                                                int constrains)
+{
+    m_pCurLayouter->set_constrains(constrains);
     m_pCurLayouter->prepare_to_start_layout();
+    return continue_with_current_layouter(pItem, pParentBox);
+}
+
+//---------------------------------------------------------------------------------------
+int Layouter::resume_item_layout(Layouter* pLayouter, ImoContentObj* pItem,
+                                 GmoBox* pParentBox)
+{
+    //Continues the layout of pItem from the state saved in pLayouter, the layouter
+    //used in a previous layout that was interrupted (progressive layout)
+
+    m_pCurLayouter = pLayouter;
+    m_pCurLayouter->set_parent_layouter(this);
+    m_pCurLayouter->set_layout_result(k_layout_not_finished);
+    return continue_with_current_layouter(pItem, pParentBox);
+}
+
+//---------------------------------------------------------------------------------------
+int Layouter::continue_with_current_layouter(ImoContentObj* pItem, GmoBox* pParentBox)
+{
     while (!m_pCurLayouter->is_item_layouted())
     {
         m_pCurLayouter->create_main_box(pParentBox, m_pageCursor,
                                         m_availableWidth, m_availableHeight);
         m_pCurLayouter->layout_in_box();
-        m_pCurLayouter->set_box_height();
+
+        //AWARE: when the layout is interrupted, boxes are left as when a new page is
+        //started, so that they are not modified when the layout is resumed
+        if (m_pCurLayouter->get_layout_result() != k_layout_interrupted)
+            m_pCurLayouter->set_box_height();
 
         if (!m_pCurLayouter->is_item_layouted())
         {
-            pParentBox = start_new_page();
+            if (must_interrupt_layout())
+                m_pCurLayouter->set_layout_result(k_layout_interrupted);
+            else
+                pParentBox = start_new_page();
         }
     }
 
     int result = m_pCurLayouter->get_layout_result();
-    if (result != k_layout_failed_auto_scale)
+    if (result == k_layout_success)
     {
         m_pCurLayouter->add_end_margins();
 
@@ -130,10 +162,10 @@ int Layouter::layout_item(ImoContentObj* pItem, GmoBox* pParentBox, int constrai
             m_pageCursor.y = pChildBox->get_bottom();
             m_availableHeight -= pChildBox->get_height();
         }
-
-        if (!pItem->is_score())
-            delete m_pCurLayouter;
     }
+
+    if (result != k_layout_failed_auto_scale && !pItem->is_score())
+        delete m_pCurLayouter;
     return result;
 }
 
@@ -29,6 +29,7 @@
 
 #include "lomse_score_layouter.h"
 
+#include "lomse_document.h"
 #include "lomse_staffobjs_table.h"
 #include "lomse_score_meter.h"
 #include "lomse_calligrapher.h"
@@ -104,6 +105,7 @@ ScoreLayouter::ScoreLayouter(ImoContentObj* pItem, Layouter* pParent,
     , m_uFirstSystemIndent(0.0f)
     , m_uOtherSystemIndent(0.0f)
     , m_pStub(nullptr)
+    , m_pRestartStub(nullptr)
     , m_pCurBoxPage(nullptr)
     , m_pCurBoxSystem(nullptr)
     , m_iColumnToTrace(-1)
@@ -115,11 +117,15 @@ ScoreLayouter::ScoreLayouter(ImoContentObj* pItem, Layouter* pParent,
 //---------------------------------------------------------------------------------------
 ScoreLayouter::~ScoreLayouter()
 {
+    if (get_layout_result() == k_layout_interrupted)
+        delete_not_engraved_objects();
+
     delete m_pPartsEngraver;
     delete_system_layouters();
     delete m_pScoreMeter;
     delete m_pSpAlgorithm;
     delete m_pShapesCreator;
+    delete m_pRestartStub;
 }
 
 //---------------------------------------------------------------------------------------
@@ -283,11 +289,13 @@ void ScoreLayouter::final_touches()
 {
     //the score has been layouted. In this method we do any additional layout task
     //for finishing the score, such as adding empty systems to fill the page, if
-    //requested, as well as removing empty unused space in the page.
+    //requested, as well as removing empty unused space in the page. Finally, the
+    //timeline for locating systems is built.
 
     fill_page_with_empty_systems_if_required();
     remove_unused_space();
     center_score_if_requested();
+    m_pStub->build_timeline();
 }
 
 //---------------------------------------------------------------------------------------
@@ -353,6 +361,11 @@ void ScoreLayouter::engrave_system()
                                         get_num_columns() : m_breaks[m_iCurSystem + 1] );
         m_pCurSysLyt->engrave_system(indent, iFirstCol, iLastCol, m_cursor);
     }
+
+    //save info for restarting the layout after this system
+    m_fSysContinues.resize(m_iCurSystem + 1);
+    m_fSysContinues[m_iCurSystem] = !m_notFinishedRelObj.empty()
+                                    || !m_notFinishedLyrics.empty();
 }
 
 //---------------------------------------------------------------------------------------
@@ -453,7 +466,7 @@ LUnits ScoreLayouter::get_other_systems_staves_size()
 }
 
 //---------------------------------------------------------------------------------------
-void ScoreLayouter::decide_line_breaks()
+void ScoreLayouter::decide_line_breaks(int iFirstSystem)
 {
     if (get_num_columns() != 0)
     {
@@ -468,12 +481,12 @@ void ScoreLayouter::decide_line_breaks()
         if (fUseSimple)
         {
             LinesBreakerSimple breaker(this, m_libraryScope, m_pSpAlgorithm, m_breaks);
-            breaker.decide_line_breaks();
+            breaker.decide_line_breaks(iFirstSystem);
         }
         else
         {
             LinesBreakerOptimal breaker(this, m_libraryScope, m_pSpAlgorithm, m_breaks);
-            breaker.decide_line_breaks();
+            breaker.decide_line_breaks(iFirstSystem);
         }
     }
 }
@@ -491,6 +504,29 @@ void ScoreLayouter::create_main_box(GmoBox* pParentBox, UPoint pos, LUnits width
     m_pItemMainBox->set_height(height);
 }
 
+//---------------------------------------------------------------------------------------
+void ScoreLayouter::set_parent_layouter(Layouter* pParent)
+{
+    //When an interrupted layout is resumed in other graphic model, a new stub is
+    //needed. The measures already engraved are copied to it.
+
+    GraphicModel* pPrevModel = m_pGModel;
+    Layouter::set_parent_layouter(pParent);
+
+    if (m_pStub && m_pGModel != pPrevModel)
+    {
+        ScoreStub* pPrevStub = m_pStub;
+        m_pStub = m_pGModel->add_stub_for(m_pScore);
+        m_pStub->copy_measures_from(pPrevStub);
+
+        if (pPrevStub == m_pRestartStub)
+        {
+            delete m_pRestartStub;
+            m_pRestartStub = nullptr;
+        }
+    }
+}
+
 //---------------------------------------------------------------------------------------
 bool ScoreLayouter::enough_space_for_empty_system()
 {
@@ -715,6 +751,23 @@ void ScoreLayouter::delete_not_used_objects()
     delete_system_boxes();
 }
 
+//---------------------------------------------------------------------------------------
+void ScoreLayouter::delete_not_engraved_objects()
+{
+    //When the layout is interrupted (i.e. progressive layout) the remaining systems
+    //will never be added to a page. The pending system and the boxes and shapes for
+    //the columns not yet engraved are not owned by the graphic model and must be
+    //deleted here.
+
+    delete_pendig_aux_objects();
+    delete_system();
+
+    for (int iCol = max(0, m_iCurColumn); iCol < get_num_columns(); ++iCol)
+        m_pSpAlgorithm->delete_box_and_shapes(iCol);
+
+    m_engravers.delete_engravers();
+}
+
 //---------------------------------------------------------------------------------------
 void ScoreLayouter::delete_pendig_aux_objects()
 {
@@ -879,6 +932,189 @@ void ScoreLayouter::finish_measure(int iInstr, GmoShapeBarline* pBarlineShape)
     pTable->finish_measure(iInstr, pBarlineShape);
 }
 
+//---------------------------------------------------------------------------------------
+void ScoreLayouter::restart_measures(const vector<int>& numMeasures)
+{
+    //invoked when the columns following a modification are created again. Only the
+    //measures finished in the preserved columns are kept
+
+    m_pStub->get_measures_table()->truncate(m_pScore, numMeasures);
+}
+
+//---------------------------------------------------------------------------------------
+GmoBoxScorePage* ScoreLayouter::restart_at_modified_page(GraphicModel* pModel,
+                                                         const list<ImoId>& dirtyIds)
+{
+    //Incremental relayout after modifying the objects in dirtyIds. This layouter has
+    //laid out the score and its pages are now in pModel. The systems preceding the
+    //page containing the first modified system are preserved, and the layouter is
+    //prepared for resuming the layout at the top of that page: the columns for the
+    //remaining content are created again and the first system for that page is
+    //pending to be added. Returns that page. It must be removed from pModel, as well
+    //as the next pages, before resuming the layout.
+    //Returns nullptr when this is not possible, e.g. when the modified objects are not
+    //staff objects or the modification affects the first page. In these cases the
+    //layouter could have been modified and must not be used again.
+
+    if (get_layout_result() != k_layout_success || get_num_columns() == 0
+        || int(m_sysLayouters.size()) < get_num_systems())
+    {
+        return nullptr;
+    }
+
+    ScoreStub* pStub = pModel->get_stub_for(m_pScore->get_id());
+    if (!pStub)
+        return nullptr;
+
+    //spacing parameters could depend on the whole score
+    ScoreMeter meter(m_pScore);
+    if (meter.get_spacing_dmin() != m_pScoreMeter->get_spacing_dmin()
+        || meter.num_staves() != m_pScoreMeter->num_staves())
+    {
+        return nullptr;
+    }
+
+    set<ImoId> modified;
+    if (!collect_modified_staffobjs(dirtyIds, &modified))
+        return nullptr;
+
+    int iCol = m_pSpAlgorithm->find_first_modified_column(modified);
+    if (iCol < 0)
+        return nullptr;
+
+    //AWARE: Pages could have been moved to other graphic model. And the measures
+    //table is modified when the columns are created again. For not modifying pModel,
+    //a private copy of the stub is used until the layout is resumed in other model
+    m_pGModel = pModel;
+    delete m_pRestartStub;
+    m_pRestartStub = LOMSE_NEW ScoreStub(m_pScore);
+    m_pRestartStub->copy_measures_from(pStub);
+    m_pStub = m_pRestartStub;
+    int iSystem = find_first_system_to_restart( get_system_containing_column(iCol) );
+    if (iSystem < 0)
+        return nullptr;
+
+    GmoBoxSystem* pPrevSystem = m_sysLayouters[iSystem-1]->get_box_system();
+    GmoBoxScorePage* pPage = static_cast<GmoBoxScorePage*>(
+                    m_sysLayouters[iSystem]->get_box_system()->get_owner_box() );
+
+    //remove data for next systems and create again the remaining columns
+    for (int i=iSystem; i < int(m_sysLayouters.size()); ++i)
+        delete m_sysLayouters[i];
+    m_sysLayouters.resize(iSystem);
+    m_fSysContinues.resize(iSystem);
+    m_breaks.resize(iSystem + 1);
+    delete_pendig_aux_objects();
+
+    m_pPartsEngraver->reset_staves_position();
+    m_pSpAlgorithm->split_content_in_columns();
+    m_pSpAlgorithm->do_spacing_algorithm();
+
+    //state as when the last system in previous page was added
+    m_pCurBoxPage = static_cast<GmoBoxScorePage*>( pPrevSystem->get_owner_box() );
+    m_iCurPage = pPrevSystem->get_page_number();
+    m_startTop = m_pCurBoxPage->get_top();
+    m_iCurSystem = iSystem - 1;
+    //the page cursor is only updated when the score is finished. Before, it
+    //determined the height assigned to the box for each page
+    m_pageCursor.y = m_pCurBoxPage->get_bottom();
+    m_pCurSysLyt = m_sysLayouters.back();
+    m_cursor.x = m_pCurBoxPage->get_left();
+    m_cursor.y = pPrevSystem->get_bottom();
+    is_first_system_in_page(false);
+
+    //and the first system for next page is pending, as when that page was started
+    decide_line_breaks(iSystem);
+    create_system();
+
+    //if the modified system now fits in previous page, that page must change
+    if (enough_space_in_page_for_system())
+    {
+        delete_not_engraved_objects();
+        return nullptr;
+    }
+
+    return pPage;
+}
+
+//---------------------------------------------------------------------------------------
+bool ScoreLayouter::collect_modified_staffobjs(const list<ImoId>& dirtyIds,
+                                               set<ImoId>* pModified)
+{
+    //Saves in pModified the ids of the staff objects owning the modified objects.
+    //Modified music data (staff objects added or removed) is ignored as it is
+    //detected by the spacing algorithm. An instrument is marked as modified when
+    //staff objects are inserted or deleted, and its other attributes are not used
+    //by the layout, so it is treated as modified music data. Returns false if any
+    //modified object is not in this score or is not owned by a staff object or
+    //by an instrument (e.g. options).
+
+    Document* pDoc = m_pScore->get_the_document();
+    if (!pDoc)
+        return false;
+
+    list<ImoId>::const_iterator it;
+    for (it = dirtyIds.begin(); it != dirtyIds.end(); ++it)
+    {
+        ImoObj* pImo = pDoc->get_pointer_to_imo(*it);
+        if (pImo && pImo->is_relobj())
+            pImo = static_cast<ImoRelObj*>(pImo)->get_start_object();
+
+        ImoObj* pOwner = nullptr;
+        bool fMusicData = false;
+        while (pImo && !pImo->is_score())
+        {
+            if (!pOwner && !fMusicData)
+            {
+                if (pImo->is_staffobj())
+                    pOwner = pImo;
+                else if (pImo->is_music_data() || pImo->is_instrument())
+                    fMusicData = true;
+            }
+            pImo = pImo->get_parent_imo();
+        }
+
+        if (pImo != m_pScore || (!pOwner && !fMusicData))
+            return false;
+
+        if (pOwner)
+            pModified->insert(pOwner->get_id());
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+int ScoreLayouter::find_first_system_to_restart(int iSystem)
+{
+    //The layout is resumed at the first system in the page containing iSystem or,
+    //if not possible, in a previous page, but never in the first page. The system
+    //must not continue RelObjs or lyrics from previous system, and the spacing
+    //algorithm must be able to restart at its first column.
+    //Returns the system or -1 if none.
+
+    int iPage = m_sysLayouters[iSystem]->get_box_system()->get_page_number();
+    while (iPage > 0)
+    {
+        while (iSystem > 0
+               && m_sysLayouters[iSystem-1]->get_box_system()->get_page_number() == iPage)
+        {
+            --iSystem;
+        }
+        if (iSystem == 0)
+            return -1;
+
+        if (!m_fSysContinues[iSystem-1]
+            && m_pSpAlgorithm->restart_at_column(m_breaks[iSystem]))
+        {
+            return iSystem;
+        }
+
+        --iSystem;
+        iPage = m_sysLayouters[iSystem]->get_box_system()->get_page_number();
+    }
+    return -1;
+}
+
 
 
 //=======================================================================================
@@ -1527,19 +1763,21 @@ LinesBreakerSimple::LinesBreakerSimple(ScoreLayouter* pScoreLyt,
 }
 
 //---------------------------------------------------------------------------------------
-void LinesBreakerSimple::decide_line_breaks()
+void LinesBreakerSimple::decide_line_breaks(int iFirstSystem)
 {
     //simple algorithm: just fill system with columns while space available
 
     int numCols = m_pScoreLyt->get_num_columns();
-    int iSystem = 0;
+    int iSystem = iFirstSystem;
+    int iFirstCol = (iFirstSystem > 0 ? m_breaks[iFirstSystem] : 0);
 
     //start first system
-    m_breaks.push_back(0);
-    LUnits space = m_pScoreLyt->get_target_size_for_system(0)
-                   - m_pScoreLyt->get_column_width(0);        //+gross
+    m_breaks.resize(iFirstSystem);
+    m_breaks.push_back(iFirstCol);
+    LUnits space = m_pScoreLyt->get_target_size_for_system(iSystem)
+                   - m_pScoreLyt->get_column_width(iFirstCol);        //+gross
 
-    for (int iCol=1; iCol < numCols; ++iCol)
+    for (int iCol=iFirstCol+1; iCol < numCols; ++iCol)
     {
         LUnits colSize = m_pScoreLyt->get_column_width(iCol);     //+gross
         if (space >= colSize && !m_pScoreLyt->column_has_system_break(iCol))
@@ -1567,15 +1805,21 @@ LinesBreakerOptimal::LinesBreakerOptimal(ScoreLayouter* pScoreLyt,
     : LinesBreaker(pScoreLyt, libScope, pSpAlgorithm, breaks)
     , m_numCols(0)
     , m_fJustifyLastLine(false)
+    , m_iFirstSystem(0)
+    , m_iFirstCol(0)
+    , m_fPruning(true)
 {
 }
 
 //---------------------------------------------------------------------------------------
-void LinesBreakerOptimal::decide_line_breaks()
+void LinesBreakerOptimal::decide_line_breaks(int iFirstSystem)
 {
     //algorithm, very closely related to Knuths' algorithm for breaking lines in
     //word processor systems, as described in [GUIDO]
 
+    m_iFirstSystem = iFirstSystem;
+    m_iFirstCol = (iFirstSystem > 0 ? m_breaks[iFirstSystem] : 0);
+
     initialize_entries_table();
     compute_optimal_break_sequence();
     retrieve_breaks_sequence();
@@ -1588,15 +1832,27 @@ void LinesBreakerOptimal::initialize_entries_table()
 
     m_entries.reserve(m_numCols+1);
     m_entries.assign(m_numCols+1, Entry());
-    m_entries[0].penalty = 0.0f;
-    m_entries[0].predecessor = 0;
-    m_entries[0].system = 0;
-    for (int i=1; i <= m_numCols; ++i)
+    for (int i=0; i <= m_numCols; ++i)
     {
         m_entries[i].penalty = LOMSE_INFINITE_PENALTY;
         m_entries[i].predecessor = -1;
         m_entries[i].system = 0;
     }
+    m_entries[m_iFirstCol].penalty = 0.0f;
+    m_entries[m_iFirstCol].predecessor = m_iFirstCol;
+    m_entries[m_iFirstCol].system = m_iFirstSystem;
+
+    //data for pruning
+    m_bestOverfull.penalty = LOMSE_INFINITE_PENALTY;
+    m_bestOverfull.predecessor = -1;
+    m_bestOverfull.system = 0;
+    m_overfull.assign(m_numCols+1, vector<Entry>());
+    m_nextBreak.assign(m_numCols+2, -1);
+    for (int j=m_numCols; j > 0; --j)
+    {
+        m_nextBreak[j] = (m_pScoreLyt->column_has_system_break(j-1) ? j
+                                                                   : m_nextBreak[j+1]);
+    }
 }
 
 //---------------------------------------------------------------------------------------
@@ -1605,8 +1861,10 @@ void LinesBreakerOptimal::compute_optimal_break_sequence()
     bool fTrace = (m_libraryScope.get_trace_level_for_lines_breaker()
                        & k_trace_breaks_computation) != 0;
 
-    for (int i=0; i < m_numCols; ++i)
+    for (int i=m_iFirstCol; i < m_numCols; ++i)
     {
+        apply_overfull_candidates(i);
+
         if (fTrace)
         {
             dbgLogger << "Breaks i loop. "
@@ -1677,9 +1935,82 @@ void LinesBreakerOptimal::compute_optimal_break_sequence()
                 //optimization: if no space for column j do not try column j+1
                 if (newPenalty >= LOMSE_INFINITE_PENALTY)
                     break;
+
+                //optimization: if no space for column j, penalty for next columns
+                //will be the same. Do not evaluate them.
+                if (m_fPruning && m_pSpAlgorithm->is_overfull_line(iSystem, i, j-1))
+                {
+                    Entry candidate;
+                    candidate.penalty = newPenalty + prevPenalty;
+                    candidate.predecessor = i;
+                    candidate.system = iSystem + 1;
+                    add_overfull_candidate(j+1, candidate);
+                    break;
+                }
             }
         }
     }
+    apply_overfull_candidates(m_numCols);
+}
+
+//---------------------------------------------------------------------------------------
+void LinesBreakerOptimal::add_overfull_candidate(int iFirst, const Entry& candidate)
+{
+    //The candidate applies to entries [iFirst, ...] until next system break, as if
+    //they had been evaluated. For the entry with the system break, the candidate
+    //replaces current value, as it would have done when evaluating it.
+
+    if (iFirst > m_numCols)
+        return;
+
+    int iBreak = m_nextBreak[iFirst];
+    if (iBreak != iFirst)
+        m_overfull[iFirst].push_back(candidate);
+
+    if (iBreak > 0)
+    {
+        m_entries[iBreak].penalty = 0.0f;
+        m_entries[iBreak].predecessor = candidate.predecessor;
+        m_entries[iBreak].system = candidate.system;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void LinesBreakerOptimal::apply_overfull_candidates(int j)
+{
+    //Candidates are compared as if they had been evaluated in order: the first one
+    //with lowest penalty wins.
+
+    if (j == m_iFirstCol)
+        return;
+
+    //candidates do not cross system breaks
+    if (m_nextBreak[j] == j)
+    {
+        m_bestOverfull.penalty = LOMSE_INFINITE_PENALTY;
+        m_bestOverfull.predecessor = -1;
+        return;
+    }
+
+    vector<Entry>::iterator it;
+    for (it = m_overfull[j].begin(); it != m_overfull[j].end(); ++it)
+    {
+        if ((*it).penalty < m_bestOverfull.penalty
+            || ((*it).penalty == m_bestOverfull.penalty
+                && (*it).predecessor < m_bestOverfull.predecessor))
+        {
+            m_bestOverfull = *it;
+        }
+    }
+
+    Entry& entry = m_entries[j];
+    if (m_bestOverfull.penalty < LOMSE_INFINITE_PENALTY
+        && (m_bestOverfull.penalty < entry.penalty
+            || (m_bestOverfull.penalty == entry.penalty
+                && m_bestOverfull.predecessor < entry.predecessor)))
+    {
+        entry = m_bestOverfull;
+    }
 }
 
 //---------------------------------------------------------------------------------------
@@ -1694,14 +2025,15 @@ void LinesBreakerOptimal::retrieve_breaks_sequence()
     }
 
     int i = m_numCols;
-    while (i > 0 && m_entries[i].predecessor <= 0)
+    while (i > m_iFirstCol && m_entries[i].predecessor <= m_iFirstCol)
         --i;
 
-    if (i == 0)
+    m_breaks.resize(m_iFirstSystem);
+    if (i == m_iFirstCol)
     {
         //no breaks. Just one single system
-        m_breaks.push_back(0);      //AWARE: breaks size is the number of systems because
-                                    //last break is implicit: last column
+        m_breaks.push_back(m_iFirstCol);    //AWARE: breaks size is the number of systems
+                                            //because last break is implicit: last column
 
         if (fTrace)
         {
@@ -1713,9 +2045,10 @@ void LinesBreakerOptimal::retrieve_breaks_sequence()
     }
 
     int numBreaks = m_entries[i].system;
-    m_breaks.assign(numBreaks, 0);
+    m_breaks.resize(numBreaks, 0);
+    m_breaks[m_iFirstSystem] = m_iFirstCol;
 
-    while (m_entries[i].predecessor > 0)
+    while (m_entries[i].predecessor > m_iFirstCol)
     {
         i = m_entries[i].predecessor;
         m_breaks[--numBreaks] = i;
@@ -43,6 +43,10 @@
 #include "lomse_box_slice.h"
 #include "lomse_shape_barline.h"
 
+//std
+#include <atomic>
+#include <thread>
+
 
 namespace lomse
 {
@@ -105,7 +109,19 @@ void SpAlgColumn::split_content_in_columns()
 //---------------------------------------------------------------------------------------
 void SpAlgColumn::do_spacing_algorithm()
 {
-    m_pColsBuilder->do_spacing_algorithm();
+    m_pColsBuilder->do_spacing_algorithm( m_pColsBuilder->get_first_column() );
+}
+
+//---------------------------------------------------------------------------------------
+int SpAlgColumn::find_first_modified_column(const std::set<ImoId>& modified)
+{
+    return m_pColsBuilder->find_first_modified_column(modified);
+}
+
+//---------------------------------------------------------------------------------------
+bool SpAlgColumn::restart_at_column(int iCol)
+{
+    return m_pColsBuilder->restart_at_column(iCol);
 }
 
 //---------------------------------------------------------------------------------------
@@ -269,6 +285,7 @@ ColumnsBuilder::ColumnsBuilder(ScoreMeter* pScoreMeter, vector<ColumnData*>& col
     , m_pSpAlgorithm(pSpAlgorithm)
     , m_maxColumn(0)
     , m_colsData(colsData)
+    , m_iFirstColumn(0)
 {
 }
 
@@ -288,16 +305,27 @@ ColumnsBuilder::~ColumnsBuilder()
 //---------------------------------------------------------------------------------------
 void ColumnsBuilder::create_columns()
 {
-    m_iColumn = -1;
-    m_iColStartMeasure = 0;
-    m_pStartBarlineShape = nullptr;
-    m_fNoSignatures.assign(m_pScore->get_num_instruments(), true);
-    m_fClefFound.assign(m_pSysCursor->get_num_staves(), false);
+    //When restarting after a modification, previous columns are preserved and the
+    //builder state is the saved one for the first column to create.
+
+    if (m_iFirstColumn == 0)
+    {
+        m_iColumn = -1;
+        m_iColStartMeasure = 0;
+        m_pStartBarlineShape = nullptr;
+        m_fNoSignatures.assign(m_pScore->get_num_instruments(), true);
+        m_fClefFound.assign(m_pSysCursor->get_num_staves(), false);
+        m_numMeasures.assign(m_pScore->get_num_instruments(), 0);
+
+        determine_staves_vertical_position();
+    }
 
-    determine_staves_vertical_position();
     while(!m_pSysCursor->is_end())
     {
         m_iColumn++;
+        ColumnStart start = { int(m_entries.size()), m_iColStartMeasure,
+                              m_pStartBarlineShape, m_numMeasures };
+        m_colStarts.push_back(start);
         prepare_for_new_column();
         m_colsData.push_back( LOMSE_NEW ColumnData(m_pScoreMeter, m_pSpAlgorithm) );
         find_and_save_context_info_for_this_column();
@@ -307,10 +335,44 @@ void ColumnsBuilder::create_columns()
 }
 
 //---------------------------------------------------------------------------------------
-void ColumnsBuilder::do_spacing_algorithm()
+//Worker for the parallel spacing pass: takes columns from a shared counter until
+//all columns are spaced
+static void layout_columns_worker(ColumnsBuilder* pBuilder, int maxColumn,
+                                  std::atomic<int>* pNext)
+{
+    for (int iCol = (*pNext)++; iCol <= maxColumn; iCol = (*pNext)++)
+        pBuilder->layout_column(iCol);
+}
+
+//---------------------------------------------------------------------------------------
+void ColumnsBuilder::do_spacing_algorithm(int iFirstCol, int numThreads)
 {
-    for (m_iColumn=0; m_iColumn <= m_maxColumn; ++m_iColumn)
-        layout_column();
+    //Spaces columns [iFirstCol, m_maxColumn]. When numThreads is not 1 the columns
+    //are distributed among numThreads threads (0 means one thread per core). The
+    //spacing algorithm must not share mutable data between columns. Tracing a column
+    //forces the serial loop, so that the trace is not mixed with other columns
+
+    if (numThreads <= 0)
+        numThreads = max(1, int(std::thread::hardware_concurrency()));
+    numThreads = min(numThreads, m_maxColumn - iFirstCol + 1);
+
+    if (numThreads <= 1 || m_iColumnToTrace >= 0)
+    {
+        for (m_iColumn=iFirstCol; m_iColumn <= m_maxColumn; ++m_iColumn)
+            layout_column(m_iColumn);
+        return;
+    }
+
+    std::atomic<int> next(iFirstCol);
+    vector<std::thread> workers;
+    for (int i=1; i < numThreads; ++i)
+        workers.push_back( std::thread(layout_columns_worker, this, m_maxColumn, &next) );
+    layout_columns_worker(this, m_maxColumn, &next);
+
+    vector<std::thread>::iterator it;
+    for (it = workers.begin(); it != workers.end(); ++it)
+        (*it).join();
+    m_iColumn = m_maxColumn + 1;
 }
 
 //---------------------------------------------------------------------------------------
@@ -351,6 +413,8 @@ void ColumnsBuilder::collect_content_for_this_column()
         if ( m_pBreaker->feasible_break_before_this_obj(pSO, rTime, iInstr, iLine) )
             break;
 
+        EntryInfo info = { pSO, pSO->get_id(), rTime };
+        m_entries.push_back(info);
 
         if (pSO->is_system_break())
         {
@@ -416,6 +480,7 @@ void ColumnsBuilder::collect_content_for_this_column()
             if (pSO->is_barline() && !static_cast<ImoBarline*>(pSO)->is_middle())
             {
                 m_pScoreLyt->finish_measure(iInstr, static_cast<GmoShapeBarline*>(pShape));
+                m_numMeasures[iInstr]++;
 
                 fSaveNonTimed = false;
                 nonTimed.assign(nonTimed.size(), nullptr);
@@ -467,6 +532,125 @@ void ColumnsBuilder::collect_content_for_this_column()
     m_pSpAlgorithm->finish_column_measurements(m_iColumn);
 }
 
+//---------------------------------------------------------------------------------------
+int ColumnsBuilder::find_first_modified_column(const std::set<ImoId>& modified)
+{
+    //Compares the entries included in the columns with the entries in the modified
+    //score. The first column that could change is the one containing the first
+    //different or modified entry. But when this entry is the first one in a column,
+    //the column break could also change and the previous column is returned.
+    //Returns -1 if no change is found.
+
+    ColStaffObjs* pTable = m_pScore->get_staffobjs_table();
+    ColStaffObjs::iterator it = pTable->begin();
+    int numEntries = int(m_entries.size());
+    int iEntry = 0;
+    for (; iEntry < numEntries && it != pTable->end(); ++iEntry, ++it)
+    {
+        EntryInfo& info = m_entries[iEntry];
+        ImoStaffObj* pSO = (*it)->imo_object();
+        if (pSO != info.pSO || pSO->get_id() != info.id
+            || !is_equal_time((*it)->time(), info.time)
+            || modified.find(info.id) != modified.end())
+        {
+            break;
+        }
+    }
+    if (iEntry == numEntries && it == pTable->end())
+        return -1;
+
+    int iCol = 0;
+    int numCols = int(m_colStarts.size());
+    while (iCol + 1 < numCols && m_colStarts[iCol + 1].iFirstEntry < iEntry)
+        ++iCol;
+    return iCol;
+}
+
+//---------------------------------------------------------------------------------------
+bool ColumnsBuilder::restart_at_column(int iCol)
+{
+    //Prepares for creating again columns [iCol, n-1] after a modification in the
+    //score. Previous columns are preserved. Their content is traversed in the
+    //modified score for positioning the cursor and the column breaker at the start of
+    //column iCol. Returns false, without changing anything, if the previous columns
+    //are not valid for the modified score.
+
+    if (iCol <= 0 || iCol >= int(m_colStarts.size())
+        || int(m_numMeasures.size()) != m_pScore->get_num_instruments())
+    {
+        return false;
+    }
+
+    StaffObjsCursor* pCursor = LOMSE_NEW StaffObjsCursor(m_pScore);
+    ColumnBreaker* pBreaker = LOMSE_NEW ColumnBreaker(m_pScoreMeter->num_instruments(),
+                                                      pCursor);
+    int iEntry = 0;
+    int iNextCol = 1;
+    bool fValid = true;
+    while (fValid && iNextCol <= iCol && !pCursor->is_end())
+    {
+        ImoStaffObj* pSO = pCursor->get_staffobj();
+        fValid = is_same_entry(iEntry, pCursor);
+        if (fValid && pBreaker->feasible_break_before_this_obj(pSO, pCursor->time(),
+                                                                pCursor->num_instrument(),
+                                                                pCursor->line()) )
+        {
+            //next column starts here. The entry will be checked again for it
+            fValid = (m_colStarts[iNextCol].iFirstEntry == iEntry);
+            ++iNextCol;
+        }
+        else if (fValid)
+        {
+            fValid = (iEntry < m_colStarts[iNextCol].iFirstEntry);
+            ++iEntry;
+            pCursor->move_next();
+        }
+    }
+
+    //prolog is only at start of score
+    if (!fValid || iNextCol <= iCol || is_equal_time(pCursor->time(), 0.0))
+    {
+        delete pBreaker;
+        delete pCursor;
+        return false;
+    }
+
+    delete m_pSysCursor;
+    delete m_pBreaker;
+    m_pSysCursor = pCursor;
+    m_pBreaker = pBreaker;
+
+    for (int i = iCol; i < int(m_colsData.size()); ++i)
+        delete m_colsData[i];
+    m_colsData.resize(iCol);
+
+    ColumnStart& start = m_colStarts[iCol];
+    m_iColStartMeasure = start.iColStartMeasure;
+    m_pStartBarlineShape = start.pStartBarlineShape;
+    m_numMeasures = start.numMeasures;
+    m_entries.resize(start.iFirstEntry);
+    m_colStarts.resize(iCol);
+
+    m_iColumn = iCol - 1;
+    m_maxColumn = m_iColumn;
+    m_iFirstColumn = iCol;
+
+    m_pScoreLyt->restart_measures(m_numMeasures);
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+bool ColumnsBuilder::is_same_entry(int iEntry, StaffObjsCursor* pCursor)
+{
+    if (iEntry >= int(m_entries.size()))
+        return false;
+
+    EntryInfo& info = m_entries[iEntry];
+    ImoStaffObj* pSO = pCursor->get_staffobj();
+    return pSO == info.pSO && pSO->get_id() == info.id
+           && is_equal_time(pCursor->time(), info.time);
+}
+
 //---------------------------------------------------------------------------------------
 void ColumnsBuilder::find_and_save_context_info_for_this_column()
 {
@@ -501,10 +685,10 @@ void ColumnsBuilder::store_info_about_attached_objects(ImoStaffObj* pSO,
 }
 
 //---------------------------------------------------------------------------------------
-void ColumnsBuilder::layout_column()
+void ColumnsBuilder::layout_column(int iCol)
 {
-    bool fTrace = (m_iColumnToTrace == m_iColumn);
-    m_pSpAlgorithm->do_spacing(m_iColumn, fTrace);
+    bool fTrace = (m_iColumnToTrace == iCol);
+    m_pSpAlgorithm->do_spacing(iCol, fTrace);
 }
 
 //---------------------------------------------------------------------------------------
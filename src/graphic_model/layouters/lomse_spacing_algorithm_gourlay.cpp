@@ -44,6 +44,7 @@
 #include "lomse_vertical_profile.h"
 
 #include <vector>
+#include <algorithm>   //find
 #include <cmath>   //abs
 using namespace std;
 
@@ -85,6 +86,11 @@ SpAlgGourlay::SpAlgGourlay(LibraryScope& libraryScope,
     , m_dmin(0.0f)
     , m_log2dmin(0.0f)
     , m_Fopt(0.0f)
+    , m_iAccFirst(-1)
+    , m_iAccLast(-1)
+    , m_accSlope(0.0f)
+    , m_accFixed(0.0f)
+    , m_accMinWidth(0.0f)
 {
 //    m_columns.reserve(pScoreLyt->get_num_columns());
     m_data.reserve(pScore->get_staffobjs_table()->num_entries());
@@ -389,7 +395,9 @@ bool SpAlgGourlay::accept_for_prolog_slice(ColStaffObjsEntry* pEntry)
 //---------------------------------------------------------------------------------------
 void SpAlgGourlay::finish_slice(ColStaffObjsEntry* pLastEntry, int numEntries)
 {
-    if (m_pCurSlice)
+    //AWARE: after restart_at_column() current slice is the last preserved slice. It
+    //is already finished and there is no last entry.
+    if (m_pCurSlice && pLastEntry)
     {
         m_pCurSlice->set_final_data(pLastEntry, numEntries, m_maxNoteDur, m_minNoteDur,
                                     m_pScoreMeter);
@@ -407,33 +415,172 @@ void SpAlgGourlay::finish_column_measurements(int UNUSED(iCol))
 }
 
 //---------------------------------------------------------------------------------------
-void SpAlgGourlay::do_spacing(int iCol, bool fTrace)
+bool SpAlgGourlay::restart_at_column(int iCol)
 {
+    //Discards slices and data for columns [iCol, n-1]. Only possible when column
+    //iCol follows a barline, as the rods of the first slice in a column modify
+    //the previous slice unless it is a barline.
+    //AWARE: ColStaffObjs entries referenced by preserved slices are no longer valid
+    //after the score modification. They are not used, as preserved columns are
+    //already spaced and included in systems.
+
+    int numCols = int(m_columns.size());
+    if (iCol <= 0 || iCol >= numCols || numCols != get_num_columns())
+        return false;
+
+    TimeSlice* pFirst = m_columns[iCol]->m_pFirstSlice;
+    if (!pFirst || !pFirst->m_prev
+        || pFirst->m_prev->get_type() != TimeSlice::k_barline)
+    {
+        return false;
+    }
+
+    if (!SpAlgColumn::restart_at_column(iCol))
+        return false;
+
+    int iFirstData = pFirst->m_iFirstData;
+    list<TimeSlice*>::iterator it = find(m_slices.begin(), m_slices.end(), pFirst);
+    for (list<TimeSlice*>::iterator itS = it; itS != m_slices.end(); ++itS)
+        delete *itS;
+    m_slices.erase(it, m_slices.end());
+
+    for (int i = iFirstData; i < int(m_data.size()); ++i)
+        delete m_data[i];
+    m_data.resize(iFirstData);
+
+    for (int i = iCol; i < numCols; ++i)
+        delete m_columns[i];
+    m_columns.resize(iCol);
+
+    m_pCurSlice = m_slices.back();
+    m_pCurSlice->set_next(nullptr);
+    m_pCurColumn = m_columns.back();
+    m_pLastEntry = nullptr;
+    m_prevType = TimeSlice::k_undefined;
+    m_numEntries = 0;
+    m_numSlices = 0;
+    m_iPrevColumn = iCol - 1;
+    m_iAccFirst = -1;
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+void SpAlgGourlay::do_spacing_algorithm()
+{
+    m_iAccFirst = -1;       //column data will change: invalidate sums for lines
+
     determine_spacing_parameters();
-    compute_springs();
-    order_slices_in_columns();
+    int iFirstCol = compute_final_springs();
+
+    //once springs are final, columns are independent and can be spaced in parallel
+    int numThreads = (m_libraryScope.dump_column_tables() ? 1
+                                                : m_libraryScope.get_spacing_threads());
+    m_pColsBuilder->do_spacing_algorithm(iFirstCol, numThreads);
+}
+
+//---------------------------------------------------------------------------------------
+int SpAlgGourlay::compute_final_springs()
+{
+    //Springs and rods must be computed sequentially, as slices data depends on the
+    //previous slice, also across column boundaries. Moreover, the rods for a slice
+    //depend on the width of a previous non-timed slice, that is only known after
+    //applying a force. Originally, springs were computed again before spacing each
+    //column, so column i was spaced with the springs from pass i+1. This is
+    //replicated here, but passes stop as soon as slices width does not change, as
+    //next passes would produce the same springs.
+    //Returns the index of the first column not yet spaced.
+
+    int numCols = int(m_columns.size());
+    int iFirstCol = m_pColsBuilder->get_first_column();
+    if (iFirstCol > 0)
+    {
+        //restarted after a modification: previous columns are already spaced and
+        //only slices in the new columns are computed
+        list<TimeSlice*>::iterator itStart = find(m_slices.begin(), m_slices.end(),
+                                                  m_columns[iFirstCol]->m_pFirstSlice);
+        for (int i = iFirstCol; i < numCols; ++i)
+        {
+            compute_springs(itStart);
+            if (!apply_force_to_slices(m_Fopt, itStart))
+                break;
+        }
+        return iFirstCol;
+    }
+
+    int iCol = 0;
+    while (iCol < numCols)
+    {
+        compute_springs();
+        if (!apply_force_to_slices(m_Fopt) || iCol == numCols - 1)
+            break;
+
+        //springs will change in next pass: this column must be spaced now
+        m_pColsBuilder->layout_column(iCol++);
+    }
+
+    //update data for the columns already spaced, to reflect the final springs
+    for (int i=0; i < iCol; ++i)
+    {
+        m_columns[i]->order_slices();
+        m_columns[i]->apply_force(m_Fopt);
+    }
+
+    return iCol;
+}
+
+//---------------------------------------------------------------------------------------
+bool SpAlgGourlay::apply_force_to_slices(float F)
+{
+    return apply_force_to_slices(F, m_slices.begin());
+}
+
+//---------------------------------------------------------------------------------------
+bool SpAlgGourlay::apply_force_to_slices(float F, list<TimeSlice*>::iterator itStart)
+{
+    //apply force to slices, starting at itStart. Returns true if the width of any
+    //slice has changed
+
+    bool fChanges = false;
+    list<TimeSlice*>::iterator it;
+    for (it = itStart; it != m_slices.end(); ++it)
+    {
+        LUnits width = (*it)->get_width();
+        (*it)->apply_force(F);
+        fChanges |= (width != (*it)->get_width());
+    }
+    return fChanges;
+}
+
+//---------------------------------------------------------------------------------------
+void SpAlgGourlay::do_spacing(int iCol, bool fTrace)
+{
+    //Springs are already computed. Only data for column iCol is modified, so that
+    //columns can be spaced in parallel
+
+    ColumnDataGourlay* pCol = m_columns[iCol];
+    pCol->order_slices();
 
     int numInstruments = m_pScoreMeter->num_instruments();
-    m_columns[iCol]->collect_barlines_information(numInstruments);
-    m_columns[iCol]->determine_minimum_width();
+    pCol->collect_barlines_information(numInstruments);
+    pCol->determine_minimum_width();
 
     if (fTrace || m_libraryScope.dump_column_tables())
     {
         dbgLogger << endl << to_simple_string(chrono::system_clock::now(), true)
                   << " ******************* Before spacing" << endl;
-        m_columns[iCol]->dump(logger.get_stream());
+        pCol->dump(logger.get_stream());
     }
 
     //apply optimum force to get an initial estimation for columns width
-    apply_force(m_Fopt);
+    pCol->apply_force(m_Fopt);
 
     //determine column spacing function slope in the neighborhood of Fopt
-    m_columns[iCol]->determine_approx_sff_for(m_Fopt);
+    pCol->determine_approx_sff_for(m_Fopt);
 
     if (fTrace || m_libraryScope.dump_column_tables())
     {
         dbgLogger << "Column " << iCol << ". Slope for Fopt= " << m_Fopt
-                  << " is slope= " << m_columns[iCol]->m_slope << endl;
+                  << " is slope= " << pCol->m_slope << endl;
     }
 }
 
@@ -474,11 +621,17 @@ void SpAlgGourlay::determine_spacing_parameters()
 
 //---------------------------------------------------------------------------------------
 void SpAlgGourlay::compute_springs()
+{
+    compute_springs(m_slices.begin());
+}
+
+//---------------------------------------------------------------------------------------
+void SpAlgGourlay::compute_springs(list<TimeSlice*>::iterator itStart)
 {
     TextMeter textMeter(m_libraryScope);
 
     list<TimeSlice*>::iterator it;
-    for (it = m_slices.begin(); it != m_slices.end(); ++it)
+    for (it = itStart; it != m_slices.end(); ++it)
         (*it)->assign_spacing_values(m_data, m_pScoreMeter, textMeter);
 
     //AWARE: Can not be included in previous loop because slice i+1 also
@@ -486,28 +639,11 @@ void SpAlgGourlay::compute_springs()
     LUnits dsFixed = m_pScoreMeter->tenths_to_logical_max(
                                 m_pScoreMeter->get_spacing_value());
     bool fProportional = m_pScoreMeter->is_proportional_spacing();
-    for (it = m_slices.begin(); it != m_slices.end(); ++it)
+    for (it = itStart; it != m_slices.end(); ++it)
         (*it)->compute_spring_data(m_uSmin, m_alpha, m_log2dmin, m_dmin,
                                    fProportional, dsFixed);
 }
 
-//---------------------------------------------------------------------------------------
-void SpAlgGourlay::order_slices_in_columns()
-{
-    vector<ColumnDataGourlay*>::iterator it;
-    for (it = m_columns.begin(); it != m_columns.end(); ++it)
-        (*it)->order_slices();
-}
-
-//---------------------------------------------------------------------------------------
-void SpAlgGourlay::apply_force(float F)
-{
-    //apply force to all columns
-    vector<ColumnDataGourlay*>::iterator it;
-    for (it = m_columns.begin(); it != m_columns.end(); ++it)
-        (*it)->apply_force(F);
-}
-
 //---------------------------------------------------------------------------------------
 void SpAlgGourlay::reposition_slices_and_staffobjs(int iFirstCol, int iLastCol,
                                                    LUnits yShift,
@@ -793,23 +929,16 @@ float SpAlgGourlay::determine_penalty_for_line(int iSystem, int iFirstCol, int i
 //        return -1.0f;
 //    }
 
-    LUnits lineWidth = m_pScoreLyt->get_target_size_for_system(iSystem);
-    if (iSystem > 0)
-        lineWidth -= 1000.0f; //m_pScoreLyt->get_prolog_width_for_system(iSystem);
+    LUnits lineWidth = determine_line_width(iSystem);
 
     //determine composite spacing function sff[cicj]
     //                       j                          j
     //    sff[cicj] = 1 / ( SUM ( 1/Cappn ) )  = 1 / ( SUM ( slope.n ) )
     //                      n=i                        n=i
-    float sum = 0.0f;
-    LUnits fixed = 0.0f;
-    LUnits minWidth = 0.0f;
-    for (int i = iFirstCol; i <= iLastCol; ++i)
-    {
-        sum += m_columns[i]->m_slope;
-        fixed += m_columns[i]->m_xFixed;
-        minWidth += m_columns[i]->get_minimum_width();
-    }
+    accumulate_columns(iFirstCol, iLastCol);
+    float sum = m_accSlope;
+    LUnits fixed = m_accFixed;
+    LUnits minWidth = m_accMinWidth;
     float c = 1.0f / sum;
 
     //if minimum width is greater than required width, it is impossible to achieve
@@ -874,6 +1003,56 @@ bool SpAlgGourlay::is_better_option(float prevPenalty, float newPenalty,
     return (newPenalty + prevPenalty < nextPenalty);
 }
 
+//---------------------------------------------------------------------------------------
+bool SpAlgGourlay::is_overfull_line(int iSystem, int iFirstCol, int iLastCol)
+{
+    //When the minimum width is greater than the line width, the penalty for the
+    //line is a fixed value. Adding more columns only increases the minimum width
+    //(columns width is never negative), so the penalty for all longer lines will
+    //be the same, unless the line ends in a system break.
+
+    if (iFirstCol == iLastCol)
+        return false;
+
+    accumulate_columns(iFirstCol, iLastCol);
+    return m_accMinWidth > determine_line_width(iSystem);
+}
+
+//---------------------------------------------------------------------------------------
+LUnits SpAlgGourlay::determine_line_width(int iSystem)
+{
+    LUnits lineWidth = m_pScoreLyt->get_target_size_for_system(iSystem);
+    if (iSystem > 0)
+        lineWidth -= 1000.0f; //m_pScoreLyt->get_prolog_width_for_system(iSystem);
+    return lineWidth;
+}
+
+//---------------------------------------------------------------------------------------
+void SpAlgGourlay::accumulate_columns(int iFirstCol, int iLastCol)
+{
+    //The lines breaker evaluates lines {ci,...,cj} for increasing j. Therefore,
+    //sums for line {ci,...,cj-1} are reused instead of computing them again.
+    //AWARE: Columns are added always in the same order, so the sums are identical
+    //to those computed from scratch.
+
+    if (iFirstCol != m_iAccFirst || iLastCol < m_iAccLast)
+    {
+        m_iAccFirst = iFirstCol;
+        m_iAccLast = iFirstCol - 1;
+        m_accSlope = 0.0f;
+        m_accFixed = 0.0f;
+        m_accMinWidth = 0.0f;
+    }
+
+    for (int i = m_iAccLast + 1; i <= iLastCol; ++i)
+    {
+        m_accSlope += m_columns[i]->m_slope;
+        m_accFixed += m_columns[i]->m_xFixed;
+        m_accMinWidth += m_columns[i]->get_minimum_width();
+    }
+    m_iAccLast = iLastCol;
+}
+
 
 //=======================================================================================
 // TimeSlice implementation
@@ -38,12 +38,49 @@
 #include "lomse_logger.h"
 
 #include <sstream>
+#include <algorithm>
 using namespace std;
 
 
 namespace lomse
 {
 
+//=======================================================================================
+// VProfileRow implementation
+//=======================================================================================
+void VProfileRow::push_back(LUnits xp, LUnits yp, GmoShape* sp)
+{
+    x.push_back(xp);
+    y.push_back(yp);
+    shape.push_back(sp);
+}
+
+//---------------------------------------------------------------------------------------
+void VProfileRow::insert(int i, LUnits xp, LUnits yp, GmoShape* sp)
+{
+    x.insert(x.begin() + i, xp);
+    y.insert(y.begin() + i, yp);
+    shape.insert(shape.begin() + i, sp);
+}
+
+//---------------------------------------------------------------------------------------
+void VProfileRow::erase(int iFirst, int iLast)
+{
+    if (iFirst >= iLast)
+        return;
+
+    x.erase(x.begin() + iFirst, x.begin() + iLast);
+    y.erase(y.begin() + iFirst, y.begin() + iLast);
+    shape.erase(shape.begin() + iFirst, shape.begin() + iLast);
+}
+
+//---------------------------------------------------------------------------------------
+int VProfileRow::lower_bound(LUnits xPos) const
+{
+    return int(std::lower_bound(x.begin(), x.end(), xPos) - x.begin());
+}
+
+
 //=======================================================================================
 // VerticalProfile implementation
 //=======================================================================================
@@ -58,18 +95,13 @@ VerticalProfile::VerticalProfile(LUnits xStart, LUnits xEnd, int numStaves)
 	m_yStaffTop.resize(m_numStaves, 0.0f);
 	m_yStaffBottom.resize(m_numStaves, 0.0f);
 
-    m_xMax.resize(m_numStaves, nullptr);
-    m_xMin.resize(m_numStaves, nullptr);
+    m_xMax.resize(m_numStaves);
+    m_xMin.resize(m_numStaves);
 }
 
 //---------------------------------------------------------------------------------------
 VerticalProfile::~VerticalProfile()
 {
-    for (int idxStaff=0; idxStaff < m_numStaves; ++idxStaff)
-    {
-        delete m_xMax[idxStaff];
-        delete m_xMin[idxStaff];
-    }
 }
 
 //---------------------------------------------------------------------------------------
@@ -81,15 +113,15 @@ void VerticalProfile::initialize(int idxStaff, LUnits yStaffTop, LUnits yStaffBo
     m_yStaffTop[idxStaff] = yStaffTop;
     m_yStaffBottom[idxStaff] = yStaffBottom;
 
-    PointsRow* pPoints = LOMSE_NEW PointsRow;
-    m_xMax[idxStaff] = pPoints;
-    pPoints->push_back( {m_xStart, LOMSE_PAPER_LOWER_LIMIT, nullptr} );
-    pPoints->push_back( {m_xEnd, LOMSE_PAPER_LOWER_LIMIT, nullptr} );
+    VProfileRow& pointsMax = m_xMax[idxStaff];
+    pointsMax = VProfileRow();
+    pointsMax.push_back(m_xStart, LOMSE_PAPER_LOWER_LIMIT, nullptr);
+    pointsMax.push_back(m_xEnd, LOMSE_PAPER_LOWER_LIMIT, nullptr);
 
-    pPoints = LOMSE_NEW PointsRow;
-    m_xMin[idxStaff] = pPoints;
-    pPoints->push_back( {m_xStart, LOMSE_PAPER_UPPER_LIMIT, nullptr} );
-    pPoints->push_back( {m_xEnd, LOMSE_PAPER_UPPER_LIMIT, nullptr} );
+    VProfileRow& pointsMin = m_xMin[idxStaff];
+    pointsMin = VProfileRow();
+    pointsMin.push_back(m_xStart, LOMSE_PAPER_UPPER_LIMIT, nullptr);
+    pointsMin.push_back(m_xEnd, LOMSE_PAPER_UPPER_LIMIT, nullptr);
 }
 
 //---------------------------------------------------------------------------------------
@@ -174,135 +206,104 @@ void VerticalProfile::update_shape(GmoShape* pShape, int idxStaff)
 
 
     //update xPos and shapes, minimum profile
-    list<VProfilePoint>* pPointsMin = m_xMin[idxStaff];
-    update_profile(pPointsMin, yTop, false, xLeft, xRight, pShape);    //false -> minimum profile
+    update_profile(m_xMin[idxStaff], yTop, false, xLeft, xRight, pShape);  //false -> min.
 
     //update xPos and shapes, maximum profile
-    list<VProfilePoint>* pPointsMax = m_xMax[idxStaff];
-    update_profile(pPointsMax, yBottom, true, xLeft, xRight, pShape);  //true -> maximum profile
+    update_profile(m_xMax[idxStaff], yBottom, true, xLeft, xRight, pShape);  //true -> max.
 }
 
 //---------------------------------------------------------------------------------------
-void VerticalProfile::update_profile(list<VProfilePoint>* pPoints, LUnits yPos, bool fMax,
+void VerticalProfile::update_profile(VProfileRow& points, LUnits yPos, bool fMax,
                                      LUnits xLeft, LUnits xRight, GmoShape* pShape)
 {
-//    cout << "Update " << (fMax ? "Max" : "Min") << " ----------------------------------------------------" << endl;
+    //The points in range [xLeft, xRight) covered by the shape are merged in a single
+    //pass: points hidden by the shape are updated or removed, and the remaining
+    //points are compacted. Then, the removed points are erased at once.
 
-    PointsIterator itLeft = locate_insertion_point(pPoints, xLeft);
-    PointsIterator itPrevLeft = (itLeft != pPoints->begin() ? std::prev(itLeft) : itLeft);
-    VProfilePoint ptPrevLeft = *itPrevLeft;    //Data defining current level
+    int iLeft = points.lower_bound(xLeft);
+    VProfilePoint ptPrevLeft = points.point(iLeft > 0 ? iLeft - 1 : iLeft);  //current level
 
-    PointsIterator itRight = locate_insertion_point(pPoints, xRight);
-    PointsIterator itPrevRight = (itRight != pPoints->begin() ? std::prev(itRight) : itRight);
-    VProfilePoint ptPrevRight = *itPrevRight;
+    int iRight = points.lower_bound(xRight);
+    VProfilePoint ptPrevRight = points.point(iRight > 0 ? iRight - 1 : iRight);
 
 
-    //Insert/update point for left border of added shape
+    //Insert point for left border of added shape. If a point exists at xLeft it
+    //will be updated when dealing with intermediate points
     if ((fMax && (yPos > ptPrevLeft.y)) || (!fMax && (yPos < ptPrevLeft.y)))
     {
-        update_point(pPoints, xLeft, yPos, pShape, itLeft);
+        if (points.x[iLeft] != xLeft)
+        {
+            points.insert(iLeft, xLeft, yPos, pShape);
+            ++iLeft;
+            ++iRight;
+        }
     }
 
 
     //remove or update intermediate points if necessary
-    VProfilePoint ptRef = {xRight, yPos, pShape};   //left border of new added shape
-//    cout << "Ref.point: xPos=" << ptRef.x << ", ptRef.y=" << ptRef.y
-//         << ", ptRef.shape=" << (void*)(ptRef.shape) << endl;
-    LUnits yPrev = (*std::prev(itLeft)).y;
-    GmoShape* pPrevShape = (*std::prev(itLeft)).shape;
-//    cout << "itLeft: xPos=" << (*itLeft).x << ", itRight: xPos=" << (*itRight).x << endl;
-    while (itLeft != itRight)
+    bool fPrev = (iLeft > 0);
+    LUnits yPrev = (fPrev ? points.y[iLeft - 1] : 0.0f);
+    GmoShape* pPrevShape = (fPrev ? points.shape[iLeft - 1] : nullptr);
+    int iDest = iLeft;
+    for (int i = iLeft; i < iRight; ++i)
     {
-        VProfilePoint ptCur = *itLeft;
-//        cout << "Cur.point: xPos=" << ptCur.x << ", ptCur.y=" << ptCur.y
-//             << ", yPrev=" << yPrev << "--> ptRef.y=" << ptRef.y << endl;
-        if ( (!fMax && (ptCur.y > ptRef.y)) || (fMax && (ptCur.y < ptRef.y)) )
+        LUnits y = points.y[i];
+        if ( (!fMax && (y > yPos)) || (fMax && (y < yPos)) )
         {
-            if (yPrev == ptRef.y && pPrevShape == ptRef.shape)
-            {
-                //remove point
-                itLeft = pPoints->erase(itLeft);
-//                cout << "    Point removed. New itLeft: xPos=" << (*itLeft).x << endl;
-            }
-            else
-            {
-                //update point
-                (*itLeft).y = ptRef.y;
-                (*itLeft).shape = ptRef.shape;
-//                cout << "    Point updated: xPos=" << ptCur.x << ", yPos=" << ptRef.y
-//                     << ", shape=" << (void*)(ptRef.shape) << endl;
-//
-                yPrev = ptRef.y;
-                pPrevShape = ptRef.shape;
-                ++itLeft;
-            }
+            //remove point if it repeats previous one. Otherwise, update it
+            if (fPrev && yPrev == yPos && pPrevShape == pShape)
+                continue;
+
+            points.y[i] = yPos;
+            points.shape[i] = pShape;
         }
-        else
+
+        yPrev = points.y[i];
+        pPrevShape = points.shape[i];
+        fPrev = true;
+        if (iDest != i)
         {
-            //keep point as is
-//            cout << "    Point kept" << endl;
-            yPrev = (*itLeft).y;
-            pPrevShape = (*itLeft).shape;
-            ++itLeft;
+            points.x[iDest] = points.x[i];
+            points.y[iDest] = yPrev;
+            points.shape[iDest] = pPrevShape;
         }
+        ++iDest;
     }
-//    cout << endl;
+    points.erase(iDest, iRight);
+    iRight = iDest;
 
-    //Insert/update point for right border of added shape
+    //Insert point for right border of added shape, restoring previous level. If a
+    //point exists at xRight it is already valid
     if ((fMax && (yPos > ptPrevRight.y)) || (!fMax && (yPos < ptPrevRight.y)))
     {
-        update_point(pPoints, xRight, ptPrevRight.y, ptPrevRight.shape, itRight);
+        if (points.x[iRight] != xRight)
+            points.insert(iRight, xRight, ptPrevRight.y, ptPrevRight.shape);
     }
 }
 
 //---------------------------------------------------------------------------------------
-void VerticalProfile::update_point(list<VProfilePoint>* pPoints, LUnits xPos,
-                                   LUnits yPos, GmoShape* pShape, PointsIterator itNext)
+int VerticalProfile::locate_start_point(VProfileRow& points, LUnits xStart)
 {
-    VProfilePoint ptNext = *itNext;    //Data for point greater or equal to xLeft
-
-    //update minimum profile
-    if (xPos == ptNext.x)
-    {
-        //replace point. But nothing to do as existing point either:
-        //- is valid (this is the case for the right border of the new shape, or
-        //- will be upated when dealing with intermediate points (left border of new shape)
-    }
-    else    //xPos < ptNext.x
-    {
-        //insert point
-        pPoints->insert(itNext, VProfilePoint(xPos, yPos, pShape));
-    }
-}
+    //returns the index of the point defining the profile at xStart
 
-//---------------------------------------------------------------------------------------
-PointsIterator VerticalProfile::locate_insertion_point(list<VProfilePoint>* pPoints,
-                                                       LUnits xPos)
-{
-    list<VProfilePoint>::iterator it;
-    for (it = pPoints->begin(); it != pPoints->end(); ++it)
-    {
-        if ((*it).x >= xPos)
-            break;
-    }
-    return it;
+    int i = points.lower_bound(xStart);
+    return (i > 0 ? i - 1 : i);
 }
 
 //---------------------------------------------------------------------------------------
 std::pair<LUnits, GmoShape*> VerticalProfile::get_max_for(LUnits xStart, LUnits xEnd, int idxStaff)
 {
-    list<VProfilePoint>* pPoints = m_xMax[idxStaff];
-    PointsIterator it = locate_insertion_point(pPoints, xStart);
-    if (it != pPoints->begin())
-        --it;
-    LUnits yMax = (*it).y;
-    GmoShape* pShape = (*it).shape;
-    for (; it != pPoints->end() && (*it).x <= xEnd; ++it)
+    VProfileRow& points = m_xMax[idxStaff];
+    int i = locate_start_point(points, xStart);
+    int numPoints = points.size();
+    LUnits yMax = points.y[i];
+    GmoShape* pShape = points.shape[i];
+    for (; i < numPoints && points.x[i] <= xEnd; ++i)
     {
-        if (yMax <= (*it).y)
+        if (yMax <= points.y[i])
         {
-            yMax = (*it).y;
-            pShape = (*it).shape;
+            yMax = points.y[i];
+            pShape = points.shape[i];
         }
     }
     return make_pair(yMax, pShape);
@@ -312,18 +313,17 @@ std::pair<LUnits, GmoShape*> VerticalProfile::get_max_for(LUnits xStart, LUnits
 std::pair<LUnits, GmoShape*> VerticalProfile::get_min_for(LUnits xStart, LUnits xEnd,
                                                           int idxStaff)
 {
-    list<VProfilePoint>* pPoints = m_xMin[idxStaff];
-    PointsIterator it = locate_insertion_point(pPoints, xStart);
-    if (it != pPoints->begin())
-        --it;
-    LUnits yMin = (*it).y;
-    GmoShape* pShape = (*it).shape;
-    for (; it != pPoints->end() && (*it).x <= xEnd; ++it)
+    VProfileRow& points = m_xMin[idxStaff];
+    int i = locate_start_point(points, xStart);
+    int numPoints = points.size();
+    LUnits yMin = points.y[i];
+    GmoShape* pShape = points.shape[i];
+    for (; i < numPoints && points.x[i] <= xEnd; ++i)
     {
-        if (yMin >= (*it).y)
+        if (yMin >= points.y[i])
         {
-            yMin = (*it).y;
-            pShape = (*it).shape;
+            yMin = points.y[i];
+            pShape = points.shape[i];
         }
     }
     return make_pair(yMin, pShape);
@@ -357,13 +357,12 @@ GmoShape* VerticalProfile::dbg_generate_shape(bool fMax, int idxStaff)
     LUnits xLast = xStart;
     LUnits yLast = yStart;
 
-    list<VProfilePoint>* pPoints = (fMax ? m_xMax[idxStaff] : m_xMin[idxStaff]);
-    PointsIterator it;
-    for (it=pPoints->begin(); it != pPoints->end(); ++it)
+    VProfileRow& points = (fMax ? m_xMax[idxStaff] : m_xMin[idxStaff]);
+    for (int i=0; i < points.size(); ++i)
     {
-        xLast = (*it).x;
+        xLast = points.x[i];
         pShape->add_vertex('L', xLast, yLast);
-        yLast = ((*it).y == yInfinite ? yBase : (*it).y);
+        yLast = (points.y[i] == yInfinite ? yBase : points.y[i]);
         pShape->add_vertex('L', xLast, yLast);
     }
     pShape->add_vertex('L', xLast, yStart);
@@ -386,13 +385,12 @@ string VerticalProfile::dump_max(int idxStaff)
 }
 
 //---------------------------------------------------------------------------------------
-string VerticalProfile::dump(list<VProfilePoint>* pPoints)
+string VerticalProfile::dump(VProfileRow& points)
 {
     stringstream msg;
-    PointsIterator it;
-    for (it=pPoints->begin(); it != pPoints->end(); ++it)
+    for (int i=0; i < points.size(); ++i)
     {
-        msg << "(" << (*it).x << ", " << (*it).y << "),";
+        msg << "(" << points.x[i] << ", " << points.y[i] << "),";
     }
     return msg.str();
 }
@@ -402,44 +400,44 @@ LUnits VerticalProfile::get_staves_distance(int idxStaff)
 {
     int idxPrev = idxStaff - 1;
 
-    list<VProfilePoint>* pPointsPrev = m_xMax[idxPrev];
-    list<VProfilePoint>* pPointsCur = m_xMin[idxStaff];
-    PointsIterator itPrev = pPointsPrev->begin();
-	LUnits xPrev = (*itPrev).x;
-    LUnits yPrev = ((*itPrev).y == LOMSE_PAPER_LOWER_LIMIT ? m_yStaffBottom[idxPrev]
-                                                           : (*itPrev).y);
-
-    PointsIterator itCur = pPointsCur->begin();
-	LUnits xCur = (*itCur).x;
-    LUnits yCur = ((*itCur).y == LOMSE_PAPER_UPPER_LIMIT ? m_yStaffTop[idxStaff]
-                                                         : (*itCur).y);
-	LUnits distance = yCur - yPrev;
-
-	while (itPrev != pPointsPrev->end() && itCur != pPointsCur->end())
-	{
-	    if (itPrev != pPointsPrev->end() && xPrev <= xCur)
-        {
-            yPrev = ((*itPrev).y == LOMSE_PAPER_LOWER_LIMIT ? m_yStaffBottom[idxPrev]
-                                                            : (*itPrev).y);
-	        ++itPrev;
-	        if (itPrev != pPointsPrev->end())
-                xPrev = (*itPrev).x;
-        }
-        else if (itCur != pPointsCur->end())
+    VProfileRow& pointsPrev = m_xMax[idxPrev];
+    VProfileRow& pointsCur = m_xMin[idxStaff];
+    int numPrev = pointsPrev.size();
+    int numCur = pointsCur.size();
+
+    int iPrev = 0;
+    LUnits xPrev = pointsPrev.x[0];
+    LUnits yPrev = (pointsPrev.y[0] == LOMSE_PAPER_LOWER_LIMIT ? m_yStaffBottom[idxPrev]
+                                                               : pointsPrev.y[0]);
+
+    int iCur = 0;
+    LUnits xCur = pointsCur.x[0];
+    LUnits yCur = (pointsCur.y[0] == LOMSE_PAPER_UPPER_LIMIT ? m_yStaffTop[idxStaff]
+                                                             : pointsCur.y[0]);
+    LUnits distance = yCur - yPrev;
+
+    while (iPrev < numPrev && iCur < numCur)
+    {
+        if (xPrev <= xCur)
         {
-            yCur = ((*itCur).y == LOMSE_PAPER_UPPER_LIMIT ? m_yStaffTop[idxStaff]
-                                                          : (*itCur).y);
-            ++itCur;
-	        if (itCur != pPointsCur->end())
-                xCur = (*itCur).x;
+            yPrev = pointsPrev.y[iPrev];
+            if (yPrev == LOMSE_PAPER_LOWER_LIMIT)
+                yPrev = m_yStaffBottom[idxPrev];
+            ++iPrev;
+            if (iPrev < numPrev)
+                xPrev = pointsPrev.x[iPrev];
         }
         else
         {
-            LOMSE_LOG_ERROR("Impossible case!");
-            break;
+            yCur = pointsCur.y[iCur];
+            if (yCur == LOMSE_PAPER_UPPER_LIMIT)
+                yCur = m_yStaffTop[idxStaff];
+            ++iCur;
+            if (iCur < numCur)
+                xCur = pointsCur.x[iCur];
         }
-	    distance = min(distance, yCur - yPrev);
-	}
+        distance = min(distance, yCur - yPrev);
+    }
 
     return distance;
 }
@@ -449,15 +447,13 @@ vector<UPoint> VerticalProfile::get_min_profile_points(LUnits xStart, LUnits xEn
                                                        int idxStaff)
 {
     vector<UPoint> dataPoints;
-    list<VProfilePoint>* pPoints = m_xMin[idxStaff];
-    PointsIterator it = locate_insertion_point(pPoints, xStart);
-    if (it != pPoints->begin())
-        --it;
-
-    for (; it != pPoints->end() && (*it).x <= xEnd; ++it)
+    VProfileRow& points = m_xMin[idxStaff];
+    int numPoints = points.size();
+    int i = locate_start_point(points, xStart);
+    for (; i < numPoints && points.x[i] <= xEnd; ++i)
     {
-        if ((*it).y != LOMSE_PAPER_UPPER_LIMIT)
-            dataPoints.push_back( UPoint((*it).x, (*it).y) );
+        if (points.y[i] != LOMSE_PAPER_UPPER_LIMIT)
+            dataPoints.push_back( UPoint(points.x[i], points.y[i]) );
     }
     return dataPoints;
 }
@@ -467,15 +463,13 @@ vector<UPoint> VerticalProfile::get_max_profile_points(LUnits xStart, LUnits xEn
                                                        int idxStaff)
 {
     vector<UPoint> dataPoints;
-    list<VProfilePoint>* pPoints = m_xMax[idxStaff];
-    PointsIterator it = locate_insertion_point(pPoints, xStart);
-    if (it != pPoints->begin())
-        --it;
-
-    for (; it != pPoints->end() && (*it).x <= xEnd; ++it)
+    VProfileRow& points = m_xMax[idxStaff];
+    int numPoints = points.size();
+    int i = locate_start_point(points, xStart);
+    for (; i < numPoints && points.x[i] <= xEnd; ++i)
     {
-        if ((*it).y != LOMSE_PAPER_LOWER_LIMIT)
-            dataPoints.push_back( UPoint((*it).x, (*it).y) );
+        if (points.y[i] != LOMSE_PAPER_LOWER_LIMIT)
+            dataPoints.push_back( UPoint(points.x[i], points.y[i]) );
     }
     return dataPoints;
 }
@@ -40,6 +40,7 @@
 #include "lomse_logger.h"
 #include "lomse_gm_measures_table.h"
 
+#include <algorithm>    //min
 #include <cstdlib>      //abs
 #include <iomanip>
 
@@ -131,6 +132,7 @@ void GmoObj::shift_origin(const USize& shift)
 {
     m_origin.x += shift.width;
     m_origin.y += shift.height;
+    on_geometry_changed();
 }
 
 //---------------------------------------------------------------------------------------
@@ -138,6 +140,18 @@ void GmoObj::shift_origin(LUnits x, LUnits y)
 {
     m_origin.x += x;
     m_origin.y += y;
+    on_geometry_changed();
+}
+
+//---------------------------------------------------------------------------------------
+void GmoObj::invalidate_page_shapes_index()
+{
+    GmoBox* pBox = m_pParentBox;
+    while (pBox && !pBox->is_box_doc_page())
+        pBox = pBox->get_parent_box();
+
+    if (pBox)
+        static_cast<GmoBoxDocPage*>(pBox)->invalidate_shapes_index();
 }
 
 //---------------------------------------------------------------------------------------
@@ -869,9 +883,16 @@ void GmoBoxDocPage::add_to_tables(GmoShape* pShape)
     else
         m_allShapes.insert(it, pShape);
 
+    m_shapesIndex.invalidate();
     store_in_map_imo_shape(pShape);
 }
 
+//---------------------------------------------------------------------------------------
+void GmoBoxDocPage::build_shapes_index()
+{
+    m_shapesIndex.build(m_allShapes);
+}
+
 //---------------------------------------------------------------------------------------
 void GmoBoxDocPage::store_in_map_imo_shape(GmoShape* pShape)
 {
@@ -884,6 +905,30 @@ void GmoBoxDocPage::store_in_map_imo_shape(GmoShape* pShape)
     }
 }
 
+//---------------------------------------------------------------------------------------
+void GmoBoxDocPage::store_all_shapes_in_map_imo_shape()
+{
+    std::list<GmoShape*>::iterator it;
+    for (it = m_allShapes.begin(); it != m_allShapes.end(); ++it)
+        store_in_map_imo_shape(*it);
+}
+
+//---------------------------------------------------------------------------------------
+void GmoBoxDocPage::remove_all_shapes_from_map_imo_shape()
+{
+    GraphicModel* pModel = get_graphic_model();
+    if (!pModel)
+        return;
+
+    std::list<GmoShape*>::iterator it;
+    for (it = m_allShapes.begin(); it != m_allShapes.end(); ++it)
+    {
+        ImoObj* pImo = (*it)->get_creator_imo();
+        if (pImo)
+            pModel->remove_from_map_imo_shape(pImo, *it);
+    }
+}
+
 //---------------------------------------------------------------------------------------
 GmoShape* GmoBoxDocPage::get_first_shape_for_layer(int layer)
 {
@@ -899,25 +944,19 @@ GmoShape* GmoBoxDocPage::get_first_shape_for_layer(int layer)
 //---------------------------------------------------------------------------------------
 GmoShape* GmoBoxDocPage::find_shape_at(LUnits x, LUnits y)
 {
-    std::list<GmoShape*>::reverse_iterator it;
-    for (it = m_allShapes.rbegin(); it != m_allShapes.rend(); ++it)
-    {
-        if ((*it)->hit_test(x, y))
-            return *it;
-    }
-    return nullptr;
+    if (!m_shapesIndex.is_valid())
+        build_shapes_index();
+
+    return m_shapesIndex.find_shape_at(x, y);
 }
 
 //---------------------------------------------------------------------------------------
 GmoShape* GmoBoxDocPage::find_shape_for_object(ImoStaffObj* pSO)
 {
-    std::list<GmoShape*>::iterator it;
-    for (it = m_allShapes.begin(); it != m_allShapes.end(); ++it)
-    {
-        if ((*it)->was_created_by(pSO))
-            return *it;
-    }
-    return nullptr;
+    if (!m_shapesIndex.is_valid())
+        build_shapes_index();
+
+    return m_shapesIndex.find_shape_for_object(pSO);
 }
 
 //---------------------------------------------------------------------------------------
@@ -939,17 +978,16 @@ void GmoBoxDocPage::select_objects_in_rectangle(SelectionSet* selection,
                                                 const URect& selRect,
                                                 unsigned UNUSED(flags))
 {
-    bool fSomethingSelected = false;
-    std::list<GmoShape*>::reverse_iterator it;
-    for (it = m_allShapes.rbegin(); it != m_allShapes.rend(); ++it)
-    {
-        URect bbox = (*it)->get_bounds();
-        if (selRect.contains(bbox))
-        {
-            selection->add(*it);
-            fSomethingSelected = true;
-        }
-    }
+    if (!m_shapesIndex.is_valid())
+        build_shapes_index();
+
+    std::vector<GmoShape*> shapes;
+    m_shapesIndex.find_shapes_in_rectangle(selRect, shapes);
+
+    bool fSomethingSelected = !shapes.empty();
+    std::vector<GmoShape*>::iterator it;
+    for (it = shapes.begin(); it != shapes.end(); ++it)
+        selection->add(*it);
 
     //if no objects in rectangle try to select clicked object
     if (!fSomethingSelected)
@@ -982,6 +1020,43 @@ GmoBoxDocPage* GmoBoxDocument::add_new_page()
     return m_pLastPage;
 }
 
+//---------------------------------------------------------------------------------------
+void GmoBoxDocument::take_pages_from(GmoBoxDocument* pSource, int numPages)
+{
+    //moves the first numPages pages of pSource to the end of this document
+
+    vector<GmoBox*>& source = pSource->m_childBoxes;
+    numPages = min(numPages, int(source.size()));
+    for (int i=0; i < numPages; ++i)
+    {
+        GmoBoxDocPage* pPage = static_cast<GmoBoxDocPage*>(source[i]);
+        add_child_box(pPage);
+        pPage->set_number(get_num_pages());
+        m_pLastPage = pPage;
+    }
+    source.erase(source.begin(), source.begin() + numPages);
+
+    if (source.empty())
+        pSource->m_pLastPage = nullptr;
+}
+
+//---------------------------------------------------------------------------------------
+void GmoBoxDocument::delete_pages_from(int iPage)
+{
+    //deletes pages iPage..n-1
+
+    int numPages = get_num_pages();
+    if (iPage >= numPages)
+        return;
+
+    for (int i=iPage; i < numPages; ++i)
+        delete m_childBoxes[i];
+    m_childBoxes.erase(m_childBoxes.begin() + iPage, m_childBoxes.end());
+
+    m_pLastPage = (m_childBoxes.empty() ? nullptr
+                   : static_cast<GmoBoxDocPage*>(m_childBoxes.back()) );
+}
+
 //---------------------------------------------------------------------------------------
 GmoBoxDocPage* GmoBoxDocument::get_page(int i)
 {
@@ -1080,6 +1155,7 @@ void GmoBoxLink::notify_event(SpEventInfo pEvent)
 //=======================================================================================
 ScoreStub::ScoreStub(ImoScore* pScore)
     : m_scoreId(pScore->get_id())
+    , m_fTimelineValid(false)
 {
     m_measures = LOMSE_NEW GmMeasuresTable(pScore);
 }
@@ -1090,18 +1166,74 @@ ScoreStub::~ScoreStub()
     delete m_measures;
 }
 
+//---------------------------------------------------------------------------------------
+void ScoreStub::copy_measures_from(ScoreStub* pStub)
+{
+    delete m_measures;
+    m_measures = LOMSE_NEW GmMeasuresTable( *(pStub->m_measures) );
+}
+
+//---------------------------------------------------------------------------------------
+void ScoreStub::append_pages_from(ScoreStub* pStub)
+{
+    m_pages.insert(m_pages.end(), pStub->m_pages.begin(), pStub->m_pages.end());
+    pStub->m_pages.clear();
+
+    delete m_measures;
+    m_measures = pStub->m_measures;
+    pStub->m_measures = nullptr;
+
+    m_fTimelineValid = false;
+}
+
+//---------------------------------------------------------------------------------------
+bool ScoreStub::remove_pages_from(int iDocPage)
+{
+    //doc page numbers are 1..n
+    vector<GmoBoxScorePage*>::iterator it = m_pages.begin();
+    while (it != m_pages.end() && (*it)->get_page_box()->get_number() <= iDocPage)
+        ++it;
+    m_pages.erase(it, m_pages.end());
+
+    m_fTimelineValid = false;
+    return !m_pages.empty();
+}
+
 //---------------------------------------------------------------------------------------
 GmoBoxScorePage* ScoreStub::get_page_for(TimeUnits timepos)
 {
     //find page with end time greater or equal than requested time
 
-    int maxPage = int(m_pages.size());
-    int i=0;
-    for (; i < maxPage; ++i)
-    {
-//        LOMSE_LOG_DEBUG(Logger::k_events, "page %d. End time = %f",
-//                        i, m_pages[i]->end_time());
+    int i = find_page_span(timepos);
+    return (i == -1 ? nullptr : static_cast<GmoBoxScorePage*>(m_pageSpans[i].pBox));
+}
+
+//---------------------------------------------------------------------------------------
+GmoBoxSystem* ScoreStub::get_system_for(TimeUnits timepos)
+{
+    //find system, in the page for requested time, with end time greater or equal
+    //than requested time
+
+    int iPage = find_page_span(timepos);
+    if (iPage == -1)
+        return nullptr;
+
+    int iStart = m_pageSpans[iPage].iFirstSystem;
+    int iEnd = (iPage + 1 < int(m_pageSpans.size()) ? m_pageSpans[iPage+1].iFirstSystem
+                                                    : int(m_systemSpans.size()) );
+    int i = find_span(m_systemSpans, iStart, iEnd, timepos);
+    return (i == -1 ? nullptr : static_cast<GmoBoxSystem*>(m_systemSpans[i].pBox));
+}
+
+//---------------------------------------------------------------------------------------
+void ScoreStub::build_timeline()
+{
+    m_pageSpans.clear();
+    m_systemSpans.clear();
 
+    vector<GmoBoxScorePage*>::iterator it;
+    for (it = m_pages.begin(); it != m_pages.end(); ++it)
+    {
         //BUG-BYPASS: first page could be empty when the score is embedded in a text and
         // space in current page is small. In these cases, an score page is allocated
         // at the end of current document page, but as there is not enough space for
@@ -1109,28 +1241,63 @@ GmoBoxScorePage* ScoreStub::get_page_for(TimeUnits timepos)
         // This causes the previously allocated score page to remain without content.
         // This is a bug bypass. The real solution would be not to allocate the unused
         // page or to remove it from ScoreStub.
-        if (m_pages[i]->get_num_systems() == 0)
+        GmoBoxScorePage* pPage = *it;
+        if (pPage->get_num_systems() == 0)
             continue;
 
-        if (is_lower_time(timepos, m_pages[i]->end_time()))
-            break;
-        else if(is_equal_time(timepos, m_pages[i]->end_time()))
+        TimelineSpan page = { pPage, pPage->start_time(), pPage->end_time(),
+                              pPage->end_time(), int(m_systemSpans.size()) };
+        if (!m_pageSpans.empty())
+            page.maxEndTime = max(page.maxEndTime, m_pageSpans.back().maxEndTime);
+        m_pageSpans.push_back(page);
+
+        int iFirst = pPage->get_num_first_system();
+        int iMax = iFirst + pPage->get_num_systems();
+        for (int i = iFirst; i < iMax; ++i)
         {
-            //look in next page
-            int iNext = i + 1;
-            if (iNext < maxPage)
-            {
-                if (is_equal_time(timepos, m_pages[iNext]->start_time()))
-                    ++i;
-            }
-            break;
+            GmoBoxSystem* pSystem = pPage->get_system(i);
+            TimelineSpan system = { pSystem, pSystem->start_time(), pSystem->end_time(),
+                                    pSystem->end_time(), -1 };
+            if (i > iFirst)
+                system.maxEndTime = max(system.maxEndTime, m_systemSpans.back().maxEndTime);
+            m_systemSpans.push_back(system);
         }
     }
-    if (i == maxPage)
-        return nullptr;
-    else
-        return m_pages[i];
+    m_fTimelineValid = true;
+}
+
+//---------------------------------------------------------------------------------------
+int ScoreStub::find_page_span(TimeUnits timepos)
+{
+    if (!m_fTimelineValid)
+        build_timeline();
+
+    return find_span(m_pageSpans, 0, int(m_pageSpans.size()), timepos);
 }
 
+//---------------------------------------------------------------------------------------
+int ScoreStub::find_span(vector<TimelineSpan>& spans, int iStart, int iEnd,
+                         TimeUnits timepos)
+{
+    //Returns the index of the first span, in range [iStart, iEnd), with end time greater
+    //or equal than timepos, or -1 if none. When timepos is the end time of the span,
+    //preference is given to next span if it starts at timepos.
+
+    vector<TimelineSpan>::iterator it =
+        lower_bound(spans.begin() + iStart, spans.begin() + iEnd, timepos,
+                    [](const TimelineSpan& span, TimeUnits t) {
+                        return is_lower_time(span.maxEndTime, t);
+                    });
+    int i = int(it - spans.begin());
+    if (i == iEnd)
+        return -1;
+
+    if (is_equal_time(timepos, spans[i].endTime)
+        && i + 1 < iEnd && is_equal_time(timepos, spans[i+1].startTime))
+    {
+        ++i;
+    }
+    return i;
+}
 
 }  //namespace lomse
@@ -50,6 +50,20 @@ GmMeasuresTable::GmMeasuresTable(ImoScore* pScore)
     initialize_vectors(pScore);
 }
 
+//---------------------------------------------------------------------------------------
+GmMeasuresTable::GmMeasuresTable(const GmMeasuresTable& table)
+    : m_numBarlines(table.m_numBarlines)
+{
+    //the barline shapes are not copied: both tables point to the same shapes
+
+    for (size_t iInstr=0; iInstr < table.m_instrument.size(); ++iInstr)
+    {
+        BarlinesVector* pBarlines = table.m_instrument[iInstr];
+        m_instrument.push_back(pBarlines ? LOMSE_NEW BarlinesVector(*pBarlines)
+                                         : nullptr);
+    }
+}
+
 //---------------------------------------------------------------------------------------
 GmMeasuresTable::~GmMeasuresTable()
 {
@@ -109,6 +123,26 @@ void GmMeasuresTable::finish_measure(int iInstr, GmoShapeBarline* pBarlineShape)
     m_numBarlines[iInstr]++;
 }
 
+//---------------------------------------------------------------------------------------
+void GmMeasuresTable::truncate(ImoScore* pScore, const vector<int>& numMeasures)
+{
+    for (size_t iInstr=0; iInstr < m_instrument.size(); ++iInstr)
+    {
+        ImoInstrument* pInstr = pScore->get_instrument(int(iInstr));
+        ImMeasuresTable* pTable = pInstr->get_measures_table();
+        if (!pTable)
+            continue;
+
+        if (!m_instrument[iInstr])
+            m_instrument[iInstr] = LOMSE_NEW BarlinesVector;
+
+        BarlinesVector* pBarlines = m_instrument[iInstr];
+        pBarlines->resize(numMeasures[iInstr]);
+        pBarlines->resize(pTable->num_entries(), nullptr);
+    }
+    m_numBarlines = numMeasures;
+}
+
 //---------------------------------------------------------------------------------------
 LUnits GmMeasuresTable::get_end_barline_left(int iInstr, int iMeasure,
                                              GmoBoxSystem* pBox)
@@ -0,0 +1,296 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2020. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+//---------------------------------------------------------------------------------------
+
+#include "lomse_gm_shapes_index.h"
+
+#include "lomse_gm_basic.h"
+
+//std
+#include <algorithm>
+#include <cmath>
+using namespace std;
+
+namespace lomse
+{
+
+//---------------------------------------------------------------------------------------
+// Helpers for sorting index items (entries or nodes) by the center of their bounds
+template <class T>
+struct CenterXLess
+{
+    bool operator()(const T& a, const T& b) const {
+        return (a.left + a.right) < (b.left + b.right);
+    }
+};
+
+template <class T>
+struct CenterYLess
+{
+    bool operator()(const T& a, const T& b) const {
+        return (a.top + a.bottom) < (b.top + b.bottom);
+    }
+};
+
+//---------------------------------------------------------------------------------------
+// Sort-Tile-Recursive ordering: items are sorted by x center and split in vertical
+// slices. Then, items in each slice are sorted by y center. After this, each group
+// of 'capacity' consecutive items is a good candidate for a tree node.
+template <class T>
+static void sort_tile_recursive(vector<T>& items, int capacity)
+{
+    size_t n = items.size();
+    size_t numPacks = (n + capacity - 1) / capacity;
+    size_t numSlices = size_t( ceil( sqrt(double(numPacks)) ) );
+    size_t sliceSize = numSlices * capacity;
+
+    std::sort(items.begin(), items.end(), CenterXLess<T>());
+    for (size_t i=0; i < n; i += sliceSize)
+    {
+        size_t last = min(n, i + sliceSize);
+        std::sort(items.begin() + i, items.begin() + last, CenterYLess<T>());
+    }
+}
+
+//---------------------------------------------------------------------------------------
+template <class N, class T>
+static void set_node_bounds(N& node, vector<T>& items, size_t first, size_t count)
+{
+    node.left = items[first].left;
+    node.top = items[first].top;
+    node.right = items[first].right;
+    node.bottom = items[first].bottom;
+    for (size_t i=first+1; i < first + count; ++i)
+    {
+        node.left = min(node.left, items[i].left);
+        node.top = min(node.top, items[i].top);
+        node.right = max(node.right, items[i].right);
+        node.bottom = max(node.bottom, items[i].bottom);
+    }
+}
+
+
+//=======================================================================================
+// GmShapesIndex implementation
+//=======================================================================================
+GmShapesIndex::GmShapesIndex()
+    : m_fValid(false)
+{
+}
+
+//---------------------------------------------------------------------------------------
+void GmShapesIndex::clear()
+{
+    m_entries.clear();
+    m_nodes.clear();
+    m_imoToShape.clear();
+    m_fValid = false;
+}
+
+//---------------------------------------------------------------------------------------
+void GmShapesIndex::build(std::list<GmoShape*>& shapes)
+{
+    clear();
+    m_entries.reserve(shapes.size());
+
+    int order = 0;
+    std::list<GmoShape*>::iterator it;
+    for (it = shapes.begin(); it != shapes.end(); ++it, ++order)
+    {
+        GmoShape* pShape = *it;
+        URect bbox = pShape->get_bounds();
+        Entry entry;
+        entry.left = min(bbox.left(), bbox.right());
+        entry.right = max(bbox.left(), bbox.right());
+        entry.top = min(bbox.top(), bbox.bottom());
+        entry.bottom = max(bbox.top(), bbox.bottom());
+        entry.order = order;
+        entry.pShape = pShape;
+        m_entries.push_back(entry);
+        pShape->set_in_shapes_index(true);
+
+        ImoObj* pImo = pShape->get_creator_imo();
+        if (pImo && m_imoToShape.find(pImo) == m_imoToShape.end())
+            m_imoToShape[pImo] = pShape;
+    }
+
+    if (!m_entries.empty())
+    {
+        vector<Node> level;
+        build_leaves(level);
+        build_upper_levels(level);
+    }
+    m_fValid = true;
+}
+
+//---------------------------------------------------------------------------------------
+void GmShapesIndex::build_leaves(std::vector<Node>& leaves)
+{
+    sort_tile_recursive(m_entries, k_max_children);
+
+    size_t n = m_entries.size();
+    leaves.reserve((n + k_max_children - 1) / k_max_children);
+    for (size_t i=0; i < n; i += k_max_children)
+    {
+        Node node;
+        node.first = int(i);
+        node.count = int( min(n - i, size_t(k_max_children)) );
+        node.fLeaf = true;
+        set_node_bounds(node, m_entries, i, size_t(node.count));
+        leaves.push_back(node);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void GmShapesIndex::build_upper_levels(std::vector<Node>& level)
+{
+    //nodes are saved level by level, from leaves to root. Root is the last node.
+    while (level.size() > 1)
+    {
+        sort_tile_recursive(level, k_max_children);
+
+        int base = int(m_nodes.size());
+        m_nodes.insert(m_nodes.end(), level.begin(), level.end());
+
+        size_t n = level.size();
+        vector<Node> parents;
+        parents.reserve((n + k_max_children - 1) / k_max_children);
+        for (size_t i=0; i < n; i += k_max_children)
+        {
+            Node node;
+            node.first = base + int(i);
+            node.count = int( min(n - i, size_t(k_max_children)) );
+            node.fLeaf = false;
+            set_node_bounds(node, level, i, size_t(node.count));
+            parents.push_back(node);
+        }
+        level.swap(parents);
+    }
+    m_nodes.push_back(level.front());
+}
+
+//---------------------------------------------------------------------------------------
+GmoShape* GmShapesIndex::find_shape_at(LUnits x, LUnits y)
+{
+    if (m_nodes.empty())
+        return nullptr;
+
+    GmoShape* pFound = nullptr;
+    int maxOrder = -1;
+
+    vector<int> pending;
+    pending.push_back(int(m_nodes.size()) - 1);
+    while (!pending.empty())
+    {
+        const Node& node = m_nodes[pending.back()];
+        pending.pop_back();
+
+        if (x < node.left || x > node.right || y < node.top || y > node.bottom)
+            continue;
+
+        if (node.fLeaf)
+        {
+            for (int i = node.first; i < node.first + node.count; ++i)
+            {
+                Entry& entry = m_entries[i];
+                if (entry.order > maxOrder && entry.pShape->hit_test(x, y))
+                {
+                    maxOrder = entry.order;
+                    pFound = entry.pShape;
+                }
+            }
+        }
+        else
+        {
+            for (int i = node.first; i < node.first + node.count; ++i)
+                pending.push_back(i);
+        }
+    }
+    return pFound;
+}
+
+//---------------------------------------------------------------------------------------
+void GmShapesIndex::find_shapes_in_rectangle(const URect& rect,
+                                             std::vector<GmoShape*>& found)
+{
+    if (m_nodes.empty())
+        return;
+
+    vector< pair<int, GmoShape*> > shapes;
+    LUnits left = rect.left();
+    LUnits right = rect.right();
+    LUnits top = rect.top();
+    LUnits bottom = rect.bottom();
+
+    vector<int> pending;
+    pending.push_back(int(m_nodes.size()) - 1);
+    while (!pending.empty())
+    {
+        const Node& node = m_nodes[pending.back()];
+        pending.pop_back();
+
+        if (node.right < left || node.left > right
+            || node.bottom < top || node.top > bottom)
+        {
+            continue;
+        }
+
+        if (node.fLeaf)
+        {
+            for (int i = node.first; i < node.first + node.count; ++i)
+            {
+                Entry& entry = m_entries[i];
+                if (rect.contains(entry.pShape->get_bounds()))
+                    shapes.push_back( make_pair(entry.order, entry.pShape) );
+            }
+        }
+        else
+        {
+            for (int i = node.first; i < node.first + node.count; ++i)
+                pending.push_back(i);
+        }
+    }
+
+    //return them in z-order, from top to bottom
+    std::sort(shapes.begin(), shapes.end());
+    vector< pair<int, GmoShape*> >::reverse_iterator it;
+    for (it = shapes.rbegin(); it != shapes.rend(); ++it)
+        found.push_back(it->second);
+}
+
+//---------------------------------------------------------------------------------------
+GmoShape* GmShapesIndex::find_shape_for_object(ImoObj* pImo)
+{
+    std::map<ImoObj*, GmoShape*>::const_iterator it = m_imoToShape.find(pImo);
+    if (it != m_imoToShape.end())
+        return it->second;
+    return nullptr;
+}
+
+
+}  //namespace lomse
@@ -46,6 +46,7 @@
 
 #include <cstdlib>      //abs
 #include <iomanip>
+#include <atomic>
 
 
 namespace lomse
@@ -55,11 +56,12 @@ namespace lomse
 //=======================================================================================
 // Graphic model implementation
 //=======================================================================================
-static long m_idCounter = 0L;
+static std::atomic<long> m_idCounter(0L);     //models can be built in a layout thread
 
 //---------------------------------------------------------------------------------------
 GraphicModel::GraphicModel()
     : m_modified(true)
+    , m_modificationStamp(0L)
 {
     m_root = LOMSE_NEW GmoBoxDocument(this, nullptr);    //TODO: replace nullptr by ImoDocument
     m_modelId = ++m_idCounter;
@@ -164,6 +166,29 @@ void GraphicModel::store_in_map_imo_shape(ImoObj* pImo, GmoShape* pShape)
         m_imoToMainShape[id] = pShape;
 }
 
+//---------------------------------------------------------------------------------------
+void GraphicModel::remove_from_map_imo_shape(ImoObj* pImo, GmoShape* pShape)
+{
+    //entries are removed only when they still point to pShape, as the same Imo
+    //could also have shapes in other pages
+
+    ImoId id = pImo->get_id();
+    ShapeId idx = pShape->get_shape_id();
+    if (idx > 0)
+    {
+        map< pair<ImoId, ShapeId>, GmoShape*>::iterator it
+            = m_imoToSecondaryShape.find( make_pair(id, idx) );
+        if (it != m_imoToSecondaryShape.end() && it->second == pShape)
+            m_imoToSecondaryShape.erase(it);
+    }
+    else
+    {
+        map<ImoId, GmoShape*>::iterator it = m_imoToMainShape.find(id);
+        if (it != m_imoToMainShape.end() && it->second == pShape)
+            m_imoToMainShape.erase(it);
+    }
+}
+
 //---------------------------------------------------------------------------------------
 void GraphicModel::add_to_map_imo_to_box(GmoBox* pBox)
 {
@@ -253,6 +278,9 @@ GmoBox* GraphicModel::get_box_for_imo(ImoId id)
 //---------------------------------------------------------------------------------------
 void GraphicModel::build_main_boxes_table()
 {
+    m_imoToBox.clear();
+    m_ctrolToPtr.clear();
+
     if (m_root)
     {
         vector<GmoBox*>& pageBoxes = m_root->get_child_boxes();
@@ -272,8 +300,80 @@ void GraphicModel::build_main_boxes_table()
 //                for (it=childBoxes.begin(); it != childBoxes.end(); ++it)
 //                    add_to_map_imo_to_box(*it);
             }
+
+            static_cast<GmoBoxDocPage*>(*itP)->build_shapes_index();
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void GraphicModel::take_pages_from(GraphicModel* pSource, int numPages)
+{
+    //Moves the first numPages pages of pSource to the end of this model, for reusing
+    //them in an incremental layout or for appending the pages of a resumed layout.
+    //Only whole pages are moved, so stubs for the scores in the moved pages are also
+    //moved. When a score continues from the pages in this model, its stubs are merged.
+    //Tables for boxes and controls are not moved: they will be rebuilt by
+    //build_main_boxes_table().
+
+    int firstPage = get_num_pages();
+    m_root->take_pages_from(pSource->m_root, numPages);
+    int numMoved = get_num_pages() - firstPage;
+
+    for (int i=firstPage; i < firstPage + numMoved; ++i)
+        get_page(i)->store_all_shapes_in_map_imo_shape();
+
+    map<ImoId, ScoreStub*>::iterator it = pSource->m_scores.begin();
+    while (it != pSource->m_scores.end())
+    {
+        vector<GmoBoxScorePage*>& pages = (it->second)->get_pages();
+        if (!pages.empty() && pages.front()->get_page_box()->get_owner_box() == m_root)
+        {
+            ScoreStub* pStub = get_stub_for(it->first);
+            if (pStub)
+            {
+                pStub->append_pages_from(it->second);
+                delete it->second;
+            }
+            else
+                m_scores[it->first] = it->second;
+            it = pSource->m_scores.erase(it);
+        }
+        else
+            ++it;
+    }
+
+    set_modified(true);
+}
+
+//---------------------------------------------------------------------------------------
+void GraphicModel::delete_pages_from(int iPage)
+{
+    int numPages = get_num_pages();
+    if (iPage >= numPages)
+        return;
+
+    for (int i=iPage; i < numPages; ++i)
+        get_page(i)->remove_all_shapes_from_map_imo_shape();
+
+    map<ImoId, ScoreStub*>::iterator it = m_scores.begin();
+    while (it != m_scores.end())
+    {
+        if ((it->second)->remove_pages_from(iPage))
+            ++it;
+        else
+        {
+            delete it->second;
+            it = m_scores.erase(it);
         }
     }
+
+    m_root->delete_pages_from(iPage);
+
+    m_imoToBox.clear();
+    m_ctrolToPtr.clear();
+
+    set_modified(true);
 }
 
 //---------------------------------------------------------------------------------------
@@ -292,43 +392,25 @@ GmoBoxSystem* GraphicModel::get_system_for(ImoId scoreId, TimeUnits timepos)
     //if not found returns nullptr
 
     ScoreStub* pStub = get_stub_for(scoreId);
-    GmoBoxScorePage* pPage = pStub->get_page_for(timepos);
-    if (pPage)
-    {
-        //find system in this page
-        GmoBoxSystem* pSystem = nullptr;
-        int i = pPage->get_num_first_system();
-        int maxSystem = pPage->get_num_systems() + i;
-        LOMSE_LOG_DEBUG(Logger::k_events, "get_system_for(%f), i=%d, maxSystem=%d",
-                        timepos, i, maxSystem);
-        for (; i < maxSystem; ++i)
-        {
-            pSystem = pPage->get_system(i);
-            LOMSE_LOG_DEBUG(Logger::k_events, "system %d. End time = %f",
-                            i, pSystem->end_time());
-            if (is_lower_time(timepos, pSystem->end_time()))
-                break;
-            else if(is_equal_time(timepos, pSystem->end_time()))
-            {
-                //look in next system
-                int iNext = i + 1;
-                if (iNext < maxSystem)
-                {
-                    GmoBoxSystem* pNextSystem = pPage->get_system(iNext);
-                    if (is_equal_time(timepos, pNextSystem->start_time()))
-                    {
-                        i = iNext;
-                        pSystem = pNextSystem;
-                    }
-                }
-                break;
-            }
-        }
+    return pStub->get_system_for(timepos);
+}
 
-        if (i < maxSystem)
-            return pSystem;
-    }
-    return nullptr;
+//---------------------------------------------------------------------------------------
+bool GraphicModel::locate_timepos(ImoId scoreId, TimeUnits timepos,
+                                  TimeposLocation* pLocation, bool fBarline)
+{
+    GmoBoxSystem* pSystem = get_system_for(scoreId, timepos);
+    if (!pSystem)
+        return false;
+
+    pLocation->pSystem = pSystem;
+    pLocation->iPage = pSystem->get_page_number();
+    pLocation->iSystem = pSystem->get_system_number();
+    if (fBarline)
+        pLocation->x = pSystem->get_x_for_barline_at_time(timepos);
+    else
+        pLocation->x = pSystem->get_x_for_note_rest_at_time(timepos);
+    return true;
 }
 
 //---------------------------------------------------------------------------------------
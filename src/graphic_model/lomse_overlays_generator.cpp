@@ -33,6 +33,9 @@
 //#include "lomse_graphic_view.h"
 #include "lomse_logger.h"
 #include "lomse_visual_effect.h"
+#include "lomse_tile_cache.h"
+
+#include <cmath>
 
 
 namespace lomse
@@ -51,6 +54,7 @@ OverlaysGenerator::OverlaysGenerator(GraphicView* view, LibraryScope& librarySco
     , m_damagedRect(0.0, 0.0, 0.0, 0.0)
     , m_prevDamagedRect(0.0, 0.0, 0.0, 0.0)
     , m_pHandlersOwner(nullptr)
+    , m_bytesPerPixel( TileCache::bytes_per_pixel(libraryScope.get_pixel_format()) )
 {
 }
 
@@ -85,7 +89,7 @@ void OverlaysGenerator::remove_visual_effect(VisualEffect* pEffect)
 void OverlaysGenerator::update_all_visual_effects(ScreenDrawer* pDrawer)
 {
     if (m_fBackgroundDirty)
-        m_pCanvasBuffer->copy_from(m_savedBuffer);
+        restore_background();
 
     m_damagedRect = URect(0.0, 0.0, 0.0, 0.0);
     int overlays = 0;
@@ -96,7 +100,9 @@ void OverlaysGenerator::update_all_visual_effects(ScreenDrawer* pDrawer)
         {
             (*it)->on_draw(pDrawer);
             ++overlays;
-            m_damagedRect.Union( (*it)->get_bounds() );
+            URect bounds = (*it)->get_bounds();
+            m_damagedRect.Union(bounds);
+            add_dirty_rectangle(bounds, pDrawer);
         }
     }
 
@@ -128,6 +134,7 @@ void OverlaysGenerator::set_rendering_buffer(RenderingBuffer* rbuf)
     m_pCanvasBuffer = rbuf;
     m_fBackgroundDirty = false;
     m_fFullRectangle = true;
+    m_dirtyRects.clear();
 }
 
 //---------------------------------------------------------------------------------------
@@ -162,6 +169,59 @@ void OverlaysGenerator::save_rendering_buffer()
 
     m_savedBuffer.copy_from(*m_pCanvasBuffer);
     m_fBackgroundDirty = false;
+    m_dirtyRects.clear();
+}
+
+//---------------------------------------------------------------------------------------
+void OverlaysGenerator::restore_background()
+{
+    //Only the pixels modified when drawing the effects are restored from the saved
+    //copy. If the pixels format is not supported, the whole buffer is restored.
+
+    if (m_bytesPerPixel == 0 || m_pSaveBytes == nullptr)
+    {
+        m_pCanvasBuffer->copy_from(m_savedBuffer);
+    }
+    else
+    {
+        vector<VRect>::iterator it;
+        for (it = m_dirtyRects.begin(); it != m_dirtyRects.end(); ++it)
+        {
+            TileCache::copy_pixels(m_savedBuffer, (*it).x, (*it).y,
+                                   *m_pCanvasBuffer, (*it).x, (*it).y,
+                                   (*it).width, (*it).height, m_bytesPerPixel);
+        }
+    }
+    m_dirtyRects.clear();
+}
+
+//---------------------------------------------------------------------------------------
+void OverlaysGenerator::add_dirty_rectangle(const URect& bounds, ScreenDrawer* pDrawer)
+{
+    //bounds are increased as in expand_damaged_rectangle() and, after conversion to
+    //pixels, by one more pixel at each side, to include anti-aliasing pixels
+
+    double left = bounds.left() - 100.0;
+    double top = bounds.top() - 100.0;
+    double right = bounds.right() + 100.0;
+    double bottom = bounds.bottom() + 100.0;
+    pDrawer->model_point_to_screen(&left, &top);
+    pDrawer->model_point_to_screen(&right, &bottom);
+
+    int x1 = int( floor(min(left, right)) ) - 1;
+    int y1 = int( floor(min(top, bottom)) ) - 1;
+    int x2 = int( ceil(max(left, right)) ) + 1;
+    int y2 = int( ceil(max(top, bottom)) ) + 1;
+
+    //trim rectangle
+    x1 = max(0, x1);
+    y1 = max(0, y1);
+    x2 = min(x2, int(m_pCanvasBuffer->width()) );
+    y2 = min(y2, int(m_pCanvasBuffer->height()) );
+    if (x2 <= x1 || y2 <= y1)
+        return;
+
+    m_dirtyRects.push_back( VRect(VPoint(x1, y1), VPoint(x2, y2)) );
 }
 
 //---------------------------------------------------------------------------------------
@@ -250,6 +250,7 @@ void GmoCompositeShape::shift_origin(const USize& shift)
 {
     m_origin.x += shift.width;
     m_origin.y += shift.height;
+    on_geometry_changed();
 
     //shift components
     std::list<GmoShape*>::iterator it;
@@ -261,6 +262,7 @@ void GmoCompositeShape::shift_origin(const USize& shift)
 void GmoCompositeShape::reposition_shape(LUnits yShift)
 {
     m_origin.y += yShift;
+    on_geometry_changed();
 
     //shift components
     std::list<GmoShape*>::iterator it;
@@ -51,12 +51,14 @@ GmoShapeText::GmoShapeText(ImoObj* pCreatorImo, ShapeId idx, const std::string&
     , m_pFontStorage( libraryScope.font_storage() )
     , m_libraryScope(libraryScope)
     , m_space(0.0f)
+    , m_ascender(0.0f)
 {
     //bounds
     select_font();
     TextMeter meter(m_libraryScope);
     m_size.width = meter.measure_width(text);
     m_size.height = meter.get_ascender() - meter.get_descender();   //meter.get_font_height();
+    m_ascender = meter.get_ascender();
 
     //position
     m_space = m_size.height - meter.get_ascender() + meter.get_descender();
@@ -80,21 +82,10 @@ Color GmoShapeText::get_normal_color()
 //---------------------------------------------------------------------------------------
 void GmoShapeText::on_draw(Drawer* pDrawer, RenderOptions& opt)
 {
-    //select_font();
-    TextMeter meter(m_libraryScope);
-    if (!m_pStyle)
-        meter.select_font(m_language, "", "Liberation serif", 12.0);
-    else
-        meter.select_font(m_language,
-                          m_pStyle->font_file(),
-                          m_pStyle->font_name(),
-                          m_pStyle->font_size(),
-                          m_pStyle->is_bold(),
-                          m_pStyle->is_italic() );
-
+    select_font(pDrawer);
     pDrawer->set_text_color( determine_color_to_use(opt) );
     LUnits x = m_origin.x;
-    LUnits y = m_origin.y + meter.get_ascender() - m_space;     //reference is at text baseline
+    LUnits y = m_origin.y + m_ascender - m_space;     //reference is at text baseline
     pDrawer->draw_text(x, y, m_text);
 
     //std::string str("¿This? is a test: Ñ € & abc. Ruso:Текст на кирилица");
@@ -118,6 +109,22 @@ void GmoShapeText::select_font()
                           m_pStyle->is_italic() );
 }
 
+//---------------------------------------------------------------------------------------
+void GmoShapeText::select_font(Drawer* pDrawer)
+{
+    //AWARE: when drawing, the font must be selected in the drawer, as it could be
+    //using its own font storage
+    if (!m_pStyle)
+        pDrawer->select_font(m_language, "", "Liberation serif", 12.0);
+    else
+        pDrawer->select_font(m_language,
+                             m_pStyle->font_file(),
+                             m_pStyle->font_name(),
+                             m_pStyle->font_size(),
+                             m_pStyle->is_bold(),
+                             m_pStyle->is_italic() );
+}
+
 //---------------------------------------------------------------------------------------
 void GmoShapeText::set_text(const std::string& text)
 {
@@ -172,7 +179,7 @@ void GmoShapeWord::on_draw(Drawer* pDrawer, RenderOptions& opt)
     if (!static_cast<ImoContentObj*>(m_pCreatorImo)->is_visible())
         return;
 
-    select_font();
+    select_font(pDrawer);
     Color color = determine_color_to_use(opt);
     pDrawer->set_text_color(color);
     //AWARE: FreeType reference is at baseline
@@ -198,7 +205,7 @@ void GmoShapeWord::on_draw(Drawer* pDrawer, RenderOptions& opt)
     //draw reference lines
     if (opt.must_draw_box_for(GmoObj::k_box_paragraph))
     {
-        TextMeter meter(m_libraryScope);
+        TextMeter meter(m_libraryScope, pDrawer->get_font_storage());
         LUnits xStart = m_origin.x;
         LUnits xEnd = m_origin.x + m_size.width;
         pDrawer->begin_path();
@@ -270,6 +277,17 @@ void GmoShapeWord::select_font()
                       m_pStyle->is_italic() );
 }
 
+//---------------------------------------------------------------------------------------
+void GmoShapeWord::select_font(Drawer* pDrawer)
+{
+    pDrawer->select_font(m_language,
+                         m_pStyle->font_file(),
+                         m_pStyle->font_name(),
+                         m_pStyle->font_size(),
+                         m_pStyle->is_bold(),
+                         m_pStyle->is_italic() );
+}
+
 
 
 ////---------------------------------------------------------------------------------------
@@ -447,6 +465,20 @@ void GmoShapeTextBox::select_font()
                           m_pStyle->is_italic() );
 }
 
+//---------------------------------------------------------------------------------------
+void GmoShapeTextBox::select_font(Drawer* pDrawer)
+{
+    if (!m_pStyle)
+        pDrawer->select_font(m_language, "", "Liberation serif", 12.0);
+    else
+        pDrawer->select_font(m_language,
+                             m_pStyle->font_file(),
+                             m_pStyle->font_name(),
+                             m_pStyle->font_size(),
+                             m_pStyle->is_bold(),
+                             m_pStyle->is_italic() );
+}
+
 //---------------------------------------------------------------------------------------
 void GmoShapeTextBox::on_draw(Drawer* pDrawer, RenderOptions& opt)
 {
@@ -472,7 +504,7 @@ void GmoShapeTextBox::draw_text(Drawer* pDrawer, RenderOptions& opt)
 //        pPaper->DrawText((*it)->sText, (*it)->uPos.x + m_uBoundsTop.x,
 //                         (*it)->uPos.y + m_uBoundsTop.y);
 //    }
-    select_font();
+    select_font(pDrawer);
     pDrawer->set_text_color( determine_color_to_use(opt) );
     LUnits x = m_origin.x;
     LUnits y = m_origin.y + m_size.height;     //reference is at text bottom
@@ -190,6 +190,7 @@ void GmoShapeSlurTie::on_handler_dragged(int iHandler, UPoint newPos)
     compute_vertices();
     compute_bounds();
     make_points_and_vertices_relative_to_origin();
+    on_geometry_changed();
 }
 
 //---------------------------------------------------------------------------------------
@@ -32,6 +32,7 @@
 #include "lomse_time.h"
 
 //std
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
 using namespace std;
@@ -122,43 +123,28 @@ LUnits TimeGridTable::get_x_for_note_rest_at_time(TimeUnits timepos)
     if (m_PosTimes.size() == 0 || is_lower_time(timepos, m_PosTimes.front().rTimepos))
         return 0.0;       //<--------------------------- Test 100
 
-    //otherwise find in table
-    vector<TimeGridTableEntry>::iterator it = m_PosTimes.begin();
-    TimeUnits prevTimepos = (*it).rTimepos;
-    LUnits xPrev = (*it).uxPos;
+    //if not found return last entry xPos. Or should return system xRight?
+    int i = find_first_entry_at_or_after(timepos);
+    if (i == get_size())
+        return m_PosTimes.back().uxPos;       //<--------------------------- Test 105
 
-    for (; it != m_PosTimes.end(); ++it)
+    TimeGridTableEntry& entry = m_PosTimes[i];
+    if (is_lower_time(timepos, entry.rTimepos))
     {
-        if (is_lower_time(timepos, (*it).rTimepos))
-        {
-            //interpolate                  //<---------------- Test 104
-            double dx = double((*it).uxPos - xPrev) / double((*it).rTimepos - prevTimepos);
-            return xPrev + LUnits( double(timepos - prevTimepos) * dx );
-        }
-        else if (is_equal_time(timepos, (*it).rTimepos))
-        {
-            if ((*it).rDuration > 0.0)
-                return (*it).uxPos;       //<--------------------------- Test 101
-
-            //try next entry
-            vector<TimeGridTableEntry>::iterator itNext = it;
-            LUnits lastPos = (*it).uxPos;
-            ++itNext;
-            while (itNext != m_PosTimes.end()
-                   && is_equal_time(timepos, (*itNext).rTimepos))
-            {
-                lastPos = (*itNext).uxPos;
-                ++itNext;
-            }
-            return lastPos;            //<-------------- Tests 102 & T103
-        }
-
-        prevTimepos = (*it).rTimepos;
-        xPrev = (*it).uxPos;
+        //interpolate                  //<---------------- Test 104
+        TimeGridTableEntry& prev = m_PosTimes[i-1];
+        double dx = double(entry.uxPos - prev.uxPos) / double(entry.rTimepos - prev.rTimepos);
+        return prev.uxPos + LUnits( double(timepos - prev.rTimepos) * dx );
     }
 
-    //if not found return last entry xPos. Or should return system xRight?
-    return m_PosTimes.back().uxPos;       //<--------------------------- Test 105
+    if (entry.rDuration > 0.0)
+        return entry.uxPos;       //<--------------------------- Test 101
+
+    //try next entries
+    LUnits lastPos = entry.uxPos;
+    for (++i; i < get_size() && is_equal_time(timepos, m_PosTimes[i].rTimepos); ++i)
+        lastPos = m_PosTimes[i].uxPos;
+    return lastPos;            //<-------------- Tests 102 & T103
 }
 
 //---------------------------------------------------------------------------------------
@@ -168,28 +154,34 @@ LUnits TimeGridTable::get_x_for_barline_at_time(TimeUnits timepos)
     if (m_PosTimes.size() == 0 || is_lower_time(timepos, m_PosTimes.front().rTimepos))
         return 0.0;       //<--------------------------- Test 200
 
-    //otherwise find in table
-    vector<TimeGridTableEntry>::iterator it = m_PosTimes.begin();
-    TimeUnits prevTimepos = (*it).rTimepos;
-    LUnits xPrev = (*it).uxPos;
-
-    for (; it != m_PosTimes.end(); ++it)
-    {
-        if (is_equal_time(timepos, (*it).rTimepos))//<--------------- Test 201 (case =)
-            return (*it).uxPos;
-        else if (is_lower_time(timepos, (*it).rTimepos))//<---------- Test 202 (case <)
-        {
-            //interpolate
-            double dx = double((*it).uxPos - xPrev) / double((*it).rTimepos - prevTimepos);
-            return xPrev + LUnits( double(timepos - prevTimepos) * dx );
-        }
-
-        prevTimepos = (*it).rTimepos;
-        xPrev = (*it).uxPos;
-    }
-
     //if not found return last entry xPos. Or should return system xRight?
-    return m_PosTimes.back().uxPos;       //<--------------------------- Test 203
+    int i = find_first_entry_at_or_after(timepos);
+    if (i == get_size())
+        return m_PosTimes.back().uxPos;       //<--------------------------- Test 203
+
+    TimeGridTableEntry& entry = m_PosTimes[i];
+    if (is_equal_time(timepos, entry.rTimepos))     //<--------------- Test 201 (case =)
+        return entry.uxPos;
+
+    //interpolate                                   //<---------- Test 202 (case <)
+    TimeGridTableEntry& prev = m_PosTimes[i-1];
+    double dx = double(entry.uxPos - prev.uxPos) / double(entry.rTimepos - prev.rTimepos);
+    return prev.uxPos + LUnits( double(timepos - prev.rTimepos) * dx );
+}
+
+//---------------------------------------------------------------------------------------
+int TimeGridTable::find_first_entry_at_or_after(TimeUnits timepos)
+{
+    //Returns the index of the first entry with timepos greater or equal than the given
+    //one, or the table size if none. Entries are ordered by timepos, as they are
+    //created by the spacing algorithm from the columns, in order.
+
+    vector<TimeGridTableEntry>::iterator it =
+        lower_bound(m_PosTimes.begin(), m_PosTimes.end(), timepos,
+                    [](const TimeGridTableEntry& entry, TimeUnits t) {
+                        return is_lower_time(entry.rTimepos, t);
+                    });
+    return int(it - m_PosTimes.begin());
 }
 
 //---------------------------------------------------------------------------------------
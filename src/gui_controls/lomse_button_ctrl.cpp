@@ -131,9 +131,9 @@ void ButtonCtrl::set_mouse_in(bool fValue)
 }
 
 //---------------------------------------------------------------------------------------
-void ButtonCtrl::center_text()
+void ButtonCtrl::center_text(Drawer* pDrawer)
 {
-    TextMeter meter(m_libraryScope);
+    TextMeter meter(m_libraryScope, pDrawer->get_font_storage());
     LUnits height = meter.get_font_height();
     LUnits width = meter.measure_width(m_label);
 
@@ -176,8 +176,8 @@ void ButtonCtrl::on_draw(Drawer* pDrawer, RenderOptions& UNUSED(opt))
     pDrawer->end_path();
 
     //draw text
-    select_font();
-    center_text();
+    select_font(pDrawer);
+    center_text(pDrawer);
     pDrawer->set_text_color( textColor );
     LUnits x = m_pos.x + m_xLabel;
     LUnits y = m_pos.y + m_yLabel;
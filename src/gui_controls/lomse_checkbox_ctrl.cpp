@@ -169,12 +169,12 @@ void CheckboxCtrl::change_label(const string& text)
 }
 
 //---------------------------------------------------------------------------------------
-URect CheckboxCtrl::determine_text_position_and_size()
+URect CheckboxCtrl::determine_text_position_and_size(Drawer* pDrawer)
 {
     URect pos;
 
     //select_font();    //AWARE: font already selected
-    TextMeter meter(m_libraryScope);
+    TextMeter meter(m_libraryScope, pDrawer->get_font_storage());
     pos.width = meter.measure_width(m_label);
     pos.height = meter.get_font_height();
     pos.y = m_pos.y + (pos.height + m_height) / 2.0f;
@@ -192,10 +192,10 @@ void CheckboxCtrl::set_tooltip(const string& UNUSED(text))
 //---------------------------------------------------------------------------------------
 void CheckboxCtrl::on_draw(Drawer* pDrawer, RenderOptions& UNUSED(opt))
 {
-    select_font();
+    select_font(pDrawer);
     Color color = (m_fEnabled ? m_currentColor : Color(192, 192, 192));
     pDrawer->set_text_color(color);
-    URect pos = determine_text_position_and_size();
+    URect pos = determine_text_position_and_size(pDrawer);
 
     pDrawer->begin_path();
     pDrawer->fill( Color(0,0,0,0) );
@@ -216,18 +216,6 @@ void CheckboxCtrl::on_draw(Drawer* pDrawer, RenderOptions& UNUSED(opt))
     }
 }
 
-//---------------------------------------------------------------------------------------
-void CheckboxCtrl::select_font()
-{
-    TextMeter meter(m_libraryScope);
-    meter.select_font(m_language,
-                      m_style->font_file(),
-                      m_style->font_name(),
-                      m_style->font_size(),
-                      m_style->is_bold(),
-                      m_style->is_italic() );
-}
-
 //---------------------------------------------------------------------------------------
 unsigned CheckboxCtrl::vertex(double* px, double* py)
 {
@@ -126,12 +126,12 @@ void ProgressBarCtrl::set_value(float value)
 }
 
 //---------------------------------------------------------------------------------------
-URect ProgressBarCtrl::determine_text_position_and_size()
+URect ProgressBarCtrl::determine_text_position_and_size(Drawer* pDrawer)
 {
     URect pos;
 
     //select_font();    //AWARE: when invoked, font is already selected
-    TextMeter meter(m_libraryScope);
+    TextMeter meter(m_libraryScope, pDrawer->get_font_storage());
     pos.width = meter.measure_width(m_label);
     pos.height = meter.get_font_height();
     pos.y = m_pos.y + m_height;
@@ -149,8 +149,8 @@ void ProgressBarCtrl::set_tooltip(const string& UNUSED(text))
 //---------------------------------------------------------------------------------------
 void ProgressBarCtrl::on_draw(Drawer* pDrawer, RenderOptions& UNUSED(opt))
 {
-    select_font();
-    URect pos = determine_text_position_and_size();
+    select_font(pDrawer);
+    URect pos = determine_text_position_and_size(pDrawer);
 
     //progress bar
     if (m_percent > 0.0f)
@@ -113,13 +113,13 @@ void StaticTextCtrl::set_text(const string& text)
 }
 
 //---------------------------------------------------------------------------------------
-URect StaticTextCtrl::determine_text_position_and_size()
+URect StaticTextCtrl::determine_text_position_and_size(Drawer* pDrawer)
 {
     int align = m_style->text_align();
     URect pos;
 
     //select_font();    //AWARE: not needed as font is already selected
-    TextMeter meter(m_libraryScope);
+    TextMeter meter(m_libraryScope, pDrawer->get_font_storage());
     pos.width = meter.measure_width(m_label);
     pos.height = meter.get_font_height();
     pos.y = m_pos.y + (pos.height + m_height) / 2.0f;
@@ -154,10 +154,10 @@ void StaticTextCtrl::set_tooltip(const string& UNUSED(text))
 //---------------------------------------------------------------------------------------
 void StaticTextCtrl::on_draw(Drawer* pDrawer, RenderOptions& UNUSED(opt))
 {
-    select_font();
+    select_font(pDrawer);
     Color color = m_style->color();
     pDrawer->set_text_color(color);
-    URect pos = determine_text_position_and_size();
+    URect pos = determine_text_position_and_size(pDrawer);
     pDrawer->draw_text(pos.x, pos.y, m_label);
 
     //text decoration
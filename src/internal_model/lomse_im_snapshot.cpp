@@ -0,0 +1,936 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2020. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+//---------------------------------------------------------------------------------------
+
+#include "lomse_im_snapshot.h"
+
+#include "lomse_internal_model.h"
+#include "private/lomse_internal_model_p.h"
+#include "private/lomse_document_p.h"
+#include "lomse_im_note.h"
+#include "lomse_im_figured_bass.h"
+#include "lomse_id_assigner.h"
+#include "lomse_injectors.h"
+#include "lomse_build_options.h"
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+namespace lomse
+{
+
+//---------------------------------------------------------------------------------------
+// ImoCloner: helper for creating a deep copy of an internal model subtree.
+//
+// Copying is done in two passes. First, all objects in the subtree are copied, using
+// the copy constructor of each Imo class, and objects owned by them (relations,
+// styles, staff info, etc.) are also copied. Then, pointers in the copies are
+// replaced by pointers to the copies of the pointed objects. Pointers to objects
+// external to the subtree are not allowed, with the exception of document styles.
+//
+// All copies are owned by `pDoc`. When `pDoc` is nullptr the copies are not linked to
+// any Document and the external styles are saved in `pExternalStyles`. Otherwise
+// external styles are replaced by the document style with the same name.
+//
+class ImoCloner
+{
+protected:
+    Document* m_pDoc;
+    list<ImoStyle*>* m_pExternalStyles;
+    unordered_map<ImoObj*, ImoObj*> m_copies;       //source object -> copy
+    vector< pair<ImoObj*, ImoObj*> > m_objects;     //copied objects, not embedded
+    vector< pair<ImoObj*, ImoObj*> > m_embedded;    //copied objects embedded in others
+    list<ImoObj*> m_orphans;                        //copies not linked to the subtree
+    size_t m_bytes;                                 //memory used by the copies
+    bool m_fValid;
+
+public:
+    ImoCloner(Document* pDoc, list<ImoStyle*>* pExternalStyles);
+    ~ImoCloner();
+
+    ImoObj* clone(ImoObj* pRoot);
+    void assign_ids(IdAssigner* pAssigner);
+
+    inline bool is_valid() { return m_fValid; }
+    inline int get_num_objects() { return int(m_objects.size() + m_embedded.size()); }
+    inline size_t get_memory_size() { return m_bytes; }
+
+protected:
+    ImoObj* clone_tree(ImoObj* pImo);
+    ImoObj* copy_object(ImoObj* pImo);
+    void add_embedded(ImoObj* pImo, ImoObj* pCopy);
+    void clone_owned_objects(ImoObj* pImo, ImoObj* pCopy);
+    void count_owned_data(ImoObj* pCopy);
+    void clone_styles(map<string, ImoStyle*>& styles);
+    void fix_references(ImoObj* pImo, ImoObj* pCopy);
+    ImoObj* copy_for(ImoObj* pImo);
+    ImoStyle* style_for(ImoStyle* pStyle);
+
+    template <class T>
+    T* copy_of(ImoObj* pImo)
+    {
+        m_bytes += sizeof(T);
+        return LOMSE_NEW T(*static_cast<T*>(pImo));
+    }
+
+    template <class T>
+    T* clone_owned(T* pImo) { return static_cast<T*>( clone_tree(pImo) ); }
+
+    //memory allocated by containers. Node sizes are estimated from the usual
+    //implementation: two links for list nodes and three links plus color for map nodes
+    static size_t bytes_of(const string& s);
+
+    template <class T>
+    static size_t bytes_of(const list<T>& l) { return l.size() * (sizeof(T) + 2 * sizeof(void*)); }
+
+    template <class T>
+    static size_t bytes_of(const vector<T>& v) { return v.capacity() * sizeof(T); }
+
+    template <class K, class V>
+    static size_t bytes_of(const map<K, V>& m)
+    {
+        return m.size() * (sizeof(pair<const K, V>) + 4 * sizeof(void*));
+    }
+
+    template <class T>
+    T* copy_for(T* pImo) { return static_cast<T*>( copy_for(static_cast<ImoObj*>(pImo)) ); }
+};
+
+//---------------------------------------------------------------------------------------
+ImoCloner::ImoCloner(Document* pDoc, list<ImoStyle*>* pExternalStyles)
+    : m_pDoc(pDoc)
+    , m_pExternalStyles(pExternalStyles)
+    , m_bytes(0)
+    , m_fValid(true)
+{
+}
+
+//---------------------------------------------------------------------------------------
+ImoCloner::~ImoCloner()
+{
+    list<ImoObj*>::iterator it;
+    for (it = m_orphans.begin(); it != m_orphans.end(); ++it)
+        delete *it;
+}
+
+//---------------------------------------------------------------------------------------
+ImoObj* ImoCloner::clone(ImoObj* pRoot)
+{
+    ImoObj* pCopy = clone_tree(pRoot);
+
+    //AWARE: all references must be fixed, even when the copy is not valid. Otherwise
+    //deleting the copy could delete objects in the source subtree
+    vector< pair<ImoObj*, ImoObj*> >::iterator it;
+    for (it = m_objects.begin(); it != m_objects.end(); ++it)
+        fix_references(it->first, it->second);
+    for (it = m_embedded.begin(); it != m_embedded.end(); ++it)
+        fix_references(it->first, it->second);
+
+    return pCopy;
+}
+
+//---------------------------------------------------------------------------------------
+void ImoCloner::assign_ids(IdAssigner* pAssigner)
+{
+    vector< pair<ImoObj*, ImoObj*> >::iterator it;
+    for (it = m_objects.begin(); it != m_objects.end(); ++it)
+    {
+        if (it->second->get_id() != k_no_imoid)
+            pAssigner->assign_id(it->second);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+ImoObj* ImoCloner::clone_tree(ImoObj* pImo)
+{
+    ImoObj* pCopy = copy_object(pImo);
+    if (!pCopy)
+    {
+        m_fValid = false;
+        return nullptr;
+    }
+    pCopy->set_id( pImo->get_id() );    //some copy constructors do not copy the id
+    m_copies[pImo] = pCopy;
+    m_objects.push_back( make_pair(pImo, pCopy) );
+
+    ImoObj::children_iterator it;
+    for (it = pImo->begin(); it != pImo->end(); ++it)
+    {
+        ImoObj* pChild = clone_tree(*it);
+        if (pChild)
+            pCopy->append_child(pChild);
+    }
+
+    clone_owned_objects(pImo, pCopy);
+    count_owned_data(pCopy);
+    return pCopy;
+}
+
+//---------------------------------------------------------------------------------------
+ImoObj* ImoCloner::copy_object(ImoObj* pImo)
+{
+    //controls and DTOs are not supported: they are either linked to external objects
+    //or transient objects only used while building the model
+    switch (pImo->get_obj_type())
+    {
+        case k_imo_anonymous_block:        return copy_of<ImoAnonymousBlock>(pImo);
+        case k_imo_articulation_line:      return copy_of<ImoArticulationLine>(pImo);
+        case k_imo_articulation_symbol:    return copy_of<ImoArticulationSymbol>(pImo);
+        case k_imo_attachments:            return copy_of<ImoAttachments>(pImo);
+        case k_imo_barline:                return copy_of<ImoBarline>(pImo);
+        case k_imo_beam:                   return copy_of<ImoBeam>(pImo);
+        case k_imo_beam_data:              return copy_of<ImoBeamData>(pImo);
+        case k_imo_bezier_info:            return copy_of<ImoBezierInfo>(pImo);
+        case k_imo_chord:                  return copy_of<ImoChord>(pImo);
+        case k_imo_clef:                   return copy_of<ImoClef>(pImo);
+        case k_imo_content:                return copy_of<ImoContent>(pImo);
+        case k_imo_cursor_info:            return copy_of<ImoCursorInfo>(pImo);
+        case k_imo_direction:              return copy_of<ImoDirection>(pImo);
+        case k_imo_document:               return copy_of<ImoDocument>(pImo);
+        case k_imo_dynamic:                return copy_of<ImoDynamic>(pImo);
+        case k_imo_dynamics_mark:          return copy_of<ImoDynamicsMark>(pImo);
+        case k_imo_fermata:                return copy_of<ImoFermata>(pImo);
+        case k_imo_figured_bass:           return copy_of<ImoFiguredBass>(pImo);
+        case k_imo_figured_bass_info:      return copy_of<ImoFiguredBassInfo>(pImo);
+        case k_imo_go_back_fwd:            return copy_of<ImoGoBackFwd>(pImo);
+        case k_imo_grace_relobj:           return copy_of<ImoGraceRelObj>(pImo);
+        case k_imo_heading:                return copy_of<ImoHeading>(pImo);
+        case k_imo_image:                  return copy_of<ImoImage>(pImo);
+        case k_imo_inline_wrapper:         return copy_of<ImoInlineWrapper>(pImo);
+        case k_imo_instr_group:            return copy_of<ImoInstrGroup>(pImo);
+        case k_imo_instrument:             return copy_of<ImoInstrument>(pImo);
+        case k_imo_instrument_groups:      return copy_of<ImoInstrGroups>(pImo);
+        case k_imo_instruments:            return copy_of<ImoInstruments>(pImo);
+        case k_imo_key_signature:          return copy_of<ImoKeySignature>(pImo);
+        case k_imo_line:                   return copy_of<ImoLine>(pImo);
+        case k_imo_line_style:             return copy_of<ImoLineStyle>(pImo);
+        case k_imo_link:                   return copy_of<ImoLink>(pImo);
+        case k_imo_list:                   return copy_of<ImoList>(pImo);
+        case k_imo_listitem:               return copy_of<ImoListItem>(pImo);
+        case k_imo_lyric:                  return copy_of<ImoLyric>(pImo);
+        case k_imo_lyrics_text_info:       return copy_of<ImoLyricsTextInfo>(pImo);
+        case k_imo_metronome_mark:         return copy_of<ImoMetronomeMark>(pImo);
+        case k_imo_midi_info:              return copy_of<ImoMidiInfo>(pImo);
+        case k_imo_multicolumn:            return copy_of<ImoMultiColumn>(pImo);
+        case k_imo_music_data:             return copy_of<ImoMusicData>(pImo);
+        case k_imo_note_cue:               return copy_of<ImoNote>(pImo);
+        case k_imo_note_grace:             return copy_of<ImoGraceNote>(pImo);
+        case k_imo_note_regular:           return copy_of<ImoNote>(pImo);
+        case k_imo_octave_shift:           return copy_of<ImoOctaveShift>(pImo);
+        case k_imo_option:                 return copy_of<ImoOptionInfo>(pImo);
+        case k_imo_options:                return copy_of<ImoOptions>(pImo);
+        case k_imo_ornament:               return copy_of<ImoOrnament>(pImo);
+        case k_imo_page_info:              return copy_of<ImoPageInfo>(pImo);
+        case k_imo_para:                   return copy_of<ImoParagraph>(pImo);
+        case k_imo_param_info:             return copy_of<ImoParamInfo>(pImo);
+        case k_imo_relations:              return copy_of<ImoRelations>(pImo);
+        case k_imo_rest:                   return copy_of<ImoRest>(pImo);
+        case k_imo_score:                  return copy_of<ImoScore>(pImo);
+        case k_imo_score_line:             return copy_of<ImoScoreLine>(pImo);
+        case k_imo_score_text:             return copy_of<ImoScoreText>(pImo);
+        case k_imo_score_title:            return copy_of<ImoScoreTitle>(pImo);
+        case k_imo_slur:                   return copy_of<ImoSlur>(pImo);
+        case k_imo_slur_data:              return copy_of<ImoSlurData>(pImo);
+        case k_imo_sound_change:           return copy_of<ImoSoundChange>(pImo);
+        case k_imo_sound_info:             return copy_of<ImoSoundInfo>(pImo);
+        case k_imo_sounds:                 return copy_of<ImoSounds>(pImo);
+        case k_imo_staff_info:             return copy_of<ImoStaffInfo>(pImo);
+        case k_imo_style:                  return copy_of<ImoStyle>(pImo);
+        case k_imo_styles:                 return copy_of<ImoStyles>(pImo);
+        case k_imo_symbol_repetition_mark: return copy_of<ImoSymbolRepetitionMark>(pImo);
+        case k_imo_system_break:           return copy_of<ImoSystemBreak>(pImo);
+        case k_imo_system_info:            return copy_of<ImoSystemInfo>(pImo);
+        case k_imo_table:                  return copy_of<ImoTable>(pImo);
+        case k_imo_table_body:             return copy_of<ImoTableBody>(pImo);
+        case k_imo_table_cell:             return copy_of<ImoTableCell>(pImo);
+        case k_imo_table_head:             return copy_of<ImoTableHead>(pImo);
+        case k_imo_table_row:              return copy_of<ImoTableRow>(pImo);
+        case k_imo_technical:              return copy_of<ImoTechnical>(pImo);
+        case k_imo_text_box:               return copy_of<ImoTextBox>(pImo);
+        case k_imo_text_info:              return copy_of<ImoTextInfo>(pImo);
+        case k_imo_text_item:              return copy_of<ImoTextItem>(pImo);
+        case k_imo_text_repetition_mark:   return copy_of<ImoTextRepetitionMark>(pImo);
+        case k_imo_text_style:             return copy_of<ImoTextStyle>(pImo);
+        case k_imo_textblock_info:         return copy_of<ImoTextBlockInfo>(pImo);
+        case k_imo_tie:                    return copy_of<ImoTie>(pImo);
+        case k_imo_tie_data:               return copy_of<ImoTieData>(pImo);
+        case k_imo_time_signature:         return copy_of<ImoTimeSignature>(pImo);
+        case k_imo_transpose:              return copy_of<ImoTranspose>(pImo);
+        case k_imo_tuplet:                 return copy_of<ImoTuplet>(pImo);
+        case k_imo_volta_bracket:          return copy_of<ImoVoltaBracket>(pImo);
+        case k_imo_wedge:                  return copy_of<ImoWedge>(pImo);
+        default:
+            return nullptr;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void ImoCloner::add_embedded(ImoObj* pImo, ImoObj* pCopy)
+{
+    //objects embedded in other objects are copied by the copy constructor of the
+    //container, but their references must also be fixed. Their ids, if any, are not
+    //registered in the document
+    pCopy->set_id( pImo->get_id() );
+    m_embedded.push_back( make_pair(pImo, pCopy) );
+    clone_owned_objects(pImo, pCopy);
+    count_owned_data(pCopy);
+}
+
+//---------------------------------------------------------------------------------------
+void ImoCloner::clone_owned_objects(ImoObj* pImo, ImoObj* pCopy)
+{
+    //After the copy constructor, pointers to owned objects are still pointing
+    //to the objects of the source object. Replace them by copies.
+
+    if (pImo->is_relobj())
+    {
+        ImoRelObj* pRO = static_cast<ImoRelObj*>(pImo);
+        std::list< pair<ImoStaffObj*, ImoRelDataObj*> >& objs = pRO->get_related_objects();
+        std::list< pair<ImoStaffObj*, ImoRelDataObj*> >::iterator it;
+        for (it = objs.begin(); it != objs.end(); ++it)
+        {
+            if (it->second)
+                clone_tree(it->second);
+        }
+    }
+
+    switch (pImo->get_obj_type())
+    {
+        case k_imo_relations:
+        {
+            //relations are shared by all participants. Copy them only once
+            std::list<ImoRelObj*>& relations = static_cast<ImoRelations*>(pImo)->get_relations();
+            std::list<ImoRelObj*>::iterator it;
+            for (it = relations.begin(); it != relations.end(); ++it)
+            {
+                if (m_copies.find(*it) == m_copies.end())
+                    clone_tree(*it);
+            }
+            break;
+        }
+
+        case k_imo_barline:
+        {
+            ImoBarline* pSrc = static_cast<ImoBarline*>(pImo);
+            ImoBarline* pDst = static_cast<ImoBarline*>(pCopy);
+            pDst->m_pMeasureInfo = (pSrc->m_pMeasureInfo ?
+                            LOMSE_NEW TypeMeasureInfo(*pSrc->m_pMeasureInfo) : nullptr);
+            break;
+        }
+
+        case k_imo_beam:
+        {
+            ImoBeam* pSrc = static_cast<ImoBeam*>(pImo);
+            ImoBeam* pDst = static_cast<ImoBeam*>(pCopy);
+            pDst->m_pStemsDir = (pSrc->m_pStemsDir ?
+                            LOMSE_NEW vector<int>(*pSrc->m_pStemsDir) : nullptr);
+            break;
+        }
+
+        case k_imo_document:
+        {
+            ImoDocument* pSrc = static_cast<ImoDocument*>(pImo);
+            ImoDocument* pDst = static_cast<ImoDocument*>(pCopy);
+            pDst->m_privateStyles.clear();
+            std::list<ImoStyle*>::iterator it;
+            for (it = pSrc->m_privateStyles.begin(); it != pSrc->m_privateStyles.end(); ++it)
+                pDst->m_privateStyles.push_back( clone_owned(*it) );
+            add_embedded(&pSrc->m_pageInfo, &pDst->m_pageInfo);
+            break;
+        }
+
+        case k_imo_dynamic:
+        {
+            ImoDynamic* pSrc = static_cast<ImoDynamic*>(pImo);
+            ImoDynamic* pDst = static_cast<ImoDynamic*>(pCopy);
+            pDst->m_params.clear();
+            std::list<ImoParamInfo*>::iterator it;
+            for (it = pSrc->m_params.begin(); it != pSrc->m_params.end(); ++it)
+                pDst->m_params.push_back( clone_owned(*it) );
+            break;
+        }
+
+        case k_imo_figured_bass:
+        {
+            ImoFiguredBass* pSrc = static_cast<ImoFiguredBass*>(pImo);
+            ImoFiguredBass* pDst = static_cast<ImoFiguredBass*>(pCopy);
+            add_embedded(&pSrc->m_info, &pDst->m_info);
+            break;
+        }
+
+        case k_imo_instr_group:
+        {
+            ImoInstrGroup* pSrc = static_cast<ImoInstrGroup*>(pImo);
+            ImoInstrGroup* pDst = static_cast<ImoInstrGroup*>(pCopy);
+            add_embedded(&pSrc->m_name, &pDst->m_name);
+            add_embedded(&pSrc->m_abbrev, &pDst->m_abbrev);
+            break;
+        }
+
+        case k_imo_instrument:
+        {
+            ImoInstrument* pSrc = static_cast<ImoInstrument*>(pImo);
+            ImoInstrument* pDst = static_cast<ImoInstrument*>(pCopy);
+            pDst->m_staves.clear();
+            std::list<ImoStaffInfo*>::iterator it;
+            for (it = pSrc->m_staves.begin(); it != pSrc->m_staves.end(); ++it)
+                pDst->m_staves.push_back( clone_owned(*it) );
+            pDst->m_pLastMeasureInfo = (pSrc->m_pLastMeasureInfo ?
+                            LOMSE_NEW TypeMeasureInfo(*pSrc->m_pLastMeasureInfo) : nullptr);
+            pDst->m_pMeasures = nullptr;    //rebuilt when structurizing the score
+            add_embedded(&pSrc->m_name, &pDst->m_name);
+            add_embedded(&pSrc->m_abbrev, &pDst->m_abbrev);
+            break;
+        }
+
+        case k_imo_line:
+        {
+            ImoLine* pSrc = static_cast<ImoLine*>(pImo);
+            ImoLine* pDst = static_cast<ImoLine*>(pCopy);
+            pDst->m_pStyle = (pSrc->m_pStyle ? clone_owned(pSrc->m_pStyle) : nullptr);
+            break;
+        }
+
+        case k_imo_lyrics_text_info:
+        {
+            ImoLyricsTextInfo* pSrc = static_cast<ImoLyricsTextInfo*>(pImo);
+            ImoLyricsTextInfo* pDst = static_cast<ImoLyricsTextInfo*>(pCopy);
+            add_embedded(&pSrc->m_text, &pDst->m_text);
+            break;
+        }
+
+        case k_imo_score:
+        {
+            ImoScore* pSrc = static_cast<ImoScore*>(pImo);
+            ImoScore* pDst = static_cast<ImoScore*>(pCopy);
+            pDst->m_pColStaffObjs = nullptr;    //rebuilt when structurizing the score
+            pDst->m_pMidiTable = nullptr;       //rebuilt on demand
+            clone_styles(pDst->m_nameToStyle);
+            add_embedded(&pSrc->m_systemInfoFirst, &pDst->m_systemInfoFirst);
+            add_embedded(&pSrc->m_systemInfoOther, &pDst->m_systemInfoOther);
+            add_embedded(&pSrc->m_pageInfo, &pDst->m_pageInfo);
+            break;
+        }
+
+        case k_imo_score_line:
+        {
+            ImoScoreLine* pSrc = static_cast<ImoScoreLine*>(pImo);
+            ImoScoreLine* pDst = static_cast<ImoScoreLine*>(pCopy);
+            add_embedded(&pSrc->m_style, &pDst->m_style);
+            break;
+        }
+
+        case k_imo_score_text:
+        case k_imo_score_title:
+        {
+            ImoScoreText* pSrc = static_cast<ImoScoreText*>(pImo);
+            ImoScoreText* pDst = static_cast<ImoScoreText*>(pCopy);
+            add_embedded(&pSrc->m_text, &pDst->m_text);
+            break;
+        }
+
+        case k_imo_slur_data:
+        {
+            ImoSlurData* pSrc = static_cast<ImoSlurData*>(pImo);
+            ImoSlurData* pDst = static_cast<ImoSlurData*>(pCopy);
+            pDst->m_pBezier = (pSrc->m_pBezier ? clone_owned(pSrc->m_pBezier) : nullptr);
+            break;
+        }
+
+        case k_imo_styles:
+            clone_styles( static_cast<ImoStyles*>(pCopy)->m_nameToStyle );
+            break;
+
+        case k_imo_text_box:
+        {
+            ImoTextBox* pSrc = static_cast<ImoTextBox*>(pImo);
+            ImoTextBox* pDst = static_cast<ImoTextBox*>(pCopy);
+            add_embedded(&pSrc->m_box, &pDst->m_box);
+            add_embedded(&pSrc->m_line, &pDst->m_line);
+            break;
+        }
+
+        case k_imo_tie_data:
+        {
+            ImoTieData* pSrc = static_cast<ImoTieData*>(pImo);
+            ImoTieData* pDst = static_cast<ImoTieData*>(pCopy);
+            pDst->m_pBezier = (pSrc->m_pBezier ? clone_owned(pSrc->m_pBezier) : nullptr);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void ImoCloner::count_owned_data(ImoObj* pCopy)
+{
+    //Adds the memory allocated by the copy for its strings, containers and other
+    //owned data that are not Imo objects. Owned Imo objects are counted when copied
+
+    for (ImoAttr* pAttr = pCopy->get_first_attribute(); pAttr;
+         pAttr = pAttr->get_next_attrib())
+    {
+        m_bytes += sizeof(ImoAttr);
+        if (pAttr->is_string_value())
+            m_bytes += bytes_of( pAttr->get_string_value() );
+    }
+
+    if (pCopy->is_relobj())
+        m_bytes += bytes_of( static_cast<ImoRelObj*>(pCopy)->get_related_objects() );
+
+    switch (pCopy->get_obj_type())
+    {
+        case k_imo_barline:
+        {
+            ImoBarline* pImo = static_cast<ImoBarline*>(pCopy);
+            if (pImo->m_pMeasureInfo)
+                m_bytes += sizeof(TypeMeasureInfo) + bytes_of(pImo->m_pMeasureInfo->number);
+            break;
+        }
+
+        case k_imo_beam:
+        {
+            ImoBeam* pImo = static_cast<ImoBeam*>(pCopy);
+            if (pImo->m_pStemsDir)
+                m_bytes += sizeof(vector<int>) + bytes_of(*pImo->m_pStemsDir);
+            break;
+        }
+
+        case k_imo_document:
+        {
+            ImoDocument* pImo = static_cast<ImoDocument*>(pCopy);
+            m_bytes += bytes_of(pImo->m_version) + bytes_of(pImo->m_language)
+                       + bytes_of(pImo->m_privateStyles);
+            break;
+        }
+
+        case k_imo_dynamic:
+        {
+            ImoDynamic* pImo = static_cast<ImoDynamic*>(pCopy);
+            m_bytes += bytes_of(pImo->m_classid) + bytes_of(pImo->m_params);
+            break;
+        }
+
+        case k_imo_dynamics_mark:
+            m_bytes += bytes_of( static_cast<ImoDynamicsMark*>(pCopy)->m_markType );
+            break;
+
+        case k_imo_instrument:
+        {
+            ImoInstrument* pImo = static_cast<ImoInstrument*>(pCopy);
+            m_bytes += bytes_of(pImo->m_partId) + bytes_of(pImo->m_staves);
+            if (pImo->m_pLastMeasureInfo)
+                m_bytes += sizeof(TypeMeasureInfo)
+                           + bytes_of(pImo->m_pLastMeasureInfo->number);
+            break;
+        }
+
+        case k_imo_link:
+        {
+            ImoLink* pImo = static_cast<ImoLink*>(pCopy);
+            m_bytes += bytes_of(pImo->m_url) + bytes_of(pImo->m_language);
+            break;
+        }
+
+        case k_imo_lyrics_text_info:
+            m_bytes += bytes_of( static_cast<ImoLyricsTextInfo*>(pCopy)->m_elision );
+            break;
+
+        case k_imo_midi_info:
+        {
+            ImoMidiInfo* pImo = static_cast<ImoMidiInfo*>(pCopy);
+            m_bytes += bytes_of(pImo->get_midi_device_name())
+                       + bytes_of(pImo->get_midi_name());
+            break;
+        }
+
+        case k_imo_multicolumn:
+            m_bytes += bytes_of( static_cast<ImoMultiColumn*>(pCopy)->m_widths );
+            break;
+
+        case k_imo_option:
+        {
+            ImoOptionInfo* pImo = static_cast<ImoOptionInfo*>(pCopy);
+            m_bytes += bytes_of(pImo->m_name) + bytes_of(pImo->m_sValue);
+            break;
+        }
+
+        case k_imo_param_info:
+        {
+            ImoParamInfo* pImo = static_cast<ImoParamInfo*>(pCopy);
+            m_bytes += bytes_of(pImo->get_name()) + bytes_of(pImo->get_value());
+            break;
+        }
+
+        case k_imo_relations:
+            m_bytes += bytes_of( static_cast<ImoRelations*>(pCopy)->get_relations() );
+            break;
+
+        case k_imo_score:
+        {
+            ImoScore* pImo = static_cast<ImoScore*>(pCopy);
+            m_bytes += bytes_of(pImo->m_titles) + bytes_of(pImo->m_nameToStyle);
+            map<string, ImoStyle*>::iterator it;
+            for (it = pImo->m_nameToStyle.begin(); it != pImo->m_nameToStyle.end(); ++it)
+                m_bytes += bytes_of(it->first);
+            break;
+        }
+
+        case k_imo_style:
+        {
+            ImoStyle* pImo = static_cast<ImoStyle*>(pCopy);
+            m_bytes += bytes_of(pImo->m_name)
+                       + bytes_of(pImo->m_lunitsProps) + bytes_of(pImo->m_floatProps)
+                       + bytes_of(pImo->m_stringProps) + bytes_of(pImo->m_intProps)
+                       + bytes_of(pImo->m_colorProps);
+            map<int, string>::iterator it;
+            for (it = pImo->m_stringProps.begin(); it != pImo->m_stringProps.end(); ++it)
+                m_bytes += bytes_of(it->second);
+            break;
+        }
+
+        case k_imo_styles:
+        {
+            ImoStyles* pImo = static_cast<ImoStyles*>(pCopy);
+            m_bytes += bytes_of(pImo->m_nameToStyle);
+            map<string, ImoStyle*>::iterator it;
+            for (it = pImo->m_nameToStyle.begin(); it != pImo->m_nameToStyle.end(); ++it)
+                m_bytes += bytes_of(it->first);
+            break;
+        }
+
+        case k_imo_table:
+            m_bytes += bytes_of( static_cast<ImoTable*>(pCopy)->m_colStyles );
+            break;
+
+        case k_imo_text_box:
+            m_bytes += bytes_of( static_cast<ImoTextBox*>(pCopy)->m_text );
+            break;
+
+        case k_imo_text_info:
+        {
+            ImoTextInfo* pImo = static_cast<ImoTextInfo*>(pCopy);
+            m_bytes += bytes_of(pImo->get_text()) + bytes_of(pImo->get_language());
+            break;
+        }
+
+        case k_imo_text_item:
+        {
+            ImoTextItem* pImo = static_cast<ImoTextItem*>(pCopy);
+            m_bytes += bytes_of(pImo->m_text) + bytes_of(pImo->m_language);
+            break;
+        }
+
+        case k_imo_volta_bracket:
+        {
+            ImoVoltaBracket* pImo = static_cast<ImoVoltaBracket*>(pCopy);
+            m_bytes += bytes_of(pImo->m_voltaNum) + bytes_of(pImo->m_voltaText)
+                       + bytes_of(pImo->m_repetitions);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+size_t ImoCloner::bytes_of(const string& s)
+{
+    //short strings are stored inside the string object
+    const char* pData = s.data();
+    const char* pObj = reinterpret_cast<const char*>(&s);
+    if (pData >= pObj && pData < pObj + sizeof(string))
+        return 0;
+    return s.capacity() + 1;
+}
+
+//---------------------------------------------------------------------------------------
+void ImoCloner::clone_styles(map<string, ImoStyle*>& styles)
+{
+    //the received map is a copy of the source map: replace styles by copies
+    map<string, ImoStyle*>::iterator it;
+    for (it = styles.begin(); it != styles.end(); ++it)
+        it->second = clone_owned(it->second);
+}
+
+//---------------------------------------------------------------------------------------
+void ImoCloner::fix_references(ImoObj* pImo, ImoObj* pCopy)
+{
+    pCopy->set_owner_document(m_pDoc);
+
+    if (pCopy->is_contentobj())
+    {
+        ImoContentObj* pObj = static_cast<ImoContentObj*>(pCopy);
+        pObj->m_pStyle = style_for(pObj->m_pStyle);
+    }
+
+    if (pCopy->is_blocks_container())
+    {
+        BlockLevelCreatorApi* pApi = static_cast<ImoBlocksContainer*>(pCopy);
+        pApi->m_pParent = copy_for(pApi->m_pParent);
+    }
+    else if (pCopy->is_inlines_container())
+    {
+        InlineLevelCreatorApi* pApi = static_cast<ImoInlinesContainer*>(pCopy);
+        pApi->m_pParent = copy_for(pApi->m_pParent);
+    }
+    else if (pCopy->is_box_inline())
+    {
+        InlineLevelCreatorApi* pApi = static_cast<ImoBoxInline*>(pCopy);
+        pApi->m_pParent = copy_for(pApi->m_pParent);
+    }
+
+    if (pCopy->is_staffobj())
+        static_cast<ImoStaffObj*>(pCopy)->set_colstaffobjs_entry(nullptr);
+
+    if (pCopy->is_auxrelobj())
+    {
+        ImoAuxRelObj* pARO = static_cast<ImoAuxRelObj*>(pCopy);
+        pARO->m_prevARO = copy_for(pARO->m_prevARO);
+        pARO->m_nextARO = copy_for(pARO->m_nextARO);
+    }
+
+    if (pCopy->is_relobj())
+    {
+        std::list< pair<ImoStaffObj*, ImoRelDataObj*> >& objs =
+            static_cast<ImoRelObj*>(pCopy)->get_related_objects();
+        std::list< pair<ImoStaffObj*, ImoRelDataObj*> >::iterator it = objs.begin();
+        while (it != objs.end())
+        {
+            ImoStaffObj* pSO = copy_for(it->first);
+            ImoRelDataObj* pData = copy_for(it->second);
+            if (pSO)
+            {
+                *it = make_pair(pSO, pData);
+                ++it;
+            }
+            else
+            {
+                if (pData)
+                    m_orphans.push_back(pData);
+                it = objs.erase(it);
+            }
+        }
+    }
+
+    switch (pCopy->get_obj_type())
+    {
+        case k_imo_instr_group:
+        {
+            ImoInstrGroup* pGroup = static_cast<ImoInstrGroup*>(pCopy);
+            pGroup->m_pScore = copy_for(pGroup->m_pScore);
+            break;
+        }
+
+        case k_imo_instrument:
+        {
+            ImoInstrument* pInstr = static_cast<ImoInstrument*>(pCopy);
+            pInstr->m_pScore = copy_for(pInstr->m_pScore);
+            break;
+        }
+
+        case k_imo_note_regular:
+        case k_imo_note_cue:
+        case k_imo_note_grace:
+        {
+            ImoNote* pNote = static_cast<ImoNote*>(pCopy);
+            pNote->set_tie_next( copy_for(pNote->get_tie_next()) );
+            pNote->set_tie_prev( copy_for(pNote->get_tie_prev()) );
+            break;
+        }
+
+        case k_imo_relations:
+        {
+            std::list<ImoRelObj*>& relations = static_cast<ImoRelations*>(pCopy)->get_relations();
+            std::list<ImoRelObj*>::iterator it = relations.begin();
+            while (it != relations.end())
+            {
+                ImoRelObj* pRO = copy_for(*it);
+                if (pRO)
+                {
+                    *it = pRO;
+                    ++it;
+                }
+                else
+                    it = relations.erase(it);
+            }
+            break;
+        }
+
+        case k_imo_score:
+        {
+            ImoScore* pScore = static_cast<ImoScore*>(pCopy);
+            std::list<ImoScoreTitle*>::iterator it;
+            for (it = pScore->m_titles.begin(); it != pScore->m_titles.end(); ++it)
+                *it = copy_for(*it);
+            pScore->m_titles.remove(nullptr);
+            break;
+        }
+
+        case k_imo_style:
+        {
+            ImoStyle* pStyle = static_cast<ImoStyle*>(pCopy);
+            pStyle->m_pParent = style_for(pStyle->m_pParent);
+            break;
+        }
+
+        case k_imo_table:
+        {
+            ImoTable* pTable = static_cast<ImoTable*>(pCopy);
+            std::list<ImoStyle*>::iterator it;
+            for (it = pTable->m_colStyles.begin(); it != pTable->m_colStyles.end(); ++it)
+                *it = style_for(*it);
+            break;
+        }
+
+        case k_imo_text_info:
+        {
+            ImoTextInfo* pInfo = static_cast<ImoTextInfo*>(pCopy);
+            pInfo->set_style( style_for(pInfo->get_style()) );
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+ImoObj* ImoCloner::copy_for(ImoObj* pImo)
+{
+    if (!pImo)
+        return nullptr;
+
+    unordered_map<ImoObj*, ImoObj*>::iterator it = m_copies.find(pImo);
+    if (it != m_copies.end())
+        return it->second;
+
+    //pointer to an object external to the subtree
+    m_fValid = false;
+    return nullptr;
+}
+
+//---------------------------------------------------------------------------------------
+ImoStyle* ImoCloner::style_for(ImoStyle* pStyle)
+{
+    if (!pStyle)
+        return nullptr;
+
+    unordered_map<ImoObj*, ImoObj*>::iterator it = m_copies.find(pStyle);
+    if (it != m_copies.end())
+        return static_cast<ImoStyle*>(it->second);
+
+    ImoStyle* pNewStyle = nullptr;
+    if (m_pDoc)
+    {
+        //restoring: use the document style with the same name
+        ImoDocument* pImoDoc = m_pDoc->get_im_root();
+        if (pImoDoc)
+        {
+            pNewStyle = pImoDoc->find_style( pStyle->get_name() );
+            if (!pNewStyle)
+                pNewStyle = pImoDoc->get_default_style();
+        }
+    }
+    else
+    {
+        //capturing: only named document styles can be replaced when restoring
+        ImoDocument* pImoDoc = pStyle->get_document();
+        if (pImoDoc && pImoDoc->find_style( pStyle->get_name() ) == pStyle)
+        {
+            pNewStyle = LOMSE_NEW ImoStyle(*pStyle);
+            pNewStyle->set_owner_document(nullptr);
+            pNewStyle->set_id(k_no_imoid);
+            pNewStyle->m_pParent = nullptr;
+            m_pExternalStyles->push_back(pNewStyle);
+        }
+        else
+            m_fValid = false;
+    }
+
+    m_copies[pStyle] = pNewStyle;
+    return pNewStyle;
+}
+
+
+//=======================================================================================
+// ImSnapshot implementation
+//=======================================================================================
+ImSnapshot::ImSnapshot()
+    : m_pRoot(nullptr)
+    , m_numObjects(0)
+    , m_memorySize(0)
+{
+}
+
+//---------------------------------------------------------------------------------------
+ImSnapshot::~ImSnapshot()
+{
+    delete m_pRoot;
+
+    list<ImoStyle*>::iterator it;
+    for (it = m_externalStyles.begin(); it != m_externalStyles.end(); ++it)
+        delete *it;
+}
+
+//---------------------------------------------------------------------------------------
+ImSnapshot* ImSnapshot::capture(ImoObj* pImo)
+{
+    if (!pImo)
+        return nullptr;
+
+    ImSnapshot* pSnapshot = LOMSE_NEW ImSnapshot();
+    ImoCloner cloner(nullptr, &pSnapshot->m_externalStyles);
+    pSnapshot->m_pRoot = cloner.clone(pImo);
+    pSnapshot->m_numObjects = cloner.get_num_objects();
+    pSnapshot->m_memorySize = cloner.get_memory_size();
+
+    if (!cloner.is_valid())
+    {
+        delete pSnapshot;
+        return nullptr;
+    }
+    return pSnapshot;
+}
+
+//---------------------------------------------------------------------------------------
+ImoObj* ImSnapshot::restore(Document* pDoc, IdAssigner* pAssigner)
+{
+    ImoCloner cloner(pDoc, nullptr);
+    ImoObj* pImo = cloner.clone(m_pRoot);
+    cloner.assign_ids(pAssigner);
+    return pImo;
+}
+
+
+}  //namespace lomse
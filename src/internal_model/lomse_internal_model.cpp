@@ -386,6 +386,30 @@ ImoObj::ImoObj(int objtype, ImoId id)
 {
 }
 
+//---------------------------------------------------------------------------------------
+ImoObj::ImoObj(const ImoObj& a)
+    : Visitable(a)
+    , TreeNode<ImoObj>()
+    , m_pDoc(a.m_pDoc)
+    , m_id(a.m_id)
+    , m_objtype(a.m_objtype)
+    , m_flags(a.m_flags)
+    , m_pAttribs(nullptr)
+{
+    //the copy is not linked to the tree but it owns a copy of the attributes
+    ImoAttr* pLast = nullptr;
+    for (ImoAttr* pAttr = a.m_pAttribs; pAttr; pAttr = pAttr->get_next_attrib())
+    {
+        ImoAttr* pCopy = LOMSE_NEW ImoAttr(*pAttr);
+        pCopy->set_next_attrib(nullptr);
+        if (pLast)
+            pLast->set_next_attrib(pCopy);
+        else
+            m_pAttribs = pCopy;
+        pLast = pCopy;
+    }
+}
+
 //---------------------------------------------------------------------------------------
 ImoObj::~ImoObj()
 {
@@ -778,6 +802,25 @@ void ImoObj::set_children_dirty(bool value)
     value ? m_flags |= k_children_dirty : m_flags &= ~k_children_dirty;
 }
 
+//---------------------------------------------------------------------------------------
+void ImoObj::clear_dirty(std::list<ImoId>* pDirtyIds)
+{
+    //clear dirty flags in this object and in all its dirty descendants. If a list
+    //is received, the ids of the dirty objects are appended to it
+
+    if (is_dirty() && pDirtyIds)
+        pDirtyIds->push_back(m_id);
+
+    if (are_children_dirty())
+    {
+        TreeNode<ImoObj>::children_iterator it;
+        for (it = this->begin(); it != this->end(); ++it)
+            (*it)->clear_dirty(pDirtyIds);
+    }
+
+    m_flags &= ~(k_dirty | k_children_dirty);
+}
+
 //---------------------------------------------------------------------------------------
 void ImoObj::propagate_dirty()
 {
@@ -792,7 +835,8 @@ void ImoObj::propagate_dirty()
     {
         ImoDocument* pImoDoc = static_cast<ImoDocument*>(this);
         Document* pDoc = pImoDoc->get_the_document();
-        pDoc->set_dirty();
+        if (pDoc)   //nullptr for models not owned by a Document (e.g. ImSnapshot)
+            pDoc->set_dirty();
     }
 }
 
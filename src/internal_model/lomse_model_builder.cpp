@@ -84,13 +84,33 @@ public:
 ImoDocument* ModelBuilder::build_model(ImoDocument* pImoDoc)
 {
     if (pImoDoc)
-    {
-        VisitorForStructurizables v(this);
-        pImoDoc->accept_visitor(v);
-    }
+        structurize_subtree(pImoDoc);
     return pImoDoc;
 }
 
+//---------------------------------------------------------------------------------------
+void ModelBuilder::structurize_subtree(ImoObj* pImo)
+{
+    VisitorForStructurizables v(this);
+    pImo->accept_visitor(v);
+
+    //the model is built. Modifications made while building it are not relevant
+    clear_dirty_flags(pImo);
+}
+
+//---------------------------------------------------------------------------------------
+void ModelBuilder::clear_dirty_flags(ImoObj* pImo)
+{
+    //AWARE: objects are marked as dirty before being added to the tree. Therefore,
+    //the whole tree must be traversed, not only the dirty branches.
+    pImo->set_dirty(false);
+    pImo->set_children_dirty(false);
+
+    TreeNode<ImoObj>::children_iterator it;
+    for (it = pImo->begin(); it != pImo->end(); ++it)
+        clear_dirty_flags(*it);
+}
+
 //---------------------------------------------------------------------------------------
 void ModelBuilder::structurize(ImoObj* pImo)
 {
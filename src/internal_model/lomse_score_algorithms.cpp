@@ -148,24 +148,8 @@ ImoNoteRest* ScoreAlgorithms::find_noterest_at(ImoScore* pScore,
                                                int instr, int voice, TimeUnits time)
 {
     ColStaffObjs* pColStaffObjs = pScore->get_staffobjs_table();
-    ColStaffObjsIterator it;
-    for (it=pColStaffObjs->begin(); it != pColStaffObjs->end(); ++it)
-    {
-        if (is_greater_time((*it)->time(), time))
-            break;
-        ImoObj* pImo = (*it)->imo_object();
-        if (pImo->is_note_rest())
-        {
-            ImoNoteRest* pNR = static_cast<ImoNoteRest*>(pImo);
-            if ((*it)->num_instrument() == instr)
-            {
-                if (pNR->get_voice() == voice
-                    && !is_greater_time(time, (*it)->time() + pNR->get_duration()) )
-                    return pNR;
-            }
-        }
-    }
-    return nullptr;
+    ColStaffObjsEntry* pEntry = pColStaffObjs->find_noterest_at(instr, voice, time);
+    return (pEntry ? static_cast<ImoNoteRest*>(pEntry->imo_object()) : nullptr);
 }
 
 //---------------------------------------------------------------------------------------
@@ -174,67 +158,57 @@ list<OverlappedNoteRest*> ScoreAlgorithms::find_and_classify_overlapped_noterest
 {
     list<OverlappedNoteRest*> overlaps;
     ColStaffObjs* pColStaffObjs = pScore->get_staffobjs_table();
-    ColStaffObjsIterator it;
-    for (it=pColStaffObjs->begin(); it != pColStaffObjs->end(); ++it)
+    vector<ColStaffObjsEntry*> entries;
+    pColStaffObjs->find_noterests_in(instr, voice, time, time + duration, entries);
+
+    vector<ColStaffObjsEntry*>::iterator it;
+    for (it=entries.begin(); it != entries.end(); ++it)
     {
-        ImoObj* pImo = (*it)->imo_object();
-        if (pImo->is_note_rest())
+        ImoNoteRest* pNR = static_cast<ImoNoteRest*>( (*it)->imo_object() );
+        TimeUnits nrTime = (*it)->time();
+        TimeUnits nrDuration = pNR->get_duration();
+        OverlappedNoteRest* pOV = LOMSE_NEW OverlappedNoteRest(pNR);
+        if (is_equal_time(nrTime, time))
         {
-            ImoNoteRest* pNR = static_cast<ImoNoteRest*>(pImo);
-            TimeUnits nrTime = (*it)->time();
-            TimeUnits nrDuration = pNR->get_duration();
-            if ((*it)->num_instrument() == instr
-                && pNR->get_voice() == voice
-                && is_greater_time(time + duration, nrTime)     //starts before end of inserted one
-                && is_lower_time(time, nrTime + nrDuration)     //ends after start of inserted one
-               )
+            //both start at same time
+            if (is_lower_time(duration, nrDuration))
             {
-                OverlappedNoteRest* pOV = LOMSE_NEW OverlappedNoteRest(pNR);
-                if (is_equal_time(nrTime, time))
-                {
-                    //both start at same time
-                    if (is_lower_time(duration, nrDuration))
-                    {
-                        //test 4
-                        pOV->type = k_overlap_at_start;
-                        pOV->overlap = duration;
-                    }
-                    else
-                    {
-                        //test 1
-                        pOV->type = k_overlap_full;
-                        pOV->overlap = nrDuration;
-                    }
-                }
-                else if (is_lower_time(time, nrTime))
-                {
-                    //starts after inserted one: overlap at_start or full
-                    pOV->overlap = duration - (nrTime - time);
-                    if (is_lower_time(pOV->overlap, nrDuration))
-                    {
-                        //test 5
-                        pOV->type = k_overlap_at_start;
-                    }
-                    else
-                    {
-                        //test 3
-                        pOV->type = k_overlap_full;
-                        pOV->overlap = nrDuration;
-                    }
-                }
-                else
-                {
-                    //starts before inserted one: overlap at_end
-                    //test 2, 3, 5
-                    pOV->overlap = nrDuration - (time - nrTime);
-                    pOV->type = k_overlap_at_end;
-                }
-
-                overlaps.push_back(pOV);
+                //test 4
+                pOV->type = k_overlap_at_start;
+                pOV->overlap = duration;
+            }
+            else
+            {
+                //test 1
+                pOV->type = k_overlap_full;
+                pOV->overlap = nrDuration;
             }
-            else if (is_lower_time(time + duration, nrTime))
-                break;
         }
+        else if (is_lower_time(time, nrTime))
+        {
+            //starts after inserted one: overlap at_start or full
+            pOV->overlap = duration - (nrTime - time);
+            if (is_lower_time(pOV->overlap, nrDuration))
+            {
+                //test 5
+                pOV->type = k_overlap_at_start;
+            }
+            else
+            {
+                //test 3
+                pOV->type = k_overlap_full;
+                pOV->overlap = nrDuration;
+            }
+        }
+        else
+        {
+            //starts before inserted one: overlap at_end
+            //test 2, 3, 5
+            pOV->overlap = nrDuration - (time - nrTime);
+            pOV->type = k_overlap_at_end;
+        }
+
+        overlaps.push_back(pOV);
     }
     return overlaps;
 }
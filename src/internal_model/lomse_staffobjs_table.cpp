@@ -98,14 +98,16 @@ ColStaffObjs::ColStaffObjs()
     , m_minNoteDuration(LOMSE_NO_NOTE_DURATION)
     , m_pFirst(nullptr)
     , m_pLast(nullptr)
+    , m_fBulkLoad(false)
+    , m_fVoicesValid(false)
 {
 }
 
 //---------------------------------------------------------------------------------------
 ColStaffObjs::~ColStaffObjs()
 {
-    ColStaffObjs::iterator it;
-    for (it=begin(); it != end(); ++it)
+    vector<ColStaffObjsEntry*>::iterator it;
+    for (it=m_added.begin(); it != m_added.end(); ++it)
         delete *it;
 }
 
@@ -113,13 +115,64 @@ ColStaffObjs::~ColStaffObjs()
 ColStaffObjsEntry* ColStaffObjs::add_entry(int measure, int instr, int voice, int staff,
                                            ImoStaffObj* pImo)
 {
+    ++m_numEntries;
+
+    if (m_fBulkLoad)
+    {
+        //AWARE: the returned pointer is only valid until next entry is added
+        m_entries.emplace_back(measure, instr, voice, staff, pImo);
+        return &m_entries.back();
+    }
+
     ColStaffObjsEntry* pEntry =
         LOMSE_NEW ColStaffObjsEntry(measure, instr, voice, staff, pImo);
+    m_added.push_back(pEntry);
     add_entry_to_list(pEntry);
-    ++m_numEntries;
+    add_to_index(pEntry);
+    if (pImo->is_note_rest())
+        m_fVoicesValid = false;     //rebuilt when needed
     return pEntry;
 }
 
+//---------------------------------------------------------------------------------------
+void ColStaffObjs::start_bulk_load()
+{
+    //Entries added from now on are just appended to the storage, without ordering
+    //them. The table is not usable until finish_bulk_load() is invoked.
+    m_fBulkLoad = true;
+}
+
+//---------------------------------------------------------------------------------------
+void ColStaffObjs::finish_bulk_load()
+{
+    m_fBulkLoad = false;
+
+    vector<ColStaffObjsEntry*> entries;
+    entries.reserve(m_entries.size());
+    vector<ColStaffObjsEntry>::iterator it;
+    for (it=m_entries.begin(); it != m_entries.end(); ++it)
+        entries.push_back(&(*it));
+
+    sort_entries(entries);
+
+    //move entries to their final location, in table order
+    vector<ColStaffObjsEntry> sorted;
+    sorted.reserve(entries.size());
+    vector<ColStaffObjsEntry*>::iterator itE;
+    for (itE=entries.begin(); itE != entries.end(); ++itE)
+        sorted.push_back(**itE);
+    m_entries.swap(sorted);
+
+    entries.clear();
+    for (it=m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        ColStaffObjsEntry* pEntry = &(*it);
+        pEntry->m_pImo->set_colstaffobjs_entry(pEntry);
+        entries.push_back(pEntry);
+    }
+    link_entries(entries);
+}
+
 //---------------------------------------------------------------------------------------
 string ColStaffObjs::dump(bool fWithIds)
 {
@@ -179,6 +232,262 @@ void ColStaffObjs::add_entry_to_list(ColStaffObjsEntry* pEntry)
     m_pFirst = pEntry;
 }
 
+//---------------------------------------------------------------------------------------
+void ColStaffObjs::link_entries(vector<ColStaffObjsEntry*>& entries)
+{
+    //rebuild the list and the index from the entries, already in table order
+
+    m_pFirst = nullptr;
+    m_pLast = nullptr;
+    m_index.clear();
+
+    vector<ColStaffObjsEntry*>::iterator it;
+    for (it=entries.begin(); it != entries.end(); ++it)
+    {
+        ColStaffObjsEntry* pEntry = *it;
+        pEntry->set_prev( m_pLast );
+        pEntry->set_next( nullptr );
+        if (m_pLast)
+            m_pLast->set_next( pEntry );
+        else
+            m_pFirst = pEntry;
+        m_pLast = pEntry;
+
+        ImoId id = pEntry->imo_object()->get_id();
+        if (id != k_no_imoid)
+            m_index.insert( make_pair(id, pEntry) );    //keeps the first one
+    }
+
+    build_voices_index();
+}
+
+//---------------------------------------------------------------------------------------
+void ColStaffObjs::build_voices_index()
+{
+    m_voices.clear();
+
+    ColStaffObjsEntry* pEntry = m_pFirst;
+    while (pEntry != nullptr)
+    {
+        ImoStaffObj* pSO = pEntry->imo_object();
+        if (pSO->is_note_rest())
+        {
+            int voice = static_cast<ImoNoteRest*>(pSO)->get_voice();
+            VoiceNoteRests& data = m_voices[make_pair(pEntry->num_instrument(), voice)];
+            TimeUnits endTime = pEntry->time() + pEntry->duration();
+            if (!data.maxEndTime.empty())
+                endTime = max(endTime, data.maxEndTime.back());
+            data.entries.push_back(pEntry);
+            data.maxEndTime.push_back(endTime);
+        }
+        pEntry = pEntry->get_next();
+    }
+    m_fVoicesValid = true;
+}
+
+//---------------------------------------------------------------------------------------
+void ColStaffObjs::remove_from_voices_index(ColStaffObjsEntry* pEntry)
+{
+    ImoStaffObj* pSO = pEntry->imo_object();
+    if (!m_fVoicesValid || !pSO->is_note_rest())
+        return;
+
+    int voice = static_cast<ImoNoteRest*>(pSO)->get_voice();
+    map<pair<int, int>, VoiceNoteRests>::iterator it =
+        m_voices.find( make_pair(pEntry->num_instrument(), voice) );
+    if (it == m_voices.end())
+        return;
+
+    VoiceNoteRests& data = it->second;
+    vector<ColStaffObjsEntry*>::iterator itE =
+        std::find(data.entries.begin(), data.entries.end(), pEntry);
+    if (itE == data.entries.end())
+        return;
+
+    //remove the entry and update max end time for next ones
+    size_t i = size_t(itE - data.entries.begin());
+    data.entries.erase(itE);
+    data.maxEndTime.erase(data.maxEndTime.begin() + i);
+    for (; i < data.entries.size(); ++i)
+    {
+        ColStaffObjsEntry* pNR = data.entries[i];
+        TimeUnits endTime = pNR->time() + pNR->duration();
+        data.maxEndTime[i] = (i > 0 ? max(endTime, data.maxEndTime[i-1]) : endTime);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+ColStaffObjs::VoiceNoteRests* ColStaffObjs::get_voice_noterests(int instr, int voice)
+{
+    if (!m_fVoicesValid)
+        build_voices_index();
+
+    map<pair<int, int>, VoiceNoteRests>::iterator it =
+        m_voices.find( make_pair(instr, voice) );
+    return (it != m_voices.end() ? &(it->second) : nullptr);
+}
+
+//---------------------------------------------------------------------------------------
+size_t ColStaffObjs::first_sounding_at(VoiceNoteRests* pVoice, TimeUnits time,
+                                       bool fIncludeEnd)
+{
+    //Returns the index of the first note/rest ending after timepos (or at timepos, when
+    //fIncludeEnd). All previous note/rests end before it.
+
+    vector<TimeUnits>& maxEnd = pVoice->maxEndTime;
+    vector<TimeUnits>::iterator it;
+    if (fIncludeEnd)
+        it = lower_bound(maxEnd.begin(), maxEnd.end(), time,
+                         [](TimeUnits endTime, TimeUnits t) {
+                             return is_lower_time(endTime, t);
+                         });
+    else
+        it = lower_bound(maxEnd.begin(), maxEnd.end(), time,
+                         [](TimeUnits endTime, TimeUnits t) {
+                             return !is_greater_time(endTime, t);
+                         });
+    return size_t(it - maxEnd.begin());
+}
+
+//---------------------------------------------------------------------------------------
+ColStaffObjsEntry* ColStaffObjs::find_noterest_at(int instr, int voice, TimeUnits time)
+{
+    //Returns the first note/rest, in table order, sounding at timepos, that is, the
+    //note/rest starting before or at timepos and ending at or after timepos.
+
+    VoiceNoteRests* pVoice = get_voice_noterests(instr, voice);
+    if (!pVoice)
+        return nullptr;
+
+    //the first note/rest ending at or after timepos is the one that raises the max.
+    //end time. Next ones start after it.
+    size_t i = first_sounding_at(pVoice, time, true);
+    if (i < pVoice->entries.size()
+        && !is_greater_time(pVoice->entries[i]->time(), time))
+    {
+        return pVoice->entries[i];
+    }
+    return nullptr;
+}
+
+//---------------------------------------------------------------------------------------
+void ColStaffObjs::find_noterests_in(int instr, int voice, TimeUnits startTime,
+                                     TimeUnits endTime,
+                                     vector<ColStaffObjsEntry*>& found)
+{
+    //Appends to found all note/rests, in table order, that sound in the time range,
+    //that is, that start before endTime and end after startTime.
+
+    VoiceNoteRests* pVoice = get_voice_noterests(instr, voice);
+    if (!pVoice)
+        return;
+
+    size_t numEntries = pVoice->entries.size();
+    for (size_t i = first_sounding_at(pVoice, startTime, false); i < numEntries; ++i)
+    {
+        ColStaffObjsEntry* pEntry = pVoice->entries[i];
+        if (!is_lower_time(pEntry->time(), endTime))
+            break;
+        if (is_greater_time(pEntry->time() + pEntry->duration(), startTime))
+            found.push_back(pEntry);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void ColStaffObjs::sort_entries(vector<ColStaffObjsEntry*>& entries)
+{
+    //Sorts the entries, in the order they were added, as if each one were inserted in
+    //the table by add_entry_to_list(). When inserting an entry, the ordering rules only
+    //are relevant for entries at the same timepos: all entries at higher timepos are
+    //skipped and the insertion point is never before an entry at lower timepos.
+    //Therefore, the result is the same than doing a stable sort by timepos and then
+    //applying the insertion algorithm to each group of entries at the same timepos.
+
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](ColStaffObjsEntry* a, ColStaffObjsEntry* b) {
+                         return is_lower_time(a->time(), b->time());
+                     });
+
+    size_t numEntries = entries.size();
+    size_t iStart = 0;
+    while (iStart < numEntries)
+    {
+        size_t iEnd = iStart + 1;
+        while (iEnd < numEntries
+               && !is_greater_time(entries[iEnd]->time(), entries[iStart]->time()))
+        {
+            ++iEnd;
+        }
+
+        for (size_t i = iStart + 1; i < iEnd; ++i)
+        {
+            ColStaffObjsEntry* pEntry = entries[i];
+            size_t j = i;
+            while (j > iStart && is_lower_entry(pEntry, entries[j-1]))
+            {
+                entries[j] = entries[j-1];
+                --j;
+            }
+            entries[j] = pEntry;
+        }
+
+        iStart = iEnd;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void ColStaffObjs::add_to_index(ColStaffObjsEntry* pEntry)
+{
+    ImoId id = pEntry->imo_object()->get_id();
+    if (id == k_no_imoid)
+        return;
+
+    unordered_map<ImoId, ColStaffObjsEntry*>::iterator it = m_index.find(id);
+    if (it == m_index.end())
+    {
+        m_index[id] = pEntry;
+        return;
+    }
+
+    //the staffobj has more entries (i.e. key signature in several staves). The index
+    //must point to the first one. As all them are at the same timepos, only entries
+    //at that timepos need to be checked.
+    ColStaffObjsEntry* pNext = pEntry->get_next();
+    while (pNext && !is_greater_time(pNext->time(), pEntry->time()))
+    {
+        if (pNext == it->second)
+        {
+            it->second = pEntry;
+            return;
+        }
+        pNext = pNext->get_next();
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void ColStaffObjs::remove_from_index(ColStaffObjsEntry* pEntry)
+{
+    //AWARE: must be invoked before removing the entry from the list
+
+    ImoId id = pEntry->imo_object()->get_id();
+    unordered_map<ImoId, ColStaffObjsEntry*>::iterator it = m_index.find(id);
+    if (it == m_index.end() || it->second != pEntry)
+        return;
+
+    //if the staffobj has more entries, the next one is now the first one
+    ColStaffObjsEntry* pNext = pEntry->get_next();
+    while (pNext && !is_greater_time(pNext->time(), pEntry->time()))
+    {
+        if (pNext->imo_object() == pEntry->imo_object())
+        {
+            it->second = pNext;
+            return;
+        }
+        pNext = pNext->get_next();
+    }
+    m_index.erase(it);
+}
+
 //---------------------------------------------------------------------------------------
 bool ColStaffObjs::is_lower_entry(ColStaffObjsEntry* b, ColStaffObjsEntry* a)
 {
@@ -279,9 +588,10 @@ void ColStaffObjs::delete_entry_for(ImoStaffObj* pSO)
         throw runtime_error("[ColStaffObjs::delete_entry_for] entry not found!");
     }
 
+    remove_from_index(pEntry);
+    remove_from_voices_index(pEntry);
     ColStaffObjsEntry* pPrev = pEntry->get_prev();
     ColStaffObjsEntry* pNext = pEntry->get_next();
-    delete pEntry;
     if (pPrev == nullptr)
     {
         //removing the head of the list
@@ -307,6 +617,15 @@ void ColStaffObjs::delete_entry_for(ImoStaffObj* pSO)
 //---------------------------------------------------------------------------------------
 ColStaffObjsEntry* ColStaffObjs::find_entry_for(ImoStaffObj* pSO)
 {
+    ImoId id = pSO->get_id();
+    if (id != k_no_imoid)
+    {
+        unordered_map<ImoId, ColStaffObjsEntry*>::iterator itI = m_index.find(id);
+        if (itI != m_index.end() && itI->second->imo_object() == pSO)
+            return itI->second;
+    }
+
+    //objects without id or not indexed
     ColStaffObjs::iterator it;
     for (it=begin(); it != end(); ++it)
     {
@@ -322,25 +641,20 @@ void ColStaffObjs::sort_table()
     //The table is created with entries in order. But edition operations forces to
     //reorder entries. The main requirement for the sort algorithm is:
     // * stable (preserve order of elements with equal keys)
-    //The chosen algorithm is the insertion sort, that also has some advantages:
-    // * good performance when table is nearly ordered
-    // * simple to implement and much better performance than other simple algorithms,
-    //   such as the bubble sort
-    // * in-place sort (does not require extra memory)
+    //Entries are re-sorted, in current order, as if they were inserted again in
+    //the table. See sort_entries().
 
-    ColStaffObjsEntry* pUnsorted = m_pFirst;
-    m_pFirst = nullptr;
-    m_pLast = nullptr;
-
-    while (pUnsorted != nullptr)
+    vector<ColStaffObjsEntry*> entries;
+    entries.reserve(m_numEntries);
+    ColStaffObjsEntry* pEntry = m_pFirst;
+    while (pEntry != nullptr)
     {
-        ColStaffObjsEntry* pCurrent = pUnsorted;
-
-        //get next here, as insertion could change next element
-        pUnsorted = pUnsorted->get_next();
-
-        add_entry_to_list(pCurrent);
+        entries.push_back(pEntry);
+        pEntry = pEntry->get_next();
     }
+
+    sort_entries(entries);
+    link_entries(entries);
 }
 
 
@@ -385,12 +699,14 @@ ColStaffObjs* ColStaffObjsBuilderEngine::do_build()
 void ColStaffObjsBuilderEngine::create_table()
 {
     initializations();
+    m_pColStaffObjs->start_bulk_load();
     int totalInstruments = m_pImScore->get_num_instruments();
     for (int instr = 0; instr < totalInstruments; instr++)
     {
         create_entries_for_instrument(instr);
         prepare_for_next_instrument();
     }
+    m_pColStaffObjs->finish_bulk_load();
     compute_playback_time();
     collect_anacruxis_info();
 }
@@ -500,12 +816,11 @@ void ColStaffObjsBuilderEngine::set_min_note_duration()
 //---------------------------------------------------------------------------------------
 void ColStaffObjsBuilderEngine::compute_playback_time()
 {
-    for (auto pEntry : m_graces)
+    for (auto pGrace : m_graces)
     {
-        ImoGraceNote* pGrace = static_cast<ImoGraceNote*>(pEntry->imo_object());
         ImoGraceRelObj* pGraceRO = pGrace->get_grace_relobj();
         if (static_cast<ImoGraceNote*>(pGraceRO->get_start_object()) == pGrace)
-            process_grace_relobj(pGrace, pGraceRO, pEntry);
+            process_grace_relobj(pGrace, pGraceRO, pGrace->get_colstaffobjs_entry());
     }
 }
 
@@ -779,10 +1094,9 @@ void ColStaffObjsBuilderEngine1x::add_entry_for_staffobj(ImoObj* pImo, int nInst
             m_minNoteDuration = min(m_minNoteDuration, pNR->get_duration());
     }
     int nLine = get_line_for(nVoice, nStaff);
-    ColStaffObjsEntry* pEntry = m_pColStaffObjs->add_entry(m_nCurMeasure, nInstr,
-                                                           nLine, nStaff, pSO);
+    m_pColStaffObjs->add_entry(m_nCurMeasure, nInstr, nLine, nStaff, pSO);
     if (pSO->is_grace_note())
-        m_graces.push_back(pEntry);
+        m_graces.push_back(static_cast<ImoGraceNote*>(pSO));
 }
 
 //---------------------------------------------------------------------------------------
@@ -29,24 +29,26 @@
 
 #include "lomse_events_dispatcher.h"
 
+#include <algorithm>
+
 namespace lomse
 {
 
-//TODO: For now, direct invocation without enqueuing the event in the thread.
-#define LOMSE_DIRECT_INVOCATION     1       //1=do not use events thread
-
 //=======================================================================================
 // EventsDispatcher implementation
 //=======================================================================================
-EventsDispatcher::EventsDispatcher()
-    : m_pThread(nullptr)
+EventsDispatcher::EventsDispatcher(bool fDirectInvocation)
+    : m_fDirectInvocation(fDirectInvocation)
+    , m_pThread(nullptr)
     , m_fStopLoop(false)
 {
+    reset_statistics();
 }
 
 //---------------------------------------------------------------------------------------
 EventsDispatcher::~EventsDispatcher()
 {
+    stop_events_loop();
 }
 
 //---------------------------------------------------------------------------------------
@@ -56,45 +58,227 @@ void EventsDispatcher::start_events_loop()
     //run_events_loop())
 
     //AWARE: this method is only intended to be invoked by Lomse, when the library is
-    //initialized. This method only returns when the stop_events_loop() method
+    //initialized. The thread only finishes when the stop_events_loop() method
     //is invoked.
 
-#if (LOMSE_DIRECT_INVOCATION == 0)
-    delete m_pThread;
-    m_pThread = LOMSE_NEW EventsThread(&EventsDispatcher::thread_main, this);
-#endif
+    if (!m_fDirectInvocation && !m_pThread)
+    {
+        m_fStopLoop = false;
+        m_pThread = LOMSE_NEW EventsThread(&EventsDispatcher::thread_main, this);
+    }
 }
 
 //---------------------------------------------------------------------------------------
 void EventsDispatcher::stop_events_loop()
 {
-    //stops the events dispatch loop
+    //stops the events dispatch loop. Pending events are dispatched before stopping.
 
     //AWARE: this method is only intended to be run by Lomse, when the
     //Lomse LibraryScope object is destroyed.
 
-    m_fStopLoop = true;
+    {
+        QueueLock lock(m_mutex);
+        m_fStopLoop = true;
+    }
+    m_wakeUp.notify_all();
+
+    if (m_pThread)
+    {
+        if (m_pThread->joinable())
+            m_pThread->join();
+        delete m_pThread;
+        m_pThread = nullptr;
+    }
 }
 
 //---------------------------------------------------------------------------------------
 void EventsDispatcher::thread_main()
 {
-#if (LOMSE_DIRECT_INVOCATION == 0)
     run_events_loop();
-#endif
 }
 
 //---------------------------------------------------------------------------------------
 void EventsDispatcher::post_event(Observer* pObserver, SpEventInfo pEvent)
 {
-#if (LOMSE_DIRECT_INVOCATION == 1)
-    pObserver->notify(pEvent);
-#else
+    if (m_fDirectInvocation)
+    {
+        pObserver->notify(pEvent);
+        return;
+    }
+
     {
         QueueLock lock(m_mutex);
-        m_events.push( make_pair(pEvent, pObserver));
+        ++m_numPosted;
+        if (coalesce_with_pending_event(pObserver, pEvent))
+        {
+            ++m_numCoalesced;
+            return;
+        }
+
+        QueuedEvent event;
+        event.pEvent = pEvent;
+        event.pObserver = pObserver;
+        event.timestamp = std::chrono::steady_clock::now();
+        m_events.push_back(event);
+        m_maxQueueDepth = max(m_maxQueueDepth, m_events.size());
     }
-#endif
+    m_wakeUp.notify_one();
+}
+
+//---------------------------------------------------------------------------------------
+bool EventsDispatcher::coalesce_with_pending_event(Observer* pObserver,
+                                                   SpEventInfo pEvent)
+{
+    //AWARE: the queue must be locked when invoking this method
+
+    if (m_events.empty())
+        return false;
+
+    QueuedEvent& last = m_events.back();
+    if (last.pObserver != pObserver
+        || last.pEvent->get_event_type() != pEvent->get_event_type())
+    {
+        return false;
+    }
+
+    if (pEvent->is_update_viewport_event())
+    {
+        SpEventUpdateViewport pNew(
+                static_pointer_cast<EventUpdateViewport>(pEvent) );
+        SpEventUpdateViewport pOld(
+                static_pointer_cast<EventUpdateViewport>(last.pEvent) );
+        WpInteractor wpNew = pNew->get_interactor();
+        WpInteractor wpOld = pOld->get_interactor();
+        if (wpNew.owner_before(wpOld) || wpOld.owner_before(wpNew))
+            return false;
+
+        //the new viewport supersedes the pending one
+        last.pEvent = pEvent;
+        return true;
+    }
+
+    if (pEvent->is_tracking_event())
+    {
+        SpEventVisualTracking pNew(
+                static_pointer_cast<EventVisualTracking>(pEvent) );
+        SpEventVisualTracking pOld(
+                static_pointer_cast<EventVisualTracking>(last.pEvent) );
+        WpInteractor wpNew = pNew->get_interactor();
+        WpInteractor wpOld = pOld->get_interactor();
+        if (pNew->get_score_id() != pOld->get_score_id()
+            || wpNew.owner_before(wpOld) || wpOld.owner_before(wpNew))
+        {
+            return false;
+        }
+
+        //merge sub-events in a new event, as the poster could still reference the
+        //pending one. Highlight sub-events must be preserved but only the last
+        //tempo line position is relevant.
+        SpEventVisualTracking pMerged( LOMSE_NEW EventVisualTracking(*pOld) );
+        std::list< pair<int, ImoId> >& items = pNew->get_items();
+        bool fMovesTempoLine = false;
+        std::list< pair<int, ImoId> >::iterator it;
+        for (it = items.begin(); it != items.end(); ++it)
+            fMovesTempoLine |= (it->first == EventVisualTracking::k_move_tempo_line);
+
+        if (fMovesTempoLine)
+        {
+            std::list< pair<int, ImoId> >& merged = pMerged->get_items();
+            for (it = merged.begin(); it != merged.end(); )
+            {
+                if (it->first == EventVisualTracking::k_move_tempo_line)
+                    it = merged.erase(it);
+                else
+                    ++it;
+            }
+        }
+
+        for (it = items.begin(); it != items.end(); ++it)
+        {
+            if (it->first == EventVisualTracking::k_move_tempo_line)
+                pMerged->add_move_tempo_line_event(pNew->get_timepos());
+            else
+                pMerged->add_item(it->first, it->second);
+        }
+
+        last.pEvent = pMerged;
+        return true;
+    }
+
+    return false;
+}
+
+//---------------------------------------------------------------------------------------
+void EventsDispatcher::update_statistics(const EventTimestamp& posted)
+{
+    std::chrono::duration<double, std::milli> latency =
+        std::chrono::steady_clock::now() - posted;
+
+    QueueLock lock(m_mutex);
+    ++m_numDispatched;
+    m_totalLatency += latency.count();
+    m_maxLatency = max(m_maxLatency, latency.count());
+}
+
+//---------------------------------------------------------------------------------------
+size_t EventsDispatcher::get_queue_depth()
+{
+    QueueLock lock(m_mutex);
+    return m_events.size();
+}
+
+//---------------------------------------------------------------------------------------
+size_t EventsDispatcher::get_max_queue_depth()
+{
+    QueueLock lock(m_mutex);
+    return m_maxQueueDepth;
+}
+
+//---------------------------------------------------------------------------------------
+long EventsDispatcher::get_num_posted_events()
+{
+    QueueLock lock(m_mutex);
+    return m_numPosted;
+}
+
+//---------------------------------------------------------------------------------------
+long EventsDispatcher::get_num_dispatched_events()
+{
+    QueueLock lock(m_mutex);
+    return m_numDispatched;
+}
+
+//---------------------------------------------------------------------------------------
+long EventsDispatcher::get_num_coalesced_events()
+{
+    QueueLock lock(m_mutex);
+    return m_numCoalesced;
+}
+
+//---------------------------------------------------------------------------------------
+double EventsDispatcher::get_mean_dispatch_latency()
+{
+    QueueLock lock(m_mutex);
+    return (m_numDispatched > 0 ? m_totalLatency / double(m_numDispatched) : 0.0);
+}
+
+//---------------------------------------------------------------------------------------
+double EventsDispatcher::get_max_dispatch_latency()
+{
+    QueueLock lock(m_mutex);
+    return m_maxLatency;
+}
+
+//---------------------------------------------------------------------------------------
+void EventsDispatcher::reset_statistics()
+{
+    QueueLock lock(m_mutex);
+    m_maxQueueDepth = m_events.size();
+    m_numPosted = 0;
+    m_numDispatched = 0;
+    m_numCoalesced = 0;
+    m_totalLatency = 0.0;
+    m_maxLatency = 0.0;
 }
 
 //---------------------------------------------------------------------------------------
@@ -103,31 +287,35 @@ void EventsDispatcher::post_event(Observer* pObserver, SpEventInfo pEvent)
 
 void EventsDispatcher::run_events_loop()
 {
-    std::chrono::milliseconds waitTime(5);   //5ms
-
-    while (!stop_event_received())
+    std::deque<QueuedEvent> batch;
+    while (true)
     {
-        if (pending_events())
-            dispatch_next_event();
-        else
-            std::this_thread::sleep_for(waitTime);
+        {
+            QueueLock lock(m_mutex);
+            while (m_events.empty() && !m_fStopLoop)
+                m_wakeUp.wait(lock);
+
+            if (m_events.empty() && m_fStopLoop)
+                return;
+
+            //take all pending events
+            batch.swap(m_events);
+        }
+
+        dispatch_events(batch);
+        batch.clear();
     }
 }
 
 //---------------------------------------------------------------------------------------
-void EventsDispatcher::dispatch_next_event()
+void EventsDispatcher::dispatch_events(std::deque<QueuedEvent>& batch)
 {
-    pair<SpEventInfo, Observer*> event;
-
+    std::deque<QueuedEvent>::iterator it;
+    for (it = batch.begin(); it != batch.end(); ++it)
     {
-        QueueLock lock(m_mutex);
-        event = m_events.front();
-        m_events.pop();
+        it->pObserver->notify(it->pEvent);
+        update_statistics(it->timestamp);
     }
-
-    SpEventInfo pEvent = event.first;
-    Observer* pObserver = event.second;
-    pObserver->notify(pEvent);
 }
 
 
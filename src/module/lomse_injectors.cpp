@@ -68,6 +68,9 @@ using namespace std;
 namespace lomse
 {
 
+//font storage to use in current thread, when not the shared one
+static thread_local FontStorage* m_pThreadFontStorage = nullptr;
+
 
 //=======================================================================================
 // LibraryScope implementation
@@ -88,6 +91,9 @@ LibraryScope::LibraryScope(ostream& reporter, LomseDoorway* pDoorway)
     , m_pMusicGlyphs(nullptr)      //lazzy instantiation. Singleton scope.
     , m_fReplaceLocalMetronome(false)
     , m_importOptions()
+    , m_spacingThreads(1)
+    , m_fUndoSnapshots(true)
+    , m_fQueuedEvents(false)
     , m_fJustifySystems(true)
     , m_fDumpColumnTables(false)
     , m_fDrawAnchorObjects(false)
@@ -138,11 +144,24 @@ LdpFactory* LibraryScope::ldp_factory()
 //---------------------------------------------------------------------------------------
 FontStorage* LibraryScope::font_storage()
 {
+    if (m_pThreadFontStorage)
+        return m_pThreadFontStorage;
+
     if (!m_pFontStorage)
         m_pFontStorage = LOMSE_NEW FontStorage(this);
     return m_pFontStorage;
 }
 
+//---------------------------------------------------------------------------------------
+void LibraryScope::use_font_storage_in_this_thread(FontStorage* pFonts)
+{
+    //For threads doing layout concurrently with the main thread: font_storage() will
+    //return pFonts when invoked from the calling thread. A nullptr restores the use
+    //of the shared font storage.
+
+    m_pThreadFontStorage = pFonts;
+}
+
 //---------------------------------------------------------------------------------------
 FontSelector* LibraryScope::get_font_selector()
 {
@@ -191,12 +210,30 @@ EventsDispatcher* LibraryScope::get_events_dispatcher()
 {
     if (!m_pDispatcher)
     {
-        m_pDispatcher = LOMSE_NEW EventsDispatcher();
+        m_pDispatcher = LOMSE_NEW EventsDispatcher(!m_fQueuedEvents);
         m_pDispatcher->start_events_loop();
     }
     return m_pDispatcher;
 }
 
+//---------------------------------------------------------------------------------------
+void LibraryScope::set_queued_events(bool value)
+{
+    if (m_fQueuedEvents == value)
+        return;
+
+    //AWARE: documents and interactors keep a pointer to the dispatcher, and events
+    //could be being posted from other threads. Therefore, the dispatcher can not be
+    //replaced and the mode can only be changed before it is created.
+    if (m_pDispatcher)
+    {
+        LOMSE_LOG_ERROR("Events dispatcher already created. Mode not changed.");
+        return;
+    }
+
+    m_fQueuedEvents = value;
+}
+
 //---------------------------------------------------------------------------------------
 double LibraryScope::get_screen_ppi() const
 {
@@ -48,6 +48,11 @@
 #include "lomse_box_system.h"
 #include "lomse_timegrid_table.h"
 #include "lomse_half_page_view.h"
+#include "lomse_tile_cache.h"
+#include "lomse_font_storage.h"
+
+#include <thread>
+#include <atomic>
 
 using namespace std;
 
@@ -132,6 +137,8 @@ GraphicView::GraphicView(LibraryScope& libraryScope, ScreenDrawer* pDrawer)
     , m_pPrintBuf(nullptr)
     , m_print_ppi(0.0)
     , m_backgroundColor( Color(145, 156, 166) )
+    , m_pTileCache(nullptr)
+    , m_tileCacheBudget(TileCache::k_default_memory_budget)
     , m_pScrollSystem(nullptr)
     , m_xScrollLeft(0.0f)
     , m_xScrollRight(0.0f)
@@ -171,6 +178,7 @@ GraphicView::~GraphicView()
 {
     delete m_pDrawer;
     delete m_pOverlaysGenerator;
+    delete m_pTileCache;
 
     //AWARE: ownership of all VisualEffects (m_pCaret, m_pDragImg, m_pHighlighted,
     //       m_pTimeGrid & m_pTempoLine) is transferred to OverlaysGenerator.
@@ -359,15 +367,13 @@ bool GraphicView::determine_page_system_and_position_for(ImoId scoreId, TimeUnit
     if (!pGModel)
         return false;    //error
 
-    m_pScrollSystem = pGModel->get_system_for(scoreId, timepos);
-    //LOMSE_LOG_DEBUG(Logger::k_events,
-    //                "scoreId=%d, timepos=%f, system=%s",
-    //                scoreId, timepos, (m_pScrollSystem != nullptr ? "found" : "not found"));
-    if (!m_pScrollSystem)
+    TimeposLocation loc;
+    if (!pGModel->locate_timepos(scoreId, timepos, &loc))
         return false;    //error
 
-    m_iScrollPage = m_pScrollSystem->get_page_number();
-    m_xScrollLeft = m_pScrollSystem->get_x_for_note_rest_at_time(timepos);
+    m_pScrollSystem = loc.pSystem;
+    m_iScrollPage = loc.iPage;
+    m_xScrollLeft = loc.x;
     m_xScrollRight = m_xScrollLeft + 1000;   //1 cm
 
     //LOMSE_LOG_DEBUG(Logger::k_events, "new scroll pos = %f, %f", m_xScrollLeft, m_xScrollRight);
@@ -776,11 +782,120 @@ void GraphicView::print_page(int page, VPoint viewport)
     set_scale(screenScale);
 }
 
+//---------------------------------------------------------------------------------------
+//Worker for print_pages(). Takes pages from the shared list until all are rendered.
+//Each worker has its own drawer, renderer and font storage, so that workers do not
+//share any font engine state.
+static void print_pages_worker(LibraryScope* pLibScope, GraphicModel* pGModel,
+                               RenderOptions options, const vector<int>* pPages,
+                               const vector<RenderingBuffer*>* pBuffers,
+                               TransAffine transform, VPoint viewport,
+                               std::atomic<size_t>* pNext)
+{
+    FontStorage fonts(pLibScope);
+    ScreenDrawer drawer(*pLibScope, &fonts);
+    size_t numPages = min(pPages->size(), pBuffers->size());
+    int maxPage = pGModel->get_num_pages();
+
+    for (size_t i = (*pNext)++; i < numPages; i = (*pNext)++)
+    {
+        int page = (*pPages)[i];
+        if (page < 0 || page >= maxPage || (*pBuffers)[i] == nullptr)
+        {
+            LOMSE_LOG_ERROR("Invalid page %d or null buffer", page);
+            continue;
+        }
+
+        drawer.reset(*(*pBuffers)[i], Color(255, 255, 255));
+        drawer.set_viewport(viewport.x, viewport.y);
+        drawer.set_transform(transform);
+
+        UPoint origin(0.0f, 0.0f);
+        pGModel->draw_page(page, origin, &drawer, options);
+        drawer.render();
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void GraphicView::print_pages(const vector<int>& pages,
+                              const vector<RenderingBuffer*>& buffers,
+                              int numThreads, VPoint viewport)
+{
+    size_t numPages = min(pages.size(), buffers.size());
+    GraphicModel* pGModel = get_graphic_model();
+    if (numPages == 0 || !pGModel)
+        return;
+
+    //determine the transform used by print_page()
+    double screenScale = get_scale();
+    set_scale(m_print_ppi / get_resolution());
+    TransAffine transform = m_transform;
+    set_scale(screenScale);
+
+    //objects lazily created by LibraryScope and used when drawing must be created
+    //before starting the workers
+    m_libraryScope.get_font_selector();
+    m_libraryScope.get_glyphs_table();
+
+    if (numThreads <= 0)
+        numThreads = max(1, int(std::thread::hardware_concurrency()));
+    numThreads = min(numThreads, int(numPages));
+
+    std::atomic<size_t> next(0);
+    vector<std::thread> workers;
+    for (int i=1; i < numThreads; ++i)
+    {
+        workers.push_back( std::thread(print_pages_worker, &m_libraryScope, pGModel,
+                                       m_options, &pages, &buffers, transform,
+                                       viewport, &next) );
+    }
+    print_pages_worker(&m_libraryScope, pGModel, m_options, &pages, &buffers,
+                       transform, viewport, &next);
+
+    vector<std::thread>::iterator it;
+    for (it = workers.begin(); it != workers.end(); ++it)
+        (*it).join();
+}
+
 //---------------------------------------------------------------------------------------
 void GraphicView::draw_graphic_model()
 {
     LOMSE_LOG_DEBUG(Logger::k_mvc, string(""));
 
+    if (update_render_options())
+        invalidate_tiles();
+
+    if (m_pTileCache && is_valid_viewport())
+    {
+        draw_graphic_model_using_tiles();
+        return;
+    }
+
+    m_pDrawer->reset(*m_pRenderBuf, m_options.background_color);
+    m_pDrawer->set_viewport(m_vxOrg, m_vyOrg);
+    m_pDrawer->set_transform(m_transform);
+
+    generate_paths();
+    m_pDrawer->render();
+}
+
+//---------------------------------------------------------------------------------------
+bool GraphicView::update_render_options()
+{
+    //returns true if any option affecting the rendering of the graphic model changed
+
+    bool fReadOnly = m_pInteractor->get_operating_mode() != Interactor::k_mode_edition;
+    bool fChanged = m_options.background_color.r != m_backgroundColor.r
+        || m_options.background_color.g != m_backgroundColor.g
+        || m_options.background_color.b != m_backgroundColor.b
+        || m_options.background_color.a != m_backgroundColor.a
+        || m_options.draw_anchor_objects != m_libraryScope.draw_anchor_objects()
+        || m_options.draw_anchor_lines != m_libraryScope.draw_anchor_lines()
+        || m_options.draw_shape_bounds != m_libraryScope.draw_shape_bounds()
+        || m_options.draw_slur_points != m_libraryScope.draw_slur_ctrol_points()
+        || m_options.draw_vertical_profile != m_libraryScope.draw_vertical_profile()
+        || m_options.read_only_mode != fReadOnly;
+
     m_options.background_color = m_backgroundColor;
     m_options.page_border_flag = true;
     m_options.cast_shadow_flag = true;
@@ -789,15 +904,168 @@ void GraphicView::draw_graphic_model()
     m_options.draw_shape_bounds = m_libraryScope.draw_shape_bounds();
     m_options.draw_slur_points = m_libraryScope.draw_slur_ctrol_points();
     m_options.draw_vertical_profile = m_libraryScope.draw_vertical_profile();
-    m_options.read_only_mode =
-        m_pInteractor->get_operating_mode() != Interactor::k_mode_edition;
+    m_options.read_only_mode = fReadOnly;
+
+    return fChanged;
+}
+
+//---------------------------------------------------------------------------------------
+static int tile_index(Pixels pos, int tileSize)
+{
+    //floor division, as viewport origin can be negative
+    return (pos >= 0 ? pos / tileSize : -((-pos + tileSize - 1) / tileSize));
+}
 
+//---------------------------------------------------------------------------------------
+void GraphicView::draw_graphic_model_using_tiles()
+{
+    GraphicModel* pGModel = get_graphic_model();
+    m_pTileCache->validate(pGModel->get_model_id(), pGModel->get_modification_stamp());
+    collect_page_bounds();
+
+    //tiles covering the viewport
+    int size = m_pTileCache->get_tile_size();
+    int bpp = m_pTileCache->get_bytes_per_pixel();
+    double scale = m_transform.scale();
+    int minCol = tile_index(m_vxOrg, size);
+    int maxCol = tile_index(m_vxOrg + m_viewportSize.width - 1, size);
+    int minRow = tile_index(m_vyOrg, size);
+    int maxRow = tile_index(m_vyOrg + m_viewportSize.height - 1, size);
+
+    //get cached tiles and determine the area covering the missing ones
+    vector< pair<RenderingBuffer*, VPoint> > cached;
+    vector<VPoint> missing;
+    int col1 = maxCol;
+    int col2 = minCol;
+    int row1 = maxRow;
+    int row2 = minRow;
+    for (int row=minRow; row <= maxRow; ++row)
+    {
+        for (int col=minCol; col <= maxCol; ++col)
+        {
+            RenderingBuffer* pTile = m_pTileCache->get_tile(scale, col, row);
+            if (pTile)
+                cached.push_back( make_pair(pTile, VPoint(col, row)) );
+            else
+            {
+                missing.push_back( VPoint(col, row) );
+                col1 = min(col1, col);
+                col2 = max(col2, col);
+                row1 = min(row1, row);
+                row2 = max(row2, row);
+            }
+        }
+    }
+
+    //render all missing tiles in a single pass
+    RenderingBuffer* pArea = nullptr;
+    Pixels xArea = col1 * size;
+    Pixels yArea = row1 * size;
+    Pixels width = (col2 - col1 + 1) * size;
+    Pixels height = (row2 - row1 + 1) * size;
+    if (!missing.empty())
+    {
+        //AWARE: the renderer clip box excludes the last column and row of the
+        //buffer. Add one pixel so that all tile pixels are rendered.
+        pArea = &(m_pTileCache->get_scratch_buffer(width + 1, height + 1));
+        TransAffine transform = m_transform;
+        transform.tx = double(-xArea);
+        transform.ty = double(-yArea);
+        m_pDrawer->reset(*pArea, m_options.background_color);
+        m_pDrawer->set_viewport(xArea, yArea);
+        m_pDrawer->set_transform(transform);
+
+        draw_pages_in_area(xArea, yArea, width + 1, height + 1);
+        m_pDrawer->render();
+    }
+
+    //compose the view
     m_pDrawer->reset(*m_pRenderBuf, m_options.background_color);
     m_pDrawer->set_viewport(m_vxOrg, m_vyOrg);
     m_pDrawer->set_transform(m_transform);
 
-    generate_paths();
-    m_pDrawer->render();
+    vector< pair<RenderingBuffer*, VPoint> >::iterator it;
+    for (it = cached.begin(); it != cached.end(); ++it)
+    {
+        TileCache::copy_pixels(*(it->first), 0, 0, *m_pRenderBuf,
+                               it->second.x * size - m_vxOrg,
+                               it->second.y * size - m_vyOrg, size, size, bpp);
+    }
+
+    if (pArea)
+    {
+        TileCache::copy_pixels(*pArea, 0, 0, *m_pRenderBuf, xArea - m_vxOrg,
+                               yArea - m_vyOrg, width, height, bpp);
+
+        vector<VPoint>::iterator itM;
+        for (itM = missing.begin(); itM != missing.end(); ++itM)
+        {
+            m_pTileCache->add_tile(scale, (*itM).x, (*itM).y, *pArea,
+                                   ((*itM).x - col1) * size, ((*itM).y - row1) * size);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void GraphicView::draw_pages_in_area(Pixels x, Pixels y, Pixels width, Pixels height)
+{
+    //AWARE: the drawer transform must be already set for the area
+
+    LUnits left = m_pDrawer->Pixels_to_LUnits(x);
+    LUnits top = m_pDrawer->Pixels_to_LUnits(y);
+    LUnits right = m_pDrawer->Pixels_to_LUnits(x + width);
+    LUnits bottom = m_pDrawer->Pixels_to_LUnits(y + height);
+
+    GraphicModel* pGModel = get_graphic_model();
+    list<URect>::iterator it;
+    int i = 0;
+    for (it = m_pageBounds.begin(); it != m_pageBounds.end(); ++it, ++i)
+    {
+        URect& bounds = *it;
+        if (bounds.right() > left && bounds.left() < right
+            && bounds.bottom() > top && bounds.top() < bottom)
+        {
+            UPoint origin = bounds.get_top_left();
+            pGModel->draw_page(i, origin, m_pDrawer, m_options);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void GraphicView::enable_tile_cache(bool fValue)
+{
+    if (fValue && !m_pTileCache)
+    {
+        int bpp = TileCache::bytes_per_pixel(m_libraryScope.get_pixel_format());
+        if (bpp == 0)
+        {
+            LOMSE_LOG_ERROR("Tile cache not supported for current pixel format");
+            return;
+        }
+        m_pTileCache = LOMSE_NEW TileCache(TileCache::k_default_tile_size,
+                                           m_tileCacheBudget);
+        m_pTileCache->set_bytes_per_pixel(bpp);
+    }
+    else if (!fValue)
+    {
+        delete m_pTileCache;
+        m_pTileCache = nullptr;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void GraphicView::set_tile_cache_budget(size_t bytes)
+{
+    m_tileCacheBudget = bytes;
+    if (m_pTileCache)
+        m_pTileCache->set_memory_budget(bytes);
+}
+
+//---------------------------------------------------------------------------------------
+void GraphicView::invalidate_tiles()
+{
+    if (m_pTileCache)
+        m_pTileCache->clear();
 }
 
 //---------------------------------------------------------------------------------------
@@ -1093,6 +1361,15 @@ LUnits GraphicView::get_viewport_width()
         return 0.0f;
 }
 
+//---------------------------------------------------------------------------------------
+LUnits GraphicView::get_viewport_height()
+{
+    if (m_pRenderBuf && m_pDrawer)  //in unit test they can not exist
+        return m_pDrawer->Pixels_to_LUnits( m_pRenderBuf->height() );
+    else
+        return 0.0f;
+}
+
 //---------------------------------------------------------------------------------------
 void GraphicView::set_viewport_at_page_center(Pixels screenWidth)
 {
@@ -1462,24 +1739,28 @@ void GraphicView::set_rendering_option(int option, bool value)
             m_options.draw_voices_coloured = value;
             break;
     }
+    invalidate_tiles();
 }
 
 //---------------------------------------------------------------------------------------
 void GraphicView::reset_boxes_to_draw()
 {
     m_options.reset_boxes_to_draw();
+    invalidate_tiles();
 }
 
 //---------------------------------------------------------------------------------------
 void GraphicView::set_box_to_draw(int boxType)
 {
     m_options.draw_box_for(boxType);
+    invalidate_tiles();
 }
 
 //---------------------------------------------------------------------------------------
 void GraphicView::highlight_voice(int voice)
 {
     m_options.highlighted_voice = voice;
+    invalidate_tiles();
 }
 
 //---------------------------------------------------------------------------------------
@@ -1596,19 +1877,13 @@ FragmentMark* GraphicView::add_fragment_mark_at(ImoId scoreId, TimeUnits timepos
     if (!pGModel)
         return nullptr;
 
-    GmoBoxSystem* pBoxSystem = pGModel->get_system_for(scoreId, timepos);
-    if (!pBoxSystem)
+    TimeposLocation loc;
+    if (!pGModel->locate_timepos(scoreId, timepos, &loc, fBarline))
         return nullptr;
 
-    LUnits xLeft = 0.0;
-    if (fBarline)
-        xLeft = pBoxSystem->get_x_for_barline_at_time(timepos);
-    else
-        xLeft = pBoxSystem->get_x_for_note_rest_at_time(timepos);
-
     FragmentMark* pMark = LOMSE_NEW FragmentMark(this, m_libraryScope);
     pMark->set_visible(true);
-    pMark->initialize(xLeft, pBoxSystem, fBarline);
+    pMark->initialize(loc.x, loc.pSystem, fBarline);
 
     add_visual_effect(pMark);
     return pMark;
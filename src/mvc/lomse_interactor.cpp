@@ -52,14 +52,20 @@
 #include "lomse_score_utilities.h"
 #include "lomse_shape_staff.h"
 #include "lomse_score_algorithms.h"
+#include "lomse_font_storage.h"
 
 #include <sstream>
 #include <chrono>
+#include <set>
+#include <cmath>        //ceil
 using namespace std;
 
 namespace lomse
 {
 
+//Interactor whose background layout is running in current thread, if any
+static thread_local Interactor* pLayoutThreadOwner = nullptr;
+
 ptime::duration ptime::operator-(const ptime rhs)
 {
     long long millis = chrono::duration_cast<chrono::milliseconds>(timepoint - rhs.timepoint).count();
@@ -87,6 +93,14 @@ Interactor::Interactor(LibraryScope& libraryScope, WpDocument wpDoc, View* pView
     , m_fEditionEnabled(false)
     , m_fViewParamsChanged(false)
     , m_fViewUpdatesEnabled(true)
+    , m_fIncrementalRelayout(false)
+    , m_pDocLayouter(nullptr)
+    , m_fProgressiveLayout(false)
+    , m_fCancelLayout(false)
+    , m_pFullModel(nullptr)
+    , m_pFullLayouter(nullptr)
+    , m_fLayoutResumed(false)
+    , m_pLayoutFonts(nullptr)
     , m_idControlledImo(k_no_imoid)
 {
     switch_task(TaskFactory::k_task_only_clicks);
@@ -113,6 +127,7 @@ Interactor::Interactor(LibraryScope& libraryScope, WpDocument wpDoc, View* pView
 Interactor::~Interactor()
 {
     delete_graphic_model();
+    delete m_pLayoutFonts;
     delete m_pTask;
     delete m_pView;
     delete m_pCursor;
@@ -149,6 +164,8 @@ void Interactor::create_graphic_model()
 
     LOMSE_LOG_DEBUG(Logger::k_render, string(""));
 
+    stop_background_layout();
+
     if (SpDocument spDoc = m_wpDoc.lock())
     {
         m_gmodelBuildStartTime.init_now();
@@ -160,16 +177,32 @@ void Interactor::create_graphic_model()
             LOMSE_LOG_DEBUG(Logger::k_render, "[Interactor::create_graphic_model]");
             int constrains = pView->get_layout_constrains();
             LUnits width = pView->get_viewport_width();
-            DocLayouter layouter(pDoc, m_libScope, constrains, width);
+            DocLayouter* pLayouter = LOMSE_NEW DocLayouter(pDoc, m_libScope, constrains,
+                                                           width);
 
             if (pView->is_valid_for_this_view(pDoc))
-                layouter.layout_document();
+            {
+                if (m_fProgressiveLayout
+                    && !(constrains & (k_infinite_width | k_infinite_height)))
+                {
+                    pLayouter->set_page_limit(
+                                num_pages_for_progressive_layout(pView, pDoc) );
+                }
+                pLayouter->layout_document();
+            }
             else
-                layouter.layout_empty_document();
+                pLayouter->layout_empty_document();
 
-            m_pGraphicModel = layouter.get_graphic_model();
+            m_pGraphicModel = pLayouter->get_graphic_model();
             m_pGraphicModel->build_main_boxes_table();
             m_pSelections->graphic_model_changed(m_pGraphicModel);
+
+            if (pLayouter->is_layout_interrupted())
+                start_background_layout(pLayouter);
+            else if (m_fIncrementalRelayout)
+                m_pDocLayouter = pLayouter;
+            else
+                delete pLayouter;
         }
         spDoc->clear_dirty();
 
@@ -181,6 +214,312 @@ void Interactor::create_graphic_model()
 //    m_idLastMouseOver = k_no_imoid;
 }
 
+//---------------------------------------------------------------------------------------
+int Interactor::num_pages_for_progressive_layout(GraphicView* pView, Document* pDoc)
+{
+    //Number of pages to layout before returning: the pages that can be visible
+    //in the viewport, in any page arrangement (vertical or horizontal)
+
+    ImoDocument* pImoDoc = pDoc->get_im_root();
+    float scale = pImoDoc->get_page_content_scale();
+    LUnits pageWidth = pImoDoc->get_paper_width() / scale;
+    LUnits pageHeight = pImoDoc->get_paper_height() / scale;
+    if (pageWidth <= 0.0f || pageHeight <= 0.0f)
+        return 1;
+
+    float pages = max(pView->get_viewport_width() / pageWidth,
+                      pView->get_viewport_height() / pageHeight);
+    return max(1, int(ceil(pages)));
+}
+
+//---------------------------------------------------------------------------------------
+void Interactor::start_background_layout(DocLayouter* pLayouter)
+{
+    //The graphic model only contains the first pages. The interrupted layout continues
+    //in a layout thread, that takes ownership of the layouter. The remaining pages
+    //will be added to current graphic model when the user application invokes
+    //on_layout_completed().
+
+    //objects lazily created by LibraryScope and used in layout must be created
+    //before starting the layout thread
+    m_libScope.get_font_selector();
+    m_libScope.get_glyphs_table();
+    m_libScope.get_music_font_path();
+
+    //the font storage is kept, as shapes store a pointer to it
+    if (!m_pLayoutFonts)
+        m_pLayoutFonts = LOMSE_NEW FontStorage(&m_libScope);
+
+    std::lock_guard<std::recursive_mutex> lock(m_layoutMutex);
+    pLayouter->set_page_limit(0);
+    pLayouter->set_cancel_flag(&m_fCancelLayout);
+    WpInteractor wpIntor(get_shared_ptr_from_this());
+    int numPrevPages = m_pGraphicModel->get_num_pages();
+    m_fCancelLayout = false;
+    m_layoutThread = std::thread(&Interactor::background_layout, this, pLayouter,
+                                 numPrevPages, wpIntor);
+}
+
+//---------------------------------------------------------------------------------------
+void Interactor::background_layout(DocLayouter* pLayouter, int numPrevPages,
+                                   WpInteractor wpIntor)
+{
+    //AWARE: This code is executed in the layout thread. After posting the event,
+    //the thread must not access the Interactor, as the thread could have been
+    //detached by on_layout_completed(). Parameter numPrevPages is the number of
+    //pages in current graphic model, as it must not be accessed from this thread.
+
+    LibraryScope::use_font_storage_in_this_thread(m_pLayoutFonts);
+    pLayoutThreadOwner = this;
+
+    bool fResumed = pLayouter->resume_layout();
+
+    GraphicModel* pGModel = pLayouter->get_graphic_model();
+    if (pLayouter->is_layout_interrupted())
+    {
+        delete pGModel;
+        pGModel = nullptr;
+        delete pLayouter;
+        pLayouter = nullptr;
+    }
+
+    LibraryScope::use_font_storage_in_this_thread(nullptr);
+
+    if (pGModel)
+    {
+        int numPages = pGModel->get_num_pages();
+        if (fResumed)
+            numPages += numPrevPages;
+        else
+            pGModel->build_main_boxes_table();
+
+        {
+            std::lock_guard<std::recursive_mutex> lock(m_layoutMutex);
+            m_fLayoutResumed = fResumed;
+            m_pFullModel = pGModel;
+            m_pFullLayouter = pLayouter;
+        }
+        SpEventInfo pEvent( LOMSE_NEW EventLayout(k_layout_completed_event, wpIntor,
+                                                  numPages) );
+        m_libScope.post_event(pEvent);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void Interactor::stop_background_layout()
+{
+    //Cancels the background layout, if any, and discards its result. The layout
+    //thread stops when starting a new page.
+    //AWARE: the thread is joined without holding the mutex, as the layout thread
+    //locks it for saving its result.
+
+    std::thread thread;
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_layoutMutex);
+        if (m_layoutThread.joinable())
+        {
+            m_fCancelLayout = true;
+            thread = std::move(m_layoutThread);
+        }
+    }
+    if (thread.joinable())
+        thread.join();
+
+    std::lock_guard<std::recursive_mutex> lock(m_layoutMutex);
+    delete m_pFullModel;
+    m_pFullModel = nullptr;
+    delete m_pFullLayouter;
+    m_pFullLayouter = nullptr;
+}
+
+//---------------------------------------------------------------------------------------
+bool Interactor::is_layout_in_progress()
+{
+    std::lock_guard<std::recursive_mutex> lock(m_layoutMutex);
+    return m_layoutThread.joinable();
+}
+
+//---------------------------------------------------------------------------------------
+void Interactor::on_layout_completed()
+{
+    std::unique_lock<std::recursive_mutex> lock(m_layoutMutex);
+    if (!m_layoutThread.joinable())
+        return;
+
+    if (pLayoutThreadOwner == this)
+    {
+        //Invoked from the handler for the event, in the layout thread. The layout
+        //is finished but the thread can not join itself. If the main thread is
+        //already waiting for the layout, the thread is no longer joinable and the
+        //main thread will accept the result.
+        m_layoutThread.detach();
+    }
+    else
+    {
+        //AWARE: the thread is joined without holding the mutex, as the layout thread
+        //locks it for saving its result.
+        std::thread thread = std::move(m_layoutThread);
+        lock.unlock();
+        thread.join();
+        lock.lock();
+    }
+
+    accept_background_layout();
+}
+
+//---------------------------------------------------------------------------------------
+void Interactor::accept_background_layout()
+{
+    GraphicModel* pGModel = m_pFullModel;
+    DocLayouter* pLayouter = m_pFullLayouter;
+    m_pFullModel = nullptr;
+    m_pFullLayouter = nullptr;
+    if (!pGModel)
+        return;
+
+    if (m_fLayoutResumed)
+    {
+        //the background layout only contains the remaining pages
+        m_pGraphicModel->take_pages_from(pGModel, pGModel->get_num_pages());
+        delete pGModel;
+        m_pGraphicModel->build_main_boxes_table();
+    }
+    else
+    {
+        delete_graphic_model();
+        m_pGraphicModel = pGModel;
+    }
+
+    //the layouter is kept for incremental relayout
+    delete m_pDocLayouter;
+    m_pDocLayouter = nullptr;
+    if (m_fIncrementalRelayout)
+        m_pDocLayouter = pLayouter;
+    else
+        delete pLayouter;
+    m_pSelections->graphic_model_changed(m_pGraphicModel);
+    restore_selection();
+    force_redraw();
+}
+
+//---------------------------------------------------------------------------------------
+bool Interactor::update_graphic_model()
+{
+    //Incremental relayout after a document modification: the pages preceding the
+    //first modified top-level block are reused. When the modified block is the score
+    //laid out last by the kept layouter, the score layout is resumed at the page
+    //containing the first modified system.
+    //Returns false if the incremental relayout is not possible. In this case the
+    //graphic model must be fully rebuilt.
+
+    SpDocument spDoc = m_wpDoc.lock();
+    if (!spDoc)
+        return false;
+
+    stop_background_layout();
+
+    Document* pDoc = spDoc.get();
+    int iBlock = (m_fIncrementalRelayout ? find_first_dirty_block(pDoc) : -1);
+    list<ImoId> dirtyIds;
+    if (m_pExec)
+    {
+        dirtyIds = m_pExec->get_dirty_ids();
+        m_pExec->clear_dirty_ids();
+    }
+
+    GraphicView* pView = dynamic_cast<GraphicView*>(m_pView);
+    if (iBlock < 0 || !m_pGraphicModel || !pView || !pView->is_valid_for_this_view(pDoc))
+        return false;
+
+    m_gmodelBuildStartTime.init_now();
+
+    int iPage = -1;
+    if (m_pDocLayouter)
+        iPage = m_pDocLayouter->relayout_score(m_pGraphicModel, iBlock, dirtyIds);
+
+    bool fReused = (iPage > 0);
+    if (fReused)
+    {
+        //only the pages from iPage have been laid out again
+        GraphicModel* pGModel = m_pDocLayouter->get_graphic_model();
+        pView->remove_all_visual_tracking();
+        set_drag_image(nullptr, k_do_not_get_ownership, UPoint(0.0, 0.0));
+        m_pGraphicModel->take_pages_from(pGModel, pGModel->get_num_pages());
+        delete pGModel;
+    }
+    else
+    {
+        DocLayouter* pLayouter = m_pDocLayouter;
+        m_pDocLayouter = nullptr;
+        if (iPage < 0)
+        {
+            delete pLayouter;
+            int constrains = pView->get_layout_constrains();
+            LUnits width = pView->get_viewport_width();
+            pLayouter = LOMSE_NEW DocLayouter(pDoc, m_libScope, constrains, width);
+            fReused = pLayouter->layout_document_reusing(m_pGraphicModel, iBlock);
+        }
+
+        delete_graphic_model();
+        m_pGraphicModel = pLayouter->get_graphic_model();
+        m_pDocLayouter = pLayouter;
+    }
+    m_pGraphicModel->build_main_boxes_table();
+    m_pSelections->graphic_model_changed(m_pGraphicModel);
+    spDoc->clear_dirty();
+
+    timing_graphic_model_build_end();
+
+    double buildTime = get_elapsed_time_since(m_gmodelBuildStartTime);
+    LOMSE_LOG_INFO("gmodel update time = %d ms. Pages reused: %s", (int)buildTime,
+                   (fReused ? "yes" : "no"));
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+int Interactor::find_first_dirty_block(Document* pDoc)
+{
+    //Returns the index of the first top-level block containing objects modified by
+    //the edition commands, or -1 if the modified objects are not known or are not
+    //contained in top-level blocks (e.g. styles).
+
+    if (!m_pExec || m_pExec->get_dirty_ids().empty())
+        return -1;
+
+    set<ImoObj*> blocks;
+    const list<ImoId>& ids = m_pExec->get_dirty_ids();
+    list<ImoId>::const_iterator it;
+    for (it = ids.begin(); it != ids.end(); ++it)
+    {
+        ImoObj* pImo = pDoc->get_pointer_to_imo(*it);
+        if (!pImo)
+            return -1;
+
+        ImoObj* pParent = pImo->get_parent_imo();
+        while (pParent && !(pParent->is_content()
+                            && pParent->get_parent_imo()
+                            && pParent->get_parent_imo()->is_document()) )
+        {
+            pImo = pParent;
+            pParent = pImo->get_parent_imo();
+        }
+        if (!pParent)
+            return -1;
+
+        blocks.insert(pImo);
+    }
+
+    ImoContent* pContent = pDoc->get_im_root()->get_content();
+    TreeNode<ImoObj>::children_iterator itB;
+    int i = 0;
+    for (itB = pContent->begin(); itB != pContent->end(); ++itB, ++i)
+    {
+        if (blocks.find(*itB) != blocks.end())
+            return i;
+    }
+    return -1;
+}
+
 //---------------------------------------------------------------------------------------
 bool Interactor::graphic_model_must_be_updated()
 {
@@ -196,8 +535,11 @@ bool Interactor::graphic_model_must_be_updated()
 void Interactor::on_document_updated()
 {
     LOMSE_LOG_DEBUG(Logger::k_mvc, "[Interactor::on_document_updated]");
-    delete_graphic_model();
-    create_graphic_model();
+    if (!update_graphic_model())
+    {
+        delete_graphic_model();
+        create_graphic_model();
+    }
     //TODO: Interactor::on_document_updated. Update cursor
     //DocCursor cursor(m_pDoc);
     //m_cursor = cursor;
@@ -209,7 +551,8 @@ void Interactor::handle_event(SpEventInfo pEvent)
     switch(pEvent->get_event_type())
     {
         case k_doc_modified_event:
-            delete_graphic_model();
+            if (!update_graphic_model())
+                delete_graphic_model();
             restore_selection();
             force_redraw();
             break;
@@ -244,8 +587,12 @@ void Interactor::handle_event(SpEventInfo pEvent)
 //---------------------------------------------------------------------------------------
 void Interactor::delete_graphic_model()
 {
+    stop_background_layout();
+
     delete m_pGraphicModel;
     m_pGraphicModel = nullptr;
+    delete m_pDocLayouter;
+    m_pDocLayouter = nullptr;
     m_pSelections->graphic_model_changed(nullptr);
 
     GraphicView* pGView = dynamic_cast<GraphicView*>(m_pView);
@@ -1449,6 +1796,22 @@ void Interactor::set_view_background(Color color)
         pGView->set_background(color);
 }
 
+//---------------------------------------------------------------------------------------
+void Interactor::enable_tile_cache(bool fValue)
+{
+    GraphicView* pGView = dynamic_cast<GraphicView*>(m_pView);
+    if (pGView)
+        pGView->enable_tile_cache(fValue);
+}
+
+//---------------------------------------------------------------------------------------
+void Interactor::set_tile_cache_budget(size_t bytes)
+{
+    GraphicView* pGView = dynamic_cast<GraphicView*>(m_pView);
+    if (pGView)
+        pGView->set_tile_cache_budget(bytes);
+}
+
 //---------------------------------------------------------------------------------------
 void Interactor::set_box_to_draw(int boxType)
 {
@@ -1509,6 +1872,16 @@ void Interactor::print_page(int page, VPoint viewport)
         pGView->print_page(page, viewport);
 }
 
+//---------------------------------------------------------------------------------------
+void Interactor::print_pages(const std::vector<int>& pages,
+                             const std::vector<RenderingBuffer*>& buffers,
+                             int numThreads, VPoint viewport)
+{
+    GraphicView* pGView = dynamic_cast<GraphicView*>(m_pView);
+    if (pGView)
+        pGView->print_pages(pages, buffers, numThreads, viewport);
+}
+
 //---------------------------------------------------------------------------------------
 int Interactor::get_num_pages()
 {
@@ -2026,6 +2399,7 @@ void Interactor::set_drag_image(GmoShape* pShape, bool fGetOwnership, UPoint off
 //---------------------------------------------------------------------------------------
 void Interactor::exec_command(DocCommand* pCmd)
 {
+    stop_background_layout();
     m_pExec->execute(m_pCursor, pCmd, m_pSelections);
     update_caret_and_view();
     send_update_UI_event(k_pointed_object_change);
@@ -2034,6 +2408,7 @@ void Interactor::exec_command(DocCommand* pCmd)
 //---------------------------------------------------------------------------------------
 void Interactor::exec_undo()
 {
+    stop_background_layout();
     m_pExec->undo(m_pCursor, m_pSelections);
     update_caret_and_view();
     send_update_UI_event(k_pointed_object_change);
@@ -2042,6 +2417,7 @@ void Interactor::exec_undo()
 //---------------------------------------------------------------------------------------
 void Interactor::exec_redo()
 {
+    stop_background_layout();
     m_pExec->redo(m_pCursor, m_pSelections);
     update_caret_and_view();
     send_update_UI_event(k_pointed_object_change);
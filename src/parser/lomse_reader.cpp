@@ -34,6 +34,7 @@
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <algorithm>    //count
 using namespace std;
 
 
@@ -41,86 +42,76 @@ namespace lomse
 {
 
 //=======================================================================================
-// LdpFileReader implementation
+// LdpBufferedReader implementation
 //=======================================================================================
-LdpFileReader::LdpFileReader(const std::string& filelocator)
+LdpBufferedReader::LdpBufferedReader(bool fCountLines)
     : LdpReader()
-    , m_file( FileSystem::open_input_stream(filelocator) )
-    , m_locator(filelocator)
-    , m_numLine(1)
-    , m_repeating_last_char(false)
+    , m_pNext(nullptr)
+    , m_pEnd(nullptr)
+    , m_numLine(fCountLines ? 1 : 0)
+    , m_fCountLines(fCountLines)
+    , m_fEofReturned(false)
 {
 }
-//---------------------------------------------------------------------------------------
-LdpFileReader::~LdpFileReader()
-{
-    delete m_file;
-}
 
 //---------------------------------------------------------------------------------------
-char LdpFileReader::get_next_char()
+void LdpBufferedReader::set_data_ready()
 {
-    char ch = m_file->get_char();
-    if (!m_repeating_last_char && ch == 0x0a)
-        m_numLine++;
-    m_repeating_last_char = false;
-    return ch;
+    m_pNext = m_data.data();
+    m_pEnd = m_pNext + m_data.size();
 }
 
 //---------------------------------------------------------------------------------------
-void LdpFileReader::repeat_last_char()
+void LdpBufferedReader::skip_to(const char* pos)
 {
-    m_repeating_last_char = true;
-    m_file->unget();
+    if (m_fCountLines)
+        m_numLine += int( std::count(m_pNext, pos, 0x0a) );
+    m_pNext = pos;
 }
 
-//---------------------------------------------------------------------------------------
-bool LdpFileReader::is_ready()
+
+//=======================================================================================
+// LdpFileReader implementation
+//=======================================================================================
+LdpFileReader::LdpFileReader(const std::string& filelocator)
+    : LdpBufferedReader(true)
+    , m_locator(filelocator)
+    , m_fReady(false)
 {
-    return m_file->is_open();
+    InputStream* file = FileSystem::open_input_stream(filelocator);
+    m_fReady = file->is_open();
+    if (m_fReady)
+        load_file(file);
+    delete file;
+    set_data_ready();
 }
 
 //---------------------------------------------------------------------------------------
-bool LdpFileReader::end_of_data()
+void LdpFileReader::load_file(InputStream* file)
 {
-    return m_file->eof();
+    const long k_blockSize = 64 * 1024;
+    size_t size = 0;
+    while (!file->eof())
+    {
+        m_data.resize(size + k_blockSize);
+        long bytes = file->read(reinterpret_cast<unsigned char*>(&m_data[size]),
+                                k_blockSize);
+        if (bytes <= 0)
+            break;
+        size += size_t(bytes);
+    }
+    m_data.resize(size);
 }
 
 
-
-
 //=======================================================================================
 // LdpTextReader implementation
 //=======================================================================================
-
 LdpTextReader::LdpTextReader(const std::string& sourceText)
-    : LdpReader()
-    , m_stream(sourceText)
-{
-}
-
-//---------------------------------------------------------------------------------------
-char LdpTextReader::get_next_char()
-{
-    return m_stream.get();
-}
-
-//---------------------------------------------------------------------------------------
-void LdpTextReader::repeat_last_char()
-{
-    m_stream.unget();
-}
-
-//---------------------------------------------------------------------------------------
-bool LdpTextReader::is_ready()
-{
-    return true;
-}
-
-//---------------------------------------------------------------------------------------
-bool LdpTextReader::end_of_data()
+    : LdpBufferedReader(false)
 {
-    return m_stream.peek() == EOF;
+    m_data = sourceText;
+    set_data_ready();
 }
 
 
@@ -70,6 +70,41 @@ const char chUnderscore = '_';
 const char nEOF = EOF;         //End Of File
 
 
+//---------------------------------------------------------------------------------------
+//chars that can be appended to the token data without changing the automata state.
+//Used in the fast path for buffered readers. Chars CR and TAB are excluded in all
+//cases, as they are converted to spaces when read by get_next_char()
+
+//label, state k_ETQ01
+static bool is_label_char(char ch)
+{
+    return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z')
+           || (ch >= '0' && ch <= '9')
+           || ch == chUnderscore || ch == chDot || ch == chPlusSign
+           || ch == chMinusSign || ch == chSharp || ch == chSlash
+           || ch == chEqualSign || ch == chApostrophe || ch == chCloseBracket
+           || ch == chBar;
+}
+
+//string between quotes, state k_STR01
+static bool is_string_char(char ch)
+{
+    return ch != chQuotes && ch != chTab && ch != chCR;
+}
+
+//string between apostrophes, state k_STR02
+static bool is_quoted_label_char(char ch)
+{
+    return ch != chApostrophe && ch != chTab && ch != chCR;
+}
+
+//line comment, state k_CMT02
+static bool is_comment_char(char ch)
+{
+    return ch != chLF && ch != chTab && ch != chCR;
+}
+
+
 //---------------------------------------------------------------------------------------
 // Implementation of class LdpTokenizer
 //---------------------------------------------------------------------------------------
@@ -81,6 +116,7 @@ const char nEOF = EOF;         //End Of File
 
 LdpTokenizer::LdpTokenizer(LdpReader& reader, ostream& reporter)
     : m_reader(reader)
+    , m_pBuffered( dynamic_cast<LdpBufferedReader*>(&reader) )
     , m_reporter(reporter)
     , m_repeatToken(false)
     , m_pToken(nullptr)
@@ -108,7 +144,7 @@ void LdpTokenizer::skip_utf_bom()
         curChar = get_next_char();  // 0xbf
     }
     else
-        m_reader.repeat_last_char();
+        repeat_last_char();
 }
 
 //---------------------------------------------------------------------------------------
@@ -202,7 +238,7 @@ LdpToken* LdpTokenizer::parse_new_token()
     };
 
     EAutomataState state = k_Start;
-    stringstream tokendata;
+    std::string tokendata;
     char curChar = 0;
     int numLine = 0;
 
@@ -266,7 +302,8 @@ LdpToken* LdpTokenizer::parse_new_token()
                 break;
 
             case k_ETQ01:
-                tokendata << curChar;
+                tokendata += curChar;
+                scan_chars<is_label_char>(tokendata);
                 curChar = get_next_char();
                 if (is_letter(curChar) || is_number(curChar) ||
                     curChar == chUnderscore || curChar == chDot ||
@@ -281,12 +318,12 @@ LdpToken* LdpTokenizer::parse_new_token()
                     // compact notation [ name:value --> (name value) ]
                     // 'name' part is parsed and we've found the ':' sign
                     m_expectingNamePart = true;
-                    m_pTokenNamePart = LOMSE_NEW LdpToken(tkLabel, tokendata.str(), numLine);
+                    m_pTokenNamePart = LOMSE_NEW LdpToken(tkLabel, tokendata, numLine);
                     return LOMSE_NEW LdpToken(tkStartOfElement, chOpenParenthesis, numLine);
                 }
                 else {
-                    m_reader.repeat_last_char();
-                    return LOMSE_NEW LdpToken(tkLabel, tokendata.str(), numLine);
+                    repeat_last_char();
+                    return LOMSE_NEW LdpToken(tkLabel, tokendata, numLine);
                 }
                 break;
 
@@ -312,7 +349,7 @@ LdpToken* LdpTokenizer::parse_new_token()
             case k_STR00:
                 curChar = get_next_char();
                 if (curChar == chQuotes) {
-                    return LOMSE_NEW LdpToken(tkString, tokendata.str(), numLine);
+                    return LOMSE_NEW LdpToken(tkString, tokendata, numLine);
                 } else {
                     if (curChar == nEOF) {
                         state = k_Error;
@@ -323,10 +360,11 @@ LdpToken* LdpTokenizer::parse_new_token()
                 break;
 
             case k_STR01:
-                tokendata << curChar;
+                tokendata += curChar;
+                scan_chars<is_string_char>(tokendata);
                 curChar = get_next_char();
                 if (curChar == chQuotes) {
-                    return LOMSE_NEW LdpToken(tkString, tokendata.str(), numLine);
+                    return LOMSE_NEW LdpToken(tkString, tokendata, numLine);
                 } else {
                     if (curChar == nEOF) {
                         state = k_Error;
@@ -346,7 +384,8 @@ LdpToken* LdpTokenizer::parse_new_token()
                 break;
 
             case k_STR02:
-                tokendata << curChar;
+                tokendata += curChar;
+                scan_chars<is_quoted_label_char>(tokendata);
                 curChar = get_next_char();
                 if (curChar == chApostrophe) {
                     state = k_STR03;
@@ -358,14 +397,14 @@ LdpToken* LdpTokenizer::parse_new_token()
             case k_STR03:
                 curChar = get_next_char();
                 if (curChar == chApostrophe) {
-                    return LOMSE_NEW LdpToken(tkString, tokendata.str(), numLine);
+                    return LOMSE_NEW LdpToken(tkString, tokendata, numLine);
                 } else {
                     state = k_STR02;
                 }
                 break;
 
             case k_CMT01:
-                tokendata << curChar;
+                tokendata += curChar;
                 curChar = get_next_char();
                 if (curChar == chSlash)
                     state = k_CMT02;
@@ -376,16 +415,17 @@ LdpToken* LdpTokenizer::parse_new_token()
                 break;
 
             case k_CMT02:
-                tokendata << curChar;
+                tokendata += curChar;
+                scan_chars<is_comment_char>(tokendata);
                 curChar = get_next_char();
                 if (curChar == chLF || curChar == nEOF) {
-                    return LOMSE_NEW LdpToken(tkComment, tokendata.str(), numLine);
+                    return LOMSE_NEW LdpToken(tkComment, tokendata, numLine);
                 }
                 //else continue in this state
                 break;
 
             case k_CMT03:
-                tokendata << curChar;
+                tokendata += curChar;
                 curChar = get_next_char();
                 if (curChar == chAsterisk || curChar == nEOF) {
                     state = k_CMT04;
@@ -394,18 +434,19 @@ LdpToken* LdpTokenizer::parse_new_token()
                 break;
 
             case k_CMT04:
-                tokendata << curChar;
+                tokendata += curChar;
                 curChar = get_next_char();
                 if (curChar == chSlash || curChar == nEOF) {
-                    tokendata << curChar;
-                    return LOMSE_NEW LdpToken(tkComment, tokendata.str(), numLine);
+                    tokendata += curChar;
+                    return LOMSE_NEW LdpToken(tkComment, tokendata, numLine);
                 }
                 else
                     state = k_CMT03;
                 break;
 
             case k_NUM01:
-                tokendata << curChar;
+                tokendata += curChar;
+                scan_chars<is_number>(tokendata);
                 curChar = get_next_char();
                 if (is_number(curChar)) {
                     state = k_NUM01;
@@ -414,42 +455,51 @@ LdpToken* LdpTokenizer::parse_new_token()
                 } else if (is_letter(curChar) || curChar == chUnderscore) {
                     state = k_ETQ01;
                 } else {
-                    m_reader.repeat_last_char();
-                    return LOMSE_NEW LdpToken(tkIntegerNumber, tokendata.str(), numLine);
+                    repeat_last_char();
+                    return LOMSE_NEW LdpToken(tkIntegerNumber, tokendata, numLine);
                 }
                 break;
 
             case k_NUM02:
-                tokendata << curChar;
+                tokendata += curChar;
+                scan_chars<is_number>(tokendata);
                 curChar = get_next_char();
                 if (is_number(curChar)) {
                     state = k_NUM02;
                 } else {
-                    m_reader.repeat_last_char();
-                    return LOMSE_NEW LdpToken(tkRealNumber, tokendata.str(), numLine);
+                    repeat_last_char();
+                    return LOMSE_NEW LdpToken(tkRealNumber, tokendata, numLine);
                 }
                 break;
 
             case k_SPC01:
+                if (m_pBuffered)
+                {
+                    const char* pos = m_pBuffered->current();
+                    const char* end = m_pBuffered->end();
+                    while (pos != end && (*pos == chSpace || *pos == chTab || *pos == chCR))
+                        ++pos;
+                    m_pBuffered->skip_to(pos);
+                }
                 curChar = get_next_char();
                 if (curChar == chSpace || curChar == chTab) {
                     state = k_SPC01;
                 } else {
-                    m_reader.repeat_last_char();
+                    repeat_last_char();
                     return LOMSE_NEW LdpToken(tkSpaces, chSpace, numLine);
                 }
                 break;
 
             case k_S01:
-                tokendata << curChar;
+                tokendata += curChar;
                 curChar = get_next_char();
                 if (curChar == chSpace || curChar == chTab) {
-                    return LOMSE_NEW LdpToken(tkLabel, tokendata.str(), numLine);
+                    return LOMSE_NEW LdpToken(tkLabel, tokendata, numLine);
                 }
                 else if (curChar == chCloseParenthesis)
                 {
-                    m_reader.repeat_last_char();
-                    return LOMSE_NEW LdpToken(tkLabel, tokendata.str(), numLine);
+                    repeat_last_char();
+                    return LOMSE_NEW LdpToken(tkLabel, tokendata, numLine);
                 }
                 else if (is_number(curChar)) {
                     state = k_NUM01;
@@ -487,25 +537,51 @@ LdpToken* LdpTokenizer::parse_new_token()
 //---------------------------------------------------------------------------------------
 char LdpTokenizer::get_next_char()
 {
-    char ch = m_reader.get_next_char();
+    char ch = (m_pBuffered ? m_pBuffered->next_char() : m_reader.get_next_char());
     if (ch == chTab || ch == chCR)
         return ' ';
     else
         return ch;
 }
 
+//---------------------------------------------------------------------------------------
+void LdpTokenizer::repeat_last_char()
+{
+    if (m_pBuffered)
+        m_pBuffered->unget_char();
+    else
+        m_reader.repeat_last_char();
+}
+
+//---------------------------------------------------------------------------------------
+template <bool (*IsValid)(char)>
+void LdpTokenizer::scan_chars(std::string& tokendata)
+{
+    if (!m_pBuffered)
+        return;
+
+    const char* start = m_pBuffered->current();
+    const char* end = m_pBuffered->end();
+    const char* pos = start;
+    while (pos != end && IsValid(*pos))
+        ++pos;
+    if (pos != start)
+    {
+        tokendata.append(start, pos);
+        m_pBuffered->skip_to(pos);
+    }
+}
+
 //---------------------------------------------------------------------------------------
 bool LdpTokenizer::is_letter(char ch)
 {
-    static const std::string letters("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz");
-    return (letters.find(ch) != string::npos);
+    return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z');
 }
 
 //---------------------------------------------------------------------------------------
 bool LdpTokenizer::is_number(char ch)
 {
-    static const std::string numbers("0123456789");
-    return (numbers.find(ch) != string::npos);
+    return (ch >= '0' && ch <= '9');
 }
 
 //---------------------------------------------------------------------------------------
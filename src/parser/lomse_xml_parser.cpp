@@ -33,6 +33,8 @@
 #include <ostream>
 #include <sstream>
 #include <vector>
+#include <cstdio>
+#include <cstring>      //memchr, strlen
 using namespace std;
 
 
@@ -141,26 +143,73 @@ XmlParser::~XmlParser()
 //---------------------------------------------------------------------------------------
 void XmlParser::parse_text(const std::string& sourceText)
 {
-    parse_char_string( const_cast<char*>(sourceText.c_str()) );
+    parse_char_string( const_cast<char*>(sourceText.c_str()), sourceText.size() );
 }
 
 //---------------------------------------------------------------------------------------
 void XmlParser::parse_cstring(char* sourceText)
 {
-    parse_char_string(sourceText);
+    parse_char_string(sourceText, strlen(sourceText));
+}
+
+//---------------------------------------------------------------------------------------
+char* XmlParser::allocate_buffer(size_t size)
+{
+    //Returns a buffer suitable for parse_buffer_own(), or nullptr if not enough memory
+
+    return static_cast<char*>( pugi::get_memory_allocation_function()(size > 0 ? size : 1) );
+}
+
+//---------------------------------------------------------------------------------------
+void XmlParser::parse_buffer_own(char* buffer, size_t size)
+{
+    //Parses the XML text in buffer without copying it: the tree is built in-situ and
+    //the parser takes ownership of the buffer. It must have been allocated by
+    //allocate_buffer().
+
+    m_filename.clear();
+    build_offset_data(buffer, size);
+    pugi::xml_parse_result result = m_doc.load_buffer_inplace_own(buffer, size,
+                                                            (pugi::parse_default |
+                                                             pugi::parse_declaration)
+                                                     );
+
+    if (!result)
+    {
+        m_errorMsg = string(result.description());
+        m_errorOffset = int(result.offset);
+        m_reporter << "Pos: " << m_errorOffset << ". Error: " << m_errorMsg << endl;
+    }
+    find_root();
 }
 
 //---------------------------------------------------------------------------------------
 void XmlParser::parse_file(const std::string& filename, bool UNUSED(fErrorMsg))
 {
-    m_fOffsetDataReady = false;
+    //The file is loaded in a buffer, for building the line index, and then it is
+    //parsed in-situ
+
     m_filename = filename;
-    pugi::xml_parse_result result = m_doc.load_file(filename.c_str(),
-                                                    (pugi::parse_default |
-                                                     //pugi::parse_trim_pcdata |
-                                                     //pugi::parse_wnorm_attribute |
-                                                     pugi::parse_declaration)
-                                                   );
+    pugi::xml_parse_result result;
+    size_t size = 0;
+    char* buffer = load_file(filename, &size);
+    if (buffer)
+    {
+        build_offset_data(buffer, size);
+        result = m_doc.load_buffer_inplace_own(buffer, size,
+                                               (pugi::parse_default |
+                                                //pugi::parse_trim_pcdata |
+                                                //pugi::parse_wnorm_attribute |
+                                                pugi::parse_declaration)
+                                              );
+    }
+    else
+    {
+        //let pugixml report the problem
+        m_fOffsetDataReady = false;
+        result = m_doc.load_file(filename.c_str(), (pugi::parse_default |
+                                                    pugi::parse_declaration) );
+    }
 
     if (!result)
     {
@@ -173,10 +222,35 @@ void XmlParser::parse_file(const std::string& filename, bool UNUSED(fErrorMsg))
 }
 
 //---------------------------------------------------------------------------------------
-void XmlParser::parse_char_string(char* str)
+char* XmlParser::load_file(const std::string& filename, size_t* pSize)
+{
+    //Returns a buffer allocated by allocate_buffer() with the file content, or nullptr
+    //if the file can not be read
+
+    FILE* f = fopen(filename.c_str(), "rb");
+    if (!f)
+        return nullptr;
+
+    char* buffer = nullptr;
+    long length = -1;
+    if (fseek(f, 0, SEEK_END) == 0)
+        length = ftell(f);
+    if (length >= 0 && fseek(f, 0, SEEK_SET) == 0)
+    {
+        buffer = allocate_buffer(size_t(length));
+        if (buffer)
+            *pSize = fread(buffer, 1, size_t(length), f);
+    }
+
+    fclose(f);
+    return buffer;
+}
+
+//---------------------------------------------------------------------------------------
+void XmlParser::parse_char_string(char* str, size_t size)
 {
-    m_fOffsetDataReady = false;
     m_filename.clear();
+    build_offset_data(str, size);
     pugi::xml_parse_result result = m_doc.load_string(str, (pugi::parse_default |
                                                             //pugi::parse_trim_pcdata |
                                                             //pugi::parse_wnorm_attribute |
@@ -209,8 +283,12 @@ void XmlParser::find_root()
 }
 
 //---------------------------------------------------------------------------------------
-bool XmlParser::build_offset_data(const char* filename)
+void XmlParser::build_offset_data(const char* buffer, size_t size)
 {
+    //Builds the index with the offset of each line end. It must be invoked before
+    //parsing, as pugixml modifies the buffer when parsing in-situ. The search for
+    //line ends is done by memchr(), that most C libraries vectorize.
+    //
     //AWARE:
     // * Windows and DOS use a pair of CR (\r) and LF (\n) chars to end lines
     // * UNIX (including Linux and FreeBSD) uses only an LF char
@@ -222,27 +300,18 @@ bool XmlParser::build_offset_data(const char* filename)
 
     m_offsetData.clear();
 
-    FILE* f = fopen(filename, "rb");
-    if (!f)
-        return false;
-
-    ptrdiff_t offset = 0;
-
-    char buffer[1024];
-    size_t size;
-
-    while ((size = fread(buffer, 1, sizeof(buffer), f)) > 0)
+    const char* end = buffer + size;
+    const char* pos = buffer;
+    while (pos < end)
     {
-        for (size_t i = 0; i < size; ++i)
-            if (buffer[i] == '\n')
-                m_offsetData.push_back(offset + i);
-
-        offset += size;
+        const char* lf = static_cast<const char*>( memchr(pos, '\n', size_t(end - pos)) );
+        if (!lf)
+            break;
+        m_offsetData.push_back(lf - buffer);
+        pos = lf + 1;
     }
 
-    fclose(f);
-
-    return true;
+    m_fOffsetDataReady = true;
 }
 
 //---------------------------------------------------------------------------------------
@@ -260,9 +329,6 @@ std::pair<int, int> XmlParser::get_location(ptrdiff_t offset)
 int XmlParser::get_line_number(XmlNode* node)
 {
     ptrdiff_t offset = node->offset();
-    if (!m_fOffsetDataReady && !m_filename.empty())
-        m_fOffsetDataReady = build_offset_data(m_filename.c_str());
-
     if ( m_fOffsetDataReady)
     {
         std::pair<int, int> pos = get_location(offset);
@@ -61,26 +61,25 @@ ImoDocument* CompressedMxlCompiler::compile_file(const std::string& filename)
 
 #if (LOMSE_ENABLE_COMPRESSION == 1)
     ZipInputStream zip(filename);
-
-    const std::string mxmlString = read_rootfile(zip);
-
-    if (mxmlString.empty())
-    {
-        LOMSE_LOG_ERROR("[CompressedMxlCompiler::compile_file] Couldn't read rootfile");
-        return nullptr;
-    }
-
-    return m_pMxlCompiler->compile_string(mxmlString);
+    return compile_rootfile(zip);
 #else
     throw runtime_error("Could not open compressed file: Lomse was compiled without compression support");
 #endif
 }
 
 //---------------------------------------------------------------------------------------
-ImoDocument* CompressedMxlCompiler::compile_string(const std::string& UNUSED(source))
+ImoDocument* CompressedMxlCompiler::compile_string(const std::string& source)
 {
+    //source is the content of a compressed .mxl file
+
     m_fileLocator = "string:";
-    throw runtime_error("Could not open compressed .mxl string: reading compressed string is not supported currently");
+
+#if (LOMSE_ENABLE_COMPRESSION == 1)
+    ZipInputStream zip(source.data(), source.size());
+    return compile_rootfile(zip);
+#else
+    throw runtime_error("Could not open compressed .mxl string: Lomse was compiled without compression support");
+#endif
 }
 
 //---------------------------------------------------------------------------------------
@@ -113,24 +112,35 @@ std::string CompressedMxlCompiler::get_rootfile_path(ZipInputStream& zip)
 }
 
 //---------------------------------------------------------------------------------------
-std::string CompressedMxlCompiler::read_rootfile(ZipInputStream& zip)
+ImoDocument* CompressedMxlCompiler::compile_rootfile(ZipInputStream& zip)
 {
 #if (LOMSE_ENABLE_COMPRESSION == 1)
-    const std::string rootFilePath = get_rootfile_path(zip);
+    //The rootfile is inflated directly into the buffer that the XML parser will use
+    //for building the tree in-situ. Thus, there are no intermediate copies.
 
-    if (rootFilePath.empty())
-        return std::string();
-
-    zip.move_to_entry(rootFilePath);
+    const std::string rootFilePath = get_rootfile_path(zip);
 
-    if (!zip.open_current_entry())
-        return std::string();
+    if (rootFilePath.empty()
+        || !zip.move_to_entry(rootFilePath)
+        || !zip.open_current_entry()
+        || zip.eof() )
+    {
+        LOMSE_LOG_ERROR("[CompressedMxlCompiler::compile_rootfile] Couldn't read rootfile");
+        return nullptr;
+    }
 
-    std::vector<unsigned char> mxmlBuffer = zip.get_as_vector();
+    size_t size = size_t( zip.get_size() );
+    char* buffer = XmlParser::allocate_buffer(size);
+    if (!buffer)
+    {
+        LOMSE_LOG_ERROR("[CompressedMxlCompiler::compile_rootfile] Not enough memory");
+        return nullptr;
+    }
+    size = size_t( zip.read(reinterpret_cast<unsigned char*>(buffer), long(size)) );
 
-    return std::string(reinterpret_cast<char*>(mxmlBuffer.data()));
+    return m_pMxlCompiler->compile_buffer(buffer, size);
 #else
-    return std::string();
+    return nullptr;
 #endif
 }
 
@@ -54,6 +54,7 @@
 
 #include <iostream>
 #include <sstream>
+#include <cstring>      //memcmp, strlen
 //BUG: In my Ubuntu box next line causes problems since approx. 20/march/2011
 #if (LOMSE_PLATFORM_WIN32 == 1)
     #include <locale>
@@ -7506,69 +7507,6 @@ MxlAnalyser::MxlAnalyser(ostream& reporter, LibraryScope& libraryScope, Document
     , m_measuresCounter(0)
     , m_curVoice(0)
 {
-    //populate the name to enum conversion map
-    m_NameToEnum["accordion-registration"] = k_mxl_tag_accordion_registration;
-    m_NameToEnum["articulations"] = k_mxl_tag_articulations;
-    m_NameToEnum["attributes"] = k_mxl_tag_attributes;
-    m_NameToEnum["backup"] = k_mxl_tag_backup;
-    m_NameToEnum["barline"] = k_mxl_tag_barline;
-    m_NameToEnum["bracket"] = k_mxl_tag_bracket;
-    m_NameToEnum["clef"] = k_mxl_tag_clef;
-    m_NameToEnum["coda"] = k_mxl_tag_coda;
-    m_NameToEnum["damp"] = k_mxl_tag_damp;
-    m_NameToEnum["damp-all"] = k_mxl_tag_damp_all;
-    m_NameToEnum["dashes"] = k_mxl_tag_dashes;
-    m_NameToEnum["direction"] = k_mxl_tag_direction;
-    m_NameToEnum["direction-type"] = k_mxl_tag_direction_type;
-    m_NameToEnum["dynamics"] = k_mxl_tag_dynamics;
-    m_NameToEnum["ending"] = k_mxl_tag_ending;
-    m_NameToEnum["eyeglasses"] = k_mxl_tag_eyeglasses;
-    m_NameToEnum["fermata"] = k_mxl_tag_fermata;
-    m_NameToEnum["forward"] = k_mxl_tag_forward;
-    m_NameToEnum["harp-pedals"] = k_mxl_tag_harp_pedals;
-    m_NameToEnum["image"] = k_mxl_tag_image;
-    m_NameToEnum["key"] = k_mxl_tag_key;
-    m_NameToEnum["lyric"] = k_mxl_tag_lyric;
-    m_NameToEnum["measure"] = k_mxl_tag_measure;
-    m_NameToEnum["metronome"] = k_mxl_tag_metronome;
-    m_NameToEnum["midi-device"] = k_mxl_tag_midi_device;
-    m_NameToEnum["midi-instrument"] = k_mxl_tag_midi_instrument;
-    m_NameToEnum["notations"] = k_mxl_tag_notations;
-    m_NameToEnum["note"] = k_mxl_tag_note;
-    m_NameToEnum["octave-shift"] = k_mxl_tag_octave_shift;
-    m_NameToEnum["ornaments"] = k_mxl_tag_ornaments;
-    m_NameToEnum["part"] = k_mxl_tag_part;
-    m_NameToEnum["part-group"] = k_mxl_tag_part_group;
-    m_NameToEnum["part-list"] = k_mxl_tag_part_list;
-    m_NameToEnum["part-name"] = k_mxl_tag_part_name;
-    m_NameToEnum["pedal"] = k_mxl_tag_pedal;
-    m_NameToEnum["percussion"] = k_mxl_tag_percussion;
-    m_NameToEnum["pitch"] = k_mxl_tag_pitch;
-    m_NameToEnum["principal-voice"] = k_mxl_tag_principal_voice;
-    m_NameToEnum["print"] = k_mxl_tag_print;
-    m_NameToEnum["rehearsal"] = k_mxl_tag_rehearsal;
-    m_NameToEnum["rest"] = k_mxl_tag_rest;
-    m_NameToEnum["scordatura"] = k_mxl_tag_scordatura;
-    m_NameToEnum["score-instrument"] = k_mxl_tag_score_instrument;
-    m_NameToEnum["score-part"] = k_mxl_tag_score_part;
-    m_NameToEnum["score-partwise"] = k_mxl_tag_score_partwise;
-    m_NameToEnum["segno"] = k_mxl_tag_segno;
-    m_NameToEnum["slur"] = k_mxl_tag_slur;
-    m_NameToEnum["sound"] = k_mxl_tag_sound;
-    m_NameToEnum["string-mute"] = k_mxl_tag_string_mute;
-    m_NameToEnum["technical"] = k_mxl_tag_technical;
-    m_NameToEnum["text"] = k_mxl_tag_text;
-    m_NameToEnum["tied"] = k_mxl_tag_tied;
-    m_NameToEnum["time"] = k_mxl_tag_time;
-    m_NameToEnum["time-modification"] = k_mxl_tag_time_modification;
-    m_NameToEnum["transpose"] = k_mxl_tag_transpose;
-    m_NameToEnum["tuplet"] = k_mxl_tag_tuplet;
-    m_NameToEnum["tuplet-actual"] = k_mxl_tag_tuplet_actual;
-    m_NameToEnum["tuplet-normal"] = k_mxl_tag_tuplet_normal;
-    m_NameToEnum["virtual-instrument"] = k_mxl_tag_virtual_instr;
-    m_NameToEnum["wedge"] = k_mxl_tag_wedge;
-    m_NameToEnum["words"] = k_mxl_tag_words;
-
     m_notes.assign(50, nullptr);
 }
 
@@ -7576,7 +7514,6 @@ MxlAnalyser::MxlAnalyser(ostream& reporter, LibraryScope& libraryScope, Document
 MxlAnalyser::~MxlAnalyser()
 {
     delete_relation_builders();
-    m_NameToEnum.clear();
     m_lyrics.clear();
     m_lyricIndex.clear();
 }
@@ -7622,18 +7559,14 @@ ImoObj* MxlAnalyser::analyse_tree(XmlNode* tree, const string& locator)
 ImoObj* MxlAnalyser::analyse_node(XmlNode* pNode, ImoObj* pAnchor)
 {
     //m_reporter << "DBG. Analysing node: " << pNode->name() << endl;
-    MxlElementAnalyser* a = new_analyser( pNode->name(), pAnchor );
-    ImoObj* pImo = a->analyse_node(pNode);
-    delete a;
-    return pImo;
+    return dispatch_analysis(pNode, pAnchor, nullptr);
 }
 
 //---------------------------------------------------------------------------------------
 bool MxlAnalyser::analyse_node_bool(XmlNode* pNode, ImoObj* pAnchor)
 {
-    MxlElementAnalyser* a = new_analyser( pNode->name(), pAnchor );
-    bool value = a->analyse_node_bool(pNode);
-    delete a;
+    bool value = false;
+    dispatch_analysis(pNode, pAnchor, &value);
     return value;
 }
 
@@ -8055,85 +7988,213 @@ bool MxlAnalyser::to_integer(const string& text, int* pResult)
 }
 
 //---------------------------------------------------------------------------------------
-MxlElementAnalyser* MxlAnalyser::new_analyser(const string& name, ImoObj* pAnchor)
+//Element analysers are short lived and keep per-node state, and analysis is recursive.
+//Thus, instead of allocating them in the heap, each analyser is created in the stack
+//frame of the analysis of its node.
+template <class T, class... Args>
+static ImoObj* analyse_with(XmlNode* pNode, bool* pValue, Args&&... args)
 {
-    //Factory method to create analysers
+    T a(std::forward<Args>(args)...);
+    if (pValue)
+    {
+        *pValue = a.analyse_node_bool(pNode);
+        return nullptr;
+    }
+    return a.analyse_node(pNode);
+}
 
+//---------------------------------------------------------------------------------------
+ImoObj* MxlAnalyser::dispatch_analysis(XmlNode* pNode, ImoObj* pAnchor, bool* pValue)
+{
+    //Creates the analyser for the node in the stack and analyses the node. If pValue
+    //is not nullptr, the node is analysed by analyse_node_bool() and the result is
+    //returned in pValue.
+
+    const char* name = pNode->name_ptr();
     switch ( name_to_enum(name) )
     {
-//        case k_mxl_tag_accordion_registration: return LOMSE_NEW AccordionRegistrationMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_articulations:        return LOMSE_NEW ArticulationsMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_attributes:           return LOMSE_NEW AtribbutesMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_backup:               return LOMSE_NEW FwdBackMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_barline:              return LOMSE_NEW BarlineMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_bracket:              return LOMSE_NEW BracketMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_clef:                 return LOMSE_NEW ClefMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_coda:                 return LOMSE_NEW CodaMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_damp:                 return LOMSE_NEW DampMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_damp_all:             return LOMSE_NEW DampAllMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_dashes:               return LOMSE_NEW DashesMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_direction:            return LOMSE_NEW DirectionMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_direction_type:       return LOMSE_NEW DirectionTypeMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_dynamics:             return LOMSE_NEW DynamicsMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_ending:               return LOMSE_NEW EndingMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_eyeglasses:           return LOMSE_NEW EyeglassesMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_fermata:              return LOMSE_NEW FermataMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_forward:              return LOMSE_NEW FwdBackMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_harp_pedals:          return LOMSE_NEW HarpPedalsMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_image:                return LOMSE_NEW ImageMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_key:                  return LOMSE_NEW KeyMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_lyric:                return LOMSE_NEW LyricMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_measure:              return LOMSE_NEW MeasureMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_metronome:            return LOMSE_NEW MetronomeMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_midi_device:          return LOMSE_NEW MidiDeviceMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_midi_instrument:      return LOMSE_NEW MidiInstrumentMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_notations:            return LOMSE_NEW NotationsMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_note:                 return LOMSE_NEW NoteRestMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_octave_shift:         return LOMSE_NEW OctaveShiftMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_ornaments:            return LOMSE_NEW OrnamentsMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_part:                 return LOMSE_NEW PartMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_part_group:           return LOMSE_NEW PartGroupMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_part_list:            return LOMSE_NEW PartListMxlAnalyser(this, m_reporter, m_libraryScope);
-        case k_mxl_tag_part_name:            return LOMSE_NEW PartNameMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_pedal:                return LOMSE_NEW PedalMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_percussion:           return LOMSE_NEW PercussionMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_pitch:                return LOMSE_NEW PitchMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_principal_voice:      return LOMSE_NEW PrincipalVoiceMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_print:                return LOMSE_NEW PrintMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_rehearsal:            return LOMSE_NEW RehearsalMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_scordatura:           return LOMSE_NEW ScordaturaMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_score_instrument:     return LOMSE_NEW ScoreInstrumentMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_score_part:           return LOMSE_NEW ScorePartMxlAnalyser(this, m_reporter, m_libraryScope);
-        case k_mxl_tag_score_partwise:       return LOMSE_NEW ScorePartwiseMxlAnalyser(this, m_reporter, m_libraryScope);
-        case k_mxl_tag_segno:                return LOMSE_NEW SegnoMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_slur:                 return LOMSE_NEW SlurMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_sound:                return LOMSE_NEW SoundMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-//        case k_mxl_tag_string_mute:          return LOMSE_NEW StringMmuteMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_technical:            return LOMSE_NEW TecnicalMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_text:                 return LOMSE_NEW TextMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_tied:                 return LOMSE_NEW TiedMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_time:                 return LOMSE_NEW TimeMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_time_modification:    return LOMSE_NEW TimeModificationXmlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_transpose:            return LOMSE_NEW TransposeMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_tuplet:               return LOMSE_NEW TupletMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_tuplet_actual:        return LOMSE_NEW TupletNumbersMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_tuplet_normal:        return LOMSE_NEW TupletNumbersMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_virtual_instr:        return LOMSE_NEW VirtualInstrumentMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_wedge:                return LOMSE_NEW WedgeMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
-        case k_mxl_tag_words:                return LOMSE_NEW WordsMxlAnalyser(this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_accordion_registration: return analyse_with<AccordionRegistrationMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_articulations:       return analyse_with<ArticulationsMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_attributes:          return analyse_with<AtribbutesMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_backup:              return analyse_with<FwdBackMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_barline:             return analyse_with<BarlineMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_bracket:             return analyse_with<BracketMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_clef:                return analyse_with<ClefMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_coda:                return analyse_with<CodaMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_damp:                return analyse_with<DampMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_damp_all:            return analyse_with<DampAllMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_dashes:              return analyse_with<DashesMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_direction:           return analyse_with<DirectionMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_direction_type:      return analyse_with<DirectionTypeMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_dynamics:            return analyse_with<DynamicsMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_ending:              return analyse_with<EndingMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_eyeglasses:          return analyse_with<EyeglassesMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_fermata:             return analyse_with<FermataMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_forward:             return analyse_with<FwdBackMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_harp_pedals:         return analyse_with<HarpPedalsMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_image:               return analyse_with<ImageMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_key:                 return analyse_with<KeyMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_lyric:               return analyse_with<LyricMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_measure:             return analyse_with<MeasureMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_metronome:           return analyse_with<MetronomeMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_midi_device:         return analyse_with<MidiDeviceMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_midi_instrument:     return analyse_with<MidiInstrumentMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_notations:           return analyse_with<NotationsMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_note:                return analyse_with<NoteRestMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_octave_shift:        return analyse_with<OctaveShiftMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_ornaments:           return analyse_with<OrnamentsMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_part:                return analyse_with<PartMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_part_group:          return analyse_with<PartGroupMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_part_list:           return analyse_with<PartListMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope);
+        case k_mxl_tag_part_name:           return analyse_with<PartNameMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_pedal:               return analyse_with<PedalMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_percussion:          return analyse_with<PercussionMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_pitch:               return analyse_with<PitchMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_principal_voice:     return analyse_with<PrincipalVoiceMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_print:               return analyse_with<PrintMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_rehearsal:           return analyse_with<RehearsalMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_scordatura:          return analyse_with<ScordaturaMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_score_instrument:    return analyse_with<ScoreInstrumentMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_score_part:          return analyse_with<ScorePartMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope);
+        case k_mxl_tag_score_partwise:      return analyse_with<ScorePartwiseMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope);
+        case k_mxl_tag_segno:               return analyse_with<SegnoMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_slur:                return analyse_with<SlurMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_sound:               return analyse_with<SoundMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+//        case k_mxl_tag_string_mute:         return analyse_with<StringMmuteMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_technical:           return analyse_with<TecnicalMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_text:                return analyse_with<TextMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_tied:                return analyse_with<TiedMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_time:                return analyse_with<TimeMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_time_modification:   return analyse_with<TimeModificationXmlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_transpose:           return analyse_with<TransposeMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_tuplet:              return analyse_with<TupletMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_tuplet_actual:       return analyse_with<TupletNumbersMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_tuplet_normal:       return analyse_with<TupletNumbersMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_virtual_instr:       return analyse_with<VirtualInstrumentMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_wedge:               return analyse_with<WedgeMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
+        case k_mxl_tag_words:               return analyse_with<WordsMxlAnalyser>(pNode, pValue, this, m_reporter, m_libraryScope, pAnchor);
         default:
-            return LOMSE_NEW NullMxlAnalyser(this, m_reporter, m_libraryScope, name);
+            return analyse_with<NullMxlAnalyser>(pNode, pValue, this, m_reporter,
+                                                 m_libraryScope, string(name));
     }
 }
 
 //---------------------------------------------------------------------------------------
 int MxlAnalyser::name_to_enum(const string& name) const
 {
-	map<string, int>::const_iterator it = m_NameToEnum.find(name);
-	if (it != m_NameToEnum.end())
-		return it->second;
-    else
-        return k_mxl_tag_undefined;
+    return name_to_enum(name.c_str());
+}
+
+//---------------------------------------------------------------------------------------
+int MxlAnalyser::name_to_enum(const char* name)
+{
+    //Tags are first selected by length and then compared. This avoids creating
+    //strings and searching a map for each analysed element.
+
+    #define LOMSE_MXL_TAG(tag, value) \
+        if (memcmp(name, tag, sizeof(tag)-1) == 0) return value
+
+    switch (strlen(name))
+    {
+        case 3:
+            LOMSE_MXL_TAG("key", k_mxl_tag_key);
+            break;
+        case 4:
+            LOMSE_MXL_TAG("clef", k_mxl_tag_clef);
+            LOMSE_MXL_TAG("coda", k_mxl_tag_coda);
+            LOMSE_MXL_TAG("damp", k_mxl_tag_damp);
+            LOMSE_MXL_TAG("note", k_mxl_tag_note);
+            LOMSE_MXL_TAG("part", k_mxl_tag_part);
+            LOMSE_MXL_TAG("rest", k_mxl_tag_rest);
+            LOMSE_MXL_TAG("slur", k_mxl_tag_slur);
+            LOMSE_MXL_TAG("text", k_mxl_tag_text);
+            LOMSE_MXL_TAG("tied", k_mxl_tag_tied);
+            LOMSE_MXL_TAG("time", k_mxl_tag_time);
+            break;
+        case 5:
+            LOMSE_MXL_TAG("image", k_mxl_tag_image);
+            LOMSE_MXL_TAG("lyric", k_mxl_tag_lyric);
+            LOMSE_MXL_TAG("pedal", k_mxl_tag_pedal);
+            LOMSE_MXL_TAG("pitch", k_mxl_tag_pitch);
+            LOMSE_MXL_TAG("print", k_mxl_tag_print);
+            LOMSE_MXL_TAG("segno", k_mxl_tag_segno);
+            LOMSE_MXL_TAG("sound", k_mxl_tag_sound);
+            LOMSE_MXL_TAG("wedge", k_mxl_tag_wedge);
+            LOMSE_MXL_TAG("words", k_mxl_tag_words);
+            break;
+        case 6:
+            LOMSE_MXL_TAG("backup", k_mxl_tag_backup);
+            LOMSE_MXL_TAG("dashes", k_mxl_tag_dashes);
+            LOMSE_MXL_TAG("ending", k_mxl_tag_ending);
+            LOMSE_MXL_TAG("tuplet", k_mxl_tag_tuplet);
+            break;
+        case 7:
+            LOMSE_MXL_TAG("barline", k_mxl_tag_barline);
+            LOMSE_MXL_TAG("bracket", k_mxl_tag_bracket);
+            LOMSE_MXL_TAG("fermata", k_mxl_tag_fermata);
+            LOMSE_MXL_TAG("forward", k_mxl_tag_forward);
+            LOMSE_MXL_TAG("measure", k_mxl_tag_measure);
+            break;
+        case 8:
+            LOMSE_MXL_TAG("damp-all", k_mxl_tag_damp_all);
+            LOMSE_MXL_TAG("dynamics", k_mxl_tag_dynamics);
+            break;
+        case 9:
+            LOMSE_MXL_TAG("direction", k_mxl_tag_direction);
+            LOMSE_MXL_TAG("metronome", k_mxl_tag_metronome);
+            LOMSE_MXL_TAG("notations", k_mxl_tag_notations);
+            LOMSE_MXL_TAG("ornaments", k_mxl_tag_ornaments);
+            LOMSE_MXL_TAG("part-list", k_mxl_tag_part_list);
+            LOMSE_MXL_TAG("part-name", k_mxl_tag_part_name);
+            LOMSE_MXL_TAG("rehearsal", k_mxl_tag_rehearsal);
+            LOMSE_MXL_TAG("technical", k_mxl_tag_technical);
+            LOMSE_MXL_TAG("transpose", k_mxl_tag_transpose);
+            break;
+        case 10:
+            LOMSE_MXL_TAG("attributes", k_mxl_tag_attributes);
+            LOMSE_MXL_TAG("eyeglasses", k_mxl_tag_eyeglasses);
+            LOMSE_MXL_TAG("part-group", k_mxl_tag_part_group);
+            LOMSE_MXL_TAG("percussion", k_mxl_tag_percussion);
+            LOMSE_MXL_TAG("scordatura", k_mxl_tag_scordatura);
+            LOMSE_MXL_TAG("score-part", k_mxl_tag_score_part);
+            break;
+        case 11:
+            LOMSE_MXL_TAG("harp-pedals", k_mxl_tag_harp_pedals);
+            LOMSE_MXL_TAG("midi-device", k_mxl_tag_midi_device);
+            LOMSE_MXL_TAG("string-mute", k_mxl_tag_string_mute);
+            break;
+        case 12:
+            LOMSE_MXL_TAG("octave-shift", k_mxl_tag_octave_shift);
+            break;
+        case 13:
+            LOMSE_MXL_TAG("articulations", k_mxl_tag_articulations);
+            LOMSE_MXL_TAG("tuplet-actual", k_mxl_tag_tuplet_actual);
+            LOMSE_MXL_TAG("tuplet-normal", k_mxl_tag_tuplet_normal);
+            break;
+        case 14:
+            LOMSE_MXL_TAG("direction-type", k_mxl_tag_direction_type);
+            LOMSE_MXL_TAG("score-partwise", k_mxl_tag_score_partwise);
+            break;
+        case 15:
+            LOMSE_MXL_TAG("midi-instrument", k_mxl_tag_midi_instrument);
+            LOMSE_MXL_TAG("principal-voice", k_mxl_tag_principal_voice);
+            break;
+        case 16:
+            LOMSE_MXL_TAG("score-instrument", k_mxl_tag_score_instrument);
+            break;
+        case 17:
+            LOMSE_MXL_TAG("time-modification", k_mxl_tag_time_modification);
+            break;
+        case 18:
+            LOMSE_MXL_TAG("virtual-instrument", k_mxl_tag_virtual_instr);
+            break;
+        case 22:
+            LOMSE_MXL_TAG("accordion-registration", k_mxl_tag_accordion_registration);
+            break;
+    }
+    #undef LOMSE_MXL_TAG
+
+    return k_mxl_tag_undefined;
 }
 
 
@@ -90,11 +90,20 @@ ImoDocument* MxlCompiler::compile_file(const std::string& filename)
         InputStream* pFile = FileSystem::open_input_stream(m_fileLocator);
         ZipInputStream* zip  = static_cast<ZipInputStream*>(pFile);
 
-        unsigned char* buffer = zip->get_as_string();
-        m_pXmlParser->parse_cstring( (char *)buffer );
+        //inflate directly into the buffer to be parsed in-situ. An entry at eof has
+        //no data to read: an empty buffer is parsed
+        size_t size = (zip->eof() ? 0 : size_t( zip->get_size() ));
+        char* buffer = XmlParser::allocate_buffer(size);
+        if (!buffer)
+        {
+            delete pFile;
+            throw std::runtime_error("[MxlCompiler::compile_file] error allocating memory for zip file");
+        }
+        if (size > 0)
+            size = size_t( zip->read(reinterpret_cast<unsigned char*>(buffer), long(size)) );
+        m_pXmlParser->parse_buffer_own(buffer, size);
 
         delete pFile;
-        delete[] buffer;
 #else
 		throw runtime_error("Could not open compressed file: Lomse was compiled without compression support");
 #endif
@@ -117,6 +126,17 @@ ImoDocument* MxlCompiler::compile_string(const std::string& source)
     return compile_parsed_tree( m_pXmlParser->get_tree_root() );
 }
 
+//---------------------------------------------------------------------------------------
+ImoDocument* MxlCompiler::compile_buffer(char* buffer, size_t size)
+{
+    //The buffer is parsed in-situ and its ownership is transferred to the parser.
+    //It must have been allocated by XmlParser::allocate_buffer().
+
+    m_fileLocator = "string:";
+    m_pXmlParser->parse_buffer_own(buffer, size);
+    return compile_parsed_tree( m_pXmlParser->get_tree_root() );
+}
+
 //---------------------------------------------------------------------------------------
 ImoDocument* MxlCompiler::compile_parsed_tree(XmlNode* root)
 {
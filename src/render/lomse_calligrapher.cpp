@@ -153,6 +153,125 @@ void Calligrapher::set_scale(double scale)
     m_pFonts->set_transform(mtx);
 }
 
+//---------------------------------------------------------------------------------------
+int Calligrapher::add_text_to_batch(double x, double y, const std::string& str,
+                                    Color color, double scale)
+{
+    //convert to utf-32
+    const char* utf8str = str.c_str();
+    wstring utf32result;
+    utf8::utf8to32(utf8str, utf8str + strlen(utf8str), std::back_inserter(utf32result));
+
+    return add_text_to_batch(x, y, utf32result, color, scale);
+}
+
+//---------------------------------------------------------------------------------------
+int Calligrapher::add_text_to_batch(double x, double y, const wstring& str,
+                                    Color color, double scale)
+{
+    //returns the number of chars queued
+
+    if (!m_pFonts->is_font_valid())
+        return 0;
+
+    set_scale(scale);
+
+    //glyph positions, kerning included, must be computed now, as the font could
+    //be changed before rendering the batch
+    int num_glyphs = 0;
+    wstring::const_iterator it;
+    for (it = str.begin(); it != str.end(); ++it)
+    {
+        const lomse::glyph_cache* glyph = m_pFonts->get_glyph_cache(*it);
+        if(glyph)
+        {
+            m_pFonts->add_kerning(&x, &y);
+            add_glyph_to_batch(glyph, x, y, color);
+
+            // increment pen position
+            x += glyph->advance_x;
+            ++num_glyphs;
+        }
+    }
+    return num_glyphs;
+}
+
+//---------------------------------------------------------------------------------------
+void Calligrapher::add_glyph_to_batch(double x, double y, unsigned int ch, Color color,
+                                      double scale)
+{
+    //ch is the glyph (utf-32)
+
+    if (!m_pFonts->is_font_valid())
+        return;
+
+    set_scale(scale);
+
+    const lomse::glyph_cache* glyph = m_pFonts->get_glyph_cache(ch);
+    if(glyph)
+    {
+        m_pFonts->add_kerning(&x, &y);
+        add_glyph_to_batch(glyph, x, y, color);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+bool Calligrapher::add_glyph_to_batch(const lomse::glyph_cache* glyph,
+                                      double x, double y, Color color)
+{
+    //Returns true if the glyph has been queued. Only glyphs rendered as gray8
+    //scanlines can be queued. Any other glyph is rendered now, after rendering
+    //the glyphs already queued, so that drawing order is preserved.
+
+    if (glyph->data_type != glyph_data_gray8)
+    {
+        render_batch();
+        m_pFonts->init_adaptors(glyph, x, y);
+        m_pRenderer->render(m_pFonts->get_gray8_adaptor(),
+                            m_pFonts->get_gray8_scanline(),
+                            color);
+        return false;
+    }
+
+    BatchedGlyph bg;
+    bg.x = x;
+    bg.y = y;
+    bg.offset = m_batchData.size();
+    bg.size = glyph->data_size;
+    bg.color = color;
+    m_batchData.insert(m_batchData.end(), glyph->data, glyph->data + glyph->data_size);
+    m_batch.push_back(bg);
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+void Calligrapher::render_batch()
+{
+    if (m_batch.empty())
+        return;
+
+    //a single adaptor and scanline are reused for all queued glyphs
+    FontRasterizer adaptor;
+    FontScanline& sl = m_pFonts->get_gray8_scanline();
+    const unsigned char* data = &m_batchData.front();
+
+    std::vector<BatchedGlyph>::const_iterator it;
+    for (it = m_batch.begin(); it != m_batch.end(); ++it)
+    {
+        adaptor.init(data + (*it).offset, (*it).size, (*it).x, (*it).y);
+        m_pRenderer->render(adaptor, sl, (*it).color);
+    }
+    clear_batch();
+}
+
+//---------------------------------------------------------------------------------------
+void Calligrapher::clear_batch()
+{
+    //capacity is preserved for reusing memory in next batch
+    m_batch.clear();
+    m_batchData.clear();
+}
+
 
 //---------------------------------------------------------------------------------------
 // TextMeter implementation
@@ -163,6 +282,13 @@ TextMeter::TextMeter(LibraryScope& libraryScope)
 {
 }
 
+//---------------------------------------------------------------------------------------
+TextMeter::TextMeter(LibraryScope& libraryScope, FontStorage* pFonts)
+    : m_pFonts(pFonts)
+    , m_scale( libraryScope.get_screen_ppi() / 2540.0 )
+{
+}
+
 //---------------------------------------------------------------------------------------
 TextMeter::~TextMeter()
 {
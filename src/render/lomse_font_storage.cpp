@@ -96,6 +96,13 @@ FontStorage::~FontStorage()
 bool FontStorage::set_font(const std::string& fontFullName, double height,
                            EFontCacheType type)
 {
+    //nothing to do if requested font is already the current font
+    if (m_fValidFont && type == m_fontCacheType && height == m_fontHeight
+        && height == m_fontWidth && fontFullName == m_fontFullName)
+    {
+        return false;
+    }
+
     m_fValidFont = false;
     lomse::glyph_rendering gren = lomse::glyph_ren_agg_gray8;
     if(! m_fontEngine.select_font(fontFullName, 0, gren))
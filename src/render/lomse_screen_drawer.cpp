@@ -512,6 +512,13 @@ Drawer::Drawer(LibraryScope& libraryScope)
     m_pFonts = libraryScope.font_storage();
 }
 
+//---------------------------------------------------------------------------------------
+Drawer::Drawer(LibraryScope& libraryScope, FontStorage* pFonts)
+    : m_libraryScope(libraryScope)
+    , m_pFonts(pFonts)
+{
+}
+
 //---------------------------------------------------------------------------------------
 void Drawer::set_text_color(Color color)
 {
@@ -532,6 +539,16 @@ ScreenDrawer::ScreenDrawer(LibraryScope& libraryScope)
 {
 }
 
+//---------------------------------------------------------------------------------------
+ScreenDrawer::ScreenDrawer(LibraryScope& libraryScope, FontStorage* pFonts)
+    : Drawer(libraryScope, pFonts)
+    , m_pRenderer( RendererFactory::create_renderer(libraryScope, m_attr_storage, m_path) )
+    , m_pTextMeter(nullptr)
+    , m_pCalligrapher( LOMSE_NEW Calligrapher(m_pFonts, m_pRenderer) )
+    , m_numPaths(0)
+{
+}
+
 //---------------------------------------------------------------------------------------
 ScreenDrawer::~ScreenDrawer()
 {
@@ -809,6 +826,7 @@ void ScreenDrawer::render(FontRasterizer& ras, FontScanline& sl, Color color)
 //---------------------------------------------------------------------------------------
 void ScreenDrawer::gsv_text(double x, double y, const char* str)
 {
+    m_pCalligrapher->render_batch();
     m_pRenderer->render_gsv_text(x, y, str);
 }
 
@@ -844,11 +862,15 @@ bool ScreenDrawer::select_vector_font(const std::string& language,
 //---------------------------------------------------------------------------------------
 void ScreenDrawer::draw_glyph(double x, double y, unsigned int ch)
 {
-    render_existing_paths();
+    //glyphs are not rendered here but queued, to render them all in a single pass
+    //when paths are rendered. But pending paths must be rendered before, to
+    //preserve drawing order
+    if (m_numPaths > 0)
+        render();
 
     TransAffine& mtx = m_pRenderer->get_transform();
     mtx.transform(&x, &y);
-    m_pCalligrapher->draw_glyph(x, y, ch, m_textColor, m_pRenderer->get_scale());
+    m_pCalligrapher->add_glyph_to_batch(x, y, ch, m_textColor, m_pRenderer->get_scale());
 }
 
 //---------------------------------------------------------------------------------------
@@ -856,11 +878,13 @@ int ScreenDrawer::draw_text(double x, double y, const std::string& str)
 {
     //returns the number of chars drawn
 
-    render_existing_paths();
+    if (m_numPaths > 0)
+        render();
 
     TransAffine& mtx = m_pRenderer->get_transform();
     mtx.transform(&x, &y);
-    return m_pCalligrapher->draw_text(x, y, str, m_textColor, m_pRenderer->get_scale());
+    return m_pCalligrapher->add_text_to_batch(x, y, str, m_textColor,
+                                              m_pRenderer->get_scale());
 }
 
 //---------------------------------------------------------------------------------------
@@ -868,11 +892,13 @@ int ScreenDrawer::draw_text(double x, double y, const wstring& str)
 {
     //returns the number of chars drawn
 
-    render_existing_paths();
+    if (m_numPaths > 0)
+        render();
 
     TransAffine& mtx = m_pRenderer->get_transform();
     mtx.transform(&x, &y);
-    return m_pCalligrapher->draw_text(x, y, str, m_textColor, m_pRenderer->get_scale());
+    return m_pCalligrapher->add_text_to_batch(x, y, str, m_textColor,
+                                              m_pRenderer->get_scale());
 }
 
 ////---------------------------------------------------------------------------------------
@@ -1002,6 +1028,10 @@ Pixels ScreenDrawer::LUnits_to_Pixels(double value)
 //---------------------------------------------------------------------------------------
 void ScreenDrawer::reset(RenderingBuffer& buf, Color bgcolor)
 {
+    //glyphs still queued belong to a render pass not finished with render(). The
+    //previous buffer could be no longer valid: discard them
+    m_pCalligrapher->clear_batch();
+
     m_pRenderer->initialize(buf, bgcolor);
     delete_paths();
 }
@@ -1022,6 +1052,9 @@ void ScreenDrawer::set_transform(TransAffine& transform)
 //---------------------------------------------------------------------------------------
 void ScreenDrawer::render()
 {
+    //queued glyphs were drawn before any pending path
+    m_pCalligrapher->render_batch();
+
     m_pRenderer->render();
     delete_paths();
 }
@@ -1181,8 +1214,10 @@ void ScreenDrawer::rect(UPoint pos, USize size, LUnits radius)
 //------------------------------------------------------------------------
 void ScreenDrawer::render_existing_paths()
 {
-    if (m_path.total_vertices() > 0)
+    if (m_numPaths > 0)
         render();
+    else
+        m_pCalligrapher->render_batch();
 }
 
 //------------------------------------------------------------------------
@@ -0,0 +1,233 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2020. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+//---------------------------------------------------------------------------------------
+
+#include "lomse_tile_cache.h"
+
+#include "lomse_build_options.h"
+#include "lomse_pixel_formats.h"
+
+#include <algorithm>    //max, min
+#include <cstring>      //memcpy
+
+namespace lomse
+{
+
+//=======================================================================================
+// TileCache implementation
+//=======================================================================================
+TileCache::TileCache(int tileSize, size_t budget)
+    : m_tileSize(tileSize)
+    , m_bytesPerPixel(4)
+    , m_budget(budget)
+    , m_used(0)
+    , m_modelId(-1L)
+    , m_modelStamp(-1L)
+    , m_numHits(0)
+    , m_numMisses(0)
+{
+}
+
+//---------------------------------------------------------------------------------------
+TileCache::~TileCache()
+{
+    clear();
+}
+
+//---------------------------------------------------------------------------------------
+void TileCache::set_memory_budget(size_t bytes)
+{
+    m_budget = bytes;
+    evict_until(m_budget);
+}
+
+//---------------------------------------------------------------------------------------
+void TileCache::set_bytes_per_pixel(int bytes)
+{
+    if (bytes != m_bytesPerPixel)
+    {
+        clear();
+        m_bytesPerPixel = bytes;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void TileCache::validate(long modelId, long stamp)
+{
+    if (modelId != m_modelId || stamp != m_modelStamp)
+    {
+        clear();
+        m_modelId = modelId;
+        m_modelStamp = stamp;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void TileCache::clear()
+{
+    std::list<Tile*>::iterator it;
+    for (it = m_tiles.begin(); it != m_tiles.end(); ++it)
+        delete *it;
+
+    m_tiles.clear();
+    m_index.clear();
+    m_used = 0;
+}
+
+//---------------------------------------------------------------------------------------
+RenderingBuffer* TileCache::get_tile(double scale, int col, int row)
+{
+    std::map<TileKey, TileIterator>::iterator it = m_index.find(TileKey(scale, col, row));
+    if (it == m_index.end())
+    {
+        ++m_numMisses;
+        return nullptr;
+    }
+
+    ++m_numHits;
+    m_tiles.splice(m_tiles.begin(), m_tiles, it->second);
+    return &((*it->second)->rbuf);
+}
+
+//---------------------------------------------------------------------------------------
+void TileCache::add_tile(double scale, int col, int row, RenderingBuffer& src,
+                         int xSrc, int ySrc)
+{
+    size_t bytes = tile_bytes();
+    if (bytes == 0 || bytes > m_budget)
+        return;
+
+    TileKey key(scale, col, row);
+    std::map<TileKey, TileIterator>::iterator itIdx = m_index.find(key);
+    Tile* pTile;
+    if (itIdx != m_index.end())
+    {
+        pTile = *(itIdx->second);
+        m_tiles.splice(m_tiles.begin(), m_tiles, itIdx->second);
+    }
+    else
+    {
+        evict_until(m_budget - bytes);
+
+        pTile = LOMSE_NEW Tile(key);
+        pTile->pixels.resize(bytes);
+        pTile->rbuf.attach(&pTile->pixels[0], unsigned(m_tileSize),
+                           unsigned(m_tileSize), m_tileSize * m_bytesPerPixel);
+        m_tiles.push_front(pTile);
+        m_index[key] = m_tiles.begin();
+        m_used += bytes;
+    }
+
+    copy_pixels(src, xSrc, ySrc, pTile->rbuf, 0, 0, m_tileSize, m_tileSize,
+                m_bytesPerPixel);
+}
+
+//---------------------------------------------------------------------------------------
+void TileCache::evict_until(size_t bytes)
+{
+    while (m_used > bytes && !m_tiles.empty())
+    {
+        Tile* pTile = m_tiles.back();
+        m_index.erase(pTile->key);
+        m_tiles.pop_back();
+        m_used -= pTile->pixels.size();
+        delete pTile;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+RenderingBuffer& TileCache::get_scratch_buffer(int width, int height)
+{
+    size_t bytes = size_t(width) * size_t(height) * size_t(m_bytesPerPixel);
+    if (m_scratch.size() < bytes)
+        m_scratch.resize(bytes);
+
+    m_scratchBuf.attach(&m_scratch[0], unsigned(width), unsigned(height),
+                        width * m_bytesPerPixel);
+    return m_scratchBuf;
+}
+
+//---------------------------------------------------------------------------------------
+void TileCache::copy_pixels(RenderingBuffer& src, int xSrc, int ySrc,
+                            RenderingBuffer& dest, int xDest, int yDest,
+                            int width, int height, int bytesPerPixel)
+{
+    //clip to source bounds
+    int dx = std::max(0, -xSrc);
+    dx = std::max(dx, -xDest);
+    int dy = std::max(0, -ySrc);
+    dy = std::max(dy, -yDest);
+    xSrc += dx;
+    xDest += dx;
+    width -= dx;
+    ySrc += dy;
+    yDest += dy;
+    height -= dy;
+
+    //clip to destination bounds
+    width = std::min(width, int(src.width()) - xSrc);
+    width = std::min(width, int(dest.width()) - xDest);
+    height = std::min(height, int(src.height()) - ySrc);
+    height = std::min(height, int(dest.height()) - yDest);
+    if (width <= 0 || height <= 0)
+        return;
+
+    size_t rowBytes = size_t(width) * size_t(bytesPerPixel);
+    for (int y=0; y < height; ++y)
+    {
+        memcpy(dest.row_ptr(yDest + y) + xDest * bytesPerPixel,
+               src.row_ptr(ySrc + y) + xSrc * bytesPerPixel,
+               rowBytes);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+int TileCache::bytes_per_pixel(int pixelFormat)
+{
+    //only the formats supported by RendererFactory
+    switch(pixelFormat)
+    {
+        case k_pix_format_rgb555:
+        case k_pix_format_rgb565:
+            return 2;
+
+        case k_pix_format_rgb24:
+            return 3;
+
+        case k_pix_format_rgba32:
+        case k_pix_format_argb32:
+        case k_pix_format_bgra32:
+            return 4;
+
+        default:
+            return 0;
+    }
+}
+
+
+}  //namespace lomse
@@ -487,41 +487,28 @@ void SoundEventsTable::create_measures_table()
 }
 
 //---------------------------------------------------------------------------------------
-void SoundEventsTable::sort_by_time()
+//helper functor for ordering events by time, event type (priority) and measure.
+//Priority takes precedence over measure so that, at the same time, control events
+//placed in measure 0 (e.g. end of score) are still ordered by their priority.
+struct SoundEventLess
 {
-    // Sort events by time, measure and event type. Uses the bubble sort algorithm
-
-    int j, k;
-    bool fChanges;
-    int nNumElements = int(m_events.size());
-    SoundEvent* pEvAux;
-
-    for (int i = 0; i < nNumElements; i++)
+    bool operator()(const SoundEvent* a, const SoundEvent* b) const
     {
-        fChanges = false;
-        j = nNumElements - 1;
+        if (a->DeltaTime != b->DeltaTime)
+            return a->DeltaTime < b->DeltaTime;
+        if (a->EventType != b->EventType)
+            return a->EventType < b->EventType;
+        return a->Measure < b->Measure;
+    }
+};
 
-        while ( j != i )
-        {
-            k = j - 1;
-            if ((m_events[j]->DeltaTime < m_events[k]->DeltaTime) ||
-                ((m_events[j]->DeltaTime == m_events[k]->DeltaTime) &&
-                 ((m_events[j]->Measure < m_events[k]->Measure) ||
-                  (m_events[j]->EventType < m_events[k]->EventType))))
-            {
-                //interchange elements
-                pEvAux = m_events[j];
-                m_events[j] = m_events[k];
-                m_events[k] = pEvAux;
-                fChanges = true;
-            }
-            j = k;
-        }
+//---------------------------------------------------------------------------------------
+void SoundEventsTable::sort_by_time()
+{
+    // Sort events by time, event type and measure. The sort must be stable, as events
+    // with the same key must preserve creation order.
 
-        //If there were no changes in this loop step it implies that the table is ordered;
-        //in this case exit loop to save time
-        if (!fChanges) break;
-    }
+    std::stable_sort(m_events.begin(), m_events.end(), SoundEventLess());
 }
 
 //---------------------------------------------------------------------------------------
@@ -41,13 +41,103 @@
 #include "lomse_im_note.h"
 
 #include <algorithm>    //max(), min()
-#include <ctime>        //clock()
 
 
 namespace lomse
 {
 
+//=======================================================================================
+// PlaybackScheduler implementation
+//=======================================================================================
+PlaybackScheduler::PlaybackScheduler()
+    : m_epoch( Clock::now() )
+    , m_epochTime(0L)
+    , m_lastDeadline(m_epoch)
+    , m_fSpin(false)
+    , m_spinMargin(1000)
+    , m_numEvents(0L)
+    , m_totalLateness(0LL)
+    , m_maxLateness(0L)
+    , m_lastLateness(0L)
+{
+}
+
+//---------------------------------------------------------------------------------------
+void PlaybackScheduler::start(long time)
+{
+    //events time 'time' is now
+    m_epoch = Clock::now();
+    m_epochTime = time;
+    m_lastDeadline = m_epoch;
+    reset_statistics();
+}
+
+//---------------------------------------------------------------------------------------
+void PlaybackScheduler::reanchor(long time)
+{
+    //events time 'time' is the deadline of last event
+    m_epoch = m_lastDeadline;
+    m_epochTime = time;
+}
+
 //---------------------------------------------------------------------------------------
+void PlaybackScheduler::resume(long time)
+{
+    //after a pause, the timeline continues from current real time
+    m_epoch = Clock::now();
+    m_epochTime = time;
+    m_lastDeadline = m_epoch;
+}
+
+//---------------------------------------------------------------------------------------
+PlaybackScheduler::Clock::time_point PlaybackScheduler::deadline_for(long time) const
+{
+    return m_epoch + std::chrono::milliseconds(time - m_epochTime);
+}
+
+//---------------------------------------------------------------------------------------
+void PlaybackScheduler::wait_until(long time)
+{
+    Clock::time_point deadline = deadline_for(time);
+    if (m_fSpin)
+    {
+        //sleep_until() wake up depends on OS sleep granularity. Sleep until
+        //shortly before the deadline and spin for the remaining time
+        std::this_thread::sleep_until(deadline - m_spinMargin);
+        while (Clock::now() < deadline)
+            std::this_thread::yield();
+    }
+    else
+        std::this_thread::sleep_until(deadline);
+
+    m_lastDeadline = deadline;
+
+    //update lateness statistics
+    long lateness = long( std::chrono::duration_cast<std::chrono::microseconds>(
+                                Clock::now() - deadline).count() );
+    m_lastLateness = lateness;
+    m_totalLateness += lateness;
+    if (lateness > m_maxLateness)
+        m_maxLateness = lateness;
+    ++m_numEvents;
+
+    LOMSE_LOG_DEBUG(Logger::k_score_player, "event time=%ld, lateness=%ld us",
+                    time, lateness);
+}
+
+//---------------------------------------------------------------------------------------
+void PlaybackScheduler::reset_statistics()
+{
+    m_numEvents = 0L;
+    m_totalLateness = 0LL;
+    m_maxLateness = 0L;
+    m_lastLateness = 0L;
+}
+
+
+//=======================================================================================
+// ScorePlayer implementation
+//=======================================================================================
 ScorePlayer::ScorePlayer(LibraryScope& libScope, MidiServerBase* pMidi)
     : m_libScope(libScope)
     , m_pThread(nullptr)
@@ -497,6 +587,7 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
     //pulses before first anacruxis note, or full measure if no anacruxis.
     //At least two pulses.
     bool fSendMtrOff = false;                //if true, next metronome event is start
+    m_scheduler.start(0L);
     if (fCountOff)
     {
         //determine num pulses
@@ -543,14 +634,17 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
             numPulses += m_nCurNumPulses;
 
         //generate the pulses
+        long pulseTime = 0L;
+        long halfPulse = m_nCurMtrIntval/2L;
         for (int j=numPulses; j > 1; --j)
         {
             //generate click
             m_pMidi->note_on(m_MtrChannel, m_MtrTone2, 127);
-            std::chrono::milliseconds waitTime(m_nCurMtrIntval/2L);
-            std::this_thread::sleep_for(waitTime);
+            pulseTime += halfPulse;
+            m_scheduler.wait_until(pulseTime);
             m_pMidi->note_off(m_MtrChannel, m_MtrTone2, 127);
-            std::this_thread::sleep_for(waitTime);
+            pulseTime += halfPulse;
+            m_scheduler.wait_until(pulseTime);
         }
 
         //generate final metronome click before real events
@@ -564,6 +658,9 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
                         "end of count-off: nMtrEvDeltaTime=%ld", nMtrEvDeltaTime);
     }
 
+    //events timeline starts now, or at the final count-off click
+    m_scheduler.reanchor(curTime);
+
     //loop to process events
     do
     {
@@ -581,10 +678,8 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
             if (curTime < nEvTime)
             {
                 //flush pending events
-                long elapsed = 0L;
                 if (fVisualTracking && pEvent->get_num_items() > 0)
                 {
-                    clock_t t1=clock();
                     if (m_fPostEvents)
                         m_libScope.post_event(pEvent);
                     else if (pInteractor)
@@ -592,20 +687,13 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
                     pEvent = SpEventVisualTracking(
                                 LOMSE_NEW EventVisualTracking(wpInteractor,
                                                               m_pScore->get_id()) );
-                    clock_t t2=clock();
-                    elapsed = long( ((t2-t1)*1000.0)/double(CLOCKS_PER_SEC));
                 }
 
                 //wait for current time
-                long waitT = nEvTime - curTime - elapsed;
-                if (waitT > 0L)
-                {
-                    std::chrono::milliseconds waitTime(waitT);
-                    std::this_thread::sleep_for(waitTime);
-                }
+                m_scheduler.wait_until(nEvTime);
                 curTime = nEvTime;
-                LOMSE_LOG_DEBUG(Logger::k_score_player, "flush pending events: waitT=%ld, new curTime=%ld",
-                                waitT, curTime);
+                LOMSE_LOG_DEBUG(Logger::k_score_player, "flush pending events: new curTime=%ld",
+                                curTime);
             }
 
             if (fSendMtrOff)
@@ -662,12 +750,10 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
             if (nEvTime > curTime)
             {
                 //flush accumulated events for curTime
-                long elapsed = 0L;
                 if (fVisualTracking && pEvent->get_num_items() > 0)
                 {
                     LOMSE_LOG_DEBUG(Logger::k_events | Logger::k_score_player,
                                     "Flush pending events");
-                    clock_t t1=clock();
                     if (m_fPostEvents)
                         m_libScope.post_event(pEvent);
                     else if (pInteractor)
@@ -675,17 +761,10 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
                     pEvent = SpEventVisualTracking(
                                 LOMSE_NEW EventVisualTracking(wpInteractor,
                                                               m_pScore->get_id()) );
-                    clock_t t2=clock();
-                    elapsed = long( ((t2-t1)*1000.0)/double(CLOCKS_PER_SEC));
                 }
 
                 //wait until new time arrives
-                long waitT = nEvTime - curTime - elapsed;
-                if (waitT > 0L)
-                {
-                    std::chrono::milliseconds waitTime(waitT);
-                    std::this_thread::sleep_for(waitTime);
-                }
+                m_scheduler.wait_until(nEvTime);
             }
 
             //if it is a jump event, execute the jump if applicable
@@ -701,6 +780,7 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
                         i = pJump->get_event();
                         nEvTime = time_units_to_milliseconds( events[i]->DeltaTime );
                         curTime = nEvTime;
+                        m_scheduler.reanchor(curTime);
                         nMtrEvDeltaTime = events[i]->DeltaTime;
                         if (pJump->get_times_valid() > pJump->get_executed())
                             pJump->increment_applied();
@@ -854,14 +934,18 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
             LOMSE_LOG_DEBUG(Logger::k_score_player, "Going to finish 1");
             break;
         }
-        while(m_fPaused)
+        if (m_fPaused)
         {
-            std::this_thread::sleep_for( std::chrono::milliseconds(200) );
-            if (m_fShouldStop)
+            while(m_fPaused)
             {
-                LOMSE_LOG_DEBUG(Logger::k_score_player, "Going to finish 2");
-                break;
+                std::this_thread::sleep_for( std::chrono::milliseconds(200) );
+                if (m_fShouldStop)
+                {
+                    LOMSE_LOG_DEBUG(Logger::k_score_player, "Going to finish 2");
+                    break;
+                }
             }
+            m_scheduler.resume(curTime);
         }
 
         //update metronome information, just in case metronome was updated
@@ -875,8 +959,12 @@ void ScorePlayer::do_play(int nEvStart, int nEvEnd, bool fVisualTracking,
                 m_conversionFactor *= factor;
                 m_nPrevMtrIntval = long( float(m_nPrevMtrIntval) * factor);
                 m_nCurMtrIntval = newMtrClickIntval;
-                curTime = time_units_to_milliseconds( events[i-1]->DeltaTime );
                 m_prevGuiBpm = curGuiBpm;
+
+                //convert current time to the new tempo and continue from the deadline
+                //of last event
+                curTime = long( float(curTime) * factor );
+                m_scheduler.reanchor(curTime);
             }
         }
         fPlayWithMetronome = m_pPlayerGui->metronome_status();
@@ -1815,6 +1815,41 @@ SUITE(DocCommandTest)
         CHECK( pNote->get_stem_direction() == k_stem_down );
     }
 
+    TEST_FIXTURE(DocCommandTestFixture, change_attribute_int_1405)
+    {
+        //executer reports modified objects
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument#121 (musicData "
+            "(clef G)(n c4 q (stem up))"
+            ")))");
+        doc.clear_dirty();
+        DocCursor cursor(&doc);
+        DocCommandExecuter executer(&doc);
+        cursor.enter_element();     //points to clef
+        cursor.move_next();         //points to note
+        ImoObj* pImo = *cursor;
+        DocCommand* pCmd = LOMSE_NEW CmdChangeAttribute(k_attr_stem_type,
+                                                        k_stem_down,
+                                                        "Toggle note stem");
+
+        MySelectionSet sel(&doc);
+        CHECK( executer.get_dirty_ids().empty() == true );
+        executer.execute(&cursor, pCmd, &sel);
+
+        CHECK( executer.get_dirty_ids().size() == 1 );
+        CHECK( executer.get_dirty_ids().front() == pImo->get_id() );
+        CHECK( pImo->is_dirty() == false );
+        CHECK( doc.get_im_root()->are_children_dirty() == false );
+
+        executer.clear_dirty_ids();
+        executer.undo(&cursor, &sel);
+        CHECK( executer.get_dirty_ids().size() == 1 );
+        CHECK( executer.get_dirty_ids().front() == pImo->get_id() );
+
+        executer.redo(&cursor, &sel);
+        CHECK( executer.get_dirty_ids().size() == 2 );
+    }
+
     // CmdChangeDots --------------------------------------------------------------------
 
     TEST_FIXTURE(DocCommandTestFixture, change_dots_1501)
@@ -5184,4 +5219,263 @@ SUITE(DocCommandTest)
         CHECK( pNote && pNote->get_notated_accidentals() == k_no_accidentals );
     }
 
+    // Undo checkpoints -----------------------------------------------------------------
+
+    TEST_FIXTURE(DocCommandTestFixture, undo_checkpoint_01)
+    {
+        //@01. Full checkpoint restored from snapshot. Ids preserved
+
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument#121 (musicData "
+            "(clef G)(n e4 e g+)(n f4 e g-)(n g4 q l)(barline)(n g4 q)"
+            ")))");
+        LdpExporter exporter(&m_libraryScope);
+        exporter.set_add_id(true);
+        string source = exporter.get_source( doc.get_im_root()->get_content_item(0) );
+
+        MySelectionSet sel(&doc);
+        DocCursor cursor(&doc);
+        cursor.enter_element();     //points to clef
+        ++cursor;       //n e4
+        ImoId idNote = (*cursor)->get_id();
+        sel.debug_add(*cursor);
+        DocCommandExecuter executer(&doc);
+        executer.execute(&cursor, LOMSE_NEW CmdDeleteSelection(), &sel);
+
+        executer.undo(&cursor, &sel);
+
+        ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        CHECK( exporter.get_source(pScore) == source );
+        CHECK( doc.get_pointer_to_imo(idNote) != nullptr );
+        CHECK( pScore->get_staffobjs_table()->num_entries() == 6 );
+    }
+
+    TEST_FIXTURE(DocCommandTestFixture, undo_checkpoint_02)
+    {
+        //@02. Text checkpoints when snapshots disabled. Same result
+
+        m_libraryScope.set_undo_snapshots(false);
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument#121 (musicData "
+            "(clef G)(n e4 e g+)(n f4 e g-)(n g4 q l)(barline)(n g4 q)"
+            ")))");
+        LdpExporter exporter(&m_libraryScope);
+        exporter.set_add_id(true);
+        string source = exporter.get_source( doc.get_im_root()->get_content_item(0) );
+
+        MySelectionSet sel(&doc);
+        DocCursor cursor(&doc);
+        cursor.enter_element();     //points to clef
+        ++cursor;       //n e4
+        ImoId idNote = (*cursor)->get_id();
+        sel.debug_add(*cursor);
+        DocCommandExecuter executer(&doc);
+        executer.execute(&cursor, LOMSE_NEW CmdDeleteSelection(), &sel);
+
+        executer.undo(&cursor, &sel);
+
+        ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        CHECK( exporter.get_source(pScore) == source );
+        CHECK( doc.get_pointer_to_imo(idNote) != nullptr );
+        CHECK( pScore->get_staffobjs_table()->num_entries() == 6 );
+    }
+
+    // Undo history memory --------------------------------------------------------------
+
+    TEST_FIXTURE(DocCommandTestFixture, undo_history_01)
+    {
+        //@01. Budget exceeded. Checkpoints saved as compressed deltas. Undo restores
+        //@    all of them
+
+        m_libraryScope.set_undo_snapshots(false);
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument#121 (musicData "
+            "(clef G)(n e4 q)(n f4 q)(n g4 q)(n a4 q)(barline)"
+            ")))");
+        LdpExporter exporter(&m_libraryScope);
+        exporter.set_add_id(true);
+        DocCursor cursor(&doc);
+        MySelectionSet sel(&doc);
+        DocCommandExecuter executer(&doc);
+        executer.set_undo_memory_budget( 2 * doc.get_checkpoint_data().size() );
+        cursor.enter_element();     //points to clef
+        vector<string> sources;
+        for (int i=0; i < 3; ++i)
+        {
+            sources.push_back( exporter.get_source(doc.get_im_root()->get_content_item(0)) );
+            cursor.move_next();
+            executer.execute(&cursor, LOMSE_NEW CmdAddNoteRest("(n c5 q v1)",
+                                                               k_edit_mode_replace), &sel);
+        }
+        size_t memory = executer.get_undo_memory_size();
+        CHECK( executer.undo_stack_size() == 3 );
+        CHECK( memory > 0 );
+        CHECK( memory < 3 * sources[0].size() );
+
+        for (int i=2; i >= 0; --i)
+        {
+            executer.undo(&cursor, &sel);
+            CHECK( exporter.get_source(doc.get_im_root()->get_content_item(0)) == sources[i] );
+        }
+        CHECK( executer.get_undo_memory_size() == memory );
+    }
+
+    TEST_FIXTURE(DocCommandTestFixture, undo_history_02)
+    {
+        //@02. New command after undo. Checkpoint based on deleted redo history
+
+        m_libraryScope.set_undo_snapshots(false);
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument#121 (musicData "
+            "(clef G)(n e4 q)(n f4 q)(n g4 q)(n a4 q)(barline)"
+            ")))");
+        LdpExporter exporter(&m_libraryScope);
+        exporter.set_add_id(true);
+        DocCursor cursor(&doc);
+        MySelectionSet sel(&doc);
+        DocCommandExecuter executer(&doc);
+        cursor.enter_element();     //points to clef
+        cursor.move_next();         //points to e4
+        string source = exporter.get_source(doc.get_im_root()->get_content_item(0));
+        executer.execute(&cursor, LOMSE_NEW CmdAddNoteRest("(n c5 q v1)",
+                                                           k_edit_mode_replace), &sel);
+        executer.execute(&cursor, LOMSE_NEW CmdAddNoteRest("(n d5 q v1)",
+                                                           k_edit_mode_replace), &sel);
+        executer.set_undo_memory_budget( executer.get_undo_memory_size() - 1 );
+        CHECK( executer.undo_stack_size() == 2 );
+        executer.undo(&cursor, &sel);
+        executer.execute(&cursor, LOMSE_NEW CmdAddNoteRest("(n e5 q v1)",
+                                                           k_edit_mode_replace), &sel);
+        CHECK( executer.undo_stack_size() == 2 );
+        CHECK( executer.is_redo_possible() == false );
+
+        executer.undo(&cursor, &sel);
+        executer.undo(&cursor, &sel);
+        CHECK( exporter.get_source(doc.get_im_root()->get_content_item(0)) == source );
+    }
+
+    TEST_FIXTURE(DocCommandTestFixture, undo_history_03)
+    {
+        //@03. When memory budget exceeded, checkpoints are compressed and, if not
+        //@    enough, oldest undo elements are removed
+
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument#121 (musicData "
+            "(clef G)(n e4 q)(n f4 q)(n g4 q)(n a4 q)(barline)"
+            ")))");
+        DocCursor cursor(&doc);
+        MySelectionSet sel(&doc);
+        DocCommandExecuter executer(&doc);
+        cursor.enter_element();     //points to clef
+        for (int i=0; i < 4; ++i)
+        {
+            cursor.move_next();
+            executer.execute(&cursor, LOMSE_NEW CmdAddNoteRest("(n c5 q v1)",
+                                                               k_edit_mode_replace), &sel);
+        }
+        CHECK( executer.undo_stack_size() == 4 );
+        size_t memory = executer.get_undo_memory_size();
+
+        executer.set_undo_memory_budget(memory / 2);
+
+        CHECK( executer.get_undo_memory_budget() == memory / 2 );
+        CHECK( executer.undo_stack_size() == 4 );
+        size_t packed = executer.get_undo_memory_size();
+        CHECK( packed <= memory / 2 );
+
+        executer.set_undo_memory_budget(packed - 1);
+
+        CHECK( executer.undo_stack_size() < 4 );
+        CHECK( executer.undo_stack_size() >= 1 );
+        CHECK( executer.undo_stack_size() == 1
+               || executer.get_undo_memory_size() <= packed - 1 );
+
+        executer.set_undo_memory_budget(1);
+        CHECK( executer.undo_stack_size() == 1 );
+        CHECK( executer.is_undo_possible() == true );
+    }
+
+    TEST_FIXTURE(DocCommandTestFixture, undo_history_04)
+    {
+        //@04. No budget. Checkpoints are kept as snapshots, not compressed
+
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument#121 (musicData "
+            "(clef G)(n e4 q)(n f4 q)(n g4 q)(n a4 q)(barline)"
+            ")))");
+        LdpExporter exporter(&m_libraryScope);
+        exporter.set_add_id(true);
+        DocCursor cursor(&doc);
+        MySelectionSet sel(&doc);
+        DocCommandExecuter executer(&doc);
+        cursor.enter_element();     //points to clef
+        vector<string> sources;
+        vector<DocCommand*> commands;
+        for (int i=0; i < 3; ++i)
+        {
+            sources.push_back( exporter.get_source(doc.get_im_root()->get_content_item(0)) );
+            cursor.move_next();
+            commands.push_back( LOMSE_NEW CmdAddNoteRest("(n c5 q v1)",
+                                                         k_edit_mode_replace) );
+            executer.execute(&cursor, commands.back(), &sel);
+        }
+        CHECK( commands[0]->is_checkpoint_packed() == false );
+        CHECK( commands[1]->is_checkpoint_packed() == false );
+        CHECK( commands[2]->is_checkpoint_packed() == false );
+        CHECK( executer.get_undo_memory_size() ==
+               commands[0]->get_checkpoint_memory() + commands[1]->get_checkpoint_memory()
+               + commands[2]->get_checkpoint_memory() );
+
+        for (int i=2; i >= 0; --i)
+        {
+            executer.undo(&cursor, &sel);
+            CHECK( exporter.get_source(doc.get_im_root()->get_content_item(0)) == sources[i] );
+        }
+    }
+
+    TEST_FIXTURE(DocCommandTestFixture, undo_history_05)
+    {
+        //@05. Budget exceeded. Snapshots, but the last one, are replaced by
+        //@    compressed deltas
+
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument#121 (musicData "
+            "(clef G)(n e4 q)(n f4 q)(n g4 q)(n a4 q)(barline)"
+            ")))");
+        LdpExporter exporter(&m_libraryScope);
+        exporter.set_add_id(true);
+        DocCursor cursor(&doc);
+        MySelectionSet sel(&doc);
+        DocCommandExecuter executer(&doc);
+        size_t budget = 0;
+        cursor.enter_element();     //points to clef
+        vector<string> sources;
+        vector<DocCommand*> commands;
+        for (int i=0; i < 3; ++i)
+        {
+            sources.push_back( exporter.get_source(doc.get_im_root()->get_content_item(0)) );
+            cursor.move_next();
+            commands.push_back( LOMSE_NEW CmdAddNoteRest("(n c5 q v1)",
+                                                         k_edit_mode_replace) );
+            executer.execute(&cursor, commands.back(), &sel);
+            if (i == 0)
+            {
+                budget = 2 * commands[0]->get_checkpoint_memory();
+                executer.set_undo_memory_budget(budget);
+            }
+        }
+        CHECK( executer.undo_stack_size() == 3 );
+        CHECK( executer.get_undo_memory_size() <= budget );
+        CHECK( commands[0]->is_checkpoint_packed() == true );
+        CHECK( commands[1]->is_checkpoint_packed() == true );
+        CHECK( commands[2]->is_checkpoint_packed() == false );
+        CHECK( commands[0]->get_checkpoint_memory() < commands[2]->get_checkpoint_memory() );
+
+        for (int i=2; i >= 0; --i)
+        {
+            executer.undo(&cursor, &sel);
+            CHECK( exporter.get_source(doc.get_im_root()->get_content_item(0)) == sources[i] );
+        }
+    }
+
 }
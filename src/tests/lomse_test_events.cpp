@@ -38,6 +38,7 @@
 #include "lomse_events.h"
 #include "lomse_hyperlink_ctrl.h"
 #include "lomse_button_ctrl.h"
+#include "lomse_events_dispatcher.h"
 
 using namespace UnitTest;
 using namespace std;
@@ -118,6 +119,33 @@ public:
     bool event_received() { return m_fEventReceived; }
 };
 
+//---------------------------------------------------------------------------------------
+class MyTrackingHandler : public EventHandler
+{
+protected:
+    int m_numEvents;
+    int m_numItems;
+
+public:
+    MyTrackingHandler() : m_numEvents(0), m_numItems(0) {}
+    ~MyTrackingHandler() {}
+
+    //mandatory override
+    void handle_event(SpEventInfo pEvent)
+    {
+        ++m_numEvents;
+        if (pEvent->is_tracking_event())
+        {
+            SpEventVisualTracking pEv(
+                    static_pointer_cast<EventVisualTracking>(pEvent) );
+            m_numItems += pEv->get_num_items();
+        }
+    }
+
+    int num_events() { return m_numEvents; }
+    int num_items() { return m_numItems; }
+};
+
 //---------------------------------------------------------------------------------------
 class DocumentEventsTestFixture
 {
@@ -228,6 +256,106 @@ SUITE(DocumentEventsTest)
         CHECK( handler.event_received() == true );
     }
 
+    TEST_FIXTURE(DocumentEventsTestFixture, dispatcher_direct_invocation)
+    {
+        SpDocument spDoc( new MyDocument(m_libraryScope) );
+        spDoc->create_empty();
+        ImoParagraph* pPara = spDoc->add_paragraph();
+        ImoLink* pLink = pPara->add_link("Click me");
+        MyTrackingHandler handler;
+        pLink->add_event_handler(k_tracking_event, &handler);
+        MyDocument* pDoc = static_cast<MyDocument*>( spDoc.get() );
+        Observer* pObserver = pDoc->my_get_first_observer();
+
+        EventsDispatcher dispatcher;
+        dispatcher.start_events_loop();
+        SpEventVisualTracking pEv( new EventVisualTracking(WpInteractor(), 1L) );
+        pEv->add_item(EventVisualTracking::k_highlight_on, 20L);
+        dispatcher.post_event(pObserver, pEv);
+
+        CHECK( handler.num_events() == 1 );
+        CHECK( dispatcher.get_queue_depth() == 0 );
+        CHECK( dispatcher.get_num_posted_events() == 0 );   //no statistics
+        dispatcher.stop_events_loop();
+    }
+
+    TEST_FIXTURE(DocumentEventsTestFixture, dispatcher_queued_mode_in_library_scope)
+    {
+        SpDocument spDoc( new MyDocument(m_libraryScope) );
+        spDoc->create_empty();
+        ImoParagraph* pPara = spDoc->add_paragraph();
+        ImoLink* pLink = pPara->add_link("Click me");
+        MyTrackingHandler handler;
+        pLink->add_event_handler(k_tracking_event, &handler);
+        MyDocument* pDoc = static_cast<MyDocument*>( spDoc.get() );
+        Observer* pObserver = pDoc->my_get_first_observer();
+
+        {
+            stringstream errormsg;
+            LibraryScope libraryScope(errormsg);
+            CHECK( libraryScope.use_queued_events() == false );
+            libraryScope.set_queued_events(true);
+            EventsDispatcher* pDispatcher = libraryScope.get_events_dispatcher();
+            SpEventVisualTracking pEv( new EventVisualTracking(WpInteractor(), 1L) );
+            pEv->add_item(EventVisualTracking::k_highlight_on, 20L);
+            pDispatcher->post_event(pObserver, pEv);
+
+            CHECK( pDispatcher->get_num_posted_events() == 1 );
+
+            //once the dispatcher is created the mode can not be changed
+            libraryScope.set_queued_events(false);
+
+            CHECK( libraryScope.use_queued_events() == true );
+            CHECK( libraryScope.get_events_dispatcher() == pDispatcher );
+        }
+
+        //pending events are dispatched when the dispatcher is deleted
+        CHECK( handler.num_events() == 1 );
+    }
+
+    TEST_FIXTURE(DocumentEventsTestFixture, dispatcher_coalesces_events)
+    {
+        SpDocument spDoc( new MyDocument(m_libraryScope) );
+        spDoc->create_empty();
+        ImoParagraph* pPara = spDoc->add_paragraph();
+        ImoLink* pLink = pPara->add_link("Click me");
+        MyTrackingHandler handler;
+        pLink->add_event_handler(k_tracking_event, &handler);
+        pLink->add_event_handler(k_update_viewport_event, &handler);
+        MyDocument* pDoc = static_cast<MyDocument*>( spDoc.get() );
+        Observer* pObserver = pDoc->my_get_first_observer();
+
+        //events are queued as the dispatch loop is not yet started
+        EventsDispatcher dispatcher(false);
+        for (int i=0; i < 3; ++i)
+        {
+            SpEventVisualTracking pEv( new EventVisualTracking(WpInteractor(), 1L) );
+            pEv->add_item(EventVisualTracking::k_highlight_off, 20L + i);
+            pEv->add_item(EventVisualTracking::k_highlight_on, 21L + i);
+            pEv->add_move_tempo_line_event(64.0 * i);
+            dispatcher.post_event(pObserver, pEv);
+        }
+        for (int i=0; i < 2; ++i)
+        {
+            SpEventInfo pEv( new EventUpdateViewport(WpInteractor(), 100 * i, 0) );
+            dispatcher.post_event(pObserver, pEv);
+        }
+
+        CHECK( dispatcher.get_queue_depth() == 2 );
+        CHECK( dispatcher.get_num_posted_events() == 5 );
+        CHECK( dispatcher.get_num_coalesced_events() == 3 );
+        CHECK( handler.num_events() == 0 );
+
+        //pending events are dispatched before stopping the loop
+        dispatcher.start_events_loop();
+        dispatcher.stop_events_loop();
+
+        CHECK( dispatcher.get_queue_depth() == 0 );
+        CHECK( dispatcher.get_num_dispatched_events() == 2 );
+        CHECK( handler.num_events() == 2 );
+        CHECK( handler.num_items() == 7 );      //six highlight + one tempo line
+    }
+
 ////    TEST_FIXTURE(DocumentEventsTestFixture, ReplaceHandler)
 ////    {
 ////        Document doc(m_libraryScope);
@@ -274,6 +274,136 @@ SUITE(GmoTest)
         delete pInfo;
     }
 
+    TEST_FIXTURE(GmoTestFixture, DocPage_FindShapeAtReturnsTopShape)
+    {
+        Document doc(m_libraryScope);
+        MyGmoBoxDocPage page(nullptr);
+        GmoBoxDocPageContent* pDPC = LOMSE_NEW GmoBoxDocPageContent(nullptr);
+        page.add_child_box(pDPC);
+        GmoBoxScorePage* pScorePage = LOMSE_NEW GmoBoxScorePage(nullptr);
+        pDPC->add_child_box(pScorePage);
+        GmoBoxSystem* pBox = LOMSE_NEW GmoBoxSystem(nullptr);
+        ImoStaffInfo* pInfo = static_cast<ImoStaffInfo*>(
+                                    ImFactory::inject(k_imo_staff_info, &doc));
+        GmoShapeStaff* pShape0 = LOMSE_NEW GmoShapeStaff(pInfo, 0, pInfo, 0, 200.0f, Color(0,0,0));
+        pBox->add_shape(pShape0, 2);
+        GmoShapeStaff* pShape1 = LOMSE_NEW GmoShapeStaff(pInfo, 1, pInfo, 0, 200.0f, Color(0,0,0));
+        pBox->add_shape(pShape1, 1);
+        GmoShapeStaff* pShape2 = LOMSE_NEW GmoShapeStaff(pInfo, 2, pInfo, 0, 200.0f, Color(0,0,0));
+        pBox->add_shape(pShape2, 2);
+        GmoShapeStaff* pShape3 = LOMSE_NEW GmoShapeStaff(pInfo, 3, pInfo, 0, 200.0f, Color(0,0,0));
+        pBox->add_shape(pShape3, 3);
+        pShape3->set_origin(5000.0f, 0.0f);
+
+        pScorePage->add_system(pBox, 0);
+        pBox->add_shapes_to_tables();
+
+        CHECK( page.find_shape_at(10.0f, 10.0f) == pShape2 );
+        CHECK( page.find_shape_at(5010.0f, 10.0f) == pShape3 );
+        CHECK( page.find_shape_at(3000.0f, 10.0f) == nullptr );
+        delete pInfo;
+    }
+
+    TEST_FIXTURE(GmoTestFixture, DocPage_FindShapeAtAfterMovingShape)
+    {
+        Document doc(m_libraryScope);
+        MyGmoBoxDocPage page(nullptr);
+        GmoBoxDocPageContent* pDPC = LOMSE_NEW GmoBoxDocPageContent(nullptr);
+        page.add_child_box(pDPC);
+        GmoBoxScorePage* pScorePage = LOMSE_NEW GmoBoxScorePage(nullptr);
+        pDPC->add_child_box(pScorePage);
+        GmoBoxSystem* pBox = LOMSE_NEW GmoBoxSystem(nullptr);
+        ImoStaffInfo* pInfo = static_cast<ImoStaffInfo*>(
+                                    ImFactory::inject(k_imo_staff_info, &doc));
+        GmoShapeStaff* pShape0 = LOMSE_NEW GmoShapeStaff(pInfo, 0, pInfo, 0, 200.0f, Color(0,0,0));
+        pBox->add_shape(pShape0, 2);
+        GmoShapeStaff* pShape1 = LOMSE_NEW GmoShapeStaff(pInfo, 1, pInfo, 0, 200.0f, Color(0,0,0));
+        pBox->add_shape(pShape1, 2);
+        pShape1->set_origin(5000.0f, 0.0f);
+
+        pScorePage->add_system(pBox, 0);
+        pBox->add_shapes_to_tables();
+        page.build_shapes_index();
+
+        CHECK( pShape1->is_in_shapes_index() == true );
+        CHECK( page.find_shape_at(5010.0f, 10.0f) == pShape1 );
+
+        pShape1->set_origin(8000.0f, 0.0f);
+
+        CHECK( page.find_shape_at(5010.0f, 10.0f) == nullptr );
+        CHECK( page.find_shape_at(8010.0f, 10.0f) == pShape1 );
+
+        pShape0->set_width(6000.0f);
+
+        CHECK( page.find_shape_at(5010.0f, 10.0f) == pShape0 );
+        delete pInfo;
+    }
+
+    TEST_FIXTURE(GmoTestFixture, DocPage_FindShapeAtManyShapes)
+    {
+        Document doc(m_libraryScope);
+        MyGmoBoxDocPage page(nullptr);
+        GmoBoxDocPageContent* pDPC = LOMSE_NEW GmoBoxDocPageContent(nullptr);
+        page.add_child_box(pDPC);
+        GmoBoxScorePage* pScorePage = LOMSE_NEW GmoBoxScorePage(nullptr);
+        pDPC->add_child_box(pScorePage);
+        GmoBoxSystem* pBox = LOMSE_NEW GmoBoxSystem(nullptr);
+        ImoStaffInfo* pInfo = static_cast<ImoStaffInfo*>(
+                                    ImFactory::inject(k_imo_staff_info, &doc));
+        vector<GmoShape*> shapes;
+        for (int i=0; i < 500; ++i)
+        {
+            GmoShapeStaff* pShape = LOMSE_NEW GmoShapeStaff(pInfo, i, pInfo, 0, 50.0f, Color(0,0,0));
+            pBox->add_shape(pShape, i % 3);
+            pShape->set_origin(100.0f * (i % 25), 1000.0f * (i / 25));
+            shapes.push_back(pShape);
+        }
+        pScorePage->add_system(pBox, 0);
+        pBox->add_shapes_to_tables();
+
+        bool fAllFound = true;
+        for (int i=0; i < 500; ++i)
+        {
+            LUnits x = shapes[i]->get_left() + 10.0f;
+            LUnits y = shapes[i]->get_top() + 10.0f;
+            fAllFound &= (page.find_shape_at(x, y) == shapes[i]);
+            fAllFound &= (page.find_shape_at(x + 60.0f, y) == nullptr);
+        }
+        CHECK( fAllFound == true );
+        delete pInfo;
+    }
+
+    TEST_FIXTURE(GmoTestFixture, ShapesIndex_FindShapesInRectangle)
+    {
+        Document doc(m_libraryScope);
+        ImoStaffInfo* pInfo = static_cast<ImoStaffInfo*>(
+                                    ImFactory::inject(k_imo_staff_info, &doc));
+        std::list<GmoShape*> shapes;
+        for (int i=0; i < 100; ++i)
+        {
+            GmoShapeStaff* pShape = LOMSE_NEW GmoShapeStaff(pInfo, i, pInfo, 0, 50.0f, Color(0,0,0));
+            pShape->set_origin(100.0f * i, 0.0f);
+            shapes.push_back(pShape);
+        }
+        GmShapesIndex index;
+        index.build(shapes);
+
+        vector<GmoShape*> found;
+        index.find_shapes_in_rectangle(URect(950.0f, -100.0f, 320.0f, 2000.0f), found);
+
+        //shapes 10, 11 and 12 are fully included. Returned in reverse z-order
+        CHECK( found.size() == 3 );
+        CHECK( found.size() == 3 && found[0]->get_left() == 1200.0f );
+        CHECK( found.size() == 3 && found[2]->get_left() == 1000.0f );
+        CHECK( index.get_num_entries() == 100 );
+        CHECK( index.find_shape_for_object(pInfo) == shapes.front() );
+
+        std::list<GmoShape*>::iterator it;
+        for (it = shapes.begin(); it != shapes.end(); ++it)
+            delete *it;
+        delete pInfo;
+    }
+
     TEST_FIXTURE(GmoTestFixture, Shape_SetOrigin)
     {
         Document doc(m_libraryScope);
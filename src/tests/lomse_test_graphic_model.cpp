@@ -49,6 +49,8 @@
 #include "lomse_model_builder.h"
 #include "lomse_im_factory.h"
 #include "lomse_timegrid_table.h"
+#include "lomse_document_layouter.h"
+#include "lomse_shapes.h"
 
 using namespace UnitTest;
 using namespace std;
@@ -759,6 +761,88 @@ SUITE(GraphicModelTest)
         delete pIntor;
     }
 
+    TEST_FIXTURE(GraphicModelTestFixture, get_system_for_002)
+    {
+        //@002. get_system_for() returns second system for timepos of the barline
+        //@     at end of first system. Returns nullptr when timepos not in score
+
+        MyDoorway doorway;
+        LibraryScope libraryScope(cout, &doorway);
+        libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+        SpDocument spDoc( new Document(libraryScope) );
+        spDoc->from_string("(score (vers 2.0) "
+            "(instrument (musicData (clef G)(key C)(time 2 4)(n c4 q)(r q)(barline simple)"
+            "(newSystem)(n e4 q)(r q)(barline simple)"
+            "(newSystem)(n g4 q)(r q)(barline simple)"
+            ")))" );
+        VerticalBookView* pView = static_cast<VerticalBookView*>(
+            Injector::inject_View(libraryScope, k_view_vertical_book, spDoc.get()) );
+        Interactor* pIntor = Injector::inject_Interactor(libraryScope, WpDocument(spDoc), pView, nullptr);
+        GraphicModel* pGModel = pIntor->get_graphic_model();
+
+        GmoBoxDocPage* pPage = pGModel->get_page(0);     //DocPage
+        GmoBox* pBDPC = pPage->get_child_box(0);        //DocPageContent
+        GmoBox* pBSP = pBDPC->get_child_box(0);         //ScorePage
+        GmoBoxSystem* pBSys0 = static_cast<GmoBoxSystem*>(pBSP->get_child_box(0));
+        GmoBoxSystem* pBSys1 = static_cast<GmoBoxSystem*>(pBSP->get_child_box(1));
+        GmoBoxSystem* pBSys2 = static_cast<GmoBoxSystem*>(pBSP->get_child_box(2));
+
+        ImoId scoreId = spDoc->get_im_root()->get_content_item(0)->get_id();
+
+        CHECK( pGModel->get_system_for(scoreId, 0.0) == pBSys0 );
+        CHECK( pGModel->get_system_for(scoreId, 64.0) == pBSys0 );
+        CHECK( pGModel->get_system_for(scoreId, 128.0) == pBSys1 );
+        CHECK( pGModel->get_system_for(scoreId, 200.0) == pBSys1 );
+        CHECK( pGModel->get_system_for(scoreId, 256.0) == pBSys2 );
+        CHECK( pGModel->get_system_for(scoreId, 384.0) == pBSys2 );
+        CHECK( pGModel->get_system_for(scoreId, 400.0) == nullptr );
+
+        delete pIntor;
+    }
+
+
+    //@ locate_timepos() ----------------------------------------------------------------
+
+    TEST_FIXTURE(GraphicModelTestFixture, locate_timepos_001)
+    {
+        //@001. locate_timepos() returns system, page, system number and x position
+
+        MyDoorway doorway;
+        LibraryScope libraryScope(cout, &doorway);
+        libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+        SpDocument spDoc( new Document(libraryScope) );
+        spDoc->from_string("(score (vers 2.0) "
+            "(instrument (musicData (clef G)(key C)(time 2 4)(n c4 q)(r q)(barline simple)"
+            "(newSystem)(n e4 q)(r q)(barline simple)"
+            ")))" );
+        VerticalBookView* pView = static_cast<VerticalBookView*>(
+            Injector::inject_View(libraryScope, k_view_vertical_book, spDoc.get()) );
+        Interactor* pIntor = Injector::inject_Interactor(libraryScope, WpDocument(spDoc), pView, nullptr);
+        GraphicModel* pGModel = pIntor->get_graphic_model();
+
+        GmoBoxDocPage* pPage = pGModel->get_page(0);     //DocPage
+        GmoBox* pBDPC = pPage->get_child_box(0);        //DocPageContent
+        GmoBox* pBSP = pBDPC->get_child_box(0);         //ScorePage
+        GmoBoxSystem* pBSys1 = static_cast<GmoBoxSystem*>(pBSP->get_child_box(1));
+
+        ImoId scoreId = spDoc->get_im_root()->get_content_item(0)->get_id();
+        TimeposLocation loc;
+
+        CHECK( pGModel->locate_timepos(scoreId, 192.0, &loc) == true );
+        CHECK( loc.pSystem == pBSys1 );
+        CHECK( loc.iPage == 0 );
+        CHECK( loc.iSystem == 1 );
+        CHECK( loc.x == pBSys1->get_x_for_note_rest_at_time(192.0) );
+
+        CHECK( pGModel->locate_timepos(scoreId, 256.0, &loc, true) == true );
+        CHECK( loc.pSystem == pBSys1 );
+        CHECK( loc.x == pBSys1->get_x_for_barline_at_time(256.0) );
+
+        CHECK( pGModel->locate_timepos(scoreId, 300.0, &loc) == false );
+
+        delete pIntor;
+    }
+
 
     //@1xx. TimeGridTable::get_x_for_note_rest_at_time() --------------------------------
 
@@ -40,7 +40,12 @@
 #include "lomse_graphic_view.h"
 #include "lomse_tasks.h"
 #include "lomse_graphical_model.h"
+#include "lomse_gm_measures_table.h"
 #include "lomse_shapes.h"
+#include "lomse_command.h"
+#include "lomse_document_cursor.h"
+#include "lomse_selections.h"
+#include "lomse_im_note.h"
 
 using namespace UnitTest;
 using namespace std;
@@ -54,6 +59,39 @@ using namespace lomse;
 //}
 
 
+//---------------------------------------------------------------------------------------
+//for progressive layout tests
+static std::atomic<int> m_numLayoutCompletedEvents(0);
+static int m_numPagesInEvent = 0;
+static std::atomic<bool> m_fHandlerCanComplete(true);
+static void my_layout_event_handler(void* UNUSED(pThis), SpEventInfo pEvent)
+{
+    if (pEvent->is_layout_completed_event())
+    {
+        SpEventLayout pEv( static_pointer_cast<EventLayout>(pEvent) );
+        m_numPagesInEvent = pEv->get_num_pages();
+        ++m_numLayoutCompletedEvents;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+static void my_completing_layout_event_handler(void* UNUSED(pThis), SpEventInfo pEvent)
+{
+    //the layout is accepted in the handler, without using the application events loop
+    if (pEvent->is_layout_completed_event())
+    {
+        //wait until the test does not access the graphic model
+        while (!m_fHandlerCanComplete)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        SpEventLayout pEv( static_pointer_cast<EventLayout>(pEvent) );
+        m_numPagesInEvent = pEv->get_num_pages();
+        if (SpInteractor spIntor = pEv->get_interactor().lock())
+            spIntor->on_layout_completed();
+        ++m_numLayoutCompletedEvents;
+    }
+}
+
 //---------------------------------------------------------------------------------------
 //MyDoorway: Derived class to avoid platform dependent code
 class MyDoorway : public LomseDoorway
@@ -515,6 +553,316 @@ SUITE(InteractorTest)
         CHECK( pIntor->sel_point_is(10, 33) == true );
     }
 
+    //-- updating the graphic model -----------------------------------------------------
+
+    TEST_FIXTURE(InteractorTestFixture, Interactor_IncrementalRelayoutReusesPages)
+    {
+        stringstream src;
+        src << "(lenmusdoc (vers 0.0) (content ";
+        for (int i=0; i < 40; ++i)
+        {
+            src << "(para (txt \"Paragraph " << i << "\"))"
+                << "(score (vers 2.0)(instrument (musicData "
+                   "(clef G)(n c4 q)(n e4 q)(n g4 q)(barline simple))))";
+        }
+        src << "))";
+        SpDocument spDoc( new Document(m_libraryScope) );
+        spDoc->from_string(src.str());
+        DocCommandExecuter executer(spDoc.get());
+        View* pView = Injector::inject_View(m_libraryScope, k_view_vertical_book,
+                                            spDoc.get());
+        SpInteractor pIntor(Injector::inject_Interactor(m_libraryScope,
+                                WpDocument(spDoc), pView, &executer));
+        pIntor->set_incremental_relayout(true);
+        GraphicModel* pModel = pIntor->get_graphic_model();
+        int numPages = pModel->get_num_pages();
+        GmoBoxDocPage* pFirstPage = pModel->get_page(0);
+        CHECK( numPages > 2 );
+
+        //modify a note in last score
+        ImoContent* pContent = spDoc->get_im_root()->get_content();
+        ImoScore* pScore = static_cast<ImoScore*>( pContent->get_last_child() );
+        ImoMusicData* pMD = pScore->get_instrument(0)->get_musicdata();
+        ImoObj* pNote = pMD->get_child(1);
+        CHECK( pNote->is_note() == true );
+        DocCursor cursor(spDoc.get());
+        SelectionSet sel(spDoc.get());
+        executer.execute(&cursor, LOMSE_NEW CmdChangeAttribute(pNote, k_attr_stem_type,
+                                                               k_stem_down), &sel);
+        pIntor->on_document_updated();
+
+        pModel = pIntor->get_graphic_model();
+        CHECK( pModel->get_num_pages() == numPages );
+        CHECK( pModel->get_page(0) == pFirstPage );
+        CHECK( executer.get_dirty_ids().empty() == true );
+
+        //the result is the same than when fully rebuilding the graphic model
+        View* pView2 = Injector::inject_View(m_libraryScope, k_view_vertical_book,
+                                             spDoc.get());
+        SpInteractor pIntor2(Injector::inject_Interactor(m_libraryScope,
+                                WpDocument(spDoc), pView2, nullptr));
+        GraphicModel* pModel2 = pIntor2->get_graphic_model();
+        CHECK( pModel2->get_num_pages() == numPages );
+        for (int i=0; i < numPages; ++i)
+        {
+            stringstream dump1;
+            stringstream dump2;
+            pModel->dump_page(i, dump1);
+            pModel2->dump_page(i, dump2);
+            CHECK( dump1.str() == dump2.str() );
+        }
+        CHECK( pModel->get_main_shape_for_imo(pNote->get_id()) != nullptr );
+        CHECK( pModel->get_measures_table(pScore->get_id()) != nullptr );
+        ImoId firstScoreId = pContent->get_child(1)->get_id();
+        CHECK( pModel->get_measures_table(firstScoreId) != nullptr );
+    }
+
+    TEST_FIXTURE(InteractorTestFixture, Interactor_IncrementalRelayoutResumesScore)
+    {
+        //single score: layout is resumed at the page with the first modified system
+        stringstream src;
+        src << "(lenmusdoc (vers 0.0) (content (score (vers 2.0)(instrument "
+               "(musicData (clef G)";
+        for (int i=0; i < 300; ++i)
+            src << "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)";
+        src << ")))))";
+        SpDocument spDoc( new Document(m_libraryScope) );
+        spDoc->from_string(src.str());
+        DocCommandExecuter executer(spDoc.get());
+        View* pView = Injector::inject_View(m_libraryScope, k_view_vertical_book,
+                                            spDoc.get());
+        SpInteractor pIntor(Injector::inject_Interactor(m_libraryScope,
+                                WpDocument(spDoc), pView, &executer));
+        pIntor->set_incremental_relayout(true);
+        GraphicModel* pModel = pIntor->get_graphic_model();
+        int numPages = pModel->get_num_pages();
+        GmoBoxDocPage* pFirstPage = pModel->get_page(0);
+        GmoBoxDocPage* pLastPage = pModel->get_page(numPages - 1);
+        CHECK( numPages > 3 );
+
+        //modify a note in measure 250
+        ImoContent* pContent = spDoc->get_im_root()->get_content();
+        ImoScore* pScore = static_cast<ImoScore*>( pContent->get_first_child() );
+        ImoMusicData* pMD = pScore->get_instrument(0)->get_musicdata();
+        ImoObj* pNote = pMD->get_child(1 + 5 * 250);
+        CHECK( pNote->is_note() == true );
+        DocCursor cursor(spDoc.get());
+        SelectionSet sel(spDoc.get());
+        executer.execute(&cursor, LOMSE_NEW CmdChangeAttribute(pNote, k_attr_stem_type,
+                                                               k_stem_down), &sel);
+        pIntor->on_document_updated();
+
+        pModel = pIntor->get_graphic_model();
+        CHECK( pModel->get_num_pages() == numPages );
+        CHECK( pModel->get_page(0) == pFirstPage );
+        CHECK( pModel->get_page(numPages - 1) != pLastPage );
+
+        //the result is the same than when fully rebuilding the graphic model
+        View* pView2 = Injector::inject_View(m_libraryScope, k_view_vertical_book,
+                                             spDoc.get());
+        SpInteractor pIntor2(Injector::inject_Interactor(m_libraryScope,
+                                WpDocument(spDoc), pView2, nullptr));
+        GraphicModel* pModel2 = pIntor2->get_graphic_model();
+        CHECK( pModel2->get_num_pages() == numPages );
+        for (int i=0; i < numPages; ++i)
+        {
+            stringstream dump1;
+            stringstream dump2;
+            pModel->dump_page(i, dump1);
+            pModel2->dump_page(i, dump2);
+            CHECK( dump1.str() == dump2.str() );
+        }
+        CHECK( pModel->get_main_shape_for_imo(pNote->get_id()) != nullptr );
+        CHECK( pModel->get_main_shape_for_imo(pMD->get_child(1)->get_id()) != nullptr );
+        GmMeasuresTable* pTable = pModel->get_measures_table(pScore->get_id());
+        CHECK( pTable != nullptr );
+        CHECK( pTable->get_num_measures(0) == 300 );
+    }
+
+    TEST_FIXTURE(InteractorTestFixture, Interactor_IncrementalRelayoutResumesScoreAfterTimeChanges)
+    {
+        //inserted notes shift the time of all following objects
+        stringstream src;
+        src << "(lenmusdoc (vers 0.0) (content (score (vers 2.0)(instrument "
+               "(musicData (clef G)";
+        for (int i=0; i < 300; ++i)
+            src << "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)";
+        src << ")))))";
+        SpDocument spDoc( new Document(m_libraryScope) );
+        spDoc->from_string(src.str());
+        DocCommandExecuter executer(spDoc.get());
+        View* pView = Injector::inject_View(m_libraryScope, k_view_vertical_book,
+                                            spDoc.get());
+        SpInteractor pIntor(Injector::inject_Interactor(m_libraryScope,
+                                WpDocument(spDoc), pView, &executer));
+        pIntor->set_incremental_relayout(true);
+        GraphicModel* pModel = pIntor->get_graphic_model();
+        int numPages = pModel->get_num_pages();
+        GmoBoxDocPage* pFirstPage = pModel->get_page(0);
+
+        //insert a note before a note in measure 200
+        ImoContent* pContent = spDoc->get_im_root()->get_content();
+        ImoScore* pScore = static_cast<ImoScore*>( pContent->get_first_child() );
+        ImoMusicData* pMD = pScore->get_instrument(0)->get_musicdata();
+        ImoObj* pNote = pMD->get_child(1 + 5 * 200);
+        DocCursor cursor(spDoc.get());
+        cursor.point_to(pNote->get_id());
+        SelectionSet sel(spDoc.get());
+        executer.execute(&cursor, LOMSE_NEW CmdAddNoteRest("(n d4 e v1)",
+                                                           k_edit_mode_ripple), &sel);
+        pIntor->on_document_updated();
+
+        pModel = pIntor->get_graphic_model();
+        CHECK( pModel->get_page(0) == pFirstPage );
+
+        View* pView2 = Injector::inject_View(m_libraryScope, k_view_vertical_book,
+                                             spDoc.get());
+        SpInteractor pIntor2(Injector::inject_Interactor(m_libraryScope,
+                                WpDocument(spDoc), pView2, nullptr));
+        GraphicModel* pModel2 = pIntor2->get_graphic_model();
+        numPages = pModel2->get_num_pages();
+        CHECK( pModel->get_num_pages() == numPages );
+        for (int i=0; i < numPages && i < pModel->get_num_pages(); ++i)
+        {
+            stringstream dump1;
+            stringstream dump2;
+            pModel->dump_page(i, dump1);
+            pModel2->dump_page(i, dump2);
+            CHECK( dump1.str() == dump2.str() );
+        }
+        GmMeasuresTable* pTable = pModel->get_measures_table(pScore->get_id());
+        GmMeasuresTable* pTable2 = pModel2->get_measures_table(pScore->get_id());
+        CHECK( pTable->get_num_measures(0) == pTable2->get_num_measures(0) );
+    }
+
+    TEST_FIXTURE(InteractorTestFixture, Interactor_ProgressiveLayout)
+    {
+        m_libraryScope.platform_interface()->set_notify_callback(nullptr,
+                                                        my_layout_event_handler);
+        m_numLayoutCompletedEvents = 0;
+        m_numPagesInEvent = 0;
+        stringstream src;
+        src << "(lenmusdoc (vers 0.0) (content "
+            << "(para (txt \"Title\"))"
+            << "(score (vers 2.0)(instrument (musicData (clef G)";
+        for (int i=0; i < 300; ++i)
+            src << "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)";
+        src << ")))(para (txt \"The end\"))))";
+        SpDocument spDoc( new Document(m_libraryScope) );
+        spDoc->from_string(src.str());
+        View* pView = Injector::inject_View(m_libraryScope, k_view_vertical_book,
+                                            spDoc.get());
+        SpInteractor pIntor(Injector::inject_Interactor(m_libraryScope,
+                                WpDocument(spDoc), pView, nullptr));
+        pIntor->set_progressive_layout(true);
+
+        //only first page. Viewport size is 0 in unit tests
+        GraphicModel* pModel = pIntor->get_graphic_model();
+        CHECK( pModel->get_num_pages() == 1 );
+        CHECK( pIntor->is_layout_in_progress() == true );
+        GmoBoxDocPage* pFirstPage = pModel->get_page(0);
+
+        pIntor->on_layout_completed();
+        CHECK( pIntor->is_layout_in_progress() == false );
+        CHECK( m_numLayoutCompletedEvents == 1 );
+        m_libraryScope.platform_interface()->set_notify_callback(nullptr,
+                                                LomseDoorway::null_notify_function);
+
+        //the layout has been continued: the first page is not laid out again
+        CHECK( pIntor->get_graphic_model() == pModel );
+        CHECK( pModel->get_page(0) == pFirstPage );
+        int numPages = pModel->get_num_pages();
+        CHECK( numPages > 2 );
+        CHECK( m_numPagesInEvent == numPages );
+
+        //the result is the same than when not using progressive layout
+        View* pView2 = Injector::inject_View(m_libraryScope, k_view_vertical_book,
+                                             spDoc.get());
+        SpInteractor pIntor2(Injector::inject_Interactor(m_libraryScope,
+                                WpDocument(spDoc), pView2, nullptr));
+        GraphicModel* pModel2 = pIntor2->get_graphic_model();
+        CHECK( pModel2->get_num_pages() == numPages );
+        for (int i=0; i < numPages; ++i)
+        {
+            stringstream dump1;
+            stringstream dump2;
+            pModel->dump_page(i, dump1);
+            pModel2->dump_page(i, dump2);
+            CHECK( dump1.str() == dump2.str() );
+        }
+        ImoScore* pScore = static_cast<ImoScore*>(
+                                spDoc->get_im_root()->get_content()->get_child(1) );
+        CHECK( pModel->get_measures_table(pScore->get_id()) != nullptr );
+    }
+
+    TEST_FIXTURE(InteractorTestFixture, Interactor_ProgressiveLayoutAcceptedInHandler)
+    {
+        m_libraryScope.platform_interface()->set_notify_callback(nullptr,
+                                                my_completing_layout_event_handler);
+        m_numLayoutCompletedEvents = 0;
+        m_numPagesInEvent = 0;
+        m_fHandlerCanComplete = false;
+        stringstream src;
+        src << "(lenmusdoc (vers 0.0) (content "
+            << "(score (vers 2.0)(instrument (musicData (clef G)";
+        for (int i=0; i < 300; ++i)
+            src << "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)";
+        src << ")))))";
+        SpDocument spDoc( new Document(m_libraryScope) );
+        spDoc->from_string(src.str());
+        View* pView = Injector::inject_View(m_libraryScope, k_view_vertical_book,
+                                            spDoc.get());
+        SpInteractor pIntor(Injector::inject_Interactor(m_libraryScope,
+                                WpDocument(spDoc), pView, nullptr));
+        pIntor->set_progressive_layout(true);
+        GraphicModel* pModel = pIntor->get_graphic_model();
+        CHECK( pModel->get_num_pages() == 1 );
+        m_fHandlerCanComplete = true;
+
+        //wait for the handler
+        for (int i=0; i < 1000 && m_numLayoutCompletedEvents == 0; ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        m_libraryScope.platform_interface()->set_notify_callback(nullptr,
+                                                LomseDoorway::null_notify_function);
+
+        CHECK( m_numLayoutCompletedEvents == 1 );
+        CHECK( pIntor->is_layout_in_progress() == false );
+        CHECK( pIntor->get_graphic_model() == pModel );
+        CHECK( pModel->get_num_pages() > 2 );
+        CHECK( m_numPagesInEvent == pModel->get_num_pages() );
+    }
+
+    TEST_FIXTURE(InteractorTestFixture, Interactor_ProgressiveLayoutCancelled)
+    {
+        stringstream src;
+        src << "(lenmusdoc (vers 0.0) (content "
+            << "(score (vers 2.0)(instrument (musicData (clef G)";
+        for (int i=0; i < 300; ++i)
+            src << "(n c4 q)(n e4 q)(n g4 q)(n c5 q)(barline simple)";
+        src << ")))))";
+        SpDocument spDoc( new Document(m_libraryScope) );
+        spDoc->from_string(src.str());
+        View* pView = Injector::inject_View(m_libraryScope, k_view_vertical_book,
+                                            spDoc.get());
+        SpInteractor pIntor(Injector::inject_Interactor(m_libraryScope,
+                                WpDocument(spDoc), pView, nullptr));
+        pIntor->set_progressive_layout(true);
+        GraphicModel* pModel = pIntor->get_graphic_model();
+        CHECK( pModel->get_num_pages() == 1 );
+        CHECK( pIntor->is_layout_in_progress() == true );
+
+        //rebuilding the graphic model cancels the background layout and starts a
+        //new one
+        pIntor->on_document_updated();
+        pModel = pIntor->get_graphic_model();
+        CHECK( pModel->get_num_pages() == 1 );
+        CHECK( pIntor->is_layout_in_progress() == true );
+
+        //deleting the interactor also cancels it
+        pIntor.reset();
+        CHECK( pIntor.get() == nullptr );
+    }
+
     //TEST_FIXTURE(InteractorTestFixture, NotificationReceived)
     //{
     //    fNotified = false;
@@ -39,6 +39,9 @@
 #include "lomse_time.h"
 #include "private/lomse_document_p.h"
 #include "lomse_im_factory.h"
+#include "lomse_im_snapshot.h"
+#include "lomse_ldp_exporter.h"
+#include "lomse_staffobjs_table.h"
 
 using namespace UnitTest;
 using namespace std;
@@ -1831,6 +1834,98 @@ SUITE(InternalModelTest)
         delete pImo;
    }
 
-}
+    //@ ImSnapshot --------------------------------------------------------------------
+
+    TEST_FIXTURE(InternalModelTestFixture, im_snapshot_01)
+    {
+        //@ 01. Whole document restored from snapshot. Ids and content preserved
+
+        Document doc(m_libraryScope);
+        doc.from_string("(lenmusdoc (vers 0.0) (content "
+            "(score (vers 2.0)(instrument (musicData (clef G)(key D)(time 2 4)"
+            "(n c4 e g+ (t + 2 3))(n e4 e)(n g4 e g- t-)(n c5 q l)(barline)"
+            "(n c5 q)(r q)(barline))))"
+            "(para (txt \"Hello world!\"))"
+            "))" );
+        LdpExporter exporter(&m_libraryScope);
+        exporter.set_add_id(true);
+        ImoObj* pScore = doc.get_im_root()->get_content_item(0);
+        ImoId idScore = pScore->get_id();
+        string source = exporter.get_source(pScore);
+
+        ImSnapshot* pSnapshot = doc.get_snapshot();
+        CHECK( pSnapshot != nullptr );
+        CHECK( pSnapshot->get_num_objects() > 20 );
+        doc.from_snapshot(pSnapshot);
 
+        pScore = doc.get_im_root()->get_content_item(0);
+        CHECK( pScore->get_id() == idScore );
+        CHECK( doc.get_pointer_to_imo(idScore) == pScore );
+        CHECK( exporter.get_source(pScore) == source );
+        CHECK( doc.get_im_root()->get_content_item(1)->is_paragraph() );
+        delete pSnapshot;
+    }
+
+    TEST_FIXTURE(InternalModelTestFixture, im_snapshot_02)
+    {
+        //@ 02. Score replaced from snapshot. Objects are new, ids preserved
 
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument (musicData (clef G)"
+            "(n c4 q l)(n c4 q)(n e4 q (stem up))(barline))))");
+        LdpExporter exporter(&m_libraryScope);
+        exporter.set_add_id(true);
+        ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        ImoId idScore = pScore->get_id();
+        string source = exporter.get_source(pScore);
+
+        ImSnapshot* pSnapshot = doc.get_snapshot_for(idScore);
+        CHECK( pSnapshot != nullptr );
+        ImoNote* pNote = static_cast<ImoNote*>( pScore->get_staffobjs_table()
+                                                ->front()->get_next()->imo_object() );
+        ImoId idNote = pNote->get_id();
+        pNote->set_notated_pitch(k_step_D, 4, k_no_accidentals);
+        doc.replace_object_from_snapshot(idScore, pSnapshot);
+
+        pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        CHECK( pScore->get_id() == idScore );
+        CHECK( exporter.get_source(pScore) == source );
+        pNote = static_cast<ImoNote*>( doc.get_pointer_to_imo(idNote) );
+        CHECK( pNote && pNote->get_step() == k_step_C );
+        CHECK( pNote && pNote->is_tied_next() );
+        CHECK( pScore->get_staffobjs_table()->num_entries() == 5 );
+        delete pSnapshot;
+    }
+
+    TEST_FIXTURE(InternalModelTestFixture, im_snapshot_03)
+    {
+        //@ 03. Memory size includes all copied objects
+
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument (musicData (clef G)"
+            "(n c4 q)(n e4 q)(barline))))");
+
+        ImSnapshot* pSnapshot = doc.get_snapshot();
+        CHECK( pSnapshot->get_memory_size() > 2 * sizeof(ImoNote) );
+        delete pSnapshot;
+    }
+
+    TEST_FIXTURE(InternalModelTestFixture, im_snapshot_04)
+    {
+        //@ 04. Memory size includes strings owned by the copied objects
+
+        string text(1000, 'x');
+        Document doc1(m_libraryScope);
+        doc1.from_string("(lenmusdoc (vers 0.0)(content (para (txt \"x\"))))");
+        Document doc2(m_libraryScope);
+        doc2.from_string("(lenmusdoc (vers 0.0)(content (para (txt \"" + text + "\"))))");
+
+        ImSnapshot* pSnapshot1 = doc1.get_snapshot();
+        ImSnapshot* pSnapshot2 = doc2.get_snapshot();
+        CHECK( pSnapshot2->get_memory_size()
+               >= pSnapshot1->get_memory_size() + text.size() );
+        delete pSnapshot1;
+        delete pSnapshot2;
+    }
+
+}
@@ -1422,4 +1422,45 @@ SUITE(LdpExporterTest)
         CHECK( source == expected );
     }
 
+    //@ Output to stream --------------------------------------------------------------
+
+    TEST_FIXTURE(LdpExporterTestFixture, write_source_01)
+    {
+        //@01 write_source() generates the same source than get_source()
+        Document doc(m_libraryScope);
+        doc.from_file(m_scores_path + "01014-nested-tuplets.lms", Document::k_format_ldp);
+        ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+
+        LdpExporter exporter(&m_libraryScope);
+        exporter.set_current_score(pScore);
+        string expected = exporter.get_source(pScore);
+        stringstream out;
+        exporter.write_source(out, pScore);
+
+        CHECK( out.str() == expected );
+    }
+
+    TEST_FIXTURE(LdpExporterTestFixture, write_source_02)
+    {
+        //@02 source is appended to previous stream content
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)"
+            "(instrument (musicData (clef G)(n c4 q)(n e4 q)"
+            ")))" );
+        ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        ImoInstrument* pInstr = pScore->get_instrument(0);
+        ImoMusicData* pMD = pInstr->get_musicdata();
+
+        LdpExporter exporter(&m_libraryScope);
+        exporter.set_current_score(pScore);
+        exporter.set_remove_newlines(true);
+        stringstream out;
+        out << "//music: ";
+        exporter.write_source(out, pMD);
+        out << ".";
+
+        //cout << test_name() << endl << "\"" << out.str() << "\"" << endl;
+        CHECK( out.str() == "//music: (musicData (clef G p1)(n c4 q v1 p1)(n e4 q v1 p1))." );
+    }
+
 };
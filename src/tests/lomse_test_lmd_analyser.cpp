@@ -116,7 +116,7 @@ SUITE(LmdAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. lenmusdoc: missing mandatory element 'content'." << endl;
+        expected << "Line 1. lenmusdoc: missing mandatory element 'content'." << endl;
         parser.parse_text("<lenmusdoc vers='0.0'></lenmusdoc>");
         MyLmdAnalyser a(errormsg, m_libraryScope, &doc, &parser);
 
@@ -231,7 +231,7 @@ SUITE(LmdAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. lenmusdoc: Missing mandatory attribute 'vers'. Value '0.0' assumed." << endl;
+        expected << "Line 1. lenmusdoc: Missing mandatory attribute 'vers'. Value '0.0' assumed." << endl;
         string src =
             "<lenmusdoc><content><para>Hello world</para></content></lenmusdoc>";
         parser.parse_text(src);
@@ -330,7 +330,7 @@ SUITE(LmdAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. Unknown clef type 'Fa4'. Assumed 'G'." << endl;
+        expected << "Line 1. Unknown clef type 'Fa4'. Assumed 'G'." << endl;
         parser.parse_text("<clef><type>Fa4</type></clef>");
         LmdAnalyser a(errormsg, m_libraryScope, &doc, &parser);
         XmlNode* tree = parser.get_tree_root();
@@ -503,7 +503,7 @@ SUITE(LmdAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. Missing or invalid color value. Must be #rrggbbaa. Color ignored." << endl;
+        expected << "Line 1. Missing or invalid color value. Must be #rrggbbaa. Color ignored." << endl;
         parser.parse_text("<color>321700</color>");
         LmdAnalyser a(errormsg, m_libraryScope, &doc, &parser);
         XmlNode* tree = parser.get_tree_root();
@@ -641,7 +641,7 @@ SUITE(LmdAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. txt: missing mandatory value 'string'. Element <txt> ignored." << endl;
+        expected << "Line 1. txt: missing mandatory value 'string'. Element <txt> ignored." << endl;
         parser.parse_text("<txt></txt>");
         LmdAnalyser a(errormsg, m_libraryScope, &doc, &parser);
         XmlNode* tree = parser.get_tree_root();
@@ -1093,7 +1093,7 @@ SUITE(LmdAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. section: missing 'level' attribute. Level 1 assumed." << endl;
+        expected << "Line 1. section: missing 'level' attribute. Level 1 assumed." << endl;
         parser.parse_text("<section>This is a header</section>");
         LmdAnalyser a(errormsg, m_libraryScope, &doc, &parser);
         XmlNode* tree = parser.get_tree_root();
@@ -1117,7 +1117,7 @@ SUITE(LmdAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. Invalid integer number 'apple'. Replaced by '1'." << endl;
+        expected << "Line 1. Invalid integer number 'apple'. Replaced by '1'." << endl;
         parser.parse_text("<section level='apple'>This is a header</section>");
         LmdAnalyser a(errormsg, m_libraryScope, &doc, &parser);
         XmlNode* tree = parser.get_tree_root();
@@ -1439,7 +1439,7 @@ SUITE(LmdAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. Missing name for element 'param'. Element ignored." << endl;
+        expected << "Line 1. Missing name for element 'param'. Element ignored." << endl;
         parser.parse_text("<param>this is green</param>");
         LmdAnalyser a(errormsg, m_libraryScope, &doc, &parser);
         XmlNode* tree = parser.get_tree_root();
@@ -1611,7 +1611,7 @@ SUITE(LmdAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. link: Missing mandatory attribute 'url'." << endl;
+        expected << "Line 1. link: Missing mandatory attribute 'url'." << endl;
         parser.parse_text(
             "<link>Harmony exercise</link>");
         LmdAnalyser a(errormsg, m_libraryScope, &doc, &parser);
@@ -2493,7 +2493,7 @@ SUITE(LmdAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. instrument: missing 'instrId' element. Instrument ignored."
+        expected << "Line 1. instrument: missing 'instrId' element. Instrument ignored."
                  << endl;
         parser.parse_text(
             "<score>"
@@ -2559,7 +2559,7 @@ SUITE(LmdAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. 'instrId' is not defined in <parts> element. Instrument ignored."
+        expected << "Line 1. 'instrId' is not defined in <parts> element. Instrument ignored."
                  << endl;
         parser.parse_text(
             "<score>"
@@ -2593,7 +2593,7 @@ SUITE(LmdAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. parts: duplicated <instrId> will be ignored."
+        expected << "Line 1. parts: duplicated <instrId> will be ignored."
                  << endl;
         parser.parse_text(
             "<score>"
@@ -2630,7 +2630,7 @@ SUITE(LmdAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. parts: at least one <instrId> is required." << endl;
+        expected << "Line 1. parts: at least one <instrId> is required." << endl;
         parser.parse_text(
             "<score>"
             "<parts></parts>"
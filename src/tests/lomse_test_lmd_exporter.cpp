@@ -487,4 +487,23 @@ SUITE(LmdExporterTest)
         if (pRoot && !pRoot->is_document()) delete pRoot;
     }
 
+    // output to stream --------------------------------------------------------------
+
+    TEST_FIXTURE(LmdExporterTestFixture, write_source)
+    {
+        //embedded LDP score is written into the same stream
+        Document doc(m_libraryScope);
+        doc.from_file(m_scores_path + "01014-nested-tuplets.lms", Document::k_format_ldp);
+        ImoDocument* pImoDoc = doc.get_im_root();
+
+        MyLmdExporter exporter(m_libraryScope, "0.12.5", "2012/12/21 13:10:27");
+        exporter.set_score_format(LmdExporter::k_format_ldp);
+        string expected = exporter.get_source(pImoDoc);
+        stringstream out;
+        exporter.write_source(out, pImoDoc);
+
+        CHECK( out.str() == expected );
+        CHECK( expected.find("<ldpmusic>") != string::npos );
+    }
+
 };
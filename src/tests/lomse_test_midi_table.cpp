@@ -465,6 +465,47 @@ SUITE(MidiTableTest)
         CHECK( (*it)->DeltaTime == 64.0f );
     }
 
+    TEST_FIXTURE(MidiTableTestFixture, EventsSorted_2)
+    {
+        //@201. Events for several instruments and measures are sorted by time,
+        //      priority and measure. Events with same key keep creation order
+
+        Document doc(m_libraryScope);
+        doc.from_string("(lenmusdoc (vers 0.0) (content (score (vers 1.6) "
+            "(instrument (musicData (clef G)(n c4 h)(n e4 h)(barline)(n c4 w)(barline) ))"
+            "(instrument (musicData (clef F4)(n c3 q)(n e3 q)(n g3 h)(barline)"
+            "(n c3 h)(n d3 h)(barline) )) )))" );
+        ImoScore* pScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        MySoundEventsTable table(pScore);
+        table.my_program_sounds_for_instruments();
+        table.my_create_events();
+        table.my_close_table();
+        table.my_sort_by_time();
+
+        std::vector<SoundEvent*>& events = table.get_events();
+        bool fSorted = true;
+        for (size_t i=1; i < events.size(); ++i)
+        {
+            SoundEvent* pPrev = events[i-1];
+            SoundEvent* pCur = events[i];
+            if (pPrev->DeltaTime > pCur->DeltaTime)
+                fSorted = false;
+            else if (pPrev->DeltaTime == pCur->DeltaTime)
+            {
+                if (pPrev->EventType > pCur->EventType)
+                    fSorted = false;
+                else if (pPrev->EventType == pCur->EventType
+                         && pPrev->Measure > pCur->Measure)
+                    fSorted = false;
+            }
+        }
+        CHECK( fSorted == true );
+        CHECK( events.front()->EventType == SoundEvent::k_prog_instr );
+        CHECK( events[1]->EventType == SoundEvent::k_prog_instr );
+        CHECK( events.back()->EventType == SoundEvent::k_end_of_score );
+        CHECK( events.back()->Measure == 0 );
+    }
+
 
     //@ Measures table ------------------------------------------------------------------
 
@@ -130,7 +130,7 @@ SUITE(MnxAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. <mnx-common>: missing mandatory element <global>." << endl;
+        expected << "Line 1. <mnx-common>: missing mandatory element <global>." << endl;
         parser.parse_text(
             "<mnx>"
             "<head></head>"
@@ -169,7 +169,7 @@ SUITE(MnxAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. <global>: missing mandatory element <measure>." << endl;
+        expected << "Line 1. <global>: missing mandatory element <measure>." << endl;
         parser.parse_text(
             "<mnx>"
             "<head></head>"
@@ -346,7 +346,7 @@ SUITE(MnxAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. <mnx-common>: missing mandatory element <global>." << endl;
+        expected << "Line 1. <mnx-common>: missing mandatory element <global>." << endl;
         parser.parse_text(
             "<mnx>"
             "<head></head>"
@@ -415,7 +415,7 @@ SUITE(MnxAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. <mnx-common>: missing mandatory element <global>." << endl;
+        expected << "Line 1. <mnx-common>: missing mandatory element <global>." << endl;
         parser.parse_text(
             "<mnx>"
             "<head></head>"
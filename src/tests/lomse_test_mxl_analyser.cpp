@@ -221,6 +221,30 @@ public:
 SUITE(MxlAnalyserTest)
 {
 
+    //@ tag names -----------------------------------------------------------------------------
+
+    TEST_FIXTURE(MxlAnalyserTestFixture, MxlAnalyser_name_to_enum_01)
+    {
+        //@01. known tags are identified. Unknown tags and prefixes are not
+
+        const int k_undefined = -1;
+        CHECK( MxlAnalyser::name_to_enum("key") != k_undefined );
+        CHECK( MxlAnalyser::name_to_enum("note") != k_undefined );
+        CHECK( MxlAnalyser::name_to_enum("part-list") != k_undefined );
+        CHECK( MxlAnalyser::name_to_enum("virtual-instrument") != k_undefined );
+        CHECK( MxlAnalyser::name_to_enum("accordion-registration") != k_undefined );
+        CHECK( MxlAnalyser::name_to_enum("part-list")
+               != MxlAnalyser::name_to_enum("part-name") );
+        CHECK( MxlAnalyser::name_to_enum("part")
+               != MxlAnalyser::name_to_enum("part-list") );
+        CHECK( MxlAnalyser::name_to_enum("") == k_undefined );
+        CHECK( MxlAnalyser::name_to_enum("par") == k_undefined );
+        CHECK( MxlAnalyser::name_to_enum("notes") == k_undefined );
+        CHECK( MxlAnalyser::name_to_enum("part-lists") == k_undefined );
+        CHECK( MxlAnalyser::name_to_enum("Note") == k_undefined );
+        CHECK( MxlAnalyser::name_to_enum("duration") == k_undefined );
+    }
+
     //@ score_partwise ------------------------------------------------------------------------
 
     TEST_FIXTURE(MxlAnalyserTestFixture, MxlAnalyser_part_group_)
@@ -230,7 +254,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. <score-partwise>: missing mandatory element <part-list>." << endl;
+        expected << "Line 1. <score-partwise>: missing mandatory element <part-list>." << endl;
         parser.parse_text("<score-partwise version='3.0'></score-partwise>");
         MyMxlAnalyser a(errormsg, m_libraryScope, &doc, &parser);
 
@@ -257,7 +281,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. <score-partwise>: missing mandatory element <part-list>." << endl;
+        expected << "Line 1. <score-partwise>: missing mandatory element <part-list>." << endl;
         parser.parse_text("<score-partwise version='3.a'></score-partwise>");
         MyMxlAnalyser a(errormsg, m_libraryScope, &doc, &parser);
 
@@ -282,8 +306,8 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. <part-list>: missing mandatory element <score-part>.\n"
-                 << "Line 0. errors in <part-list>. Analysis stopped." << endl;
+        expected << "Line 1. <part-list>: missing mandatory element <score-part>.\n"
+                 << "Line 1. errors in <part-list>. Analysis stopped." << endl;
         parser.parse_text("<score-partwise version='3.0'><part-list/></score-partwise>");
         MxlAnalyser a(errormsg, m_libraryScope, &doc, &parser);
         XmlNode* tree = parser.get_tree_root();
@@ -411,7 +435,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. <part>: missing mandatory 'id' attribute. <part> content will be ignored"
+        expected << "Line 1. <part>: missing mandatory 'id' attribute. <part> content will be ignored"
                  << endl << "Error: missing <part> for <score-part id='P1'>." << endl;
         parser.parse_text("<score-partwise version='3.0'><part-list>"
                           "<score-part id='P1'><part-name>Music</part-name></score-part>"
@@ -669,7 +693,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. <part-group>: invalid or missing mandatory 'number' "
+        expected << "Line 1. <part-group>: invalid or missing mandatory 'number' "
                     "attribute. Tag ignored." << endl;
         parser.parse_text("<score-partwise version='3.0'><part-list>"
             "<part-group type='start'></part-group>"
@@ -712,7 +736,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. <part-group>: missing mandatory 'type' attribute. Tag ignored."
+        expected << "Line 1. <part-group>: missing mandatory 'type' attribute. Tag ignored."
                  << endl;
         parser.parse_text("<score-partwise version='3.0'><part-list>"
             "<part-group number='1'></part-group>"
@@ -761,7 +785,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. <part-group> type='stop': missing <part-group> with the "
+        expected << "Line 1. <part-group> type='stop': missing <part-group> with the "
                     "same number and type='start'." << endl;
         parser.parse_text("<score-partwise version='3.0'><part-list>"
             "<score-part id='P1'><part-name>Voice</part-name></score-part>"
@@ -810,7 +834,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. <part-group>: invalid mandatory 'type' attribute. Must be "
+        expected << "Line 1. <part-group>: invalid mandatory 'type' attribute. Must be "
                     "'start' or 'stop'." << endl;
         parser.parse_text("<score-partwise version='3.0'><part-list>"
             "<part-group number='1' type='begin'></part-group>"
@@ -859,7 +883,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. <part-group> type=start for number already started and not stopped"
+        expected << "Line 1. <part-group> type=start for number already started and not stopped"
                  << endl;
         parser.parse_text("<score-partwise version='3.0'><part-list>"
             "<part-group number='1' type='start'></part-group>"
@@ -1040,7 +1064,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. Invalid value for <group-symbol>. Must be "
+        expected << "Line 1. Invalid value for <group-symbol>. Must be "
                     "'none', 'brace', 'line' or 'bracket'. 'none' assumed." << endl;
         parser.parse_text("<score-partwise version='3.0'><part-list>"
             "<part-group number='1' type='start'>"
@@ -1452,7 +1476,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. Part '', measure ''. Unknown clef 'H'. Assumed 'G' in line 2." << endl;
+        expected << "Line 1. Part '', measure ''. Unknown clef 'H'. Assumed 'G' in line 2." << endl;
         parser.parse_text("<clef><sign>H</sign><line>2</line></clef>");
         MyMxlAnalyser a(errormsg, m_libraryScope, &doc, &parser);
         XmlNode* tree = parser.get_tree_root();
@@ -1542,7 +1566,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. Warning: <clef-octave-change> only supported for up to two octaves. Ignored."
+        expected << "Line 1. Warning: <clef-octave-change> only supported for up to two octaves. Ignored."
             << endl;
         parser.parse_text(
             "<clef number='2'>"
@@ -1578,7 +1602,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. Warning: G clef only supported in lines 1 or 2. Clef G3 changed to G2."
+        expected << "Line 1. Warning: G clef only supported in lines 1 or 2. Clef G3 changed to G2."
             << endl;
         parser.parse_text(
             "<clef number='2'>"
@@ -1613,7 +1637,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. Warning: F clef only supported in lines 3, 4 or 5. Clef F2 changed to F4."
+        expected << "Line 1. Warning: F clef only supported in lines 3, 4 or 5. Clef F2 changed to F4."
             << endl;
         parser.parse_text(
             "<clef number='2'>"
@@ -1648,7 +1672,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. Warning: C clef only supported in lines 1 to 5. Clef C6 changed to C1."
+        expected << "Line 1. Warning: C clef only supported in lines 1 to 5. Clef C6 changed to C1."
             << endl;
         parser.parse_text(
             "<clef number='2'>"
@@ -2722,7 +2746,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. Part 'P1', measure '1'. Error in metronome parameters. "
+        expected << "Line 1. Part 'P1', measure '1'. Error in metronome parameters. "
             "Replaced by '(metronome 60)'." << endl;
         parser.parse_text(
             "<score-partwise version='3.0'><part-list>"
@@ -2921,7 +2945,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. midi-instrument: missing mandatory attribute 'id'." << endl;
+        expected << "Line 1. midi-instrument: missing mandatory attribute 'id'." << endl;
         parser.parse_text(
             "<score-partwise version='3.0'><part-list><score-part id='P1'>"
                 "<part-name>Music</part-name>"
@@ -3062,7 +3086,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. id 'I1' doesn't match any <score-instrument>"
+        expected << "Line 1. id 'I1' doesn't match any <score-instrument>"
                  << ". <midi-instrument> ignored." << endl;
         parser.parse_text(
             "<score-partwise version='3.0'><part-list><score-part id='P1'>"
@@ -3146,7 +3170,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. Part '', measure ''. Unknown note step 'e'. Replaced by 'C'." << endl;
+        expected << "Line 1. Part '', measure ''. Unknown note step 'e'. Replaced by 'C'." << endl;
         parser.parse_text("<note><pitch><step>e</step><octave>4</octave></pitch>"
             "<duration>4</duration><type>whole</type></note>");
         MyMxlAnalyser a(errormsg, m_libraryScope, &doc, &parser);
@@ -3182,7 +3206,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. Part '', measure ''. Unknown octave 'e'. Replaced by '4'." << endl;
+        expected << "Line 1. Part '', measure ''. Unknown octave 'e'. Replaced by '4'." << endl;
         parser.parse_text("<note><pitch><step>D</step><octave>e</octave></pitch>"
             "<duration>1</duration><type>quarter</type></note>");
         MyMxlAnalyser a(errormsg, m_libraryScope, &doc, &parser);
@@ -3565,7 +3589,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. Part '', measure ''. Note/Rest: missing <duration> element. Assuming 1." << endl;
+        expected << "Line 1. Part '', measure ''. Note/Rest: missing <duration> element. Assuming 1." << endl;
         parser.parse_text("<note><pitch><step>B</step><alter>2</alter>"
             "<octave>2</octave></pitch></note>");
         MyMxlAnalyser a(errormsg, m_libraryScope, &doc, &parser);
@@ -4264,7 +4288,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. score-instrument: missing mandatory attribute 'id'." << endl;
+        expected << "Line 1. score-instrument: missing mandatory attribute 'id'." << endl;
         parser.parse_text(
             "<score-partwise version='3.0'><part-list><score-part id='P1'>"
                 "<part-name>Music</part-name>"
@@ -4347,7 +4371,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. <score-instrument>: missing mandatory element <instrument-name>." << endl;
+        expected << "Line 1. <score-instrument>: missing mandatory element <instrument-name>." << endl;
         parser.parse_text(
             "<score-partwise version='3.0'><part-list><score-part id='P1'>"
                 "<part-name>Music</part-name>"
@@ -4489,8 +4513,8 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser(errormsg);
         stringstream expected;
-        expected << "Line 0. A slur with the same number is already defined for this "
-            "element in line 0. This slur will be ignored." << endl;
+        expected << "Line 1. A slur with the same number is already defined for this "
+            "element in line 1. This slur will be ignored." << endl;
         parser.parse_text(
             "<note>"
                 "<pitch><step>A</step>"
@@ -4528,7 +4552,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. Empty <sound> element. Ignored." << endl;
+        expected << "Line 1. Empty <sound> element. Ignored." << endl;
         parser.parse_text("<sound></sound>");
         MyMxlAnalyser a(errormsg, m_libraryScope, &doc, &parser);
         XmlNode* tree = parser.get_tree_root();
@@ -4607,7 +4631,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. Invalid real number '75,7'. Replaced by '70'." << endl;
+        expected << "Line 1. Invalid real number '75,7'. Replaced by '70'." << endl;
         parser.parse_text("<sound tempo='75,7'/>");
         MyMxlAnalyser a(errormsg, m_libraryScope, &doc, &parser);
         XmlNode* tree = parser.get_tree_root();
@@ -4635,7 +4659,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. Part '', measure ''. Invalid value for 'forward-repeat' "
+        expected << "Line 1. Part '', measure ''. Invalid value for 'forward-repeat' "
                     "attribute. When used, value must be 'yes'. Ignored." << endl;
 
         parser.parse_text("<sound forward-repeat='no' tempo='72.5' />");
@@ -4995,7 +5019,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. <time>: missing mandatory element <beat-type>." << endl;
+        expected << "Line 1. <time>: missing mandatory element <beat-type>." << endl;
         parser.parse_text("<time><beats>6</beats></time>");
         MyMxlAnalyser a(errormsg, m_libraryScope, &doc, &parser);
         XmlNode* tree = parser.get_tree_root();
@@ -5141,7 +5165,7 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. <transpose>: missing mandatory element <chromatic>."
+        expected << "Line 1. <transpose>: missing mandatory element <chromatic>."
                  << endl;
         parser.parse_text(
             "<transpose>"
@@ -5766,8 +5790,8 @@ SUITE(MxlAnalyserTest)
         Document doc(m_libraryScope);
         XmlParser parser;
         stringstream expected;
-        expected << "Line 0. Invalid tuplet number. Tuplet ignored." << endl
-                 << "Line 0. Invalid tuplet number. Tuplet ignored." << endl;
+        expected << "Line 1. Invalid tuplet number. Tuplet ignored." << endl
+                 << "Line 1. Invalid tuplet number. Tuplet ignored." << endl;
                  //twice because there are two invalid tuplet elements
         parser.parse_text(
             "<score-partwise version='3.0'><part-list>"
@@ -29,6 +29,8 @@
 
 #include <UnitTest++.h>
 #include <sstream>
+#include <fstream>
+#include "lomse_config.h"
 #include "lomse_build_options.h"
 
 //classes related to these tests
@@ -124,5 +126,40 @@ SUITE(MxlCompilerTest)
         delete pRoot;
     }
 
+#if (LOMSE_ENABLE_COMPRESSION == 1)
+    TEST_FIXTURE(MxlCompilerTestFixture, MxlCompilerCompressed_200)
+    {
+        //200 - compile compressed .mxl file
+        stringstream errormsg;
+        Document doc(m_libraryScope, errormsg);
+        string path = m_scores_path + "regression/scores/recordare/Binchois.mxl";
+        doc.from_file(path, Document::k_format_mxl_compressed);
+        ImoScore* pScore = dynamic_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        CHECK( pScore != nullptr );
+        CHECK( pScore && pScore->get_num_instruments() == 2 );
+        CHECK( pScore && pScore->get_staffobjs_table() != nullptr );
+    }
+
+    TEST_FIXTURE(MxlCompilerTestFixture, MxlCompilerCompressed_201)
+    {
+        //201 - compile compressed .mxl from an in-memory buffer
+        string path = m_scores_path + "regression/scores/recordare/Binchois.mxl";
+        ifstream file(path.c_str(), ios::binary);
+        stringstream content;
+        content << file.rdbuf();
+
+        stringstream errormsg;
+        Document doc(m_libraryScope, errormsg);
+        doc.from_string(content.str(), Document::k_format_mxl_compressed);
+        ImoScore* pScore = dynamic_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        CHECK( pScore != nullptr );
+        CHECK( pScore && pScore->get_num_instruments() == 2 );
+
+        Document fromFile(m_libraryScope, errormsg);
+        fromFile.from_file(path, Document::k_format_mxl_compressed);
+        CHECK( doc.to_string() == fromFile.to_string() );
+    }
+#endif
+
 };
 
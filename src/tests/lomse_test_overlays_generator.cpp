@@ -0,0 +1,187 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2018. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+
+#include <UnitTest++.h>
+#include <sstream>
+#include "lomse_build_options.h"
+
+//classes related to these tests
+#include "lomse_injectors.h"
+#include "lomse_overlays_generator.h"
+#include "lomse_visual_effect.h"
+#include "lomse_screen_drawer.h"
+#include "lomse_renderer.h"
+
+using namespace UnitTest;
+using namespace std;
+using namespace lomse;
+
+
+//---------------------------------------------------------------------------------------
+//helper: an effect drawing a red rectangle
+class MyRectangleEffect : public VisualEffect
+{
+protected:
+    URect m_rect;
+
+public:
+    MyRectangleEffect(LibraryScope& libraryScope, const URect& rect)
+        : VisualEffect(nullptr, libraryScope)
+        , m_rect(rect)
+    {
+    }
+
+    inline void move_to(const URect& rect) { m_rect = rect; }
+
+    void on_draw(ScreenDrawer* pDrawer) override
+    {
+        pDrawer->begin_path();
+        pDrawer->fill(Color(255, 0, 0));
+        pDrawer->stroke_none();
+        pDrawer->rect(m_rect.get_top_left(), USize(m_rect.width, m_rect.height), 0.0f);
+        pDrawer->end_path();
+        pDrawer->render();
+    }
+
+    URect get_bounds() override { return m_rect; }
+};
+
+
+//---------------------------------------------------------------------------------------
+class OverlaysGeneratorTestFixture
+{
+public:
+    LibraryScope m_libraryScope;
+    vector<unsigned char> m_pixels;
+    RenderingBuffer m_rbuf;
+    LUnits m_pixelSize;
+
+    OverlaysGeneratorTestFixture()     //SetUp fixture
+        : m_libraryScope(cout)
+        , m_pixels(200*200*4, 200)
+        , m_pixelSize(2540.0f / 96.0f)
+    {
+        m_libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+        m_rbuf.attach(&m_pixels[0], 200, 200, 200*4);
+    }
+
+    ~OverlaysGeneratorTestFixture()    //TearDown fixture
+    {
+    }
+
+    ScreenDrawer* create_drawer()
+    {
+        ScreenDrawer* pDrawer = Injector::inject_ScreenDrawer(m_libraryScope);
+        pDrawer->reset(m_rbuf, Color(200, 200, 200));
+        TransAffine mtx;
+        pDrawer->set_transform(mtx);
+        return pDrawer;
+    }
+
+    URect pixels_rect(int x, int y, int width, int height)
+    {
+        return URect(x * m_pixelSize, y * m_pixelSize,
+                     width * m_pixelSize, height * m_pixelSize);
+    }
+
+    unsigned char* pixel(int x, int y)
+    {
+        return &m_pixels[(y * 200 + x) * 4];
+    }
+
+    int count_red_pixels()
+    {
+        int count = 0;
+        for (size_t i=0; i < m_pixels.size(); i += 4)
+        {
+            if (m_pixels[i] == 255 && m_pixels[i+1] == 0 && m_pixels[i+2] == 0)
+                ++count;
+        }
+        return count;
+    }
+
+};
+
+
+SUITE(OverlaysGeneratorTest)
+{
+
+    TEST_FIXTURE(OverlaysGeneratorTestFixture, effect_moved_background_restored)
+    {
+        ScreenDrawer* pDrawer = create_drawer();
+        OverlaysGenerator generator(nullptr, m_libraryScope);
+        generator.set_rendering_buffer(&m_rbuf);
+        generator.on_new_background();
+        MyRectangleEffect* pEffect =
+            LOMSE_NEW MyRectangleEffect(m_libraryScope, pixels_rect(20, 20, 10, 10));
+        pEffect->show();
+        generator.add_visual_effect(pEffect);
+
+        generator.update_all_visual_effects(pDrawer);
+        CHECK( count_red_pixels() == 100 );
+        CHECK( pixel(25, 25)[0] == 255 && pixel(25, 25)[1] == 0 );
+
+        pEffect->move_to( pixels_rect(120, 150, 10, 10) );
+        generator.update_all_visual_effects(pDrawer);
+
+        CHECK( count_red_pixels() == 100 );
+        CHECK( pixel(25, 25)[0] == 200 && pixel(25, 25)[1] == 200 );
+        CHECK( pixel(125, 155)[0] == 255 && pixel(125, 155)[1] == 0 );
+
+        pEffect->hide();
+        generator.update_all_visual_effects(pDrawer);
+        CHECK( count_red_pixels() == 0 );
+
+        delete pDrawer;
+    }
+
+    TEST_FIXTURE(OverlaysGeneratorTestFixture, only_dirty_region_is_restored)
+    {
+        ScreenDrawer* pDrawer = create_drawer();
+        OverlaysGenerator generator(nullptr, m_libraryScope);
+        generator.set_rendering_buffer(&m_rbuf);
+        generator.on_new_background();
+        MyRectangleEffect* pEffect =
+            LOMSE_NEW MyRectangleEffect(m_libraryScope, pixels_rect(20, 20, 10, 10));
+        pEffect->show();
+        generator.add_visual_effect(pEffect);
+        generator.update_all_visual_effects(pDrawer);
+
+        //pixels far from the effect are not copied back from the saved background
+        pixel(180, 180)[0] = 0;
+        pEffect->move_to( pixels_rect(40, 20, 10, 10) );
+        generator.update_all_visual_effects(pDrawer);
+
+        CHECK( pixel(180, 180)[0] == 0 );
+        CHECK( pixel(25, 25)[0] == 200 );
+        CHECK( count_red_pixels() == 100 );
+
+        delete pDrawer;
+    }
+
+}
@@ -103,6 +103,58 @@ SUITE(ScoreAlgorithmsTest)
         CHECK( pNote->get_fpitch() == FPitch("e4") );
     }
 
+    TEST_FIXTURE(ScoreAlgorithmsTestFixture, find_noterest_2)
+    {
+        //note sounding at timepos, in the right instrument and voice
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)"
+            "(instrument (staves 2)(musicData "
+            "(clef G p1)(clef F4 p2)(n e4 h v1)(n f4 q v1)"
+            "(n c3 q v2 p2)(n d3 q v2 p2)(n e3 q v2 p2))) "
+            "(instrument (musicData (clef G)(n g4 w v1)))"
+            ")");
+        ImoScore* pScore =
+            static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+
+        ImoNote* pNote = static_cast<ImoNote*>(
+                            ScoreAlgorithms::find_noterest_at(pScore, 0, 1, 32.0) );
+        CHECK( pNote && pNote->get_fpitch() == FPitch("e4") );
+
+        pNote = static_cast<ImoNote*>(
+                            ScoreAlgorithms::find_noterest_at(pScore, 0, 2, 80.0) );
+        CHECK( pNote && pNote->get_fpitch() == FPitch("d3") );
+
+        pNote = static_cast<ImoNote*>(
+                            ScoreAlgorithms::find_noterest_at(pScore, 1, 1, 160.0) );
+        CHECK( pNote && pNote->get_fpitch() == FPitch("g4") );
+
+        CHECK( ScoreAlgorithms::find_noterest_at(pScore, 0, 3, 0.0) == nullptr );
+        CHECK( ScoreAlgorithms::find_noterest_at(pScore, 0, 1, 200.0) == nullptr );
+    }
+
+    TEST_FIXTURE(ScoreAlgorithmsTestFixture, find_noterest_3)
+    {
+        //the lookup is updated when deleting a note
+        Document doc(m_libraryScope);
+        doc.from_string("(score (vers 2.0)(instrument (musicData "
+            "(clef G)(n e4 e v1)(n f4 e v1)(n g4 e v1)"
+            ")))");
+        ImoScore* pScore =
+            static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        ImoNote* pNote = static_cast<ImoNote*>(
+                            ScoreAlgorithms::find_noterest_at(pScore, 0, 1, 40.0) );
+        CHECK( pNote && pNote->get_fpitch() == FPitch("f4") );
+
+        pScore->get_instrument(0)->delete_staffobj(pNote);
+
+        pNote = static_cast<ImoNote*>(
+                            ScoreAlgorithms::find_noterest_at(pScore, 0, 1, 40.0) );
+        CHECK( pNote == nullptr );
+        pNote = static_cast<ImoNote*>(
+                            ScoreAlgorithms::find_noterest_at(pScore, 0, 1, 64.0) );
+        CHECK( pNote && pNote->get_fpitch() == FPitch("g4") );
+    }
+
     TEST_FIXTURE(ScoreAlgorithmsTestFixture, find_and_classify_021)
     {
         //@021. requested interval starts and ends at same time than existing note
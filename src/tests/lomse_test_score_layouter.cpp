@@ -103,6 +103,36 @@ public:
     void my_engrave_system() { engrave_system(); }
 
     void my_delete_all() { delete_not_used_objects(); }
+    SpacingAlgorithm* my_get_spacing_algorithm() { return m_pSpAlgorithm; }
+};
+
+//---------------------------------------------------------------------------------------
+// helper, for accesing protected members
+class MyLinesBreakerOptimal : public LinesBreakerOptimal
+{
+public:
+    MyLinesBreakerOptimal(ScoreLayouter* pScoreLyt, LibraryScope& libScope,
+                          SpacingAlgorithm* pSpAlgorithm, std::vector<int>& breaks)
+        : LinesBreakerOptimal(pScoreLyt, libScope, pSpAlgorithm, breaks)
+    {
+    }
+    virtual ~MyLinesBreakerOptimal() {}
+
+    bool my_same_entries(MyLinesBreakerOptimal& other)
+    {
+        if (m_entries.size() != other.m_entries.size())
+            return false;
+        for (size_t i=0; i < m_entries.size(); ++i)
+        {
+            if (m_entries[i].penalty != other.m_entries[i].penalty
+                || m_entries[i].predecessor != other.m_entries[i].predecessor
+                || m_entries[i].system != other.m_entries[i].system)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
 };
 
 
@@ -445,6 +475,60 @@ SUITE(ScoreLayouterTest)
         scoreLyt.my_delete_all();
     }
 
+    TEST_FIXTURE(ScoreLayouterTestFixture, ScoreLayouter_012b)
+    {
+        //@012b. pruned lines breaker gives the same result than the full algorithm
+
+        stringstream ss;
+        ss << "(score (vers 2.0)(instrument (musicData (clef G)(key D)(time 4 4)";
+        for (int i=0; i < 120; ++i)
+        {
+            switch (i % 5)
+            {
+                case 0:  ss << "(n c4 w)";                          break;
+                case 1:  ss << "(n c4 q)(n d4 q)(n e4 h)";          break;
+                case 2:  ss << "(n +c4 s)(n d4 s)(n -e4 s)(n f4 s)"
+                               "(n g4 e)(n a4 e)(n b4 q)(n c5 q)";  break;
+                case 3:  ss << "(chord (n c4 h)(n e4 h))(r h)";     break;
+                default: ss << "(n g4 e)(n a4 e)(n b4 e)(n c5 e)(n d5 h)";
+            }
+            ss << "(barline)";
+            if (i == 70)
+                ss << "(newSystem)";
+        }
+        ss << ")))";
+
+        Document doc(m_libraryScope);
+        doc.from_string(ss.str());
+        GraphicModel gmodel;
+        ImoScore* pImoScore = static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+        MyScoreLayouter scoreLyt(pImoScore, &gmodel, m_libraryScope);
+        scoreLyt.prepare_to_start_layout();
+        GmoBoxScorePage pageBox(pImoScore);
+        pageBox.set_origin(1500.0f, 2000.0f);
+        pageBox.set_width(18000.0f);
+        pageBox.set_height(25700.0f);
+        scoreLyt.my_page_initializations(&pageBox);
+        scoreLyt.my_move_cursor_to_top_left_corner();
+
+        std::vector<int> breaks;
+        MyLinesBreakerOptimal breaker(&scoreLyt, m_libraryScope,
+                                      scoreLyt.my_get_spacing_algorithm(), breaks);
+        breaker.decide_line_breaks();
+
+        std::vector<int> fullBreaks;
+        MyLinesBreakerOptimal fullBreaker(&scoreLyt, m_libraryScope,
+                                          scoreLyt.my_get_spacing_algorithm(), fullBreaks);
+        fullBreaker.use_pruning(false);
+        fullBreaker.decide_line_breaks();
+
+        CHECK( breaks.size() > 10 );
+        CHECK( breaks == fullBreaks );
+        CHECK( breaker.my_same_entries(fullBreaker) );
+
+        scoreLyt.my_delete_all();
+    }
+
     TEST_FIXTURE(ScoreLayouterTestFixture, ScoreLayouter_013)
     {
         //@013. check method create_system_box()
@@ -494,3 +494,74 @@ SUITE(ScorePlayerTest)
     }
 
 }
+
+
+//---------------------------------------------------------------------------------------
+SUITE(PlaybackSchedulerTest)
+{
+
+    TEST(scheduler_waits_until_deadline)
+    {
+        PlaybackScheduler scheduler;
+        scheduler.start(0L);
+        PlaybackScheduler::Clock::time_point start = PlaybackScheduler::Clock::now();
+
+        scheduler.wait_until(20L);
+
+        long elapsed = long( std::chrono::duration_cast<std::chrono::milliseconds>(
+                                PlaybackScheduler::Clock::now() - start).count() );
+        CHECK( elapsed >= 19L );
+        CHECK( scheduler.num_events() == 1L );
+        CHECK( scheduler.last_lateness() >= 0L );
+        CHECK( scheduler.max_lateness() == scheduler.last_lateness() );
+    }
+
+    TEST(scheduler_does_not_accumulate_errors)
+    {
+        //some work is done between events. With relative waits, 50 events would
+        //take at least 50 ms more than expected
+        PlaybackScheduler scheduler;
+        scheduler.start(0L);
+        PlaybackScheduler::Clock::time_point start = PlaybackScheduler::Clock::now();
+
+        for (long i=1; i <= 50; ++i)
+        {
+            std::this_thread::sleep_for( std::chrono::milliseconds(1) );
+            scheduler.wait_until(4L * i);
+        }
+
+        long elapsed = long( std::chrono::duration_cast<std::chrono::milliseconds>(
+                                PlaybackScheduler::Clock::now() - start).count() );
+        CHECK( elapsed >= 199L );
+        CHECK( scheduler.num_events() == 50L );
+        //the deadline for last event is not delayed by the work done between events
+        CHECK( scheduler.deadline_for(200L) <= start + std::chrono::milliseconds(200) );
+    }
+
+    TEST(scheduler_reanchor_at_last_deadline)
+    {
+        PlaybackScheduler scheduler;
+        scheduler.start(0L);
+        scheduler.wait_until(5L);
+        PlaybackScheduler::Clock::time_point deadline = scheduler.deadline_for(5L);
+
+        scheduler.reanchor(1000L);
+
+        CHECK( scheduler.deadline_for(1000L) == deadline );
+        CHECK( scheduler.deadline_for(1010L) - deadline == std::chrono::milliseconds(10) );
+    }
+
+    TEST(scheduler_spin_wait)
+    {
+        PlaybackScheduler scheduler;
+        scheduler.enable_spin(true);
+        scheduler.start(0L);
+        PlaybackScheduler::Clock::time_point start = PlaybackScheduler::Clock::now();
+
+        scheduler.wait_until(5L);
+
+        CHECK( PlaybackScheduler::Clock::now() - start >= std::chrono::milliseconds(5) );
+        CHECK( scheduler.num_events() == 1L );
+    }
+
+}
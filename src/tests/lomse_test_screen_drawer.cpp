@@ -0,0 +1,198 @@
+//---------------------------------------------------------------------------------------
+// This file is part of the Lomse library.
+// Lomse is copyrighted work (c) 2010-2018. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice, this
+//      list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright notice, this
+//      list of conditions and the following disclaimer in the documentation and/or
+//      other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+// OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+// TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+// BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// For any comment, suggestion or feature request, please contact the manager of
+// the project at cecilios@users.sourceforge.net
+
+#include <UnitTest++.h>
+#include <sstream>
+#include "lomse_build_options.h"
+
+//classes related to these tests
+#include "lomse_injectors.h"
+#include "lomse_screen_drawer.h"
+#include "lomse_calligrapher.h"
+#include "lomse_renderer.h"
+#include "lomse_font_storage.h"
+
+using namespace UnitTest;
+using namespace std;
+using namespace lomse;
+
+
+//---------------------------------------------------------------------------------------
+class ScreenDrawerTestFixture
+{
+public:
+    LibraryScope m_libraryScope;
+    vector<unsigned char> m_pixels;
+    RenderingBuffer m_rbuf;
+    LUnits m_pixelSize;
+
+    ScreenDrawerTestFixture()     //SetUp fixture
+        : m_libraryScope(cout)
+        , m_pixels(100*100*4)
+        , m_pixelSize(2540.0f / 96.0f)
+    {
+        m_libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+        m_rbuf.attach(&m_pixels[0], 100, 100, 100*4);
+    }
+
+    ~ScreenDrawerTestFixture()    //TearDown fixture
+    {
+    }
+
+    ScreenDrawer* create_drawer()
+    {
+        ScreenDrawer* pDrawer = Injector::inject_ScreenDrawer(m_libraryScope);
+        pDrawer->reset(m_rbuf, Color(255, 255, 255));
+        TransAffine mtx;
+        pDrawer->set_transform(mtx);
+        pDrawer->select_font("any",
+                             m_libraryScope.get_music_font_file(),
+                             m_libraryScope.get_music_font_name(),
+                             24.0);
+        pDrawer->set_text_color(Color(0, 0, 0));
+        return pDrawer;
+    }
+
+    void draw_notehead(ScreenDrawer* pDrawer)
+    {
+        pDrawer->draw_glyph(40.0 * m_pixelSize, 50.0 * m_pixelSize, 0xE0A4);
+    }
+
+    void draw_rectangle(ScreenDrawer* pDrawer, Color color)
+    {
+        pDrawer->begin_path();
+        pDrawer->fill(color);
+        pDrawer->stroke_none();
+        pDrawer->rect(UPoint(20.0f * m_pixelSize, 20.0f * m_pixelSize),
+                      USize(60.0f * m_pixelSize, 60.0f * m_pixelSize), 0.0f);
+        pDrawer->end_path();
+    }
+
+    int count_pixels(unsigned char r, unsigned char g, unsigned char b)
+    {
+        int count = 0;
+        for (size_t i=0; i < m_pixels.size(); i += 4)
+        {
+            if (m_pixels[i] == r && m_pixels[i+1] == g && m_pixels[i+2] == b)
+                ++count;
+        }
+        return count;
+    }
+
+};
+
+
+SUITE(ScreenDrawerTest)
+{
+
+    TEST_FIXTURE(ScreenDrawerTestFixture, glyphs_rendered_when_paths_rendered)
+    {
+        ScreenDrawer* pDrawer = create_drawer();
+
+        draw_notehead(pDrawer);
+        CHECK( count_pixels(255, 255, 255) == 100*100 );
+
+        pDrawer->render();
+        CHECK( count_pixels(0, 0, 0) > 0 );
+
+        delete pDrawer;
+    }
+
+    TEST_FIXTURE(ScreenDrawerTestFixture, glyph_before_path_is_covered)
+    {
+        ScreenDrawer* pDrawer = create_drawer();
+
+        draw_notehead(pDrawer);
+        draw_rectangle(pDrawer, Color(255, 0, 0));
+        pDrawer->render();
+
+        CHECK( count_pixels(0, 0, 0) == 0 );
+        CHECK( count_pixels(255, 0, 0) > 0 );
+
+        delete pDrawer;
+    }
+
+    TEST_FIXTURE(ScreenDrawerTestFixture, glyph_after_path_is_visible)
+    {
+        ScreenDrawer* pDrawer = create_drawer();
+
+        draw_rectangle(pDrawer, Color(255, 0, 0));
+        draw_notehead(pDrawer);
+        pDrawer->render();
+
+        CHECK( count_pixels(0, 0, 0) > 0 );
+        CHECK( count_pixels(255, 0, 0) > 0 );
+
+        delete pDrawer;
+    }
+
+    TEST_FIXTURE(ScreenDrawerTestFixture, reset_discards_queued_glyphs)
+    {
+        ScreenDrawer* pDrawer = create_drawer();
+        draw_notehead(pDrawer);
+
+        //the previous buffer must not be written when reset
+        vector<unsigned char> pixels(100*100*4, 0x7f);
+        RenderingBuffer rbuf;
+        rbuf.attach(&pixels[0], 100, 100, 100*4);
+        pDrawer->reset(rbuf, Color(255, 255, 255));
+        pDrawer->render();
+
+        CHECK( count_pixels(255, 255, 255) == 100*100 );
+
+        delete pDrawer;
+    }
+
+    TEST_FIXTURE(ScreenDrawerTestFixture, batched_glyphs_as_immediate_glyphs)
+    {
+        //render the glyph directly, without batching
+        AttrStorage attrStorage;
+        PathStorage path;
+        Renderer* pRenderer = RendererFactory::create_renderer(m_libraryScope,
+                                                               attrStorage, path);
+        pRenderer->initialize(m_rbuf, Color(255, 255, 255));
+        FontStorage* pFonts = m_libraryScope.font_storage();
+        pFonts->select_font("any", m_libraryScope.get_music_font_file(),
+                            m_libraryScope.get_music_font_name(), 24.0);
+        Calligrapher calligrapher(pFonts, pRenderer);
+        calligrapher.draw_glyph(40.0, 50.0, 0xE0A4, Color(0, 0, 0), 1.0);
+        vector<unsigned char> expected(m_pixels);
+        delete pRenderer;
+
+        ScreenDrawer* pDrawer = create_drawer();
+        draw_notehead(pDrawer);
+        pDrawer->render();
+
+        CHECK( count_pixels(0, 0, 0) > 0 );
+        CHECK( expected == m_pixels );
+
+        delete pDrawer;
+    }
+
+}
+
@@ -440,4 +440,96 @@ SUITE(SpAlgGourlayTest)
         scoreLyt.my_delete_all();
     }
 
+    TEST_FIXTURE(SpAlgGourlayTestFixture, SpAlgGourlay_06)
+    {
+        //@ 06. Parallel spacing. Columns data is identical to that of serial spacing
+        //@     and to that computed by the previous, serial only, algorithm
+
+        string src = "(lenmusdoc (vers 0.0) (content (score (vers 2.0) "
+            "(instrument (staves 2)(musicData (clef G p1)(clef F4 p2)(key D)(time 2 4)";
+        for (int i=0; i < 24; ++i)
+        {
+            switch (i % 4)
+            {
+                case 0: src += "(n d4 e p1 g+)(n f4 s)(n a4 s g-)(clef G p2)(n +c5 q)"
+                               "(goBack h)(n a3 q p2 v2)(clef F4 p2)(n d3 e g+)(n d3 e g-)";
+                        break;
+                case 1: src += "(chord (n c4 q p1)(n e4 q)(n g4 q))(n -b4 e. g+)(n a4 s g-)"
+                               "(goBack h)(n g2 h p2 v2)";
+                        break;
+                case 2: src += "(n e4 e p1 g+ (tm 2 3)(t 1 + 3 2))(n f4 e (tm 2 3))"
+                               "(n g4 e g- (tm 2 3)(t 1 -))(r q)"
+                               "(goBack h)(n c3 e. p2 v2 g+)(n d3 s g-)(n +f3 q)";
+                        break;
+                default: src += "(n a4 q. p1)(n b4 e)"
+                                "(goBack h)(n d3 s p2 v2 g+)(n e3 s)(n f3 s)(n g3 s g-)(n a3 q)";
+            }
+            src += "(barline)";
+        }
+        src += ")))))";
+
+        //expected values, from the serial algorithm before parallel spacing was added:
+        //column, width, min.width, slope, xFixed, minFi, barlines info
+        struct Expected { int iCol; float width, minWidth, slope, xFixed, minFi; int barlines; };
+        const Expected expected[] = {
+            {  0, 6986.38525f, 4922.0f, 2280.27539f, 3794.0f, 0.26158604f, 3 },
+            {  1, 3485.05103f, 1403.0f, 2212.89355f, 387.0f, 0.0f, 0 },
+            {  2, 1277.19263f, 516.0f, 880.137634f, 45.0f, 0.516196489f, 3 },
+            {  3, 2424.99097f, 1245.0f, 1455.70776f, 387.0f, 0.317322463f, 0 },
+            {  4, 1249.19263f, 45.0f, 860.137634f, 45.0f, 0.0f, 0 },
+            {  5, 1276.06323f, 904.0f, 539.330872f, 521.0f, 0.710139215f, 0 },
+            {  6, 959.795044f, 516.0f, 653.425049f, 45.0f, 0.700951159f, 3 },
+            {  7, 3188.05078f, 952.0f, 2032.89355f, 342.0f, 0.0f, 0 },
+            {  8, 1188.0f, 1056.0f, 720.0f, 180.0f, 1.2166667f, 0 },
+            {  9, 959.795044f, 516.0f, 653.425049f, 45.0f, 0.700951159f, 3 },
+            { 10, 4134.38525f, 1879.0f, 2080.27539f, 1222.0f, 0.0f, 0 },
+            { 11, 1033.0f, 1033.0f, 633.425049f, 1033.0f, 1.55977416f, 0 },
+            { 12, 1256.79517f, 780.0f, 833.42511f, 90.0f, 0.538463831f, 3 },
+            { 67, 959.795044f, 516.0f, 653.425049f, 45.0f, 0.700951159f, 3 },
+        };
+        const int numExpected = int(sizeof(expected) / sizeof(Expected));
+
+        vector<float> values[2];
+        for (int k=0; k < 2; ++k)
+        {
+            m_libraryScope.set_spacing_threads(k == 0 ? 1 : 4);
+            Document doc(m_libraryScope);
+            doc.from_string(src);
+            GraphicModel gmodel;
+            ImoScore* pImoScore =
+                static_cast<ImoScore*>( doc.get_im_root()->get_content_item(0) );
+            MyScoreLayouter3 scoreLyt(pImoScore, &gmodel, m_libraryScope);
+
+            scoreLyt.prepare_to_start_layout();     //this creates columns and do spacing
+            MySpAlgGourlay* pAlg =
+                static_cast<MySpAlgGourlay*>(scoreLyt.get_spacing_algorithm());
+            CHECK( pAlg->get_num_columns() == 68 );
+            for (int i=0; i < pAlg->get_num_columns(); ++i)
+            {
+                ColumnDataGourlay* pCol = pAlg->my_get_column(i);
+                values[k].push_back(pCol->m_colWidth);
+                values[k].push_back(pCol->m_colMinWidth);
+                values[k].push_back(pCol->m_slope);
+                values[k].push_back(pCol->m_xFixed);
+                values[k].push_back(pCol->m_minFi);
+                values[k].push_back(float(pCol->m_barlinesInfo));
+            }
+            scoreLyt.my_delete_all();
+
+            for (int i=0; i < numExpected && values[k].size() == 68 * 6; ++i)
+            {
+                const Expected& e = expected[i];
+                float* pValues = &values[k][e.iCol * 6];
+                CHECK_CLOSE( e.width, pValues[0], 0.01f );
+                CHECK_CLOSE( e.minWidth, pValues[1], 0.01f );
+                CHECK_CLOSE( e.slope, pValues[2], 0.01f );
+                CHECK_CLOSE( e.xFixed, pValues[3], 0.01f );
+                CHECK_CLOSE( e.minFi, pValues[4], 0.0001f );
+                CHECK( e.barlines == int(pValues[5]) );
+            }
+        }
+
+        CHECK( values[0] == values[1] );
+    }
+
 };
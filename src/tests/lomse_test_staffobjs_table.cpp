@@ -2822,6 +2822,95 @@ SUITE(ColStaffObjsBuilderTest)
         if (pRoot && !pRoot->is_document()) delete pRoot;
     }
 
+    TEST_FIXTURE(ColStaffObjsBuilderTestFixture, ColStaffObjs_find_first_entry)
+    {
+        //@01. find() returns the first entry for objects in several staves
+        create_score(
+            "(score (vers 2.0)(instrument (staves 2)(musicData "
+            "(clef G p1)(clef F4 p2)(key D)(n c4 q p1)(n e3 q p2)(barline)"
+            ")))"
+        );
+        ColStaffObjsBuilder builder;
+        ColStaffObjs* pTable = builder.build(m_pScore);
+
+        ColStaffObjsIterator it = pTable->begin();
+        ++it;
+        ++it;
+        ColStaffObjsIterator itKey = pTable->find( (*it)->imo_object() );
+        CHECK( itKey == it );
+        CHECK( (*itKey)->imo_object()->is_key_signature() );
+        CHECK( (*itKey)->staff() == 0 );
+
+        ++it;
+        ++it;
+        ColStaffObjsIterator itNote = pTable->find( (*it)->imo_object() );
+        CHECK( itNote == it );
+        CHECK( (*itNote)->imo_object()->is_note() );
+    }
+
+    TEST_FIXTURE(ColStaffObjsBuilderTestFixture, ColStaffObjs_delete_entry)
+    {
+        //@02. delete_entry_for() unlinks the entry and updates the index
+        create_score(
+            "(score (vers 2.0)(instrument (staves 2)(musicData "
+            "(clef G p1)(clef F4 p2)(key D)(n c4 q p1)(n e3 q p2)(barline)"
+            ")))"
+        );
+        ColStaffObjsBuilder builder;
+        ColStaffObjs* pTable = builder.build(m_pScore);
+        CHECK( pTable->num_entries() == 7 );
+
+        ColStaffObjsIterator it = pTable->begin();
+        ++it;
+        ++it;
+        ImoStaffObj* pKey = (*it)->imo_object();
+        ImoStaffObj* pClef = pTable->front()->imo_object();
+        pTable->delete_entry_for(pKey);
+        pTable->delete_entry_for(pClef);
+
+        CHECK( pTable->num_entries() == 5 );
+        it = pTable->find(pKey);
+        CHECK( it != pTable->end() );
+        CHECK( (*it)->staff() == 1 );
+        CHECK( pTable->find(pClef) == pTable->end() );
+        CHECK( pTable->front()->imo_object()->is_clef() );
+        CHECK( pTable->front()->get_prev() == nullptr );
+        CHECK( pTable->front()->get_next() == *it );
+    }
+
+    TEST_FIXTURE(ColStaffObjsBuilderTestFixture, ColStaffObjs_links_and_index)
+    {
+        //@03. bulk loaded table: entries are linked in order and all are indexed
+        create_score(
+            "(score (vers 1.6)"
+            "(instrument (staves 2)(musicData "
+            "(clef G p1)(clef F4 p2)(key D)(time 2 4)"
+            "(n c4 q p1)(n d4 e p1)(n e4 e p1)(goBack start)(n e3 h p2)(barline)"
+            "(n f4 h p1)(goBack start)(n g3 q p2)(n a3 q p2)(barline)))"
+            "(instrument (musicData "
+            "(clef G)(key D)(time 2 4)(n a4 h)(barline)(n b4 q)(r q)(barline)))"
+            ")"
+        );
+        ColStaffObjsBuilder builder;
+        ColStaffObjs* pTable = builder.build(m_pScore);
+
+        int numEntries = 0;
+        ColStaffObjsIterator it;
+        ColStaffObjsEntry* pPrev = nullptr;
+        for (it = pTable->begin(); it != pTable->end(); ++it)
+        {
+            CHECK( (*it)->get_prev() == pPrev );
+            CHECK( pTable->find((*it)->imo_object()) != pTable->end() );
+            CHECK( (*it)->imo_object()->get_colstaffobjs_entry() != nullptr );
+            if (pPrev)
+                CHECK( !is_lower_time((*it)->time(), pPrev->time()) );
+            pPrev = *it;
+            ++numEntries;
+        }
+        CHECK( pTable->back() == pPrev );
+        CHECK( pTable->num_entries() == numEntries );
+    }
+
 //    TEST_FIXTURE(ColStaffObjsBuilderTestFixture, playback_time_100)
 //    {
 //        //@100. auxiliary, for checking the ColStaffObjs
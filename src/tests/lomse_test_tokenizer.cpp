@@ -29,6 +29,9 @@
 
 #include <UnitTest++.h>
 #include <iostream>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
 #include "lomse_build_options.h"
 
 //classes related to these tests
@@ -41,6 +44,25 @@ using namespace std;
 using namespace lomse;
 
 
+//---------------------------------------------------------------------------------------
+//a reader without buffer, to check the tokenizer slow path
+class MyUnbufferedReader : public LdpReader
+{
+protected:
+    stringstream m_stream;
+
+public:
+    MyUnbufferedReader(const std::string& sourceText) : m_stream(sourceText) {}
+
+    char get_next_char() override { return m_stream.get(); }
+    void repeat_last_char() override { m_stream.unget(); }
+    bool is_ready() override { return true; }
+    bool end_of_data() override { return m_stream.peek() == EOF; }
+    int get_line_number() override { return 0; }
+    string get_locator() override { return "string:"; }
+};
+
+//---------------------------------------------------------------------------------------
 class LdpTokenizerTestFixture
 {
 public:
@@ -55,6 +77,19 @@ public:
     }
 
     std::string m_scores_path;
+
+    string tokens_as_string(LdpReader& reader)
+    {
+        stringstream ss;
+        LdpTokenizer tokenizer(reader, cout);
+        LdpToken* token = tokenizer.read_token();
+        while (token->get_type() != tkEndOfFile)
+        {
+            ss << token->get_type() << ":" << token->get_value() << "|";
+            token = tokenizer.read_token();
+        }
+        return ss.str();
+    }
 };
 
 SUITE(LdpTokenizerTest)
@@ -295,4 +330,35 @@ SUITE(LdpTokenizerTest)
         CHECK( token->get_value() == "-45.70" );
     }
 
+    TEST_FIXTURE(LdpTokenizerTestFixture, Tokenizer_buffered_as_unbuffered)
+    {
+        string src = "(score (vers 2.0)\r\n\t(instrument (name \"Flute\ttwo\")"
+                     "(musicData (clef G)(key Eb)(n +c4 q. v2 l)(r e)"
+                     "  // a comment\n(n c4 -45.70 p:1 '' 'label' 'it''s')"
+                     "/* block */(text _\"under\")(barline |:) 34a)))";
+        LdpTextReader reader(src);
+        MyUnbufferedReader unbuffered(src);
+        string tokens = tokens_as_string(reader);
+        CHECK( tokens == tokens_as_string(unbuffered) );
+//        cout << tokens << endl;
+    }
+
+    TEST_FIXTURE(LdpTokenizerTestFixture, Tokenizer_buffered_reader_line_numbers)
+    {
+        string path = m_scores_path + "00011-empty-fill-page.lms";
+        ifstream file(path.c_str(), ios::binary);
+        stringstream content;
+        content << file.rdbuf();
+        string data = content.str();
+        int numLines = 1 + int( std::count(data.begin(), data.end(), '\n') );
+
+        LdpFileReader reader(path);
+        LdpTokenizer tokenizer(reader, cout);
+        LdpToken* token = tokenizer.read_token();
+        while (token->get_type() != tkEndOfFile)
+            token = tokenizer.read_token();
+        CHECK( reader.end_of_data() );
+        CHECK( tokenizer.get_line_number() == numLines );
+    }
+
 };
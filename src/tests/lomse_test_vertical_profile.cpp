@@ -54,33 +54,21 @@ public:
 
     inline int my_get_num_staves() { return m_numStaves; }
 
-    inline size_t my_x_min_size(int idxStaff) { return m_xMin[idxStaff]->size(); }
-    inline size_t my_x_max_size(int idxStaff) { return m_xMax[idxStaff]->size(); }
-    inline list<VProfilePoint>* my_xMin(int idxStaff) { return m_xMin[idxStaff]; }
-    inline list<VProfilePoint>* my_xMax(int idxStaff) { return m_xMax[idxStaff]; }
-    VProfilePoint my_xMin(int idxStaff, int i)
-    {
-        list<VProfilePoint>::iterator it = m_xMin[idxStaff]->begin();
-        std::advance(it, i);
-        return *it;
-    }
-    inline VProfilePoint my_xMax(int idxStaff, int i)
-    {
-        list<VProfilePoint>::iterator it = m_xMax[idxStaff]->begin();
-        std::advance(it, i);
-        return *it;
-    }
-
-    string dump_points(list<VProfilePoint>* pPoints, int idxStaff)
+    inline size_t my_x_min_size(int idxStaff) { return m_xMin[idxStaff].size(); }
+    inline size_t my_x_max_size(int idxStaff) { return m_xMax[idxStaff].size(); }
+    inline VProfileRow& my_xMin(int idxStaff) { return m_xMin[idxStaff]; }
+    inline VProfileRow& my_xMax(int idxStaff) { return m_xMax[idxStaff]; }
+    inline VProfilePoint my_xMin(int idxStaff, int i) { return m_xMin[idxStaff].point(i); }
+    inline VProfilePoint my_xMax(int idxStaff, int i) { return m_xMax[idxStaff].point(i); }
+
+    string dump_points(VProfileRow& points, int idxStaff)
     {
         stringstream msg;
-        msg << "size = " << pPoints->size() << endl;
-        PointsIterator it= pPoints->begin();
-        int i = 0;
-        for (; it != pPoints->end(); ++it, ++i)
+        msg << "size = " << points.size() << endl;
+        for (int i=0; i < points.size(); ++i)
         {
-            msg << "point(" << idxStaff << ", " << i << ") = {" << (*it).x << ", "
-                << (*it).y << ", " << (void*)((*it).shape) << "}" << endl;
+            msg << "point(" << idxStaff << ", " << i << ") = {" << points.x[i] << ", "
+                << points.y[i] << ", " << (void*)(points.shape[i]) << "}" << endl;
         }
         return msg.str();
     }
@@ -609,6 +597,50 @@ SUITE(VerticalProfileTest)
         CHECK( vp.get_max_limit(0) == 5000.0f );
     }
 
+    TEST_FIXTURE(VerticalProfileTestFixture, vertical_profile_040)
+    {
+        //@040 update(): shape covering several shapes. Covered points are merged
+        LUnits xStart = 1500.0f;
+        LUnits xEnd = 19500.0f;
+        MyVerticalProfile vp(xStart, xEnd, 2);
+        vp.initialize(0, 3000.0f, 3400.0f);
+        vp.initialize(1, 3000.0f, 3400.0f);
+
+        GmoShapeRectangle shapes[5] = { GmoShapeRectangle(nullptr),
+            GmoShapeRectangle(nullptr), GmoShapeRectangle(nullptr),
+            GmoShapeRectangle(nullptr), GmoShapeRectangle(nullptr) };
+        for (int i=0; i < 5; ++i)
+        {
+            shapes[i].set_origin(3000.0f + 2000.0f * i, 2000.0f + 100.0f * i);
+            shapes[i].set_height(1000.0f);
+            shapes[i].set_width(1000.0f);
+            vp.update(&shapes[i], 0);
+        }
+        CHECK( vp.my_x_min_size(0) == 12 );
+
+        GmoShapeRectangle shape(nullptr);
+        shape.set_origin(2500.0f, 1500.0f);
+        shape.set_height(2000.0f);
+        shape.set_width(10000.0f);
+        vp.update(&shape, 0);
+
+//        cout << test_name() << ".  Dump of xMin:" << endl;
+//        cout << vp.dump_points(vp.my_xMin(0), 0) << endl;
+        CHECK( vp.my_x_min_size(0) == 4 );
+        CHECK( vp.my_xMin(0, 0) == VProfilePoint(1500.0f, LOMSE_PAPER_UPPER_LIMIT, nullptr) );
+        CHECK( vp.my_xMin(0, 1) == VProfilePoint(2500.0f, 1500.0f, &shape) );
+        CHECK( vp.my_xMin(0, 2) == VProfilePoint(12500.0f, LOMSE_PAPER_UPPER_LIMIT, nullptr) );
+        CHECK( vp.my_xMin(0, 3) == VProfilePoint(19500.0f, LOMSE_PAPER_UPPER_LIMIT, nullptr) );
+
+//        cout << test_name() << ".  Dump of xMax:" << endl;
+//        cout << vp.dump_points(vp.my_xMax(0), 0) << endl;
+        CHECK( vp.my_x_max_size(0) == 4 );
+        CHECK( vp.my_xMax(0, 1) == VProfilePoint(2500.0f, 3500.0f, &shape) );
+
+        CHECK( vp.get_min_for(4000.0f, 9000.0f, 0).second == &shape );
+        CHECK( vp.get_max_for(4000.0f, 9000.0f, 0).first == 3500.0f );
+    }
+
     TEST_FIXTURE(VerticalProfileTestFixture, vertical_profile_100)
     {
         //@100 get_max_for()
@@ -30,6 +30,7 @@
 #define LOMSE_INTERNAL_API
 #include <UnitTest++.h>
 #include <sstream>
+#include <algorithm>
 #include "lomse_build_options.h"
 
 //classes related to these tests
@@ -39,6 +40,11 @@
 #include "lomse_doorway.h"
 #include "lomse_screen_drawer.h"
 #include "lomse_interactor.h"
+#include "lomse_tile_cache.h"
+#include "lomse_button_ctrl.h"
+#include "lomse_checkbox_ctrl.h"
+#include "lomse_hyperlink_ctrl.h"
+#include "lomse_static_text_ctrl.h"
 
 using namespace UnitTest;
 using namespace std;
@@ -137,6 +143,20 @@ public:
 };
 
 
+//---------------------------------------------------------------------------------------
+//helper: compares the top-left area of two RGBA buffers
+static bool my_same_pixels(RenderingBuffer& rbuf1, RenderingBuffer& rbuf2,
+                           int width, int height)
+{
+    for (int y=0; y < height; ++y)
+    {
+        if (memcmp(rbuf1.row_ptr(y), rbuf2.row_ptr(y), size_t(width * 4)) != 0)
+            return false;
+    }
+    return true;
+}
+
+
 SUITE(GraphicViewTest)
 {
 
@@ -571,6 +591,218 @@ SUITE(GraphicViewTest)
         rectangles.clear();
     }
 
+    //-- tile cache ---------------------------------------------------------------------
+
+    TEST_FIXTURE(GraphicViewTestFixture, tile_cache_evicts_least_recently_used)
+    {
+        vector<unsigned char> pixels(64*64*4, 0);
+        RenderingBuffer src;
+        src.attach(&pixels[0], 64, 64, 64*4);
+
+        TileCache cache(16, 2*16*16*4);     //budget for two tiles
+        cache.add_tile(1.0, 0, 0, src, 0, 0);
+        cache.add_tile(1.0, 1, 0, src, 16, 0);
+        CHECK( cache.get_num_tiles() == 2 );
+        CHECK( cache.get_tile(1.0, 0, 0) != nullptr );     //now (1,0) is the LRU
+
+        cache.add_tile(1.0, 0, 1, src, 0, 16);
+        CHECK( cache.get_num_tiles() == 2 );
+        CHECK( cache.get_memory_used() == size_t(2*16*16*4) );
+        CHECK( cache.get_tile(1.0, 1, 0) == nullptr );
+        CHECK( cache.get_tile(1.0, 0, 0) != nullptr );
+        CHECK( cache.get_tile(1.0, 0, 1) != nullptr );
+        CHECK( cache.get_tile(2.0, 0, 1) == nullptr );
+
+        cache.validate(1L, 5L);     //other model: all tiles discarded
+        CHECK( cache.get_num_tiles() == 0 );
+        CHECK( cache.get_memory_used() == 0 );
+    }
+
+    TEST_FIXTURE(GraphicViewTestFixture, tile_cache_copy_pixels_is_clipped)
+    {
+        vector<unsigned char> srcPixels(4*4, 7);
+        vector<unsigned char> destPixels(6*6, 0);
+        RenderingBuffer src;
+        src.attach(&srcPixels[0], 4, 4, 4);
+        RenderingBuffer dest;
+        dest.attach(&destPixels[0], 6, 6, 6);
+
+        TileCache::copy_pixels(src, 0, 0, dest, -2, 4, 4, 4, 1);
+
+        int count = 0;
+        for (int i=0; i < 36; ++i)
+            count += (destPixels[i] == 7 ? 1 : 0);
+        CHECK( count == 4 );
+        CHECK( destPixels[4*6] == 7 );
+        CHECK( destPixels[5*6+1] == 7 );
+        CHECK( destPixels[5*6+2] == 0 );
+    }
+
+    TEST_FIXTURE(GraphicViewTestFixture, tile_cache_renders_as_without_cache)
+    {
+        MyDoorway platform;
+        LibraryScope libraryScope(cout, &platform);
+        libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+        SpDocument spDoc( new Document(libraryScope) );
+        spDoc->from_string("(lenmusdoc (vers 0.0) (content (score (vers 1.6) "
+            "(instrument (musicData (clef G)(key e)(n c4 q)(r q)(barline simple)"
+            "(n e4 e g+)(n g4 e g-)(n c5 h)(barline simple))))))" );
+        VerticalBookView* pView = Injector::inject_VerticalBookView(libraryScope, spDoc.get());
+        Interactor* pIntor = Injector::inject_Interactor(libraryScope, spDoc, pView, nullptr);
+        pView->set_interactor(pIntor);
+        VerticalBookView* pView2 = Injector::inject_VerticalBookView(libraryScope, spDoc.get());
+        Interactor* pIntor2 = Injector::inject_Interactor(libraryScope, spDoc, pView2, nullptr);
+        pView2->set_interactor(pIntor2);
+
+        //AWARE: when rendering without tiles, last column and row of the view are not
+        //rendered. Tiles render them. Therefore, they are excluded in comparisons.
+        int width = 700;
+        int height = 500;
+        vector<unsigned char> pixels(width*height*4);
+        vector<unsigned char> pixels2(width*height*4);
+        RenderingBuffer rbuf;
+        rbuf.attach(&pixels[0], width, height, width*4);
+        RenderingBuffer rbuf2;
+        rbuf2.attach(&pixels2[0], width, height, width*4);
+        pView->set_rendering_buffer(&rbuf);
+        pView2->set_rendering_buffer(&rbuf2);
+        pView->enable_tile_cache(true);
+        CHECK( pView->is_tile_cache_enabled() == true );
+        TileCache* pCache = pView->get_tile_cache();
+
+        pView->new_viewport(-30, -20);
+        pView2->new_viewport(-30, -20);
+        pView->redraw_bitmap();
+        pView2->redraw_bitmap();
+        CHECK( my_same_pixels(rbuf, rbuf2, width - 1, height - 1) );
+        CHECK( pCache->get_num_hits() == 0 );
+        CHECK( pCache->get_num_tiles() == 12 );
+
+        //small scroll: only a new row of tiles is rendered
+        pCache->reset_statistics();
+        pView->new_viewport(-20, 60);
+        pView2->new_viewport(-20, 60);
+        pView->redraw_bitmap();
+        pView2->redraw_bitmap();
+        CHECK( my_same_pixels(rbuf, rbuf2, width - 1, height - 1) );
+        CHECK( pCache->get_num_hits() == 8 );
+        CHECK( pCache->get_num_misses() == 4 );
+
+        //changing a rendering option discards tiles
+        pIntor->highlight_voice(1);
+        pIntor2->highlight_voice(1);
+        CHECK( pCache->get_num_tiles() == 0 );
+
+        delete pIntor;
+        delete pIntor2;
+    }
+
+    //-- printing -----------------------------------------------------------------------
+
+    TEST_FIXTURE(GraphicViewTestFixture, print_pages_as_print_page)
+    {
+        MyDoorway platform;
+        LibraryScope libraryScope(cout, &platform);
+        libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+        stringstream ss;
+        ss << "(lenmusdoc (vers 0.0) (content "
+           << "(para (txt \"Text shapes are also rendered by workers\"))"
+           << "(score (vers 1.6) (instrument (musicData (clef G)(key D)(time 4 4)";
+        for (int i=0; i < 150; ++i)
+            ss << "(n +c4 e g+)(n d4 e g-)(n e4 q)(chord (n c4 h)(n e4 h))(barline)";
+        ss << ")))))";
+        SpDocument spDoc( new Document(libraryScope) );
+        spDoc->from_string(ss.str());
+        VerticalBookView* pView = Injector::inject_VerticalBookView(libraryScope, spDoc.get());
+        Interactor* pIntor = Injector::inject_Interactor(libraryScope, spDoc, pView, nullptr);
+        pView->set_interactor(pIntor);
+        pIntor->set_print_ppi(48.0);
+        int numPages = pIntor->get_num_pages();
+        CHECK( numPages > 2 );
+
+        int width = 400;
+        int height = 560;
+        size_t size = size_t(width * height * 4);
+        vector<unsigned char> serial(size * numPages);
+        vector<unsigned char> parallel(size * numPages);
+        vector<RenderingBuffer> rbufs(numPages);
+        vector<RenderingBuffer*> buffers;
+        vector<int> pages;
+        for (int i=0; i < numPages; ++i)
+        {
+            RenderingBuffer rbuf;
+            rbuf.attach(&serial[size * i], width, height, width*4);
+            pIntor->set_print_buffer(&rbuf);
+            pIntor->print_page(i);
+
+            rbufs[i].attach(&parallel[size * i], width, height, width*4);
+            buffers.push_back(&rbufs[i]);
+            pages.push_back(i);
+        }
+
+        pIntor->print_pages(pages, buffers, 3);
+
+        CHECK( std::count(serial.begin(), serial.end(), 0) > 0 );     //not blank
+        CHECK( serial == parallel );
+
+        delete pIntor;
+    }
+
+    TEST_FIXTURE(GraphicViewTestFixture, print_pages_with_controls_as_print_page)
+    {
+        //controls measure their text in the font storage of the worker drawer
+        MyDoorway platform;
+        LibraryScope libraryScope(cout, &platform);
+        libraryScope.set_default_fonts_path(TESTLIB_FONTS_PATH);
+        SpDocument spDoc( new Document(libraryScope) );
+        spDoc->create_empty();
+        for (int i=0; i < 120; ++i)
+        {
+            ImoParagraph* pPara = spDoc->add_paragraph();
+            pPara->add_control( new ButtonCtrl(libraryScope, nullptr, spDoc.get(),
+                                               "Button") );
+            pPara->add_control( new CheckboxCtrl(libraryScope, nullptr, spDoc.get(),
+                                                 "Checkbox") );
+            pPara->add_control( new HyperlinkCtrl(libraryScope, nullptr, spDoc.get(),
+                                                  "Hyperlink") );
+            pPara->add_control( new StaticTextCtrl(libraryScope, nullptr, spDoc.get(),
+                                                   "Static text") );
+        }
+        VerticalBookView* pView = Injector::inject_VerticalBookView(libraryScope, spDoc.get());
+        Interactor* pIntor = Injector::inject_Interactor(libraryScope, spDoc, pView, nullptr);
+        pView->set_interactor(pIntor);
+        pIntor->set_print_ppi(48.0);
+        int numPages = pIntor->get_num_pages();
+        CHECK( numPages > 2 );
+
+        int width = 400;
+        int height = 560;
+        size_t size = size_t(width * height * 4);
+        vector<unsigned char> serial(size * numPages);
+        vector<unsigned char> parallel(size * numPages);
+        vector<RenderingBuffer> rbufs(numPages);
+        vector<RenderingBuffer*> buffers;
+        vector<int> pages;
+        for (int i=0; i < numPages; ++i)
+        {
+            RenderingBuffer rbuf;
+            rbuf.attach(&serial[size * i], width, height, width*4);
+            pIntor->set_print_buffer(&rbuf);
+            pIntor->print_page(i);
+
+            rbufs[i].attach(&parallel[size * i], width, height, width*4);
+            buffers.push_back(&rbufs[i]);
+            pages.push_back(i);
+        }
+
+        pIntor->print_pages(pages, buffers, 3);
+
+                CHECK( *std::min_element(serial.begin(), serial.end()) < 255 );   //not blank
+        CHECK( serial == parallel );
+
+        delete pIntor;
+    }
+
     //TEST_FIXTURE(GraphicViewTestFixture, EditView_UpdateWindow)
     //{
     //    MyDoorway platform;
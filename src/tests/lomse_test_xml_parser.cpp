@@ -29,6 +29,7 @@
 
 #include <UnitTest++.h>
 #include <iostream>
+#include <cstring>
 #include "lomse_build_options.h"
 
 //classes related to these tests
@@ -176,6 +177,45 @@ SUITE(XmlParserTest)
 
     }
 
+    TEST_FIXTURE(XmlParserTestFixture, xml_parser_07)
+    {
+        //@07. Line numbers when parsing a string. New lines in attributes and
+        //@    CR+LF line ends do not affect the line numbers
+
+        XmlParser parser;
+        parser.parse_text("<score-partwise\r\n version='3.0'>\r\n"
+                          "<part-list name='a\nb'/>\r\n"
+                          "<part>text\r\nmore text</part>\r\n"
+                          "<measure/></score-partwise>");
+        XmlNode* root = parser.get_tree_root();
+        CHECK( parser.get_line_number(root) == 1 );
+        XmlNode child = root->first_child();
+        CHECK( child.name() == "part-list" );
+        CHECK( parser.get_line_number(&child) == 3 );
+        child = child.next_sibling();
+        CHECK( child.name() == "part" );
+        CHECK( parser.get_line_number(&child) == 5 );
+        child = child.next_sibling();
+        CHECK( child.name() == "measure" );
+        CHECK( parser.get_line_number(&child) == 7 );
+    }
+
+    TEST_FIXTURE(XmlParserTestFixture, xml_parser_08)
+    {
+        //@08. Line numbers when parsing an owned buffer in-situ
+
+        XmlParser parser;
+        string text("<score-partwise version='3.0'>\n\n<part-list/>\n</score-partwise>");
+        char* buffer = XmlParser::allocate_buffer(text.size());
+        memcpy(buffer, text.data(), text.size());
+        parser.parse_buffer_own(buffer, text.size());
+        XmlNode* root = parser.get_tree_root();
+        CHECK( parser.get_line_number(root) == 1 );
+        XmlNode child = root->first_child();
+        CHECK( child.name() == "part-list" );
+        CHECK( parser.get_line_number(&child) == 3 );
+    }
+
     TEST_FIXTURE(XmlParserTestFixture, xml_parser_901)
     {
         //@901. File not found
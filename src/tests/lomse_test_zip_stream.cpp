@@ -39,6 +39,7 @@
 #include "lomse_zip_stream.h"
 
 #include <cstring>
+#include <fstream>
 
 using namespace UnitTest;
 using namespace std;
@@ -400,6 +401,38 @@ SUITE(ZipInputStreamTest)
         delete[] data;
     }
 
+    TEST_FIXTURE(ZipInputStreamTestFixture, memory_archive)
+    {
+        string path = m_scores_path + "10014-compressed-flat-lmd.zip";
+        ifstream file(path.c_str(), ios::binary);
+        stringstream archive;
+        archive << file.rdbuf();
+        string data = archive.str();
+
+        ZipInputStream zs(data.data(), data.size());
+        ZipEntryInfo info;
+        zs.get_current_entry_info(info);
+        CHECK( info.filename == "lenmusdoc-example.lmd" );
+        CHECK( zs.get_size() == 8364L );
+        std::vector<unsigned char> content = zs.get_as_vector();
+        CHECK( int(strlen( (char*)content.data() )) == 8364 );
+    }
+
+    TEST_FIXTURE(ZipInputStreamTestFixture, memory_archive_invalid)
+    {
+        string data("this is not a zip archive");
+        bool fThrown = false;
+        try
+        {
+            ZipInputStream zs(data.data(), data.size());
+        }
+        catch (std::runtime_error&)
+        {
+            fThrown = true;
+        }
+        CHECK( fThrown );
+    }
+
 }
 
 #endif // LOMSE_ENABLE_COMPRESSION